@@ -8,9 +8,11 @@
 #include "Benchmark.h"
 #include "SkAAClip.h"
 #include "SkCanvas.h"
+#include "SkImage.h"
 #include "SkPath.h"
 #include "SkRandom.h"
 #include "SkRegion.h"
+#include "SkRRect.h"
 #include "SkString.h"
 #include "SkClipOpPriv.h"
 
@@ -50,7 +52,7 @@ protected:
         this->setupPaint(&paint);
 
         for (int i = 0; i < loops; ++i) {
-            // jostle the clip regions each time to prevent caching
+            // jostle the clip regions each time, so that consecutive clips differ
             fClipRect.offset((i % 2) == 0 ? SkIntToScalar(10) : SkIntToScalar(-10), 0);
             fClipPath.reset();
             fClipPath.addRoundRect(fClipRect,
@@ -170,6 +172,109 @@ private:
     typedef Benchmark INHERITED;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+// This bench applies the same clips on every loop, as when scrolling containers with rounded
+// corners are redrawn frame after frame. The raster clips are only scan-converted the first time.
+class RepeatedAAClipBench : public Benchmark {
+    SkString fName;
+    SkRRect  fContainer;
+    SkPath   fContentPath;
+    SkRect   fDrawRect;
+    bool     fDoAA;
+
+public:
+    RepeatedAAClipBench(bool doAA) : fDoAA(doAA) {
+        fName.printf("aaclip_repeated_%s", doAA ? "AA" : "BW");
+
+        fContainer.setRectXY(SkRect::MakeLTRB(20.5f, 20.5f, 380.5f, 380.5f), 24, 24);
+        // a rounded content area, with a circular hole in it
+        fContentPath.addRoundRect(SkRect::MakeLTRB(40.25f, 40.25f, 360.25f, 360.25f), 12, 12);
+        fContentPath.addCircle(200, 200, 60);
+        fContentPath.setFillType(SkPath::kEvenOdd_FillType);
+        fDrawRect.set(0, 0, 400, 400);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        for (int i = 0; i < loops; ++i) {
+            canvas->save();
+            canvas->clipRRect(fContainer, fDoAA);
+            canvas->clipPath(fContentPath, fDoAA);
+            canvas->drawRect(fDrawRect, paint);
+            canvas->restore();
+        }
+    }
+private:
+    typedef Benchmark INHERITED;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// This bench draws through an anti-aliased clip with many short runs on every row (thin diagonal
+// stripes), which is where the clip blitter hands over coverage as A8 rows.
+class ClippedDrawBench : public Benchmark {
+public:
+    enum Draw {
+        kFill_Draw,
+        kImage_Draw,
+    };
+
+    ClippedDrawBench(Draw draw) : fDraw(draw) {
+        fName.printf("aaclip_draw_%s", kFill_Draw == draw ? "fill" : "image");
+
+        for (int i = -40; i < 40; ++i) {
+            fClipPath.addRect(SkRect::MakeXYWH(i * 10.0f, -200, 4, 800));
+        }
+        SkMatrix rotate;
+        rotate.setRotate(30, 200, 200);
+        fClipPath.transform(rotate);
+        fDrawRect.set(0, 0, 400, 400);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDelayedSetup() override {
+        SkBitmap bitmap;
+        bitmap.allocN32Pixels(64, 64);
+        for (int y = 0; y < 64; ++y) {
+            for (int x = 0; x < 64; ++x) {
+                *bitmap.getAddr32(x, y) = SkPreMultiplyARGB(0xFF, x * 4, y * 4, 0x80);
+            }
+        }
+        fImage = SkImage::MakeFromBitmap(bitmap);
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+        paint.setFilterQuality(kLow_SkFilterQuality);
+
+        canvas->save();
+        canvas->clipPath(fClipPath, true);
+        for (int i = 0; i < loops; ++i) {
+            if (kFill_Draw == fDraw) {
+                canvas->drawRect(fDrawRect, paint);
+            } else {
+                canvas->drawImageRect(fImage, fDrawRect, &paint);
+            }
+        }
+        canvas->restore();
+    }
+
+private:
+    SkString       fName;
+    Draw           fDraw;
+    SkPath         fClipPath;
+    SkRect         fDrawRect;
+    sk_sp<SkImage> fImage;
+
+    typedef Benchmark INHERITED;
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 class AAClipBuilderBench : public Benchmark {
     SkString fName;
@@ -255,3 +360,7 @@ DEF_BENCH(return new AAClipBench(true, false);)
 DEF_BENCH(return new AAClipBench(true, true);)
 DEF_BENCH(return new NestedAAClipBench(false);)
 DEF_BENCH(return new NestedAAClipBench(true);)
+DEF_BENCH(return new RepeatedAAClipBench(false);)
+DEF_BENCH(return new RepeatedAAClipBench(true);)
+DEF_BENCH(return new ClippedDrawBench(ClippedDrawBench::kFill_Draw);)
+DEF_BENCH(return new ClippedDrawBench(ClippedDrawBench::kImage_Draw);)
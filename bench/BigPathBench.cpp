@@ -18,18 +18,29 @@ enum Align {
 
 const char* gAlignName[] = { "left", "middle", "right" };
 
+enum Style {
+    kStroke_Style,
+    kRoundStroke_Style,
+    kFill_Style,     // thousands of edges, each only a few rows tall
+    kBWFill_Style,
+};
+
 // Inspired by crbug.com/455429
 class BigPathBench : public Benchmark {
     SkPath      fPath;
     SkString    fName;
     Align       fAlign;
-    bool        fRound;
+    Style       fStyle;
 
 public:
-    BigPathBench(Align align, bool round) : fAlign(align), fRound(round) {
+    BigPathBench(Align align, Style style) : fAlign(align), fStyle(style) {
         fName.printf("bigpath_%s", gAlignName[fAlign]);
-        if (round) {
+        if (kRoundStroke_Style == style) {
             fName.append("_round");
+        } else if (kFill_Style == style) {
+            fName.append("_fill");
+        } else if (kBWFill_Style == style) {
+            fName.append("_fill_bw");
         }
     }
 
@@ -48,10 +59,12 @@ protected:
 
     void onDraw(int loops, SkCanvas* canvas) override {
         SkPaint paint;
-        paint.setAntiAlias(true);
-        paint.setStyle(SkPaint::kStroke_Style);
-        paint.setStrokeWidth(2);
-        if (fRound) {
+        paint.setAntiAlias(kBWFill_Style != fStyle);
+        if (kStroke_Style == fStyle || kRoundStroke_Style == fStyle) {
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(2);
+        }
+        if (kRoundStroke_Style == fStyle) {
             paint.setStrokeJoin(SkPaint::kRound_Join);
         }
         this->setupPaint(&paint);
@@ -77,10 +90,14 @@ private:
     typedef Benchmark INHERITED;
 };
 
-DEF_BENCH( return new BigPathBench(kLeft_Align,     false); )
-DEF_BENCH( return new BigPathBench(kMiddle_Align,   false); )
-DEF_BENCH( return new BigPathBench(kRight_Align,    false); )
+DEF_BENCH( return new BigPathBench(kLeft_Align,     kStroke_Style); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   kStroke_Style); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    kStroke_Style); )
+
+DEF_BENCH( return new BigPathBench(kLeft_Align,     kRoundStroke_Style); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   kRoundStroke_Style); )
+DEF_BENCH( return new BigPathBench(kRight_Align,    kRoundStroke_Style); )
 
-DEF_BENCH( return new BigPathBench(kLeft_Align,     true); )
-DEF_BENCH( return new BigPathBench(kMiddle_Align,   true); )
-DEF_BENCH( return new BigPathBench(kRight_Align,    true); )
+// With --noanalyticAA, the antialiased fill is supersampled, in --aaBands bands of rows.
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   kFill_Style); )
+DEF_BENCH( return new BigPathBench(kMiddle_Align,   kBWFill_Style); )
@@ -187,6 +187,7 @@ enum Flags {
     kRotate_Flag            = 1 << 1,
     kBilerp_Flag            = 1 << 2,
     kBicubic_Flag           = 1 << 3,
+    kPerspective_Flag       = 1 << 4,
 };
 
 static bool isBilerp(uint32_t flags) {
@@ -216,6 +217,9 @@ protected:
         if (fFlags & kRotate_Flag) {
             fFullName.append("_rotate");
         }
+        if (fFlags & kPerspective_Flag) {
+            fFullName.append("_persp");
+        }
         if (isBilerp(fFlags)) {
             fFullName.append("_bilerp");
         } else if (isBicubic(fFlags)) {
@@ -241,6 +245,12 @@ protected:
             const SkScalar y = SkIntToScalar(dim.fHeight) / 2;
             canvas->rotate(SkIntToScalar(35), x, y);
         }
+        if (fFlags & kPerspective_Flag) {
+            SkMatrix persp;
+            persp.setIdentity();
+            persp.setPerspY(SK_Scalar1 / dim.fHeight / 4);
+            canvas->concat(persp);
+        }
         INHERITED::onDraw(loops, canvas);
     }
 
@@ -379,6 +389,7 @@ DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kOpaque_SkAlphaType, t
 
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kScale_Flag | kBilerp_Flag | kBicubic_Flag); )
 DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kScale_Flag | kRotate_Flag | kBilerp_Flag | kBicubic_Flag); )
+DEF_BENCH( return new FilterBitmapBench(kN32_SkColorType, kPremul_SkAlphaType, false, false, kPerspective_Flag | kBilerp_Flag | kBicubic_Flag); )
 
 // source alpha tests -> S32A_Opaque_BlitRow32_{arm,neon}
 DEF_BENCH( return new SourceAlphaBitmapBench(SourceAlphaBitmapBench::kOpaque_SourceAlpha, kN32_SkColorType); )
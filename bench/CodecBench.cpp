@@ -7,10 +7,14 @@
 
 #include "CodecBench.h"
 #include "CodecBenchPriv.h"
+#include "Resources.h"
+#include "SkAnimationDecoder.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCommandLineFlags.h"
 #include "SkOSFile.h"
+#include "SkRandom.h"
+#include "SkResourceCache.h"
 
 // Actually zeroing the memory would throw off timing, so we just lie.
 DEFINE_bool(zero_init, false, "Pretend our destination is zero-intialized, simulating Android?");
@@ -69,3 +73,77 @@ void CodecBench::onDraw(int n, SkCanvas* canvas) {
                  || result == SkCodec::kIncompleteInput);
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ *  Seeks to pseudo-random frames of an animation, either by asking SkCodec for each frame
+ *  directly (which replays its whole chain of required frames every time), or through an
+ *  SkAnimationDecoder backed by a frame cache.
+ */
+class CodecAnimSeekBench : public Benchmark {
+public:
+    CodecAnimSeekBench(const char* resource, bool useDecoder)
+        : fResource(resource)
+        , fUseDecoder(useDecoder)
+    {
+        fName.printf("Codec_anim_seek_%s_%s", resource, useDecoder ? "cached" : "direct");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fResource);
+        fCodec.reset(SkCodec::NewFromData(fData));
+        if (fCodec) {
+            fInfo = fCodec->getInfo().makeColorType(kN32_SkColorType)
+                                     .makeAlphaType(kPremul_SkAlphaType)
+                                     .makeColorSpace(nullptr);
+            fFrameCount = SkTMax<int>(1, SkToInt(fCodec->getFrameInfo().size()));
+            fPixelStorage.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
+        }
+    }
+
+    void onDraw(int n, SkCanvas*) override {
+        if (!fCodec) {
+            return;
+        }
+        // A fresh cache per run, big enough to hold every frame.
+        SkResourceCache cache(SkTMax<size_t>(fFrameCount * fInfo.getSafeSize(fInfo.minRowBytes()),
+                                             1024 * 1024));
+        std::unique_ptr<SkAnimationDecoder> decoder;
+        if (fUseDecoder) {
+            decoder = SkAnimationDecoder::Make(fData, &cache);
+        }
+        SkRandom rand;
+        SkBitmap frame;
+        for (int i = 0; i < n; i++) {
+            int index = rand.nextULessThan(fFrameCount);
+            if (decoder) {
+                decoder->getFrame(index, &frame);
+            } else {
+                SkCodec::Options options;
+                options.fFrameIndex = index;
+                fCodec->getPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes(),
+                                  &options, nullptr, nullptr);
+            }
+        }
+    }
+
+private:
+    SkString                    fName;
+    const char*                 fResource;
+    const bool                  fUseDecoder;
+    sk_sp<SkData>               fData;
+    std::unique_ptr<SkCodec>    fCodec;
+    SkImageInfo                 fInfo;
+    int                         fFrameCount = 0;
+    SkAutoMalloc                fPixelStorage;
+};
+
+DEF_BENCH(return new CodecAnimSeekBench("randPixelsAnim.gif", false);)
+DEF_BENCH(return new CodecAnimSeekBench("randPixelsAnim.gif", true);)
+DEF_BENCH(return new CodecAnimSeekBench("test640x479.gif", false);)
+DEF_BENCH(return new CodecAnimSeekBench("test640x479.gif", true);)
@@ -437,6 +437,71 @@ private:
     typedef Benchmark INHERITED;
 };
 
+// Long dashed polylines, circles with many dashes, and dashed rects, as hairlines and as thin
+// strokes.
+class DashShapeBench : public Benchmark {
+public:
+    enum Shape {
+        kPolyline_Shape,
+        kCircle_Shape,
+        kRect_Shape,
+    };
+
+    DashShapeBench(Shape shape, SkScalar strokeWidth, bool doAA)
+        : fStrokeWidth(strokeWidth)
+        , fDoAA(doAA) {
+        static const char* gNames[] = { "polyline", "circle", "rect" };
+        fName.printf("dashshape_%s_%g%s", gNames[shape], SkScalarToFloat(strokeWidth),
+                     doAA ? "_aa" : "_bw");
+        switch (shape) {
+            case kPolyline_Shape: {
+                SkRandom rand;
+                fPath.moveTo(10, 10);
+                for (int i = 0; i < 200; ++i) {
+                    fPath.lineTo(rand.nextRangeScalar(10, 630), rand.nextRangeScalar(10, 470));
+                }
+                break;
+            }
+            case kCircle_Shape:
+                fPath.addCircle(320, 240, 220);
+                break;
+            case kRect_Shape:
+                fPath.addRect(SkRect::MakeLTRB(20, 20, 620, 460));
+                break;
+        }
+
+        SkScalar vals[] = { 2, 2 };
+        fPathEffect = SkDashPathEffect::Make(vals, 2, 0);
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint p;
+        this->setupPaint(&p);
+        p.setColor(SK_ColorBLACK);
+        p.setStyle(SkPaint::kStroke_Style);
+        p.setStrokeWidth(fStrokeWidth);
+        p.setPathEffect(fPathEffect);
+        p.setAntiAlias(fDoAA);
+        for (int i = 0; i < loops; ++i) {
+            canvas->drawPath(fPath, p);
+        }
+    }
+
+private:
+    SkString fName;
+    SkPath   fPath;
+    SkScalar fStrokeWidth;
+    bool     fDoAA;
+    sk_sp<SkPathEffect> fPathEffect;
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 static const SkScalar gDots[] = { SK_Scalar1, SK_Scalar1 };
@@ -464,6 +529,15 @@ DEF_BENCH( return new DrawPointsDashingBench(3, 1, true); )
 DEF_BENCH( return new DrawPointsDashingBench(5, 5, false); )
 DEF_BENCH( return new DrawPointsDashingBench(5, 5, true); )
 
+DEF_BENCH( return new DashShapeBench(DashShapeBench::kPolyline_Shape, 0, false); )
+DEF_BENCH( return new DashShapeBench(DashShapeBench::kPolyline_Shape, 0, true); )
+DEF_BENCH( return new DashShapeBench(DashShapeBench::kCircle_Shape, 0, false); )
+DEF_BENCH( return new DashShapeBench(DashShapeBench::kCircle_Shape, 0, true); )
+DEF_BENCH( return new DashShapeBench(DashShapeBench::kCircle_Shape, 1, true); )
+DEF_BENCH( return new DashShapeBench(DashShapeBench::kRect_Shape, 0, true); )
+DEF_BENCH( return new DashShapeBench(DashShapeBench::kRect_Shape, 2, false); )
+DEF_BENCH( return new DashShapeBench(DashShapeBench::kRect_Shape, 2, true); )
+
 /* Disable the GiantDashBench for Android devices until we can better control
  * the memory usage. (https://code.google.com/p/skia/issues/detail?id=1430)
  */
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "SkBitmap.h"
+#include "SkCanvas.h"
+#include "SkDistanceFieldGen.h"
+#include "SkPath.h"
+#include "SkTArray.h"
+#include "SkTypeface.h"
+#include "sk_tool_utils.h"
+
+// Generates the distance fields for the printable ASCII glyphs of a portable typeface, one at a
+// time or with SkGenerateDistanceFields(). Each loop is one glyph.
+class DistanceFieldBench : public Benchmark {
+public:
+    DistanceFieldBench(bool batch) : fBatch(batch) {}
+
+protected:
+    const char* onGetName() override {
+        return fBatch ? "distance_field_batch" : "distance_field_serial";
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+    void onDelayedSetup() override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        paint.setTextSize(48);
+        paint.setTypeface(sk_tool_utils::create_portable_typeface("serif", SkFontStyle()));
+
+        for (char c = '!'; c <= '~'; c++) {
+            SkPath path;
+            paint.getTextPath(&c, 1, 0, 0, &path);
+            SkIRect bounds = path.getBounds().roundOut();
+            SkBitmap& mask = fMasks.push_back();
+            mask.allocPixels(SkImageInfo::MakeA8(bounds.width(), bounds.height()));
+            mask.eraseColor(SK_ColorTRANSPARENT);
+            SkCanvas canvas(mask);
+            canvas.translate(-SkIntToScalar(bounds.fLeft), -SkIntToScalar(bounds.fTop));
+            canvas.drawPath(path, paint);
+
+            fFields.emplace_back(
+                    new unsigned char[SkComputeDistanceFieldSize(bounds.width(), bounds.height())]);
+            fRequests.push_back({ fFields.back().get(), (const unsigned char*)mask.getPixels(),
+                                  mask.width(), mask.height(), mask.rowBytes(), false });
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const int count = fRequests.count();
+        if (fBatch) {
+            for (int i = 0; i < loops; i += count) {
+                SkGenerateDistanceFields(fRequests.begin(), SkTMin(count, loops - i));
+            }
+        } else {
+            for (int i = 0; i < loops; i++) {
+                const SkDistanceFieldRequest& request = fRequests[i % count];
+                SkGenerateDistanceFieldFromA8Image(request.fDistanceField, request.fImage,
+                                                   request.fWidth, request.fHeight,
+                                                   request.fRowBytes);
+            }
+        }
+    }
+
+private:
+    const bool fBatch;
+    SkTArray<SkBitmap> fMasks;
+    SkTArray<std::unique_ptr<unsigned char[]>> fFields;
+    SkTArray<SkDistanceFieldRequest> fRequests;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new DistanceFieldBench(false);)
+DEF_BENCH(return new DistanceFieldBench(true);)
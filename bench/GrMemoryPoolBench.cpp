@@ -13,6 +13,7 @@
 #include "Benchmark.h"
 #include "GrMemoryPool.h"
 #include "SkRandom.h"
+#include "SkString.h"
 #include "SkTDArray.h"
 #include "SkTemplates.h"
 
@@ -171,10 +172,110 @@ private:
     typedef Benchmark INHERITED;
 };
 
+/**
+ * This benchmark records a flush's worth of objects with sizes typical of ops, deleting some of
+ * them soon after creation (as when ops are combined), and then deletes the rest together (as at
+ * the end of a flush). Each loop is kOpsPerFlush allocations.
+ */
+class GrMemoryPoolBenchOpMix : public Benchmark {
+public:
+    enum class Pool {
+        kIndividual,  // GrMemoryPool, released without sizes
+        kSized,       // GrMemoryPool, released with sizes
+        kBulk,        // GrMemoryPool in ReleaseMode::kBulk, released with sizes
+        kThread,      // GrThreadMemoryPools
+    };
+
+    GrMemoryPoolBenchOpMix(Pool pool) : fPoolType(pool) {
+        static const char* kNames[] = { "individual", "sized", "bulk", "thread" };
+        fName.printf("grmemorypool_opmix_%s", kNames[(int)pool]);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDelayedSetup() override {
+        // Sizes of common ops, roughly weighted by how often they are recorded.
+        static const size_t kOpSizes[] = { 96, 96, 128, 128, 128, 160, 200, 240, 320, 480 };
+        SkRandom r;
+        for (int i = 0; i < kOpsPerFlush; ++i) {
+            fSizes[i] = kOpSizes[r.nextULessThan(SK_ARRAY_COUNT(kOpSizes))];
+            // About a fifth of the ops get combined into an earlier op.
+            fCombineWith[i] = (i > 0 && r.nextULessThan(5) == 0) ? r.nextULessThan(i) : -1;
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        const GrMemoryPool::ReleaseMode releaseMode = Pool::kBulk == fPoolType
+                                                              ? GrMemoryPool::ReleaseMode::kBulk
+                                                              : GrMemoryPool::ReleaseMode::kIndividual;
+        GrMemoryPool pool(16384, 16384, releaseMode);
+        GrThreadMemoryPools threadPools(16384, 16384);
+
+        void* ops[kOpsPerFlush];
+        for (int loop = 0; loop < loops; ++loop) {
+            for (int i = 0; i < kOpsPerFlush; ++i) {
+                ops[i] = this->allocate(&pool, &threadPools, fSizes[i]);
+                int combined = fCombineWith[i];
+                if (combined >= 0 && ops[combined]) {
+                    this->release(&pool, &threadPools, ops[i], fSizes[i]);
+                    ops[i] = nullptr;
+                }
+            }
+            for (int i = 0; i < kOpsPerFlush; ++i) {
+                if (ops[i]) {
+                    this->release(&pool, &threadPools, ops[i], fSizes[i]);
+                }
+            }
+        }
+    }
+
+private:
+    enum {
+        kOpsPerFlush = 1000,
+    };
+
+    void* allocate(GrMemoryPool* pool, GrThreadMemoryPools* threadPools, size_t size) {
+        return Pool::kThread == fPoolType ? threadPools->allocate(size) : pool->allocate(size);
+    }
+
+    void release(GrMemoryPool* pool, GrThreadMemoryPools* threadPools, void* p, size_t size) {
+        switch (fPoolType) {
+            case Pool::kIndividual:
+                pool->release(p);
+                break;
+            case Pool::kSized:
+            case Pool::kBulk:
+                pool->release(p, size);
+                break;
+            case Pool::kThread:
+                threadPools->release(p, size);
+                break;
+        }
+    }
+
+    Pool     fPoolType;
+    SkString fName;
+    size_t   fSizes[kOpsPerFlush];
+    int      fCombineWith[kOpsPerFlush];
+
+    typedef Benchmark INHERITED;
+};
+
 ///////////////////////////////////////////////////////////////////////////////
 
 DEF_BENCH( return new GrMemoryPoolBenchStack(); )
 DEF_BENCH( return new GrMemoryPoolBenchRandom(); )
 DEF_BENCH( return new GrMemoryPoolBenchQueue(); )
+DEF_BENCH( return new GrMemoryPoolBenchOpMix(GrMemoryPoolBenchOpMix::Pool::kIndividual); )
+DEF_BENCH( return new GrMemoryPoolBenchOpMix(GrMemoryPoolBenchOpMix::Pool::kSized); )
+DEF_BENCH( return new GrMemoryPoolBenchOpMix(GrMemoryPoolBenchOpMix::Pool::kBulk); )
+DEF_BENCH( return new GrMemoryPoolBenchOpMix(GrMemoryPoolBenchOpMix::Pool::kThread); )
 
 #endif
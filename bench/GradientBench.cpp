@@ -390,3 +390,59 @@ private:
 
 DEF_BENCH( return new Gradient2Bench(false); )
 DEF_BENCH( return new Gradient2Bench(true); )
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Creates a shader and draws a small rect with it, over and over: the cost of each of many
+// identical gradients on a page, where the first draw has to build the color ramp (or intervals).
+class GradientCreateDrawBench : public Benchmark {
+public:
+    GradientCreateDrawBench(GradType gradType, const GradData& data, bool force4f = false)
+        : fGradType(gradType)
+        , fData(data)
+        , fForce4f(force4f) {
+        fName.printf("gradient_create_draw_%s%s", gGrads[gradType].fName, data.fName);
+        if (force4f) {
+            fName.append("_4f");
+        }
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        this->setupPaint(&paint);
+
+        const SkRect r = SkRect::MakeWH(kSize, kSize);
+        const SkPoint pts[2] = {
+            { 0, 0 },
+            { SkIntToScalar(kSize), SkIntToScalar(kSize) }
+        };
+
+        for (int i = 0; i < loops; i++) {
+            paint.setShader(gGrads[fGradType].fMaker(pts, fData, SkShader::kClamp_TileMode, 1.0f,
+                                                     fForce4f));
+            canvas->drawRect(r, paint);
+        }
+    }
+
+private:
+    static const int kSize = 32;
+
+    SkString       fName;
+    const GradType fGradType;
+    const GradData fData;
+    const bool     fForce4f;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new GradientCreateDrawBench(kLinear_GradType, gGradData[0]); )
+DEF_BENCH( return new GradientCreateDrawBench(kLinear_GradType, gGradData[1]); )
+DEF_BENCH( return new GradientCreateDrawBench(kLinear_GradType, gGradData[0], true); )
+DEF_BENCH( return new GradientCreateDrawBench(kLinear_GradType, gGradData[1], true); )
+DEF_BENCH( return new GradientCreateDrawBench(kRadial_GradType, gGradData[0]); )
+DEF_BENCH( return new GradientCreateDrawBench(kRadial_GradType, gGradData[1]); )
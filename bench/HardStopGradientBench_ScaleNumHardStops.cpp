@@ -14,16 +14,35 @@
 #include "SkColor.h"
 #include "SkPaint.h"
 
+enum class GradientGeometry {
+    kLinear,
+    kRadial,
+    kSweep,
+    kConical,
+};
+
+static const char* geometry_name(GradientGeometry geometry) {
+    switch (geometry) {
+        case GradientGeometry::kLinear:  return "";
+        case GradientGeometry::kRadial:  return "radial_";
+        case GradientGeometry::kSweep:   return "sweep_";
+        case GradientGeometry::kConical: return "conical_";
+    }
+    return "error";
+}
+
 class HardStopGradientBench_ScaleNumHardStops : public Benchmark {
 public:
-    HardStopGradientBench_ScaleNumHardStops(int colorCount, int hardStopCount) {
+    HardStopGradientBench_ScaleNumHardStops(int colorCount, int hardStopCount,
+                                            GradientGeometry geometry = GradientGeometry::kLinear) {
         SkASSERT(hardStopCount <= colorCount/2);
 
-        fName.printf("hardstop_scale_num_hard_stops_%03d_colors_%03d_hard_stops", 
-                     colorCount, hardStopCount);
+        fName.printf("hardstop_scale_num_hard_stops_%s%03d_colors_%03d_hard_stops",
+                     geometry_name(geometry), colorCount, hardStopCount);
 
         fColorCount    = colorCount;
         fHardStopCount = hardStopCount;
+        fGeometry      = geometry;
     }
 
     const char* onGetName() override {
@@ -68,17 +87,35 @@ public:
             positions[i] = i / (fColorCount - 1.0f);
         }
 
-        fPaint.setShader(SkGradientShader::MakeLinear(points,
-                                                      colors.get(),
-                                                      positions.get(),
-                                                      fColorCount,
-                                                      SkShader::kClamp_TileMode,
-                                                      0,
-                                                      nullptr));
+        const SkPoint center = SkPoint::Make(kSize/2, kSize/2);
+        sk_sp<SkShader> shader;
+        switch (fGeometry) {
+            case GradientGeometry::kLinear:
+                shader = SkGradientShader::MakeLinear(points, colors.get(), positions.get(),
+                                                      fColorCount, SkShader::kClamp_TileMode,
+                                                      0, nullptr);
+                break;
+            case GradientGeometry::kRadial:
+                shader = SkGradientShader::MakeRadial(center, kSize/2, colors.get(),
+                                                      positions.get(), fColorCount,
+                                                      SkShader::kClamp_TileMode, 0, nullptr);
+                break;
+            case GradientGeometry::kSweep:
+                shader = SkGradientShader::MakeSweep(center.fX, center.fY, colors.get(),
+                                                     positions.get(), fColorCount, 0, nullptr);
+                break;
+            case GradientGeometry::kConical:
+                shader = SkGradientShader::MakeTwoPointConical(
+                        SkPoint::Make(kSize/4, kSize/4), kSize/16, center, kSize/2,
+                        colors.get(), positions.get(), fColorCount, SkShader::kClamp_TileMode,
+                        0, nullptr);
+                break;
+        }
+        fPaint.setShader(std::move(shader));
     }
 
     /*
-     * Draw simple linear gradient from left to right
+     * Draw the gradient over the whole canvas
      */
     void onDraw(int loops, SkCanvas* canvas) override {
         for (int i = 0; i < loops; i++) {
@@ -92,6 +129,7 @@ private:
     SkString fName;
     int      fColorCount;
     int      fHardStopCount;
+    GradientGeometry fGeometry;
     SkPaint  fPaint;
 
     typedef Benchmark INHERITED;
@@ -112,3 +150,11 @@ DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(50, 25);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100,  1);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100, 25);)
 DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100, 50);)
+
+// The other gradient types, at the extremes.
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops( 10,  5, GradientGeometry::kRadial);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100, 50, GradientGeometry::kRadial);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops( 10,  5, GradientGeometry::kSweep);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100, 50, GradientGeometry::kSweep);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops( 10,  5, GradientGeometry::kConical);)
+DEF_BENCH(return new HardStopGradientBench_ScaleNumHardStops(100, 50, GradientGeometry::kConical);)
@@ -9,7 +9,9 @@
 
 #include "Resources.h"
 #include "SkAutoPixmapStorage.h"
+#include "SkCommonFlags.h"
 #include "SkData.h"
+#include "SkDocument.h"
 #include "SkGradientShader.h"
 #include "SkImage.h"
 #include "SkPixmap.h"
@@ -45,6 +47,7 @@ DEF_BENCH(return new WStreamWriteTextBenchmark;)
 
 #ifdef SK_SUPPORT_PDF
 
+#include "SkDeflate.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFDocument.h"
 #include "SkPDFShader.h"
@@ -250,6 +253,102 @@ struct WritePDFTextBenchmark : public Benchmark {
     }
 };
 
+/** Deflates 1MB of either text (PDF commands) or noise (which SkDeflateWStream stores rather
+    than compresses). With --verbose, prints the input size so that throughput can be derived. */
+class PDFDeflateBench : public Benchmark {
+public:
+    PDFDeflateBench(bool noise) : fNoise(noise) {}
+
+protected:
+    const char* onGetName() override {
+        return fNoise ? "PDFDeflate_noise" : "PDFDeflate_text";
+    }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        const size_t kSize = 1 << 20;
+        SkDynamicMemoryWStream input;
+        if (fNoise) {
+            SkRandom random;
+            while (input.bytesWritten() < kSize) {
+                input.write32(random.nextU());
+            }
+        } else {
+            sk_sp<SkData> commands = GetResourceAsData("pdf_command_stream.txt");
+            while (commands && input.bytesWritten() < kSize) {
+                input.write(commands->data(), commands->size());
+            }
+        }
+        fData = input.detachAsData();
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            NullWStream nullStream;
+            SkDeflateWStream deflateWStream(&nullStream);
+            deflateWStream.write(fData->data(), fData->size());
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (FLAGS_verbose) {
+            SkDebugf("%s: %zu bytes per loop\n", this->getName(), fData->size());
+        }
+    }
+
+private:
+    bool fNoise;
+    sk_sp<SkData> fData;
+};
+
+/** Serializes a whole document: vector content, text, and an image on each of 10 pages.
+    With --verbose, prints the size of the output so that throughput can be derived. */
+class PDFSerializeBench : public Benchmark {
+protected:
+    const char* onGetName() override { return "PDFSerialize"; }
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+    void onDelayedSetup() override {
+        fImage = GetResourceAsImage("mandrill_256.png");
+    }
+    void onDraw(int loops, SkCanvas*) override {
+        while (loops-- > 0) {
+            NullWStream nullStream;
+            sk_sp<SkDocument> doc = SkDocument::MakePDF(&nullStream);
+            SkRandom random;
+            SkPaint paint;
+            for (int page = 0; page < 10; ++page) {
+                SkCanvas* canvas = doc->beginPage(612, 792);
+                for (int i = 0; i < 200; ++i) {
+                    paint.setColor(random.nextU() | 0xFF000000);
+                    canvas->drawRect(SkRect::MakeXYWH(random.nextRangeF(0, 600),
+                                                      random.nextRangeF(0, 780), 10, 10), paint);
+                }
+                paint.setColor(SK_ColorBLACK);
+                for (int y = 0; y < 40; ++y) {
+                    static const char kText[] = "The quick brown fox jumps over the lazy dog.";
+                    canvas->drawText(kText, strlen(kText), 20, 20.0f + 18 * y, paint);
+                }
+                if (fImage) {
+                    canvas->drawImage(fImage.get(), 300, 500);
+                }
+                doc->endPage();
+            }
+            doc->close();
+            fBytes = nullStream.bytesWritten();
+        }
+    }
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (FLAGS_verbose) {
+            SkDebugf("%s: %zu bytes per loop\n", this->getName(), fBytes);
+        }
+    }
+
+private:
+    sk_sp<SkImage> fImage;
+    size_t fBytes = 0;
+};
+
 }  // namespace
 DEF_BENCH(return new PDFImageBench;)
 DEF_BENCH(return new PDFJpegImageBench;)
@@ -258,6 +357,9 @@ DEF_BENCH(return new PDFScalarBench;)
 DEF_BENCH(return new PDFColorComponentBench;)
 DEF_BENCH(return new PDFShaderBench;)
 DEF_BENCH(return new WritePDFTextBenchmark;)
+DEF_BENCH(return new PDFDeflateBench(false);)
+DEF_BENCH(return new PDFDeflateBench(true);)
+DEF_BENCH(return new PDFSerializeBench;)
 
 #endif
 
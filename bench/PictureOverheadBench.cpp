@@ -10,6 +10,7 @@
 
 #include "Benchmark.h"
 #include "SkCanvas.h"
+#include "SkDeferredCanvas.h"
 #include "SkLiteDL.h"
 #include "SkLiteRecorder.h"
 #include "SkPictureRecorder.h"
@@ -60,3 +61,46 @@ DEF_BENCH(return (new PictureOverheadBench<0,  true>);)
 DEF_BENCH(return (new PictureOverheadBench<1,  true>);)
 DEF_BENCH(return (new PictureOverheadBench<2,  true>);)
 DEF_BENCH(return (new PictureOverheadBench<10, true>);)
+
+// The per-draw overhead of SkDeferredCanvas, forwarding interleaved draws with two paints to a
+// raster canvas. kLazy batches them by paint and merges the rects into regions.
+template <int kDraws, SkDeferredCanvas::EvalType kEvalType>
+struct DeferredOverheadBench : public Benchmark {
+    DeferredOverheadBench() {
+        fName.appendf("deferred_overhead_%d%s", kDraws,
+                      kEvalType == SkDeferredCanvas::kLazy ? "_lazy" : "_eager");
+    }
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fBitmap.allocN32Pixels(1000, 1000);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        SkCanvas target(fBitmap);
+        SkDeferredCanvas deferred(nullptr, kEvalType);
+        SkPaint paints[2];
+        paints[0].setColor(SK_ColorRED);
+        paints[1].setColor(SK_ColorBLUE);
+
+        for (int i = 0; i < loops; i++) {
+            deferred.reset(&target);
+            for (int j = 0; j < kDraws; j++) {
+                SkScalar x = SkIntToScalar((j % 32) * 30),
+                         y = SkIntToScalar((j / 32 % 32) * 30);
+                deferred.drawRect(SkRect::MakeXYWH(x, y, 10, 10), paints[0]);
+                deferred.drawRect(SkRect::MakeXYWH(x + 12, y, 10, 10), paints[1]);
+            }
+            deferred.flush();
+        }
+    }
+
+    SkString fName;
+    SkBitmap fBitmap;
+};
+
+DEF_BENCH(return (new DeferredOverheadBench<10,  SkDeferredCanvas::kEager>);)
+DEF_BENCH(return (new DeferredOverheadBench<100, SkDeferredCanvas::kEager>);)
+DEF_BENCH(return (new DeferredOverheadBench<10,  SkDeferredCanvas::kLazy>);)
+DEF_BENCH(return (new DeferredOverheadBench<100, SkDeferredCanvas::kLazy>);)
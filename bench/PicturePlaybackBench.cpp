@@ -143,12 +143,13 @@ DEF_BENCH( return new PosTextPlaybackBench(false); )
 
 // Chrome draws into small tiles with impl-side painting.
 // This benchmark measures the relative performance of our bounding-box hierarchies,
-// both when querying tiles perfectly and when not.
+// both when querying tiles perfectly and when not, and of compact pictures against big ones.
 enum BBH  { kNone, kRTree };
 enum Mode { kTiled, kRandom };
 class TiledPlaybackBench : public Benchmark {
 public:
-    TiledPlaybackBench(BBH bbh, Mode mode) : fBBH(bbh), fMode(mode), fName("tiled_playback") {
+    TiledPlaybackBench(BBH bbh, Mode mode, bool compact = false)
+        : fBBH(bbh), fMode(mode), fCompact(compact), fName("tiled_playback") {
         switch (fBBH) {
             case kNone:     fName.append("_none"    ); break;
             case kRTree:    fName.append("_rtree"   ); break;
@@ -157,6 +158,9 @@ public:
             case kTiled:  fName.append("_tiled" ); break;
             case kRandom: fName.append("_random"); break;
         }
+        if (fCompact) {
+            fName.append("_compact");
+        }
     }
 
     const char* onGetName() override { return fName.c_str(); }
@@ -170,7 +174,9 @@ public:
         }
 
         SkPictureRecorder recorder;
-        SkCanvas* canvas = recorder.beginRecording(1024, 1024, factory.get());
+        SkCanvas* canvas = recorder.beginRecording(1024, 1024, factory.get(),
+                                                   fCompact ? SkPictureRecorder::kCompact_RecordFlag
+                                                            : 0);
             SkRandom rand;
             for (int i = 0; i < 10000; i++) {
                 SkScalar x = rand.nextRangeScalar(0, 1024),
@@ -209,6 +215,7 @@ public:
 private:
     BBH                 fBBH;
     Mode                fMode;
+    bool                fCompact;
     SkString            fName;
     sk_sp<SkPicture>    fPic;
 };
@@ -217,3 +224,7 @@ DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled ); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom); )
 DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled ); )
+DEF_BENCH( return new TiledPlaybackBench(kNone,     kRandom, true); )
+DEF_BENCH( return new TiledPlaybackBench(kNone,     kTiled,  true); )
+DEF_BENCH( return new TiledPlaybackBench(kRTree,    kRandom, true); )
+DEF_BENCH( return new TiledPlaybackBench(kRTree,    kTiled,  true); )
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+// Measures the throughput of SkPipe over a shared-memory ring: this thread records frames of
+// draws into the ring while a second thread replays them into a null canvas.
+
+#include "Benchmark.h"
+#include "SkCanvas.h"
+#include "SkNullCanvas.h"
+#include "SkPicture.h"
+#include "SkPipe.h"
+#include "SkPipeRingBuffer.h"
+#include "SkThreadUtils.h"
+
+class PipeRingBench : public Benchmark {
+public:
+    PipeRingBench(int drawsPerFrame) : fDrawsPerFrame(drawsPerFrame) {
+        fName.printf("pipe_ring_%d", drawsPerFrame);
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return backend == kNonRendering_Backend; }
+
+    void onDelayedSetup() override {
+        fStorageSize = SkPipeRingBuffer::StorageSize(1 << 20);
+        fShared = SkPipeSharedMemory::Make(fStorageSize);
+        fMemory = fShared ? fShared->memory() : fFallback.reset(fStorageSize / 4);
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        struct Replay {
+            SkPipeRingBuffer* fRing;
+
+            static void Loop(void* ctx) {
+                Replay* replay = static_cast<Replay*>(ctx);
+                SkPipeDeserializer deserializer;
+                SkPipeRingReader reader(replay->fRing);
+                std::unique_ptr<SkCanvas> canvas = SkMakeNullCanvas();
+                while (reader.playbackNext(&deserializer, canvas.get())) {}
+            }
+        } replay = { SkPipeRingBuffer::Create(fMemory, fStorageSize) };
+
+        SkThread thread(&Replay::Loop, &replay);
+        thread.start();
+
+        SkPipeSerializer serializer;
+        SkPipeRingWriter writer(replay.fRing);
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        for (int i = 0; i < loops; ++i) {
+            SkCanvas* canvas = serializer.beginWrite(SkRect::MakeWH(1000, 1000), &writer);
+            for (int j = 0; j < fDrawsPerFrame; ++j) {
+                paint.setColor(0xFF000000 | (j * 0x10101));
+                canvas->save();
+                canvas->translate(SkIntToScalar(j % 100), SkIntToScalar(j / 100));
+                canvas->drawRect(SkRect::MakeXYWH(0, 0, 50, 50), paint);
+                canvas->restore();
+            }
+            serializer.endWrite();
+            writer.commit();
+        }
+
+        replay.fRing->close();
+        thread.join();
+    }
+
+private:
+    SkString                            fName;
+    int                                 fDrawsPerFrame;
+    std::unique_ptr<SkPipeSharedMemory> fShared;
+    SkAutoTMalloc<uint32_t>             fFallback;
+    void*                               fMemory = nullptr;
+    size_t                              fStorageSize = 0;
+};
+
+DEF_BENCH(return new PipeRingBench(10);)
+DEF_BENCH(return new PipeRingBench(1000);)
@@ -86,3 +86,44 @@ void PipingBench::onDraw(int loops, SkCanvas*) {
         stream.reset();
     }
 }
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#include "SkDeferredCanvas.h"
+#include "SkNoDrawCanvas.h"
+
+DeferredBench::DeferredBench(const char* name, const SkPicture* pic) : INHERITED(name, pic) {
+    fName.prepend("deferred_");
+}
+
+void DeferredBench::onDraw(int loops, SkCanvas*) {
+    SkIRect bounds = fSrc->cullRect().roundOut();
+    SkNoDrawCanvas target(bounds.right(), bounds.bottom());
+    SkDeferredCanvas deferred(nullptr, SkDeferredCanvas::kLazy);
+
+    while (loops --> 0) {
+        deferred.reset(&target);
+        fSrc->playback(&deferred);
+        deferred.flush();
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+SerializingBench::SerializingBench(const char* name, const SkPicture* pic, bool read)
+    : INHERITED(name, pic)
+    , fData(fSrc->serialize())
+    , fRead(read)
+{
+    fName.prepend(read ? "deserialize_" : "serialize_");
+}
+
+void SerializingBench::onDraw(int loops, SkCanvas*) {
+    while (loops --> 0) {
+        if (fRead) {
+            (void)SkPicture::MakeFromData(fData.get());
+        } else {
+            (void)fSrc->serialize();
+        }
+    }
+}
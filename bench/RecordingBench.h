@@ -9,6 +9,7 @@
 #define RecordingBench_DEFINED
 
 #include "Benchmark.h"
+#include "SkData.h"
 #include "SkPicture.h"
 #include "SkLiteDL.h"
 
@@ -53,4 +54,33 @@ private:
     typedef PictureCentricBench INHERITED;
 };
 
+// Plays the picture through a lazy SkDeferredCanvas, to time its reordering and batching.
+class DeferredBench : public PictureCentricBench {
+public:
+    DeferredBench(const char* name, const SkPicture*);
+
+protected:
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    typedef PictureCentricBench INHERITED;
+};
+
+// Serializes the picture; deserializes it when reading, to time SkPicture::MakeFromData().
+class SerializingBench : public PictureCentricBench {
+public:
+    SerializingBench(const char* name, const SkPicture*, bool read);
+
+    size_t bytes() const { return fData->size(); }
+
+protected:
+    void onDraw(int loops, SkCanvas*) override;
+
+private:
+    sk_sp<SkData> fData;
+    bool fRead;
+
+    typedef PictureCentricBench INHERITED;
+};
+
 #endif//RecordingBench_DEFINED
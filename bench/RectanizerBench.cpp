@@ -6,60 +6,82 @@
 */
 
 #include "Benchmark.h"
+#include "SkCommandLineFlags.h"
 #include "SkRandom.h"
 #include "SkSize.h"
 #include "SkTDArray.h"
 
 #if SK_SUPPORT_GPU
 
+#include "GrRectanizer_maxrects.h"
 #include "GrRectanizer_pow2.h"
 #include "GrRectanizer_skyline.h"
 
+DEFINE_bool(rectanizerOccupancy, false,
+            "Print how full the atlas was, on average, each time a rectanizer bench filled it.");
+
 /**
  * This bench exercises Ganesh' GrRectanizer classes. It exercises the following
  * rectanizers:
  *      Pow2 Rectanizer
  *      Skyline Rectanizer
+ *      MaxRects Rectanizer
  * in the following cases:
  *      random rects (e.g., pull-save-layers forward use case)
  *      random power of two rects
  *      small constant sized power of 2 rects (e.g., glyph cache use case)
+ *      small random rects (e.g., glyphs of mixed sizes)
+ * one rect at a time, or in batches (addRects). The time is per rect added; with
+ * --rectanizerOccupancy each bench also prints how well it packed.
  */
 class RectanizerBench : public Benchmark {
 public:
     static const int kWidth = 1024;
     static const int kHeight = 1024;
 
+    static const int kBatchSize = 64;
+
     enum RectanizerType {
         kPow2_RectanizerType,
         kSkyline_RectanizerType,
+        kMaxRects_RectanizerType,
     };
 
     enum RectType {
         kRand_RectType,
         kRandPow2_RectType,
-        kSmallPow2_RectType
+        kSmallPow2_RectType,
+        kSmallRand_RectType
     };
 
-    RectanizerBench(RectanizerType rectanizerType, RectType rectType)
+    RectanizerBench(RectanizerType rectanizerType, RectType rectType, bool batch = false)
         : fName("rectanizer_")
         , fRectanizerType(rectanizerType)
-        , fRectType(rectType) {
+        , fRectType(rectType)
+        , fBatch(batch) {
 
         if (kPow2_RectanizerType == fRectanizerType) {
             fName.append("pow2_");
-        } else {
-            SkASSERT(kSkyline_RectanizerType == fRectanizerType);
+        } else if (kSkyline_RectanizerType == fRectanizerType) {
             fName.append("skyline_");
+        } else {
+            SkASSERT(kMaxRects_RectanizerType == fRectanizerType);
+            fName.append("maxrects_");
         }
 
         if (kRand_RectType == fRectType) {
             fName.append("rand");
         } else if (kRandPow2_RectType == fRectType) {
             fName.append("rand2");
-        } else {
-            SkASSERT(kSmallPow2_RectType == fRectType);
+        } else if (kSmallPow2_RectType == fRectType) {
             fName.append("sm2");
+        } else {
+            SkASSERT(kSmallRand_RectType == fRectType);
+            fName.append("smrand");
+        }
+
+        if (fBatch) {
+            fName.append("_batch");
         }
     }
 
@@ -77,45 +99,89 @@ protected:
 
         if (kPow2_RectanizerType == fRectanizerType) {
             fRectanizer.reset(new GrRectanizerPow2(kWidth, kHeight));
-        } else {
-            SkASSERT(kSkyline_RectanizerType == fRectanizerType);
+        } else if (kSkyline_RectanizerType == fRectanizerType) {
             fRectanizer.reset(new GrRectanizerSkyline(kWidth, kHeight));
+        } else {
+            SkASSERT(kMaxRects_RectanizerType == fRectanizerType);
+            fRectanizer.reset(new GrRectanizerMaxRects(kWidth, kHeight));
         }
     }
 
     void onDraw(int loops, SkCanvas* canvas) override {
         SkRandom rand;
-        SkIPoint16 loc;
-        SkISize size;
-
-        for (int i = 0; i < loops; ++i) {
-            if (kRand_RectType == fRectType) {
-                size = SkISize::Make(rand.nextRangeU(1, kWidth / 2),
-                                     rand.nextRangeU(1, kHeight / 2));
-            } else if (kRandPow2_RectType == fRectType) {
-                size = SkISize::Make(GrNextPow2(rand.nextRangeU(1, kWidth / 2)),
-                                     GrNextPow2(rand.nextRangeU(1, kHeight / 2)));
-            } else {
-                SkASSERT(kSmallPow2_RectType == fRectType);
-                size = SkISize::Make(128, 128);
+        SkISize sizes[kBatchSize];
+        SkIPoint16 locs[kBatchSize];
+
+        for (int i = 0; i < loops; i += kBatchSize) {
+            int count = SkTMin(kBatchSize, loops - i);
+            for (int j = 0; j < count; ++j) {
+                sizes[j] = this->nextSize(&rand);
             }
 
-            if (!fRectanizer->addRect(size.fWidth, size.fHeight, &loc)) {
-                // insert failed so clear out the rectanizer and give the
-                // current rect another try
-                fRectanizer->reset();
-                i--;
+            if (fBatch) {
+                while (fRectanizer->addRects(sizes, count, locs) < count) {
+                    // some inserts failed so clear out the rectanizer and give
+                    // those rects another try
+                    this->resetFullRectanizer();
+                    int remaining = 0;
+                    for (int j = 0; j < count; ++j) {
+                        if (locs[j].fX < 0) {
+                            sizes[remaining++] = sizes[j];
+                        }
+                    }
+                    count = remaining;
+                }
+            } else {
+                for (int j = 0; j < count; ++j) {
+                    if (!fRectanizer->addRect(sizes[j].fWidth, sizes[j].fHeight, &locs[j])) {
+                        // insert failed so clear out the rectanizer and give the
+                        // current rect another try
+                        this->resetFullRectanizer();
+                        j--;
+                    }
+                }
             }
         }
 
         fRectanizer->reset();
     }
 
+    void onPerCanvasPostDraw(SkCanvas*) override {
+        if (FLAGS_rectanizerOccupancy && fFills > 0) {
+            SkDebugf("%s: %.1f%% full on average over %d fills\n",
+                     fName.c_str(), 100 * fOccupancy / fFills, fFills);
+        }
+    }
+
 private:
     SkString                    fName;
     RectanizerType              fRectanizerType;
     RectType                    fRectType;
+    bool                        fBatch;
     std::unique_ptr<GrRectanizer> fRectanizer;
+    double                      fOccupancy = 0;
+    int                         fFills = 0;
+
+    void resetFullRectanizer() {
+        fOccupancy += fRectanizer->percentFull();
+        fFills++;
+        fRectanizer->reset();
+    }
+
+    SkISize nextSize(SkRandom* rand) const {
+        if (kRand_RectType == fRectType) {
+            return SkISize::Make(rand->nextRangeU(1, kWidth / 2),
+                                 rand->nextRangeU(1, kHeight / 2));
+        } else if (kRandPow2_RectType == fRectType) {
+            return SkISize::Make(GrNextPow2(rand->nextRangeU(1, kWidth / 2)),
+                                 GrNextPow2(rand->nextRangeU(1, kHeight / 2)));
+        } else if (kSmallPow2_RectType == fRectType) {
+            return SkISize::Make(128, 128);
+        } else {
+            SkASSERT(kSmallRand_RectType == fRectType);
+            return SkISize::Make(rand->nextRangeU(4, 64), rand->nextRangeU(4, 64));
+        }
+    }
 
     typedef Benchmark INHERITED;
 };
@@ -134,5 +200,15 @@ DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kRandPow2_RectType);)
 DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
                                      RectanizerBench::kSmallPow2_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
+                                     RectanizerBench::kSmallRand_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kSkyline_RectanizerType,
+                                     RectanizerBench::kSmallRand_RectType, true);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kMaxRects_RectanizerType,
+                                     RectanizerBench::kRand_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kMaxRects_RectanizerType,
+                                     RectanizerBench::kSmallRand_RectType);)
+DEF_BENCH(return new RectanizerBench(RectanizerBench::kMaxRects_RectanizerType,
+                                     RectanizerBench::kSmallRand_RectType, true);)
 
 #endif
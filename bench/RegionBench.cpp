@@ -8,6 +8,7 @@
 #include "SkRandom.h"
 #include "SkRegion.h"
 #include "SkString.h"
+#include "SkTDArray.h"
 
 static bool union_proc(SkRegion& a, SkRegion& b) {
     SkRegion result;
@@ -129,3 +130,72 @@ DEF_BENCH(return new RegionBench(SMALL, containsrect_proc, "containsrect");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrgn_proc, "intersectsrgn");)
 DEF_BENCH(return new RegionBench(SMALL, sectsrect_proc, "intersectsrect");)
 DEF_BENCH(return new RegionBench(SMALL, containsxy_proc, "containsxy");)
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Builds a region from many rects: with one op() per rect, or all at once with setRects() or
+// op(rects[]).
+class RegionRectsBench : public Benchmark {
+public:
+    enum Mode {
+        kOpEach_Mode,       // union, one rect at a time
+        kSetRects_Mode,     // union, all at once
+        kOpRects_Mode,      // intersect a region with the union of all of them
+    };
+
+    RegionRectsBench(int count, Mode mode) : fMode(mode) {
+        static const char* kNames[] = { "opeach", "setrects", "intersectrects" };
+        fName.printf("region_rects_%s_%d", kNames[mode], count);
+
+        SkRandom rand;
+        for (int i = 0; i < count; i++) {
+            int x = rand.nextU() % 1024;
+            int y = rand.nextU() % 768;
+            *fRects.append() = SkIRect::MakeXYWH(x, y, 1 + rand.nextU() % 64,
+                                                 1 + rand.nextU() % 64);
+        }
+        fClip.setRect(SkIRect::MakeLTRB(128, 96, 896, 672));
+        fClip.op(SkIRect::MakeLTRB(384, 288, 640, 480), SkRegion::kDifference_Op);
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        for (int i = 0; i < loops; ++i) {
+            SkRegion rgn;
+            switch (fMode) {
+                case kOpEach_Mode:
+                    for (int j = 0; j < fRects.count(); ++j) {
+                        rgn.op(fRects[j], SkRegion::kUnion_Op);
+                    }
+                    break;
+                case kSetRects_Mode:
+                    rgn.setRects(fRects.begin(), fRects.count());
+                    break;
+                case kOpRects_Mode:
+                    rgn = fClip;
+                    rgn.op(fRects.begin(), fRects.count(), SkRegion::kIntersect_Op);
+                    break;
+            }
+        }
+    }
+
+private:
+    Mode                fMode;
+    SkString            fName;
+    SkTDArray<SkIRect>  fRects;
+    SkRegion            fClip;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH(return new RegionRectsBench(100, RegionRectsBench::kOpEach_Mode);)
+DEF_BENCH(return new RegionRectsBench(100, RegionRectsBench::kSetRects_Mode);)
+DEF_BENCH(return new RegionRectsBench(1000, RegionRectsBench::kOpEach_Mode);)
+DEF_BENCH(return new RegionRectsBench(1000, RegionRectsBench::kSetRects_Mode);)
+DEF_BENCH(return new RegionRectsBench(1000, RegionRectsBench::kOpRects_Mode);)
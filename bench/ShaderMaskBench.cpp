@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "SkCanvas.h"
 #include "SkPaint.h"
+#include "SkPath.h"
 #include "SkRandom.h"
 #include "SkString.h"
 #include "SkTemplates.h"
@@ -35,9 +36,11 @@ class ShaderMaskBench : public Benchmark {
     SkString    fText;
     SkString    fName;
     FontQuality fFQ;
+    bool        fClipped;
 public:
-    ShaderMaskBench(bool isOpaque, FontQuality fq)  {
+    ShaderMaskBench(bool isOpaque, FontQuality fq, bool clipped = false)  {
         fFQ = fq;
+        fClipped = clipped;
         fText.set(STR);
 
         fPaint.setAntiAlias(kBW != fq);
@@ -50,6 +53,9 @@ protected:
         fName.printf("shadermask");
         fName.appendf("_%s", fontQualityName(fPaint));
         fName.appendf("_%02X", fPaint.getAlpha());
+        if (fClipped) {
+            fName.append("_aaclip");
+        }
         return fName.c_str();
     }
 
@@ -67,6 +73,15 @@ protected:
         const SkScalar x0 = SkIntToScalar(-10);
         const SkScalar y0 = SkIntToScalar(-10);
 
+        if (fClipped) {
+            // an anti-aliased clip with many short runs per row
+            SkPath clip;
+            for (int x = 0; x < dim.fX; x += 8) {
+                clip.addRect(SkRect::MakeXYWH(x + 0.5f, 0, 5, SkIntToScalar(dim.fY)));
+            }
+            canvas->clipPath(clip, true);
+        }
+
         paint.setTextSize(SkIntToScalar(12));
         for (int i = 0; i < loops; i++) {
             SkScalar x = x0 + rand.nextUScalar1() * dim.fX;
@@ -94,3 +109,5 @@ DEF_BENCH( return new ShaderMaskBench(true,  kAA); )
 DEF_BENCH( return new ShaderMaskBench(false, kAA); )
 DEF_BENCH( return new ShaderMaskBench(true,  kLCD); )
 DEF_BENCH( return new ShaderMaskBench(false, kLCD); )
+DEF_BENCH( return new ShaderMaskBench(true,  kAA, true); )
+DEF_BENCH( return new ShaderMaskBench(false, kAA, true); )
@@ -0,0 +1,104 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkTypes.h"
+
+// This tests the SkSL compiler
+#if SK_SUPPORT_GPU
+
+#include "Benchmark.h"
+#include "SkSLCompiler.h"
+
+/**
+ * Measures constructing an SkSL::Compiler, which includes setting up the built-in declarations the
+ * first time, and then reusing the shared ones.
+ */
+class SkSLCompilerStartupBench : public Benchmark {
+public:
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return "sksl_compiler_startup";
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        for (int i = 0; i < loops; i++) {
+            SkSL::Compiler compiler;
+        }
+    }
+
+private:
+    typedef Benchmark INHERITED;
+};
+
+/**
+ * Measures converting a small fragment shader and generating GLSL from it, optionally including
+ * the cost of a fresh compiler for each shader.
+ */
+class SkSLCompileBench : public Benchmark {
+public:
+    SkSLCompileBench(bool newCompiler)
+        : fNewCompiler(newCompiler)
+        , fName(newCompiler ? "sksl_compile_new_compiler" : "sksl_compile") {
+        fCaps = SkSL::ShaderCapsFactory::Default();
+        fSettings.fCaps = fCaps.get();
+    }
+
+    bool isSuitableFor(Backend backend) override {
+        return backend == kNonRendering_Backend;
+    }
+
+protected:
+    const char* onGetName() override {
+        return fName.c_str();
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        static const char* kSrc =
+            "uniform vec4 color;"
+            "uniform sampler2D tex;"
+            "in vec2 coords;"
+            "void main() {"
+            "    vec4 texel = texture(tex, coords);"
+            "    float lum = dot(texel.rgb, vec3(0.2126, 0.7152, 0.0722));"
+            "    sk_FragColor = mix(texel, color * lum, clamp(length(coords), 0, 1));"
+            "}";
+        for (int i = 0; i < loops; i++) {
+            std::unique_ptr<SkSL::Compiler> compiler;
+            SkSL::Compiler* c = &fCompiler;
+            if (fNewCompiler) {
+                compiler.reset(new SkSL::Compiler());
+                c = compiler.get();
+            }
+            std::unique_ptr<SkSL::Program> program =
+                    c->convertProgram(SkSL::Program::kFragment_Kind, SkString(kSrc), fSettings);
+            SkString glsl;
+            if (!program || !c->toGLSL(*program, &glsl)) {
+                SkDebugf("%s\n", c->errorText().c_str());
+                SkFAIL("shader compilation failed");
+            }
+        }
+    }
+
+private:
+    bool                        fNewCompiler;
+    SkString                    fName;
+    sk_sp<GrShaderCaps>         fCaps;
+    SkSL::Program::Settings     fSettings;
+    SkSL::Compiler              fCompiler;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new SkSLCompilerStartupBench(); )
+DEF_BENCH( return new SkSLCompileBench(false); )
+DEF_BENCH( return new SkSLCompileBench(true); )
+
+#endif
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "Benchmark.h"
+#include "Resources.h"
+#include "SkCodec.h"
+#include "SkCommonFlags.h"
+#include "SkData.h"
+#include "SkRandom.h"
+#include "SkStreamingCodec.h"
+
+/**
+ *  Feeds an image to a decoder in random-sized chunks, the way bytes arrive from the network,
+ *  and decodes after every chunk.
+ *
+ *  "streaming" uses SkStreamingCodec, which resumes where it left off. "restart" decodes
+ *  everything received so far from scratch each time, as a client without incremental decoding
+ *  would. With --verbose, the number of bytes that were parsed more than once is printed.
+ */
+class StreamingCodecBench : public Benchmark {
+public:
+    StreamingCodecBench(const char* resource, bool streaming)
+        : fResource(resource)
+        , fStreaming(streaming)
+    {
+        fName.printf("Codec_stream_%s_%s", resource, streaming ? "streaming" : "restart");
+    }
+
+protected:
+    const char* onGetName() override { return fName.c_str(); }
+    bool isSuitableFor(Backend backend) override { return kNonRendering_Backend == backend; }
+
+    void onDelayedSetup() override {
+        fData = GetResourceAsData(fResource);
+        std::unique_ptr<SkCodec> codec(fData ? SkCodec::NewFromData(fData) : nullptr);
+        if (codec) {
+            fInfo = SkImageInfo::MakeN32Premul(codec->getInfo().width(),
+                                               codec->getInfo().height());
+            fPixelStorage.reset(fInfo.getSafeSize(fInfo.minRowBytes()));
+        }
+    }
+
+    void onDraw(int loops, SkCanvas*) override {
+        if (!fPixelStorage.get()) {
+            return;
+        }
+        fBytesParsed = fBytesReparsed = 0;
+        for (int i = 0; i < loops; i++) {
+            // The same chunk sizes every loop, so that runs are comparable.
+            SkRandom rand;
+            if (fStreaming) {
+                this->feedStreaming(&rand);
+            } else {
+                this->feedRestarting(&rand);
+            }
+        }
+    }
+
+    void onPostDraw(SkCanvas*) override {
+        if (FLAGS_verbose && fBytesParsed) {
+            SkDebugf("%s: parsed %zu bytes, %zu of them more than once (file is %zu bytes)\n",
+                     fName.c_str(), fBytesParsed, fBytesReparsed, fData->size());
+        }
+    }
+
+private:
+    size_t nextChunk(SkRandom* rand, size_t offset) {
+        return SkTMin<size_t>(rand->nextRangeU(512, 16 * 1024), fData->size() - offset);
+    }
+
+    void feedStreaming(SkRandom* rand) {
+        SkStreamingCodec streaming;
+        streaming.setDestination(fInfo, fPixelStorage.get(), fInfo.minRowBytes());
+        const char* bytes = static_cast<const char*>(fData->data());
+        for (size_t offset = 0; offset < fData->size();) {
+            const size_t chunk = this->nextChunk(rand, offset);
+            streaming.append(bytes + offset, chunk);
+            offset += chunk;
+            if (offset == fData->size()) {
+                streaming.setAllDataReceived();
+            }
+            if (SkCodec::kIncompleteInput != streaming.decode()) {
+                break;
+            }
+        }
+        fBytesParsed += streaming.bytesRead();
+        fBytesReparsed += streaming.bytesReparsed();
+    }
+
+    void feedRestarting(SkRandom* rand) {
+        size_t parsed = 0;
+        for (size_t offset = 0; offset < fData->size();) {
+            offset += this->nextChunk(rand, offset);
+            std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(SkData::MakeSubset(fData.get(),
+                                                                                  0, offset)));
+            if (codec) {
+                codec->getPixels(fInfo, fPixelStorage.get(), fInfo.minRowBytes());
+            }
+            parsed += offset;
+        }
+        fBytesParsed += parsed;
+        fBytesReparsed += parsed - fData->size();
+    }
+
+    SkString        fName;
+    const char*     fResource;
+    const bool      fStreaming;
+    sk_sp<SkData>   fData;
+    SkImageInfo     fInfo;
+    SkAutoMalloc    fPixelStorage;
+    size_t          fBytesParsed = 0;
+    size_t          fBytesReparsed = 0;
+};
+
+DEF_BENCH(return new StreamingCodecBench("yellow_rose.png", true);)
+DEF_BENCH(return new StreamingCodecBench("yellow_rose.png", false);)
+DEF_BENCH(return new StreamingCodecBench("plane_interlaced.png", true);)
+DEF_BENCH(return new StreamingCodecBench("plane_interlaced.png", false);)
+DEF_BENCH(return new StreamingCodecBench("color_wheel.gif", true);)
+DEF_BENCH(return new StreamingCodecBench("color_wheel.gif", false);)
+DEF_BENCH(return new StreamingCodecBench("mandrill_512_q075.jpg", true);)
+DEF_BENCH(return new StreamingCodecBench("mandrill_512_q075.jpg", false);)
@@ -11,12 +11,16 @@
 #include "SkRandom.h"
 #include "SkString.h"
 
+// Strokes the same path over and over. build_stroke_ marks it volatile, so that every loop runs
+// the stroker; repeat_stroke_ leaves it to SkStrokeCache, like a chart redrawn every frame.
 class StrokeBench : public Benchmark {
 public:
-    StrokeBench(const SkPath& path, const SkPaint& paint, const char pathType[], SkScalar res)
+    StrokeBench(const SkPath& path, const SkPaint& paint, const char pathType[], SkScalar res,
+                bool repeat = false)
         : fPath(path), fPaint(paint), fRes(res)
     {
-        fName.printf("build_stroke_%s_%g_%d_%d",
+        fPath.setIsVolatile(!repeat);
+        fName.printf("%s_stroke_%s_%g_%d_%d", repeat ? "repeat" : "build",
                      pathType, paint.getStrokeWidth(), paint.getStrokeJoin(), paint.getStrokeCap());
     }
 
@@ -117,3 +121,6 @@ DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_.25", .
 DEF_BENCH(return new StrokeBench(quad_path_maker(), paint_maker(), "quad_.25", .25f);)
 DEF_BENCH(return new StrokeBench(conic_path_maker(), paint_maker(), "conic_.25", .25f);)
 DEF_BENCH(return new StrokeBench(cubic_path_maker(), paint_maker(), "cubic_.25", .25f);)
+
+DEF_BENCH(return new StrokeBench(line_path_maker(), paint_maker(), "line_1", 1, true);)
+DEF_BENCH(return new StrokeBench(cubic_path_maker(), paint_maker(), "cubic_1", 1, true);)
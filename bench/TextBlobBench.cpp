@@ -8,6 +8,7 @@
 #include "Benchmark.h"
 #include "Resources.h"
 #include "SkCanvas.h"
+#include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkRandom.h"
 #include "SkStream.h"
@@ -70,3 +71,59 @@ private:
 };
 
 DEF_BENCH( return new TextBlobBench(); )
+
+/*
+ * Draws a page of distinct glyphs with an empty glyph cache, like the first draw of a page of CJK
+ * text: nearly all of the time goes to generating glyph images.
+ */
+class ColdTextBlobBench : public Benchmark {
+public:
+    ColdTextBlobBench() {}
+
+protected:
+    void onDelayedSetup() override {
+        sk_sp<SkTypeface> typeface = SkTypeface::MakeDefault();
+        const int glyphCount = kColumns * kRows;
+        // Skip glyph 0, which is usually .notdef.
+        const int distinctGlyphs = SkTMax(typeface->countGlyphs() - 1, 1);
+
+        SkPaint paint;
+        paint.setTypeface(typeface);
+        paint.setTextSize(kGlyphSize);
+        paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+        SkTextBlobBuilder builder;
+        const SkTextBlobBuilder::RunBuffer& run = builder.allocRunPos(paint, glyphCount);
+        for (int i = 0; i < glyphCount; i++) {
+            run.glyphs[i] = SkToU16(1 + i % distinctGlyphs);
+            run.pos[2 * i + 0] = (i % kColumns) * kGlyphSize;
+            run.pos[2 * i + 1] = (i / kColumns + 1) * kGlyphSize;
+        }
+        fBlob = builder.make();
+    }
+
+    const char* onGetName() override {
+        return "TextBlobBench_cold";
+    }
+
+    void onDraw(int loops, SkCanvas* canvas) override {
+        SkPaint paint;
+        paint.setAntiAlias(true);
+
+        for (int i = 0; i < loops; i++) {
+            SkGraphics::PurgeFontCache();
+            canvas->drawTextBlob(fBlob, 0, 0, paint);
+        }
+    }
+
+private:
+    static constexpr int kColumns = 32;
+    static constexpr int kRows = 24;
+    static constexpr SkScalar kGlyphSize = 20;
+
+    sk_sp<SkTextBlob> fBlob;
+
+    typedef Benchmark INHERITED;
+};
+
+DEF_BENCH( return new ColdTextBlobBench(); )
@@ -582,6 +582,8 @@ public:
                       , fGMs(skiagm::GMRegistry::Head())
                       , fCurrentRecording(0)
                       , fCurrentPiping(0)
+                      , fCurrentDeferring(0)
+                      , fCurrentSerializing(0)
                       , fCurrentScale(0)
                       , fCurrentSKP(0)
                       , fCurrentSVG(0)
@@ -741,6 +743,39 @@ public:
             return new PipingBench(name.c_str(), pic.get());
         }
 
+        // Add all .skps as DeferredBenches.
+        while (fCurrentDeferring < fSKPs.count()) {
+            const SkString& path = fSKPs[fCurrentDeferring++];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            fSourceType = "skp";
+            fBenchType  = "deferring";
+            fSKPBytes = static_cast<double>(SkPictureUtils::ApproximateBytesUsed(pic.get()));
+            fSKPOps   = pic->approximateOpCount();
+            return new DeferredBench(name.c_str(), pic.get());
+        }
+
+        // Add all .skps as SerializingBenches, writing then reading. Their bytes metric is the
+        // serialized size, so bytes over time gives the throughput.
+        while (fCurrentSerializing < 2 * fSKPs.count()) {
+            bool read = fCurrentSerializing >= fSKPs.count();
+            const SkString& path = fSKPs[fCurrentSerializing++ % fSKPs.count()];
+            sk_sp<SkPicture> pic = ReadPicture(path.c_str());
+            if (!pic) {
+                continue;
+            }
+            SkString name = SkOSPath::Basename(path.c_str());
+            auto bench = new SerializingBench(name.c_str(), pic.get(), read);
+            fSourceType = "skp";
+            fBenchType  = read ? "deserializing" : "serializing";
+            fSKPBytes = static_cast<double>(bench->bytes());
+            fSKPOps   = pic->approximateOpCount();
+            return bench;
+        }
+
         // Then once each for each scale as SKPBenches (playback).
         while (fCurrentScale < fScales.count()) {
             while (fCurrentSKP < fSKPs.count()) {
@@ -1034,7 +1069,9 @@ public:
                 log->configOption("multi_picture_draw", fUseMPDs[fCurrentUseMPD-1] ? "true" : "false");
             }
         }
-        if (0 == strcmp(fBenchType, "recording")) {
+        if (0 == strcmp(fBenchType, "recording") ||
+            0 == strcmp(fBenchType, "serializing") ||
+            0 == strcmp(fBenchType, "deserializing")) {
             log->metric("bytes", fSKPBytes);
             log->metric("ops",   fSKPOps);
         }
@@ -1072,6 +1109,8 @@ private:
     const char* fBenchType;   // How we bench it: micro, recording, playback, ...
     int fCurrentRecording;
     int fCurrentPiping;
+    int fCurrentDeferring;
+    int fCurrentSerializing;
     int fCurrentScale;
     int fCurrentSKP;
     int fCurrentSVG;
@@ -1196,6 +1235,7 @@ int nanobench_main() {
     }
 
     gSkUseAnalyticAA = FLAGS_analyticAA;
+    gSkAntiFillPathBands = FLAGS_aaBands;
 
     int runs = 0;
     BenchmarkStream benchStream;
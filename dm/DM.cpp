@@ -1288,6 +1288,7 @@ int dm_main() {
     setup_crash_handler();
 
     gSkUseAnalyticAA = FLAGS_analyticAA;
+    gSkAntiFillPathBands = FLAGS_aaBands;
 
     if (FLAGS_verbose) {
         gVLog = stderr;
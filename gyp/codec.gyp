@@ -31,6 +31,7 @@
       ],
       'sources': [
         '../src/codec/SkAndroidCodec.cpp',
+        '../src/codec/SkAnimationDecoder.cpp',
         '../src/codec/SkBmpCodec.cpp',
         '../src/codec/SkBmpMaskCodec.cpp',
         '../src/codec/SkBmpRLECodec.cpp',
@@ -47,6 +48,7 @@
         '../src/codec/SkSampler.cpp',
         '../src/codec/SkSampledCodec.cpp',
         '../src/codec/SkStreamBuffer.cpp',
+        '../src/codec/SkStreamingCodec.cpp',
         '../src/codec/SkSwizzler.cpp',
         '../src/codec/SkWbmpCodec.cpp',
         '../src/codec/SkWebpAdapterCodec.cpp',
@@ -132,6 +132,12 @@ public:
             their stacks. */
         int32_t getGenID() const { SkASSERT(kInvalidGenID != fGenID); return fGenID; }
 
+        /** Like the GenID, the content hash covers the clip elements up to and including this
+            element, but it is computed from their shapes, set operations and anti-aliasing rather
+            than assigned, so the same elements produce the same hash in any stack (e.g. when a
+            frame is redrawn). Equal hashes do not guarantee equal clips. */
+        uint32_t getContentHash() const { return fContentHash; }
+
         /**
          * Gets the bounds of the clip element, either the rect or path bounds. (Whether the shape
          * is inverse filled is not considered.)
@@ -248,6 +254,7 @@ public:
         bool fIsIntersectionOfRects;
 
         int fGenID;
+        uint32_t fContentHash;
 #if SK_SUPPORT_GPU
         mutable SkTArray<std::unique_ptr<GrUniqueKeyInvalidatedMessage>> fMessages;
 #endif
@@ -278,6 +285,7 @@ public:
             fFiniteBound.setEmpty();
             fIsIntersectionOfRects = false;
             fGenID = kInvalidGenID;
+            fContentHash = 0;
         }
 
         void initRect(int saveCount, const SkRect& rect, SkClipOp op, bool doAA) {
@@ -311,6 +319,8 @@ public:
         /** Determines possible finite bounds for the Element given the previous element of the
             stack */
         void updateBoundAndGenID(const Element* prior);
+        /** Combines the content of this element with the prior element's content hash. */
+        void updateContentHash(const Element* prior);
         // The different combination of fill & inverse fill when combining bounding boxes
         enum FillCombo {
             kPrev_Cur_FillCombo,
@@ -68,6 +68,14 @@ public:
     void    drawPosText(const char text[], size_t byteLength,
                         const SkScalar pos[], int scalarsPerPosition,
                         const SkPoint& offset, const SkPaint& paint) const;
+    /**
+     *  Generate the glyph images that drawText() (if pos is null, with offset as x and y) or
+     *  drawPosText() would need, in parallel, rather than one at a time as they are drawn.
+     *  Text with too few glyphs to split up is left alone.
+     */
+    void    prefetchGlyphImages(const char text[], size_t byteLength,
+                                const SkScalar pos[], int scalarsPerPosition,
+                                const SkPoint& offset, const SkPaint& paint) const;
     void    drawVertices(SkCanvas::VertexMode mode, int count,
                          const SkPoint vertices[], const SkPoint textures[],
                          const SkColor colors[], SkBlendMode bmode,
@@ -131,6 +139,8 @@ private:
     void drawLine(const SkPoint[2], const SkPaint&) const;
     void drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
                      SkBlitter* customBlitter, bool doFill) const;
+    bool drawDashPath(const SkPath& path, const SkPaint& paint, bool drawCoverage,
+                      SkBlitter* customBlitter) const;
     /**
      *  Return the current clip bounds, in local coordinates, with slop to account
      *  for antialiasing or hairlines (i.e. device-bounds outset by 1, and then
@@ -290,9 +290,10 @@ public:
      *  Encode the image and return the result as a caller-managed SkData.  This will
      *  attempt to reuse existing encoded data (as returned by refEncoded).
      *
-     *  We defer to the SkPixelSerializer both for vetting existing encoded data
-     *  (useEncodedData) and for encoding the image (encode) when no such data is
-     *  present or is rejected by the serializer.
+     *  We defer to the SkPixelSerializer for standing in data for an image it already
+     *  knows (encodeKnownImage), for vetting existing encoded data (useEncodedData)
+     *  and for encoding the image (encode) when no such data is present or is rejected
+     *  by the serializer.
      *
      *  If not specified, we use a default serializer which 1) always accepts existing data
      *  (in any format) and 2) encodes to PNG.
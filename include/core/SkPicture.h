@@ -171,6 +171,7 @@ private:
     // Subclass whitelist.
     SkPicture();
     friend class SkBigPicture;
+    friend class SkCompactPicture;
     friend class SkEmptyPicture;
     template <typename> friend class SkMiniPicture;
 
@@ -35,6 +35,10 @@ public:
         // If you call drawPicture() or drawDrawable() on the recording canvas, this flag forces
         // that object to playback its contents immediately rather than reffing the object.
         kPlaybackDrawPicture_RecordFlag     = 1 << 0,
+        // Store the finished picture's ops compactly, for pictures that are kept around in
+        // numbers. Playback is as fast, but the picture's ops are no longer available as an
+        // SkRecord (e.g. for GPU layer hoisting).
+        kCompact_RecordFlag                 = 1 << 1,
     };
 
     enum FinishFlags {
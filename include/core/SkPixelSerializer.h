@@ -12,6 +12,7 @@
 #include "SkPixmap.h"
 
 class SkData;
+class SkImage;
 
 /**
  *  Interface for serializing pixels, e.g. SkBitmaps in an SkPicture.
@@ -34,6 +35,20 @@ public:
      */
     SkData* encode(const SkPixmap& pixmap) { return this->onEncode(pixmap); }
 
+    /**
+     *  Call to let the client write something smaller in place of an image the
+     *  receiver already has, e.g. an id that its SkImageDeserializer looks up.
+     *  If it returns NULL, the image is serialized as usual.
+     */
+    SkData* encodeKnownImage(const SkImage* image) { return this->onEncodeKnownImage(image); }
+
+    /**
+     *  Call to determine if encode(), useEncodedData() and encodeKnownImage()
+     *  may be called from several threads at once. If so, a picture encodes
+     *  its images in parallel.
+     */
+    bool isThreadSafe() const { return this->onIsThreadSafe(); }
+
 protected:
     /**
      *  Return true if you want to serialize the encoded data, false if you want
@@ -46,5 +61,17 @@ protected:
      *  Return null if you want to serialize the raw pixels.
      */
     virtual SkData* onEncode(const SkPixmap&) = 0;
+
+    /**
+     *  Return the data to write in place of an image the receiver already has,
+     *  or null to serialize the image itself. The default returns null.
+     */
+    virtual SkData* onEncodeKnownImage(const SkImage*) { return nullptr; }
+
+    /**
+     *  Return true if onUseEncodedData(), onEncode() and onEncodeKnownImage()
+     *  are safe to call concurrently. The default returns false.
+     */
+    virtual bool onIsThreadSafe() const { return false; }
 };
 #endif // SkPixelSerializer_DEFINED
@@ -121,8 +121,8 @@ public:
 
     /**
      *  Set this region to the union of an array of rects. This is generally
-     *  faster than calling region.op(rect, kUnion_Op) in a loop. If count is
-     *  0, then this region is set to the empty region.
+     *  much faster than calling region.op(rect, kUnion_Op) in a loop. If count
+     *  is 0, then this region is set to the empty region.
      *  @return true if the resulting region is non-empty
      */
     bool setRects(const SkIRect rects[], int count);
@@ -283,6 +283,14 @@ public:
      */
     bool op(const SkRegion& rgn, Op op) { return this->op(*this, rgn, op); }
 
+    /**
+     *  Set this region to the result of applying the Op to this region and the
+     *  union of an array of rects: this = (this op (rects[0] + ... + rects[count-1])).
+     *  This is generally much faster than unioning the rects one op() at a time.
+     *  Return true if the resulting region is non-empty.
+     */
+    bool op(const SkIRect rects[], int count, Op op);
+
     /**
      *  Set this region to the result of applying the Op to the specified
      *  rectangle and region: this = (rect op rgn).
@@ -124,6 +124,12 @@ public:
     void writeTypeface(SkTypeface* typeface) override;
     void writePaint(const SkPaint& paint) override;
 
+    /**
+     * Like writeImage(), but with the result of an earlier image->encode(), so that the images
+     * can be encoded ahead of time (e.g. in parallel). Null means the image could not be encoded.
+     */
+    void writeEncodedImage(const SkImage*, SkData* encoded);
+
     bool writeToStream(SkWStream*);
     void writeToMemory(void* dst) { fWriter.flatten(dst); }
 
@@ -85,6 +85,13 @@ struct GrContextOptions {
      * sRGB support.
      */
     bool fRequireDecodeDisableForSRGB = true;
+
+    /**
+     * If set, the GLSL and SPIR-V generated from Skia's shaders is also cached as files in this
+     * directory, so that it can be reused by later processes. The cache is shared by every
+     * GrContext in the process; the most recently created context's directory is used.
+     */
+    const char* fShaderCacheDirectory = nullptr;
 };
 
 #endif
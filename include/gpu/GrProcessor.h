@@ -112,7 +112,7 @@ public:
     RequiredFeatures requiredFeatures() const { return fRequiredFeatures; }
 
     void* operator new(size_t size);
-    void operator delete(void* target);
+    void operator delete(void* target, size_t size);
 
     void* operator new(size_t size, void* placement) {
         return ::operator new(size, placement);
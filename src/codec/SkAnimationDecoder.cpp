@@ -0,0 +1,226 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAnimationDecoder.h"
+#include "SkNextID.h"
+#include "SkPixelRef.h"
+#include "SkResourceCache.h"
+#include "SkTaskGroup.h"
+#include "SkTDArray.h"
+
+namespace {
+static unsigned gAnimationFrameKeyNamespaceLabel;
+
+static uint64_t make_shared_id(uint32_t decoderID) {
+    return ((uint64_t)SkSetFourByteTag('a', 'n', 'i', 'm') << 32) | decoderID;
+}
+
+struct AnimationFrameKey : public SkResourceCache::Key {
+    AnimationFrameKey(uint32_t decoderID, int frameIndex)
+        : fDecoderID(decoderID)
+        , fFrameIndex(frameIndex)
+    {
+        this->init(&gAnimationFrameKeyNamespaceLabel, make_shared_id(decoderID),
+                   sizeof(fDecoderID) + sizeof(fFrameIndex));
+    }
+
+    uint32_t    fDecoderID;
+    int32_t     fFrameIndex;
+};
+
+struct AnimationFrameRec : public SkResourceCache::Rec {
+    AnimationFrameRec(const AnimationFrameKey& key, const SkBitmap& frame)
+        : fKey(key)
+        , fFrame(frame)
+    {}
+
+    AnimationFrameKey   fKey;
+    SkBitmap            fFrame;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(fKey) + fFrame.getSize(); }
+    const char* getCategory() const override { return "animation-frame"; }
+    SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
+        return fFrame.pixelRef()->diagnostic_only_getDiscardable();
+    }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* contextBitmap) {
+        const AnimationFrameRec& rec = static_cast<const AnimationFrameRec&>(baseRec);
+        SkBitmap* result = (SkBitmap*)contextBitmap;
+
+        *result = rec.fFrame;
+        result->lockPixels();
+        return SkToBool(result->getPixels());
+    }
+};
+} // namespace
+
+std::unique_ptr<SkAnimationDecoder> SkAnimationDecoder::Make(sk_sp<SkData> encoded,
+                                                             SkResourceCache* localCache) {
+    std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(encoded));
+    if (!codec) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkAnimationDecoder>(
+            new SkAnimationDecoder(std::move(encoded), std::move(codec), localCache));
+}
+
+SkAnimationDecoder::SkAnimationDecoder(sk_sp<SkData> data, std::unique_ptr<SkCodec> codec,
+                                       SkResourceCache* localCache)
+    : fData(std::move(data))
+    , fInfo(codec->getInfo().makeColorType(kN32_SkColorType)
+                            .makeAlphaType(codec->getInfo().isOpaque() ? kOpaque_SkAlphaType
+                                                                       : kPremul_SkAlphaType)
+                            .makeColorSpace(nullptr))
+    , fFrameInfos(codec->getFrameInfo())
+    , fUniqueID(SkNextID::ImageID())
+    , fLocalCache(localCache)
+    , fCodec(std::move(codec))
+{
+    if (fFrameInfos.empty()) {
+        // Still images are reported as having no frames; treat them as a single key frame.
+        fFrameInfos.push_back({ SkCodec::kNone, 0, true });
+    }
+}
+
+SkAnimationDecoder::~SkAnimationDecoder() {
+    if (fLocalCache) {
+        SkAutoMutexAcquire lock(fLocalCacheMutex);
+        fLocalCache->purgeSharedID(make_shared_id(fUniqueID));
+    } else {
+        SkResourceCache::PostPurgeSharedID(make_shared_id(fUniqueID));
+    }
+}
+
+bool SkAnimationDecoder::findFrame(int index, SkBitmap* frame) {
+    AnimationFrameKey key(fUniqueID, index);
+    if (fLocalCache) {
+        SkAutoMutexAcquire lock(fLocalCacheMutex);
+        return fLocalCache->find(key, AnimationFrameRec::Finder, frame);
+    }
+    return SkResourceCache::Find(key, AnimationFrameRec::Finder, frame);
+}
+
+void SkAnimationDecoder::addFrame(int index, const SkBitmap& frame) {
+    SkASSERT(frame.isImmutable());
+    AnimationFrameRec* rec = new AnimationFrameRec(AnimationFrameKey(fUniqueID, index), frame);
+    if (fLocalCache) {
+        SkAutoMutexAcquire lock(fLocalCacheMutex);
+        fLocalCache->add(rec);
+    } else {
+        SkResourceCache::Add(rec);
+    }
+}
+
+// Walks back along the required frames until it reaches a cached frame or a key frame, then
+// decodes forward, caching every composited frame along the way.
+bool SkAnimationDecoder::decodeFrame(SkCodec* codec, int index, SkBitmap* dst) {
+    SkTDArray<int> chain;
+    SkBitmap prior;
+    for (int i = index;;) {
+        if (this->findFrame(i, &prior)) {
+            break;
+        }
+        *chain.append() = i;
+        size_t required = fFrameInfos[i].fRequiredFrame;
+        if (SkCodec::kNone == required) {
+            break;
+        }
+        SkASSERT(required < (size_t)i);
+        i = SkToInt(required);
+    }
+
+    while (!chain.isEmpty()) {
+        int i;
+        chain.pop(&i);
+
+        SkBitmap frame;
+        if (!frame.tryAllocPixels(fInfo)) {
+            return false;
+        }
+        SkCodec::Options options;
+        options.fFrameIndex = i;
+        if (SkCodec::kNone != fFrameInfos[i].fRequiredFrame) {
+            // prior holds the composited required frame; blend this one on top of it.
+            SkASSERT(prior.getPixels());
+            if (!prior.readPixels(fInfo, frame.getPixels(), frame.rowBytes(), 0, 0)) {
+                return false;
+            }
+            options.fHasPriorFrame = true;
+        }
+        SkCodec::Result result = codec->getPixels(fInfo, frame.getPixels(), frame.rowBytes(),
+                                                  &options, nullptr, nullptr);
+        if (SkCodec::kSuccess != result && SkCodec::kIncompleteInput != result) {
+            return false;
+        }
+        frame.setImmutable();
+        this->addFrame(i, frame);
+        // Moving (rather than copying) keeps the pixels locked.
+        prior = std::move(frame);
+    }
+
+    dst->swap(prior);
+    return true;
+}
+
+bool SkAnimationDecoder::getFrame(int index, SkBitmap* dst) {
+    if (index < 0 || index >= this->frameCount()) {
+        return false;
+    }
+    if (this->findFrame(index, dst)) {
+        return true;
+    }
+    SkAutoMutexAcquire lock(fCodecMutex);
+    return this->decodeFrame(fCodec.get(), index, dst);
+}
+
+void SkAnimationDecoder::prefetch(int first, int count) {
+    first = SkTMax(first, 0);
+    count = SkTMin(count, this->frameCount() - first);
+    if (count <= 0) {
+        return;
+    }
+
+    // Group the frames by the key frame their chain starts at. Frames in different groups do not
+    // depend on each other, so each group can be decoded on its own thread.
+    SkTDArray<int> roots;
+    std::vector<SkTDArray<int>> groups;
+    SkBitmap cached;
+    for (int i = first; i < first + count; ++i) {
+        if (this->findFrame(i, &cached)) {
+            continue;
+        }
+        int root = i;
+        while (SkCodec::kNone != fFrameInfos[root].fRequiredFrame) {
+            root = SkToInt(fFrameInfos[root].fRequiredFrame);
+        }
+        int group = roots.find(root);
+        if (group < 0) {
+            group = roots.count();
+            *roots.append() = root;
+            groups.emplace_back();
+        }
+        *groups[group].append() = i;
+    }
+
+    SkTaskGroup tg;
+    tg.batch(SkToInt(groups.size()), [&](int group) {
+        // SkCodec is not thread-safe, so each chain gets its own.
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(fData));
+        if (!codec) {
+            return;
+        }
+        SkBitmap frame;
+        for (int i : groups[group]) {
+            // Frames are in increasing order, so each decode resumes from the last.
+            if (!this->decodeFrame(codec.get(), i, &frame)) {
+                return;
+            }
+        }
+    });
+    tg.wait();
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkAnimationDecoder_DEFINED
+#define SkAnimationDecoder_DEFINED
+
+#include "SkBitmap.h"
+#include "SkCodec.h"
+#include "SkData.h"
+#include "SkMutex.h"
+
+#include <vector>
+
+class SkResourceCache;
+
+/**
+ *  Random access to the composited frames of an animated image (GIF, WebP).
+ *
+ *  Composited frames are kept in an SkResourceCache (the global one unless a local one is
+ *  supplied), keyed by the decoder's unique ID and the frame index. Getting a frame decodes
+ *  forward from the closest cached frame along its chain of required frames, so a seek costs at
+ *  most one dependency chain, and usually much less.
+ *
+ *  prefetch() decodes the independent chains of a range of frames (each rooted at a key frame)
+ *  in parallel on SkTaskGroup threads, each with its own SkCodec.
+ *
+ *  All methods are thread-safe.
+ */
+class SkAnimationDecoder : SkNoncopyable {
+public:
+    /**
+     *  Returns nullptr if the data cannot be decoded. If localCache is not null, frames are
+     *  stored there instead of the global cache; it must outlive the decoder.
+     */
+    static std::unique_ptr<SkAnimationDecoder> Make(sk_sp<SkData> encoded,
+                                                    SkResourceCache* localCache = nullptr);
+
+    /** Purges this decoder's frames from the cache. */
+    ~SkAnimationDecoder();
+
+    /** The info of each composited frame: the image's dimensions, in legacy N32 premul. */
+    const SkImageInfo& info() const { return fInfo; }
+
+    int frameCount() const { return SkToInt(fFrameInfos.size()); }
+    const SkCodec::FrameInfo& frameInfo(int index) const { return fFrameInfos[index]; }
+
+    /**
+     *  Sets dst to the fully composited frame, sharing (immutable) pixels with the cache.
+     *  Returns false if index is out of range or the frame cannot be decoded.
+     */
+    bool getFrame(int index, SkBitmap* dst);
+
+    /**
+     *  Decodes the frames in [first, first + count) that are not already cached, running
+     *  independent chains in parallel. Returns when they are all in the cache (budget permitting).
+     */
+    void prefetch(int first, int count);
+
+private:
+    SkAnimationDecoder(sk_sp<SkData>, std::unique_ptr<SkCodec>, SkResourceCache*);
+
+    bool findFrame(int index, SkBitmap*);
+    void addFrame(int index, const SkBitmap&);
+    bool decodeFrame(SkCodec*, int index, SkBitmap* dst);
+
+    sk_sp<SkData>                   fData;
+    SkImageInfo                     fInfo;
+    std::vector<SkCodec::FrameInfo> fFrameInfos;
+    const uint32_t                  fUniqueID;
+    SkResourceCache*                fLocalCache;
+    SkMutex                         fLocalCacheMutex;   // local caches are not thread-safe
+
+    SkMutex                         fCodecMutex;        // guards fCodec
+    std::unique_ptr<SkCodec>        fCodec;
+};
+
+#endif
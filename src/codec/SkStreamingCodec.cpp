@@ -0,0 +1,228 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkStream.h"
+#include "SkStreamingCodec.h"
+
+/**
+ *  Reads from the bytes appended to the owning SkStreamingCodec. A read past the end of what has
+ *  arrived is short, which the incremental codecs treat as "more data later" and resume from.
+ */
+class SkStreamingCodec::Stream : public SkStream {
+public:
+    explicit Stream(SkStreamingCodec* owner) : fOwner(owner), fPosition(0) {}
+
+    size_t read(void* buffer, size_t size) override {
+        size = SkTMin(size, fOwner->bytesReceived() - fPosition);
+        if (buffer) {
+            size = fOwner->readAt(fPosition, buffer, size);
+        }
+        fOwner->noteRead(fPosition, size);
+        fPosition += size;
+        return size;
+    }
+
+    size_t peek(void* buffer, size_t size) const override {
+        return fOwner->readAt(fPosition, buffer, size);
+    }
+
+    bool isAtEnd() const override {
+        return fOwner->isAllDataReceived() && fPosition == fOwner->bytesReceived();
+    }
+
+    bool rewind() override {
+        fPosition = 0;
+        return true;
+    }
+
+    bool hasPosition() const override { return true; }
+    size_t getPosition() const override { return fPosition; }
+
+    bool seek(size_t position) override {
+        fPosition = SkTMin(position, fOwner->bytesReceived());
+        return true;
+    }
+
+    bool move(long offset) override {
+        return this->seek(offset < 0 && (size_t)-offset > fPosition ? 0 : fPosition + offset);
+    }
+
+private:
+    SkStreamingCodec*   fOwner;
+    size_t              fPosition;
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const size_t kMaxReserve = 256 * 1024;
+
+SkStreamingCodec::SkStreamingCodec()
+    : fBlock(nullptr)
+    , fBlockStart(0)
+    , fAllDataReceived(false)
+    , fTriedSinceAppend(false)
+    , fDst(nullptr)
+    , fRowBytes(0)
+    , fState(kNoDestination)
+    , fResult(SkCodec::kIncompleteInput)
+    , fRowsDecoded(0)
+    , fBytesRead(0)
+    , fBytesReparsed(0)
+    , fHighWater(0)
+{}
+
+SkStreamingCodec::~SkStreamingCodec() {}
+
+void SkStreamingCodec::append(const void* data, size_t length) {
+    SkASSERT(!fAllDataReceived);
+    if (length > 0) {
+        // Reserving up to as much again as has arrived keeps the number of blocks small, so
+        // finding a block again after a new snapshot or a rewind stays cheap.
+        fBuffer.append(data, length, SkTMin(fBuffer.size(), kMaxReserve));
+        fTriedSinceAppend = false;
+    }
+}
+
+void SkStreamingCodec::setAllDataReceived() {
+    fAllDataReceived = true;
+    fTriedSinceAppend = false;
+}
+
+size_t SkStreamingCodec::readAt(size_t offset, void* buffer, size_t size) {
+    if (!fSnapshot || fSnapshot->size() != fBuffer.size()) {
+        // Snapshots share the buffer's blocks rather than copying them, so this is cheap.
+        fSnapshot.reset(fBuffer.newRBufferSnapshot());
+        fBlock.reset(fSnapshot.get());
+        fBlockStart = 0;
+    }
+    if (offset < fBlockStart) {
+        // Only a rewind reads backwards; start again from the first block.
+        fBlock.reset(fSnapshot.get());
+        fBlockStart = 0;
+    }
+
+    // Codecs mostly read forwards, so resume from the block the last read ended in.
+    char* dst = static_cast<char*>(buffer);
+    size_t copied = 0;
+    while (copied < size && fBlock.data()) {
+        const size_t blockSize = fBlock.size();
+        if (offset < fBlockStart + blockSize) {
+            const size_t skip = offset - fBlockStart;
+            const size_t bytes = SkTMin(blockSize - skip, size - copied);
+            memcpy(dst + copied, static_cast<const char*>(fBlock.data()) + skip, bytes);
+            copied += bytes;
+            offset += bytes;
+            if (copied == size) {
+                break;
+            }
+        }
+        fBlockStart += blockSize;
+        fBlock.next();
+    }
+    return copied;
+}
+
+void SkStreamingCodec::noteRead(size_t offset, size_t size) {
+    fBytesRead += size;
+    if (offset < fHighWater) {
+        fBytesReparsed += SkTMin(size, fHighWater - offset);
+    }
+    fHighWater = SkTMax(fHighWater, offset + size);
+}
+
+SkCodec* SkStreamingCodec::codec() {
+    if (!fCodec && !fTriedSinceAppend) {
+        // A failed attempt may just mean the header is incomplete, so try again after the next
+        // append. Any header bytes read by the failed attempt are counted as re-parsed.
+        fTriedSinceAppend = true;
+        fCodec.reset(SkCodec::NewFromStream(new Stream(this)));
+    }
+    return fCodec.get();
+}
+
+bool SkStreamingCodec::setDestination(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                      const SkCodec::Options* options) {
+    if (!dst || dstInfo.isEmpty() || rowBytes < dstInfo.minRowBytes() ||
+        (kNoDestination != fState && kNotStarted != fState)) {
+        return false;
+    }
+    fDstInfo = dstInfo;
+    fDst = dst;
+    fRowBytes = rowBytes;
+    fOptions = options ? *options : SkCodec::Options();
+    fState = kNotStarted;
+    return true;
+}
+
+SkCodec::Result SkStreamingCodec::decode() {
+    auto finish = [this](SkCodec::Result result) {
+        if (SkCodec::kSuccess == result) {
+            fRowsDecoded = fDstInfo.height();
+        }
+        fState = kFinished;
+        fResult = result;
+        return result;
+    };
+
+    switch (fState) {
+        case kNoDestination:
+            return SkCodec::kInvalidParameters;
+        case kFinished:
+            return fResult;
+        default:
+            break;
+    }
+
+    if (!this->codec()) {
+        return fAllDataReceived ? SkCodec::kInvalidInput : SkCodec::kIncompleteInput;
+    }
+
+    if (kNotStarted == fState) {
+        SkCodec::Result result = fCodec->startIncrementalDecode(fDstInfo, fDst, fRowBytes,
+                                                                &fOptions);
+        switch (result) {
+            case SkCodec::kSuccess:
+                fState = kIncremental;
+                break;
+            case SkCodec::kUnimplemented:
+                fState = kOnePass;
+                break;
+            case SkCodec::kIncompleteInput:
+                return fAllDataReceived ? finish(SkCodec::kInvalidInput) : result;
+            default:
+                return finish(result);
+        }
+    }
+
+    if (kOnePass == fState) {
+        if (!fAllDataReceived) {
+            return SkCodec::kIncompleteInput;
+        }
+        // getPixels() fills in whatever a truncated image is missing, so every row is ready.
+        SkCodec::Result result = fCodec->getPixels(fDstInfo, fDst, fRowBytes, &fOptions,
+                                                   nullptr, nullptr);
+        fRowsDecoded = fDstInfo.height();
+        return finish(result);
+    }
+
+    int rowsDecoded = 0;
+    SkCodec::Result result = fCodec->incrementalDecode(&rowsDecoded);
+    if (SkCodec::kIncompleteInput == result) {
+        fRowsDecoded = SkTMax(fRowsDecoded, rowsDecoded);
+        return fAllDataReceived ? finish(result) : result;
+    }
+    return finish(result);
+}
+
+SkIRect SkStreamingCodec::readyRows() const {
+    const int width = fDstInfo.width();
+    const int height = fDstInfo.height();
+    if (fCodec && SkCodec::kBottomUp_SkScanlineOrder == fCodec->getScanlineOrder()) {
+        return SkIRect::MakeLTRB(0, height - fRowsDecoded, width, height);
+    }
+    return SkIRect::MakeWH(width, fRowsDecoded);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStreamingCodec_DEFINED
+#define SkStreamingCodec_DEFINED
+
+#include "SkCodec.h"
+#include "SkRWBuffer.h"
+
+/**
+ *  Front-end for decoding an image whose bytes arrive over time, e.g. from the network.
+ *
+ *  The caller append()s bytes as they arrive and calls decode() whenever it wants to paint. The
+ *  bytes are accumulated in an SkRWBuffer, and the SkCodec reads them through a stream that simply
+ *  reports a short read at the end of what has arrived so far. Codecs that support incremental
+ *  decoding (PNG, GIF) therefore resume exactly where they stopped, never rewinding or re-reading
+ *  earlier data. Other formats are decoded in one pass once all of the data has been received.
+ *
+ *  Not thread-safe.
+ */
+class SkStreamingCodec : SkNoncopyable {
+public:
+    SkStreamingCodec();
+    ~SkStreamingCodec();
+
+    /** Appends newly received bytes. */
+    void append(const void* data, size_t length);
+
+    /** Signals that no more data will be appended. */
+    void setAllDataReceived();
+    bool isAllDataReceived() const { return fAllDataReceived; }
+
+    /**
+     *  Returns the codec, or nullptr if not enough of the header has arrived yet (or the data is
+     *  not a supported image). Creation is only retried after new data has been appended.
+     */
+    SkCodec* codec();
+
+    /**
+     *  Sets the destination for decode(). May be called before the header has arrived, in which
+     *  case the decode starts as soon as it has. dst must stay valid until the decode finishes.
+     *  Returns false if dst is null, dstInfo is empty, rowBytes is too small for dstInfo, or the
+     *  decode has already started. Whether the codec can decode to dstInfo is only known once
+     *  the header has arrived; if it cannot, decode() returns the codec's error.
+     */
+    bool setDestination(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                        const SkCodec::Options* = nullptr);
+
+    /**
+     *  Decodes whatever the bytes received so far allow. Returns kSuccess once the image is
+     *  complete, kIncompleteInput while more data is needed, or the error that stopped the decode.
+     */
+    SkCodec::Result decode();
+
+    /**
+     *  The rows of the destination that hold decoded pixels so far; the rest are untouched.
+     *  (For interlaced images these rows may still be refined by later passes.)
+     */
+    SkIRect readyRows() const;
+
+    /** Total number of bytes appended. */
+    size_t bytesReceived() const { return fBuffer.size(); }
+
+    /** Total number of bytes the codec has read, including any it read more than once. */
+    size_t bytesRead() const { return fBytesRead; }
+
+    /** The number of bytes that were read more than once, e.g. because the codec rewound. */
+    size_t bytesReparsed() const { return fBytesReparsed; }
+
+private:
+    class Stream;
+
+    size_t readAt(size_t offset, void* buffer, size_t size);
+    void noteRead(size_t offset, size_t size);
+
+    SkRWBuffer                  fBuffer;
+    sk_sp<SkROBuffer>           fSnapshot;          // refreshed lazily by readAt()
+    SkROBuffer::Iter            fBlock;             // fSnapshot's block the last read ended in
+    size_t                      fBlockStart;        // offset of fBlock's first byte
+    bool                        fAllDataReceived;
+    bool                        fTriedSinceAppend;  // codec creation failed on the current data
+
+    std::unique_ptr<SkCodec>    fCodec;
+    SkImageInfo                 fDstInfo;
+    void*                       fDst;
+    size_t                      fRowBytes;
+    SkCodec::Options            fOptions;
+    enum {
+        kNoDestination,
+        kNotStarted,
+        kIncremental,   // startIncrementalDecode() succeeded
+        kOnePass,       // the codec has no incremental decode; wait for all of the data
+        kFinished,
+    }                           fState;
+    SkCodec::Result             fResult;
+    int                         fRowsDecoded;
+
+    size_t                      fBytesRead;
+    size_t                      fBytesReparsed;
+    size_t                      fHighWater;         // one past the furthest byte read so far
+};
+
+#endif
@@ -690,6 +690,14 @@ void SkAAClip::swap(SkAAClip& other) {
     SkTSwap(fRunHead, other.fRunHead);
 }
 
+size_t SkAAClip::approximateBytesUsed() const {
+    size_t size = sizeof(SkAAClip);
+    if (fRunHead) {
+        size += sizeof(RunHead) + fRunHead->fRowCount * sizeof(YOffset) + fRunHead->fDataSize;
+    }
+    return size;
+}
+
 bool SkAAClip::set(const SkAAClip& src) {
     *this = src;
     return !this->isEmpty();
@@ -1920,6 +1928,63 @@ static void expandToRuns(const uint8_t* SK_RESTRICT data, int initialCount, int
     runs[0] = 0;    // sentinel
 }
 
+static void expandToA8(const uint8_t* SK_RESTRICT data, int initialCount, int width,
+                       SkAlpha* SK_RESTRICT aa) {
+    int n = initialCount;
+    for (;;) {
+        if (n > width) {
+            n = width;
+        }
+        SkASSERT(n > 0);
+        memset(aa, data[1], n);
+        aa += n;
+
+        data += 2;
+        width -= n;
+        if (0 == width) {
+            break;
+        }
+        n = data[0];
+    }
+}
+
+// Returns the number of pixels written.
+static int runsToA8(const SkAlpha* SK_RESTRICT srcAA, const int16_t* SK_RESTRICT runs,
+                    SkAlpha* SK_RESTRICT aa) {
+    int width = 0;
+    for (int n = runs[0]; n > 0; n = runs[0]) {
+        memset(aa + width, srcAA[0], n);
+        width += n;
+        srcAA += n;
+        runs += n;
+    }
+    return width;
+}
+
+// Rows whose runs average fewer pixels than this are blitted as A8 masks, when the blitter
+// prefers that (see SkBlitter::prefersMaskRows()).
+static const int kMaxMaskRowRunLength = 8;
+
+static bool many_short_runs(const uint8_t* SK_RESTRICT data, int initialCount, int width) {
+    int runCount = 1;
+    for (int n = initialCount; n < width; n += data[0]) {
+        data += 2;
+        runCount += 1;
+    }
+    return runCount * kMaxMaskRowRunLength > width;
+}
+
+static bool many_short_runs(const int16_t* SK_RESTRICT runs) {
+    int runCount = 0;
+    int width = 0;
+    for (int n = runs[0]; n > 0; n = runs[0]) {
+        runCount += 1;
+        width += n;
+        runs += n;
+    }
+    return runCount * kMaxMaskRowRunLength > width;
+}
+
 SkAAClipBlitter::~SkAAClipBlitter() {
     sk_free(fScanlineScratch);
 }
@@ -1928,14 +1993,24 @@ void SkAAClipBlitter::ensureRunsAndAA() {
     if (nullptr == fScanlineScratch) {
         // add 1 so we can store the terminating run count of 0
         int count = fAAClipBounds.width() + 1;
-        // we use this either for fRuns + fAA, or a scaline of a mask
+        // we use this either for fRuns + fAA + fRowAA, or a scaline of a mask
         // which may be as deep as 32bits
         fScanlineScratch = sk_malloc_throw(count * sizeof(SkPMColor));
         fRuns = (int16_t*)fScanlineScratch;
         fAA = (SkAlpha*)(fRuns + count);
+        fRowAA = fAA + count;
     }
 }
 
+void SkAAClipBlitter::blitRowMask(int x, int y, int width) {
+    SkMask mask;
+    mask.fImage = fRowAA;
+    mask.fBounds.set(x, y, x + width, y + 1);
+    mask.fRowBytes = width;
+    mask.fFormat = SkMask::kA8_Format;
+    fBlitter->blitMask(mask, mask.fBounds);
+}
+
 void SkAAClipBlitter::blitH(int x, int y, int width) {
     SkASSERT(width > 0);
     SkASSERT(fAAClipBounds.contains(x, y));
@@ -1957,6 +2032,11 @@ void SkAAClipBlitter::blitH(int x, int y, int width) {
     }
 
     this->ensureRunsAndAA();
+    if (fMaskRows && many_short_runs(row, initialCount, width)) {
+        expandToA8(row, initialCount, width, fRowAA);
+        this->blitRowMask(x, y, width);
+        return;
+    }
     expandToRuns(row, initialCount, width, fRuns, fAA);
 
     fBlitter->blitAntiH(x, y, fAA, fRuns);
@@ -2016,6 +2096,11 @@ void SkAAClipBlitter::blitAntiH(int x, int y, const SkAlpha aa[],
     this->ensureRunsAndAA();
 
     merge(row, initialCount, aa, runs, fAA, fRuns, fAAClipBounds.width());
+    if (fMaskRows && many_short_runs(fRuns)) {
+        int width = runsToA8(fAA, fRuns, fRowAA);
+        this->blitRowMask(x, y, width);
+        return;
+    }
     fBlitter->blitAntiH(x, y, fAA, fRuns);
 }
 
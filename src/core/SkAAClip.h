@@ -32,6 +32,9 @@ public:
     // If true, getBounds() can be used in place of this clip.
     bool isRect() const;
 
+    // Returns the memory used by this clip, including its (possibly shared) runs.
+    size_t approximateBytesUsed() const;
+
     bool setEmpty();
     bool setRect(const SkIRect&);
     bool setRect(const SkRect&, bool doAA = true);
@@ -106,6 +109,7 @@ public:
         fBlitter = blitter;
         fAAClip = aaclip;
         fAAClipBounds = aaclip->getBounds();
+        fMaskRows = blitter->prefersMaskRows();
     }
 
     void blitH(int x, int y, int width) override;
@@ -119,10 +123,12 @@ private:
     SkBlitter*      fBlitter;
     const SkAAClip* fAAClip;
     SkIRect         fAAClipBounds;
+    bool            fMaskRows;  // hand fBlitter rows of many short runs as A8 masks
 
     // point into fScanlineScratch
     int16_t*        fRuns;
     SkAlpha*        fAA;
+    SkAlpha*        fRowAA;     // a dense row of coverage, for blitRowMask()
 
     enum {
         kSize = 32 * 32
@@ -131,6 +137,7 @@ private:
     void* fScanlineScratch;  // enough for a mask at 32bit, or runs+aa
 
     void ensureRunsAndAA();
+    void blitRowMask(int x, int y, int width);
 };
 
 #endif
@@ -20,6 +20,7 @@
 #include "SkShader.h"
 #include "SkSpecialImage.h"
 #include "SkSurface.h"
+#include "SkTextBlobRunIterator.h"
 
 class SkColorTable;
 
@@ -197,6 +198,7 @@ void SkBitmapDevice::drawRect(const SkDraw& draw, const SkRect& r, const SkPaint
 void SkBitmapDevice::drawOval(const SkDraw& draw, const SkRect& oval, const SkPaint& paint) {
     SkPath path;
     path.addOval(oval);
+    path.setIsVolatile(true);
     // call the VIRTUAL version, so any subclasses who do handle drawPath aren't
     // required to override drawOval.
     this->drawPath(draw, path, paint, nullptr, true);
@@ -207,6 +209,7 @@ void SkBitmapDevice::drawRRect(const SkDraw& draw, const SkRRect& rrect, const S
     SkPath  path;
 
     path.addRRect(rrect);
+    path.setIsVolatile(true);
     // call the VIRTUAL version, so any subclasses who do handle drawPath aren't
     // required to override drawRRect.
     this->drawPath(draw, path, paint, nullptr, true);
@@ -358,6 +361,40 @@ void SkBitmapDevice::drawPosText(const SkDraw& draw, const void* text, size_t le
     draw.drawPosText((const char*)text, len, xpos, scalarsPerPos, offset, paint);
 }
 
+void SkBitmapDevice::drawTextBlob(const SkDraw& draw, const SkTextBlob* blob,
+                                  SkScalar x, SkScalar y,
+                                  const SkPaint& paint, SkDrawFilter* drawFilter) {
+    // A cold blob (e.g. a page of CJK text) can need thousands of new glyphs. Generate them up
+    // front, in parallel, rather than one at a time as the runs are drawn. A draw filter may
+    // change each run's paint, so filtered draws are left alone.
+    if (!drawFilter) {
+        SkPaint runPaint = paint;
+        for (SkTextBlobRunIterator it(blob); !it.done(); it.next()) {
+            size_t textLen = it.glyphCount() * sizeof(uint16_t);
+            const SkPoint& offset = it.offset();
+            it.applyFontToPaint(&runPaint);
+            runPaint.setFlags(this->filterTextFlags(runPaint));
+
+            switch (it.positioning()) {
+                case SkTextBlob::kDefault_Positioning:
+                    draw.prefetchGlyphImages((const char*)it.glyphs(), textLen, nullptr, 0,
+                                             SkPoint::Make(x + offset.x(), y + offset.y()),
+                                             runPaint);
+                    break;
+                case SkTextBlob::kHorizontal_Positioning:
+                    draw.prefetchGlyphImages((const char*)it.glyphs(), textLen, it.pos(), 1,
+                                             SkPoint::Make(x, y + offset.y()), runPaint);
+                    break;
+                case SkTextBlob::kFull_Positioning:
+                    draw.prefetchGlyphImages((const char*)it.glyphs(), textLen, it.pos(), 2,
+                                             SkPoint::Make(x, y), runPaint);
+                    break;
+            }
+        }
+    }
+    this->INHERITED::drawTextBlob(draw, blob, x, y, paint, drawFilter);
+}
+
 void SkBitmapDevice::drawVertices(const SkDraw& draw, SkCanvas::VertexMode vmode,
                                   int vertexCount,
                                   const SkPoint verts[], const SkPoint textures[],
@@ -121,6 +121,13 @@ public:
      */
     virtual int requestRowsPreserved() const { return 1; }
 
+    /**
+     * Returns true if blitMask() covers each row of an A8 mask in a single pass. A row of
+     * coverage made of many short runs is then cheaper to hand over as a one-row A8 mask than
+     * through blitAntiH(), which blits each run separately. Clipping blitters use this to choose.
+     */
+    virtual bool prefersMaskRows() const { return false; }
+
     /**
      * This function allocates memory for the blitter that the blitter then owns.
      * The memory can be used by the calling function at will, but it will be
@@ -197,6 +204,10 @@ public:
         return fBlitter->requestRowsPreserved();
     }
 
+    bool prefersMaskRows() const override {
+        return fBlitter->prefersMaskRows();
+    }
+
     void* allocBlitMemory(size_t sz) override {
         return fBlitter->allocBlitMemory(sz);
     }
@@ -231,6 +242,10 @@ public:
         return fBlitter->requestRowsPreserved();
     }
 
+    bool prefersMaskRows() const override {
+        return fBlitter->prefersMaskRows();
+    }
+
     void* allocBlitMemory(size_t sz) override {
         return fBlitter->allocBlitMemory(sz);
     }
@@ -265,6 +280,10 @@ public:
         return fBlitter->requestRowsPreserved();
     }
 
+    bool prefersMaskRows() const override {
+        return fBlitter->prefersMaskRows();
+    }
+
     void* allocBlitMemory(size_t sz) override {
         return fBlitter->allocBlitMemory(sz);
     }
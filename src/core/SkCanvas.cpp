@@ -29,6 +29,7 @@
 #include "SkPicture.h"
 #include "SkRadialShadowMapShader.h"
 #include "SkRasterClip.h"
+#include "SkRasterClipCache.h"
 #include "SkReadPixelsRec.h"
 #include "SkRRect.h"
 #include "SkShadowPaintFilterCanvas.h"
@@ -1524,6 +1525,43 @@ sk_sp<SkLights> SkCanvas::getLights() const {
 
 //////////////////////////////////////////////////////////////////////////////
 
+static const SkClipStack::Element* top_clip_element(const SkClipStack& stack) {
+    SkClipStack::Iter iter(stack, SkClipStack::Iter::kTop_IterStart);
+    return iter.prev();
+}
+
+static int32_t top_clip_gen_id(const SkClipStack& stack) {
+    const SkClipStack::Element* element = top_clip_element(stack);
+    return element ? element->getGenID() : SkClipStack::kInvalidGenID;
+}
+
+/**
+ *  Scan-converting a path or round-rect clip is the expensive part of clipping, and the same clip
+ *  is often applied to the same raster clip again (on the next frame, or on another tile). When
+ *  the clip op just pushed such an element onto the stack, its result is looked up in (or added
+ *  to) SkRasterClipCache, and applyOp is only called on a miss.
+ */
+template <typename ApplyOpProc>
+static void cached_raster_clip_op(SkRasterClip* rc, const SkClipStack& stack, int32_t priorGenID,
+                                  SkClipOp op, bool doAA, const SkIRect& devBounds,
+                                  ApplyOpProc applyOp) {
+    const SkClipStack::Element* element = top_clip_element(stack);
+    if (rc->isForceConservativeRects() || !element || element->getGenID() == priorGenID ||
+        element->getOp() != op || element->isAA() != doAA ||
+        (SkClipStack::Element::kPath_Type != element->getType() &&
+         SkClipStack::Element::kRRect_Type != element->getType())) {
+        // The op was merged into an earlier element, or a clip restriction was pushed after it.
+        applyOp();
+        return;
+    }
+    if (SkRasterClipCache::Find(*rc, *element, devBounds, rc)) {
+        return;
+    }
+    SkRasterClip prior(*rc);
+    applyOp();
+    SkRasterClipCache::Add(prior, *element, devBounds, *rc);
+}
+
 void SkCanvas::clipRect(const SkRect& rect, SkClipOp op, bool doAA) {
     this->checkForDeferredSave();
     ClipEdgeStyle edgeStyle = doAA ? kSoft_ClipEdgeStyle : kHard_ClipEdgeStyle;
@@ -1569,9 +1607,14 @@ void SkCanvas::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle edge
     fDeviceCMDirty = true;
 
     bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
+    int32_t priorGenID = top_clip_gen_id(*fClipStack);
     fClipStack->clipRRect(rrect, fMCRec->fMatrix, op, isAA);
-    fMCRec->fRasterClip.op(rrect, fMCRec->fMatrix, this->getTopLayerBounds(), (SkRegion::Op)op,
-                           isAA);
+    SkIRect devBounds = this->getTopLayerBounds();
+    auto applyOp = [&] {
+        fMCRec->fRasterClip.op(rrect, fMCRec->fMatrix, devBounds, (SkRegion::Op)op, isAA);
+    };
+    cached_raster_clip_op(&fMCRec->fRasterClip, *fClipStack, priorGenID, op, isAA, devBounds,
+                          applyOp);
     fDeviceClipBounds = qr_clip_bounds(fMCRec->fRasterClip.getBounds());
     return;
 }
@@ -1607,19 +1650,22 @@ void SkCanvas::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeSty
     fDeviceCMDirty = true;
     bool isAA = kSoft_ClipEdgeStyle == edgeStyle;
 
+    int32_t priorGenID = top_clip_gen_id(*fClipStack);
     fClipStack->clipPath(path, fMCRec->fMatrix, op, isAA);
 
-    const SkPath* rasterClipPath = &path;
-    const SkMatrix* matrix = &fMCRec->fMatrix;
-    SkPath tempPath;
     if (fAllowSimplifyClip) {
+        SkPath tempPath;
         isAA = getClipStack()->asPath(&tempPath);
-        rasterClipPath = &tempPath;
-        matrix = &SkMatrix::I();
-        op = kReplace_SkClipOp;
+        fMCRec->fRasterClip.op(tempPath, SkMatrix::I(), this->getTopLayerBounds(),
+                               SkRegion::kReplace_Op, isAA);
+    } else {
+        SkIRect devBounds = this->getTopLayerBounds();
+        auto applyOp = [&] {
+            fMCRec->fRasterClip.op(path, fMCRec->fMatrix, devBounds, (SkRegion::Op)op, isAA);
+        };
+        cached_raster_clip_op(&fMCRec->fRasterClip, *fClipStack, priorGenID, op, isAA, devBounds,
+                              applyOp);
     }
-    fMCRec->fRasterClip.op(*rasterClipPath, *matrix, this->getTopLayerBounds(), (SkRegion::Op)op,
-                           isAA);
     fDeviceClipBounds = qr_clip_bounds(fMCRec->fRasterClip.getBounds());
 }
 
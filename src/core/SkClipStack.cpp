@@ -8,8 +8,10 @@
 #include "SkAtomics.h"
 #include "SkCanvas.h"
 #include "SkClipStack.h"
+#include "SkOpts.h"
 #include "SkPath.h"
 #include "SkPathOps.h"
+#include "SkPathPriv.h"
 #include "SkClipOpPriv.h"
 
 #include <new>
@@ -43,6 +45,7 @@ SkClipStack::Element::Element(const Element& that) {
     fFiniteBound = that.fFiniteBound;
     fIsIntersectionOfRects = that.fIsIntersectionOfRects;
     fGenID = that.fGenID;
+    fContentHash = that.fContentHash;
 }
 
 bool SkClipStack::Element::operator== (const Element& element) const {
@@ -165,6 +168,8 @@ void SkClipStack::Element::setEmpty() {
     fRRect.setEmpty();
     fPath.reset();
     fGenID = kEmptyGenID;
+    // An empty element empties the clip whatever came before it.
+    fContentHash = 0;
     SkDEBUGCODE(this->checkEmpty();)
 }
 
@@ -387,7 +392,38 @@ void SkClipStack::Element::combineBoundsRevDiff(int combination, const SkRect& p
     }
 }
 
+void SkClipStack::Element::updateContentHash(const Element* prior) {
+    int32_t header[4] = {
+        fType, (int32_t)fOp, fDoAA,
+        kPath_Type == fType ? fPath.get()->getFillType() : 0,
+    };
+    uint32_t hash = SkOpts::hash(header, sizeof(header), prior ? prior->fContentHash : 0);
+    switch (fType) {
+        case kRect_Type:
+        case kRRect_Type: {
+            char rrect[SkRRect::kSizeInMemory];
+            fRRect.writeToMemory(rrect);
+            hash = SkOpts::hash(rrect, sizeof(rrect), hash);
+            break;
+        }
+        case kPath_Type: {
+            const SkPath& path = *fPath.get();
+            hash = SkOpts::hash(SkPathPriv::VerbData(path), path.countVerbs(), hash);
+            hash = SkOpts::hash(SkPathPriv::PointData(path), path.countPoints() * sizeof(SkPoint),
+                                hash);
+            hash = SkOpts::hash(SkPathPriv::ConicWeightData(path),
+                                SkPathPriv::ConicWeightCnt(path) * sizeof(SkScalar), hash);
+            break;
+        }
+        case kEmpty_Type:
+            break;
+    }
+    fContentHash = hash;
+}
+
 void SkClipStack::Element::updateBoundAndGenID(const Element* prior) {
+    this->updateContentHash(prior);
+
     // We set this first here but we may overwrite it later if we determine that the clip is
     // either wide-open or empty.
     fGenID = GetNextGenID();
@@ -0,0 +1,524 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBoxHierarchy.h"
+#include "SkCanvas.h"
+#include "SkCompactPicture.h"
+#include "SkImage.h"
+#include "SkPictureCommon.h"
+#include "SkRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+#include "SkTHash.h"
+#include "SkTextBlob.h"
+#include <cmath>
+
+// Each op starts with its SkRecords::Type in one byte. Most of the encoded ops follow that with a
+// byte of flags, then their fields in order:
+//   paint, path, image and blob   a varint index into the side table
+//   rect                          16 bytes, or with kIntRect set, 8: left, top, width and
+//                                 height as int16_t
+//   matrix                        6 scalars with kAffine set, 9 without
+//   rrect                         the SkRRect's bytes
+// An op the stream does not encode is written as its type, the index of its first op in
+// fOtherOps, and how many ops it took there.
+
+namespace {
+
+enum Flags {
+    kIntRect  = 1 << 0,   // The (dst) rect is stored as int16_t.
+    kIntSrc   = 1 << 1,   // DrawImageRect's src rect is stored as int16_t.
+    kHasPaint = 1 << 2,
+    kHasSrc   = 1 << 3,
+    kStrict   = 1 << 4,   // SkCanvas::kStrict_SrcRectConstraint
+    kAA       = 1 << 5,
+    kAffine   = 1 << 6,
+    kOpShift  = 8,        // ClipRect and ClipRRect keep their SkClipOp above the flags.
+};
+
+// Whether x is an integer that fits in an int16_t. -0 is left as a float, to come back as -0.
+bool is_int16(SkScalar x) {
+    return x >= SK_MinS16 && x <= SK_MaxS16 && x == (SkScalar)(int)x &&
+           (x != 0 || !std::signbit(x));
+}
+
+// Rects on whole pixels are most of what gets drawn, and are stored in half the bytes. The fixed
+// width keeps them as quick to read as floats.
+bool is_int_rect(const SkRect& r) {
+    return is_int16(r.fLeft) && is_int16(r.fTop) && is_int16(r.fRight) && is_int16(r.fBottom) &&
+           is_int16(r.width()) && is_int16(r.height());
+}
+
+class Writer {
+public:
+    void byte(unsigned b) { *fBytes.append() = SkToU8(b); }
+
+    void varint(uint32_t v) {
+        while (v >= 0x80) {
+            this->byte((v & 0x7f) | 0x80);
+            v >>= 7;
+        }
+        this->byte(v);
+    }
+
+    void raw(const void* src, size_t size) { memcpy(fBytes.append(SkToInt(size)), src, size); }
+    void scalar(SkScalar x) { this->raw(&x, sizeof(x)); }
+
+    void rect(const SkRect& r, bool asInts) {
+        if (asInts) {
+            const int16_t values[] = {
+                SkToS16((int)r.fLeft), SkToS16((int)r.fTop),
+                SkToS16((int)r.width()), SkToS16((int)r.height()),
+            };
+            this->raw(values, sizeof(values));
+        } else {
+            this->raw(&r, sizeof(r));
+        }
+    }
+
+    void matrix(const SkMatrix& m, bool affine) {
+        SkScalar values[9];
+        m.get9(values);
+        this->raw(values, (affine ? 6 : 9) * sizeof(SkScalar));
+    }
+
+    int offset() const { return fBytes.count(); }
+    sk_sp<SkData> detach() { return SkData::MakeWithCopy(fBytes.begin(), fBytes.count()); }
+
+private:
+    SkTDArray<uint8_t> fBytes;
+};
+
+class Reader {
+public:
+    explicit Reader(const uint8_t* bytes) : fBytes(bytes) {}
+
+    unsigned byte() { return *fBytes++; }
+
+    uint32_t varint() {
+        uint32_t v = 0;
+        int shift = 0;
+        unsigned b;
+        do {
+            b = *fBytes++;
+            v |= (b & 0x7f) << shift;
+            shift += 7;
+        } while (b & 0x80);
+        return v;
+    }
+
+    void raw(void* dst, size_t size) {
+        memcpy(dst, fBytes, size);
+        fBytes += size;
+    }
+
+    SkScalar scalar() {
+        SkScalar x;
+        this->raw(&x, sizeof(x));
+        return x;
+    }
+
+    SkRect rect(bool asInts) {
+        SkRect r;
+        if (asInts) {
+            int16_t values[4];
+            this->raw(values, sizeof(values));
+            r.setXYWH(values[0], values[1], values[2], values[3]);
+        } else {
+            this->raw(&r, sizeof(r));
+        }
+        return r;
+    }
+
+    SkMatrix matrix(bool affine) {
+        SkScalar values[9] = { 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+        this->raw(values, (affine ? 6 : 9) * sizeof(SkScalar));
+        SkMatrix m;
+        m.set9(values);
+        return m;
+    }
+
+    const uint8_t* position() const { return fBytes; }
+
+private:
+    const uint8_t* fBytes;
+};
+
+// Paints are looked up by value while encoding.
+struct PaintKey {
+    SkPaint fPaint;
+    bool operator==(const PaintKey& other) const { return fPaint == other.fPaint; }
+};
+struct PaintKeyHash {
+    uint32_t operator()(const PaintKey& key) const { return key.fPaint.getHash(); }
+};
+
+}  // namespace
+
+class SkCompactPicture::Encoder {
+public:
+    Encoder(SkCompactPicture* picture, const SkRect& cull,
+            const SkBigPicture::SnapshotArray* drawablePicts)
+        : fPicture(picture)
+        , fOtherOps(new SkRecord)
+        , fRecorder(fOtherOps.get(), cull)
+        , fDraw(&fRecorder,
+                drawablePicts ? drawablePicts->begin() : nullptr, nullptr,
+                drawablePicts ? drawablePicts->count() : 0) {}
+
+    void encode(const SkRecord& record, bool withOffsets) {
+        for (int i = 0; i < record.count(); i++) {
+            if (withOffsets) {
+                *fPicture->fOffsets.append() = SkToU32(fOps.offset());
+            }
+            record.visit(i, *this);
+        }
+        fPicture->fOps = fOps.detach();
+        if (fOtherOps->count() > 0) {
+            fPicture->fOtherOps = std::move(fOtherOps);
+        }
+    }
+
+    // The ops not encoded here are recorded again, into fOtherOps.
+    template <typename T>
+    void operator()(const T& op) {
+        const int index = fOtherOps->count();
+        fDraw(op);
+        const int count = fOtherOps->count() - index;
+        if (0 == count) {
+            // The canvas saw nothing to record.
+            fOps.byte(SkRecords::NoOp_Type);
+            return;
+        }
+        fOps.byte(T::kType);
+        fOps.varint(index);
+        fOps.varint(count);
+    }
+
+    void operator()(const SkRecords::NoOp&)    { fOps.byte(SkRecords::NoOp_Type); }
+    void operator()(const SkRecords::Restore&) { fOps.byte(SkRecords::Restore_Type); }
+    void operator()(const SkRecords::Save&)    { fOps.byte(SkRecords::Save_Type); }
+
+    void operator()(const SkRecords::SetMatrix& op) { this->matrix(op.kType, op.matrix); }
+    void operator()(const SkRecords::Concat& op)    { this->matrix(op.kType, op.matrix); }
+
+    void operator()(const SkRecords::Translate& op) {
+        fOps.byte(op.kType);
+        fOps.scalar(op.dx);
+        fOps.scalar(op.dy);
+    }
+
+    void operator()(const SkRecords::ClipRect& op) {
+        const bool ints = is_int_rect(op.rect);
+        fOps.byte(op.kType);
+        fOps.varint(((unsigned)op.opAA.op() << kOpShift) | (op.opAA.aa() ? kAA : 0) |
+                    (ints ? kIntRect : 0));
+        fOps.rect(op.rect, ints);
+    }
+
+    void operator()(const SkRecords::ClipRRect& op) {
+        fOps.byte(op.kType);
+        fOps.varint(((unsigned)op.opAA.op() << kOpShift) | (op.opAA.aa() ? kAA : 0));
+        fOps.raw(&op.rrect, sizeof(op.rrect));
+    }
+
+    void operator()(const SkRecords::DrawRect& op) { this->rect(op.kType, op.paint, op.rect); }
+    void operator()(const SkRecords::DrawOval& op) { this->rect(op.kType, op.paint, op.oval); }
+
+    void operator()(const SkRecords::DrawRRect& op) {
+        fOps.byte(op.kType);
+        fOps.varint(this->paint(op.paint));
+        fOps.raw(&op.rrect, sizeof(op.rrect));
+    }
+
+    void operator()(const SkRecords::DrawPaint& op) {
+        fOps.byte(op.kType);
+        fOps.varint(this->paint(op.paint));
+    }
+
+    void operator()(const SkRecords::DrawPath& op) {
+        fOps.byte(op.kType);
+        fOps.varint(this->paint(op.paint));
+        fOps.varint(this->path(op.path));
+    }
+
+    void operator()(const SkRecords::DrawTextBlob& op) {
+        fOps.byte(op.kType);
+        fOps.varint(this->paint(op.paint));
+        fOps.varint(Find(&fBlobIndices, &fPicture->fBlobs, op.blob));
+        fOps.scalar(op.x);
+        fOps.scalar(op.y);
+    }
+
+    void operator()(const SkRecords::DrawImage& op) {
+        fOps.byte(op.kType);
+        fOps.byte(op.paint ? kHasPaint : 0);
+        if (op.paint) {
+            fOps.varint(this->paint(*op.paint));
+        }
+        fOps.varint(Find(&fImageIndices, &fPicture->fImages, op.image));
+        fOps.scalar(op.left);
+        fOps.scalar(op.top);
+    }
+
+    void operator()(const SkRecords::DrawImageRect& op) {
+        const bool dstInts = is_int_rect(op.dst),
+                   srcInts = op.src && is_int_rect(*op.src);
+        fOps.byte(op.kType);
+        fOps.byte((op.paint ? kHasPaint : 0) |
+                  (op.src ? kHasSrc : 0) |
+                  (dstInts ? kIntRect : 0) |
+                  (srcInts ? kIntSrc : 0) |
+                  (SkCanvas::kStrict_SrcRectConstraint == op.constraint ? kStrict : 0));
+        if (op.paint) {
+            fOps.varint(this->paint(*op.paint));
+        }
+        fOps.varint(Find(&fImageIndices, &fPicture->fImages, op.image));
+        if (op.src) {
+            fOps.rect(*op.src, srcInts);
+        }
+        fOps.rect(op.dst, dstInts);
+    }
+
+private:
+    void matrix(SkRecords::Type type, const SkMatrix& m) {
+        const bool affine = !m.hasPerspective();
+        fOps.byte(type);
+        fOps.byte(affine ? kAffine : 0);
+        fOps.matrix(m, affine);
+    }
+
+    void rect(SkRecords::Type type, const SkPaint& paint, const SkRect& r) {
+        const bool ints = is_int_rect(r);
+        fOps.byte(type);
+        fOps.byte(ints ? kIntRect : 0);
+        fOps.varint(this->paint(paint));
+        fOps.rect(r, ints);
+    }
+
+    int paint(const SkPaint& paint) {
+        PaintKey key = { paint };
+        if (int* index = fPaintIndices.find(key)) {
+            return *index;
+        }
+        fPicture->fPaints.push_back(paint);
+        fPaintIndices.set(key, fPicture->fPaints.count() - 1);
+        return fPicture->fPaints.count() - 1;
+    }
+
+    // Paths are shared when they are the same SkPath, filled the same way.
+    int path(const SkPath& path) {
+        uint64_t key = ((uint64_t)path.getGenerationID() << 32) | path.getFillType();
+        if (int* index = fPathIndices.find(key)) {
+            return *index;
+        }
+        fPicture->fPaths.push_back(path);
+        fPathIndices.set(key, fPicture->fPaths.count() - 1);
+        return fPicture->fPaths.count() - 1;
+    }
+
+    template <typename T>
+    static int Find(SkTHashMap<uint32_t, int>* indices, SkTArray<sk_sp<const T>>* table,
+                    const sk_sp<const T>& obj) {
+        if (int* index = indices->find(obj->uniqueID())) {
+            return *index;
+        }
+        table->push_back(obj);
+        indices->set(obj->uniqueID(), table->count() - 1);
+        return table->count() - 1;
+    }
+
+    SkCompactPicture*                         fPicture;
+    Writer                                    fOps;
+    sk_sp<SkRecord>                           fOtherOps;
+    SkRecorder                                fRecorder;
+    SkRecords::Draw                           fDraw;
+    SkTHashMap<PaintKey, int, PaintKeyHash>   fPaintIndices;
+    SkTHashMap<uint64_t, int>                 fPathIndices;
+    SkTHashMap<uint32_t, int>                 fImageIndices;
+    SkTHashMap<uint32_t, int>                 fBlobIndices;
+};
+
+class SkCompactPicture::Player {
+public:
+    Player(const SkCompactPicture* picture, SkCanvas* canvas)
+        : fPicture(picture)
+        , fCanvas(canvas)
+        , fInitialCTM(canvas->getTotalMatrix())
+        , fDraw(canvas, nullptr, nullptr, 0, &fInitialCTM) {}
+
+    // Draws the op at bytes, and returns the op after it.
+    const uint8_t* play(const uint8_t* bytes) {
+        Reader r(bytes);
+        const SkRecords::Type type = (SkRecords::Type)r.byte();
+        switch (type) {
+            case SkRecords::NoOp_Type:
+                break;
+            case SkRecords::Restore_Type:
+                fCanvas->restore();
+                break;
+            case SkRecords::Save_Type:
+                fCanvas->save();
+                break;
+            case SkRecords::SetMatrix_Type: {
+                SkMatrix m = r.matrix(SkToBool(r.byte() & kAffine));
+                fCanvas->setMatrix(SkMatrix::Concat(fInitialCTM, m));
+            } break;
+            case SkRecords::Concat_Type:
+                fCanvas->concat(r.matrix(SkToBool(r.byte() & kAffine)));
+                break;
+            case SkRecords::Translate_Type: {
+                SkScalar dx = r.scalar();
+                fCanvas->translate(dx, r.scalar());
+            } break;
+            case SkRecords::ClipRect_Type: {
+                uint32_t flags = r.varint();
+                fCanvas->clipRect(r.rect(SkToBool(flags & kIntRect)),
+                                  (SkClipOp)(flags >> kOpShift), SkToBool(flags & kAA));
+            } break;
+            case SkRecords::ClipRRect_Type: {
+                uint32_t flags = r.varint();
+                SkRRect rrect;
+                r.raw(&rrect, sizeof(rrect));
+                fCanvas->clipRRect(rrect, (SkClipOp)(flags >> kOpShift), SkToBool(flags & kAA));
+            } break;
+            case SkRecords::DrawRect_Type: {
+                unsigned flags = r.byte();
+                const SkPaint& paint = this->paint(&r);
+                fCanvas->drawRect(r.rect(SkToBool(flags & kIntRect)), paint);
+            } break;
+            case SkRecords::DrawOval_Type: {
+                unsigned flags = r.byte();
+                const SkPaint& paint = this->paint(&r);
+                fCanvas->drawOval(r.rect(SkToBool(flags & kIntRect)), paint);
+            } break;
+            case SkRecords::DrawRRect_Type: {
+                const SkPaint& paint = this->paint(&r);
+                SkRRect rrect;
+                r.raw(&rrect, sizeof(rrect));
+                fCanvas->drawRRect(rrect, paint);
+            } break;
+            case SkRecords::DrawPaint_Type:
+                fCanvas->drawPaint(this->paint(&r));
+                break;
+            case SkRecords::DrawPath_Type: {
+                const SkPaint& paint = this->paint(&r);
+                fCanvas->drawPath(fPicture->fPaths[r.varint()], paint);
+            } break;
+            case SkRecords::DrawTextBlob_Type: {
+                const SkPaint& paint = this->paint(&r);
+                const SkTextBlob* blob = fPicture->fBlobs[r.varint()].get();
+                SkScalar x = r.scalar();
+                fCanvas->drawTextBlob(blob, x, r.scalar(), paint);
+            } break;
+            case SkRecords::DrawImage_Type: {
+                unsigned flags = r.byte();
+                const SkPaint* paint = (flags & kHasPaint) ? &this->paint(&r) : nullptr;
+                const SkImage* image = fPicture->fImages[r.varint()].get();
+                SkScalar left = r.scalar();
+                fCanvas->drawImage(image, left, r.scalar(), paint);
+            } break;
+            case SkRecords::DrawImageRect_Type: {
+                unsigned flags = r.byte();
+                const SkPaint* paint = (flags & kHasPaint) ? &this->paint(&r) : nullptr;
+                const SkImage* image = fPicture->fImages[r.varint()].get();
+                SkRect src;
+                if (flags & kHasSrc) {
+                    src = r.rect(SkToBool(flags & kIntSrc));
+                }
+                SkRect dst = r.rect(SkToBool(flags & kIntRect));
+                fCanvas->legacy_drawImageRect(image, (flags & kHasSrc) ? &src : nullptr, dst,
+                                              paint, (flags & kStrict)
+                                                        ? SkCanvas::kStrict_SrcRectConstraint
+                                                        : SkCanvas::kFast_SrcRectConstraint);
+            } break;
+            default: {
+                const SkRecord& otherOps = *fPicture->fOtherOps;
+                int index = r.varint();
+                for (int stop = index + r.varint(); index < stop; index++) {
+                    otherOps.visit(index, fDraw);
+                }
+            } break;
+        }
+        return r.position();
+    }
+
+private:
+    const SkPaint& paint(Reader* r) const { return fPicture->fPaints[r->varint()]; }
+
+    const SkCompactPicture* fPicture;
+    SkCanvas*               fCanvas;
+    const SkMatrix          fInitialCTM;
+    SkRecords::Draw         fDraw;
+};
+
+SkCompactPicture::SkCompactPicture(const SkRect& cull,
+                                   const SkRecord& record,
+                                   const SkBigPicture::SnapshotArray* drawablePicts,
+                                   SkBBoxHierarchy* bbh,
+                                   size_t approxBytesUsedBySubPictures)
+    : fCullRect(cull)
+    , fApproxBytesUsedBySubPictures(approxBytesUsedBySubPictures)
+    , fOpCount(record.count())
+    , fBBH(bbh)                     // Take ownership of caller's ref.
+{
+    SkBitmapHunter bitmap;
+    SkPathCounter  path;
+    bool hasBitmap = false;
+    for (int i = 0; i < record.count(); i++) {
+        hasBitmap = hasBitmap || record.visit(i, bitmap);
+        record.visit(i, path);
+    }
+    fWillPlaybackBitmaps        = hasBitmap;
+    fNumSlowPathsAndDashEffects = SkTMin<int>(path.fNumSlowPathsAndDashEffects, 255);
+
+    Encoder(this, cull, drawablePicts).encode(record, SkToBool(fBBH));
+}
+
+SkCompactPicture::~SkCompactPicture() {}
+
+void SkCompactPicture::playback(SkCanvas* canvas, AbortCallback* callback) const {
+    SkASSERT(canvas);
+    SkAutoCanvasRestore saveRestore(canvas, true /*save now, restore at exit*/);
+
+    // As in SkBigPicture, the BBH is only worth querying when the clip cuts the picture.
+    SkRect clipBounds = { 0, 0, 0, 0 };
+    (void)canvas->getClipBounds(&clipBounds);
+
+    Player player(this, canvas);
+    const uint8_t* ops = fOps->bytes();
+    if (fBBH && !clipBounds.contains(fCullRect)) {
+        SkTDArray<int> found;
+        fBBH->search(clipBounds, &found);
+        for (int i = 0; i < found.count(); i++) {
+            if (callback && callback->abort()) {
+                return;
+            }
+            player.play(ops + fOffsets[found[i]]);
+        }
+    } else {
+        const uint8_t* stop = ops + fOps->size();
+        while (ops < stop) {
+            if (callback && callback->abort()) {
+                return;
+            }
+            ops = player.play(ops);
+        }
+    }
+}
+
+size_t SkCompactPicture::approximateBytesUsed() const {
+    size_t bytes = sizeof(*this) + fOps->size() + fApproxBytesUsedBySubPictures
+                 + fOffsets.reserved()  * sizeof(uint32_t)
+                 + fPaints.count()      * sizeof(SkPaint)
+                 + fPaths.count()       * sizeof(SkPath)
+                 + fImages.count()      * sizeof(sk_sp<const SkImage>)
+                 + fBlobs.count()       * sizeof(sk_sp<const SkTextBlob>);
+    if (fOtherOps) { bytes += fOtherOps->bytesUsed(); }
+    if (fBBH)      { bytes += fBBH->bytesUsed(); }
+    return bytes;
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkCompactPicture_DEFINED
+#define SkCompactPicture_DEFINED
+
+#include "SkBigPicture.h"
+#include "SkData.h"
+#include "SkPaint.h"
+#include "SkPath.h"
+#include "SkPicture.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+
+class SkBBoxHierarchy;
+class SkImage;
+class SkRecord;
+class SkTextBlob;
+
+/**
+ *  An SkPicture that holds its ops in a fraction of the memory an SkBigPicture needs, for callers
+ *  that keep many pictures around. Made by SkPictureRecorder with kCompact_RecordFlag.
+ *
+ *  The ops are a byte stream rather than an array of structs. Each distinct paint, path, image
+ *  and text blob is stored once in a side table, and ops refer to it by index. Matrices without
+ *  perspective are stored as their six affine values, and rects on whole pixels as 16-bit ints.
+ *  The most common ops are encoded that way; the rest are kept as they were, in a small SkRecord
+ *  of their own.
+ *
+ *  A compact picture is not an SkBigPicture: whatever needs the SkRecord (e.g. GPU layer
+ *  hoisting) treats it like any other picture.
+ */
+class SkCompactPicture final : public SkPicture {
+public:
+    /**
+     *  Encodes record, which is not needed afterwards. The BBH, if any, must have been built from
+     *  record.
+     */
+    SkCompactPicture(const SkRect& cull,
+                     const SkRecord& record,
+                     const SkBigPicture::SnapshotArray*,
+                     SkBBoxHierarchy*,      // We take ownership of the caller's ref.
+                     size_t approxBytesUsedBySubPictures);
+    ~SkCompactPicture() override;
+
+// SkPicture overrides
+    void playback(SkCanvas*, AbortCallback*) const override;
+    SkRect cullRect() const override { return fCullRect; }
+    bool willPlayBackBitmaps() const override { return fWillPlaybackBitmaps; }
+    int approximateOpCount() const override { return fOpCount; }
+    size_t approximateBytesUsed() const override;
+
+private:
+    class Encoder;
+    class Player;
+
+    int numSlowPaths() const override { return fNumSlowPathsAndDashEffects; }
+
+    const SkRect                        fCullRect;
+    const size_t                        fApproxBytesUsedBySubPictures;
+    int                                 fOpCount;
+    int                                 fNumSlowPathsAndDashEffects;
+    bool                                fWillPlaybackBitmaps;
+
+    sk_sp<SkData>                       fOps;
+    SkTDArray<uint32_t>                 fOffsets;   // Of each op in fOps, only if there is a BBH.
+
+    SkTArray<SkPaint>                   fPaints;
+    SkTArray<SkPath>                    fPaths;
+    SkTArray<sk_sp<const SkImage>>      fImages;
+    SkTArray<sk_sp<const SkTextBlob>>   fBlobs;
+    sk_sp<SkRecord>                     fOtherOps;  // The ops not encoded in fOps, if any.
+
+    sk_sp<SkBBoxHierarchy>              fBBH;
+};
+
+#endif//SkCompactPicture_DEFINED
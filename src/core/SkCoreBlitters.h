@@ -124,6 +124,7 @@ public:
     const SkPixmap* justAnOpaqueColor(uint32_t*) override;
     void blitAntiH2(int x, int y, U8CPU a0, U8CPU a1) override;
     void blitAntiV2(int x, int y, U8CPU a0, U8CPU a1) override;
+    bool prefersMaskRows() const override { return true; }
 
 protected:
     SkColor                fColor;
@@ -172,6 +173,7 @@ public:
     void blitRect(int x, int y, int width, int height) override;
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t[]) override;
     void blitMask(const SkMask&, const SkIRect&) override;
+    bool prefersMaskRows() const override { return true; }
 
 private:
     SkXfermode*         fXfermode;
@@ -7,6 +7,9 @@
 
 #include "SkDistanceFieldGen.h"
 #include "SkPoint.h"
+#include "SkTaskGroup.h"
+
+#include <atomic>
 
 struct DFData {
     float   fAlpha;      // alpha value of source texel
@@ -519,3 +522,37 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
 
     return generate_distance_field_from_image(distanceField, copyPtr, width, height);
 }
+
+// Each task generates this many distance fields, so that small glyphs are worth a task.
+static const int kRequestsPerTask = 4;
+
+static bool generate_distance_field(const SkDistanceFieldRequest& request) {
+    return request.fIsBW
+            ? SkGenerateDistanceFieldFromBWImage(request.fDistanceField, request.fImage,
+                                                 request.fWidth, request.fHeight,
+                                                 request.fRowBytes)
+            : SkGenerateDistanceFieldFromA8Image(request.fDistanceField, request.fImage,
+                                                 request.fWidth, request.fHeight,
+                                                 request.fRowBytes);
+}
+
+bool SkGenerateDistanceFields(const SkDistanceFieldRequest requests[], int count) {
+    if (count <= kRequestsPerTask) {
+        bool succeeded = true;
+        for (int i = 0; i < count; ++i) {
+            succeeded &= generate_distance_field(requests[i]);
+        }
+        return succeeded;
+    }
+
+    std::atomic<bool> succeeded(true);
+    SkTaskGroup().batch((count + kRequestsPerTask - 1) / kRequestsPerTask, [&](int task) {
+        int end = SkTMin(count, (task + 1) * kRequestsPerTask);
+        for (int i = task * kRequestsPerTask; i < end; ++i) {
+            if (!generate_distance_field(requests[i])) {
+                succeeded.store(false, std::memory_order_relaxed);
+            }
+        }
+    });
+    return succeeded.load(std::memory_order_relaxed);
+}
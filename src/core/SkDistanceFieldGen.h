@@ -51,6 +51,22 @@ bool SkGenerateDistanceFieldFromBWImage(unsigned char* distanceField,
                                         const unsigned char* image,
                                         int w, int h, size_t rowBytes);
 
+/** A mask to generate a distance field for, with SkGenerateDistanceFields(). */
+struct SkDistanceFieldRequest {
+    unsigned char*       fDistanceField;  // allocated by the client with the padding above
+    const unsigned char* fImage;
+    int                  fWidth;
+    int                  fHeight;
+    size_t               fRowBytes;
+    bool                 fIsBW;           // fImage is a 1-bit mask rather than an 8-bit one
+};
+
+/** Generates the distance fields for count masks, as SkGenerateDistanceFieldFromA8Image() and
+ *  SkGenerateDistanceFieldFromBWImage() do, using SkTaskGroup's threads.
+ *  Returns false if any of them could not be generated.
+ */
+bool SkGenerateDistanceFields(const SkDistanceFieldRequest requests[], int count);
+
 /** Given width and height of original image, return size (in bytes) of distance field
  *  @param w                 Width of the original image.
  *  @param h                 Height of the original image.
@@ -11,6 +11,7 @@
 #include "SkBlitter.h"
 #include "SkCanvas.h"
 #include "SkColorPriv.h"
+#include "SkDashPathPriv.h"
 #include "SkDevice.h"
 #include "SkDeviceLooper.h"
 #include "SkFindAndPlaceGlyph.h"
@@ -19,6 +20,7 @@
 #include "SkMatrix.h"
 #include "SkPaint.h"
 #include "SkPathEffect.h"
+#include "SkPathMeasure.h"
 #include "SkRasterClip.h"
 #include "SkRasterizer.h"
 #include "SkRRect.h"
@@ -996,6 +998,7 @@ DRAW_PATH:
     // Now fall back to the default case of using a path.
     SkPath path;
     path.addRRect(rrect);
+    path.setIsVolatile(true);
     this->drawPath(path, paint, nullptr, true);
 }
 
@@ -1013,6 +1016,36 @@ SkScalar SkDraw::ComputeResScaleForStroking(const SkMatrix& matrix) {
     return 1;
 }
 
+typedef void (*HairProc)(const SkPath&, const SkRasterClip&, SkBlitter*);
+
+static HairProc choose_hair_proc(const SkPaint& paint) {
+    if (paint.isAntiAlias()) {
+        switch (paint.getStrokeCap()) {
+            case SkPaint::kButt_Cap:
+                return SkScan::AntiHairPath;
+            case SkPaint::kSquare_Cap:
+                return SkScan::AntiHairSquarePath;
+            case SkPaint::kRound_Cap:
+                return SkScan::AntiHairRoundPath;
+            default:
+                SkDEBUGFAIL("unknown paint cap type");
+                return SkScan::AntiHairPath;
+        }
+    } else {
+        switch (paint.getStrokeCap()) {
+            case SkPaint::kButt_Cap:
+                return SkScan::HairPath;
+            case SkPaint::kSquare_Cap:
+                return SkScan::HairSquarePath;
+            case SkPaint::kRound_Cap:
+                return SkScan::HairRoundPath;
+            default:
+                SkDEBUGFAIL("unknown paint cap type");
+                return SkScan::HairPath;
+        }
+    }
+}
+
 void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawCoverage,
                          SkBlitter* customBlitter, bool doFill) const {
     // Do a conservative quick-reject test, since a looper or other modifier may have moved us
@@ -1053,7 +1086,7 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
         }
     }
 
-    void (*proc)(const SkPath&, const SkRasterClip&, SkBlitter*);
+    HairProc proc;
     if (doFill) {
         if (paint.isAntiAlias()) {
             proc = SkScan::AntiFillPath;
@@ -1061,39 +1094,348 @@ void SkDraw::drawDevPath(const SkPath& devPath, const SkPaint& paint, bool drawC
             proc = SkScan::FillPath;
         }
     } else {    // hairline
-        if (paint.isAntiAlias()) {
-            switch (paint.getStrokeCap()) {
-                case SkPaint::kButt_Cap:
-                    proc = SkScan::AntiHairPath;
-                    break;
-                case SkPaint::kSquare_Cap:
-                    proc = SkScan::AntiHairSquarePath;
-                    break;
-                case SkPaint::kRound_Cap:
-                    proc = SkScan::AntiHairRoundPath;
-                    break;
-                default:
-                    proc SK_INIT_TO_AVOID_WARNING;
-                    SkDEBUGFAIL("unknown paint cap type");
+        proc = choose_hair_proc(paint);
+    }
+    proc(devPath, *fRC, blitter);
+}
+
+namespace {
+
+// Draws a dashed hairline a few dashes at a time, through the same proc drawDevPath() would use
+// for the whole dashed path. Only those few dashes are ever held as a path.
+class HairDashVisitor : public SkDashPath::DashVisitor {
+public:
+    HairDashVisitor(const SkMatrix& matrix, const SkRasterClip& rc, SkBlitter* blitter,
+                    HairProc proc)
+        : fMatrix(matrix)
+        , fRC(rc)
+        , fBlitter(blitter)
+        , fProc(proc) {
+        fDashes.setIsVolatile(true);
+    }
+
+    void visitDash(SkPathMeasure& meas, SkScalar startD, SkScalar stopD,
+                   bool startsDash) override {
+        if (startsDash && fDashes.countPoints() >= kMaxPoints) {
+            this->flush(false);
+        }
+        meas.getSegment(startD, stopD, &fDashes, startsDash);
+    }
+
+    // With square and round caps, hair_path() also caps the next-to-last verb of a path, since
+    // RawIter::peek() reports kDone one verb early. Ending all but the last batch with a moveTo
+    // draws each dash just as it would be drawn within the whole dashed path.
+    void flush(bool last) {
+        if (!fDashes.isEmpty()) {
+            if (!last) {
+                SkPoint pt;
+                fDashes.getLastPt(&pt);
+                fDashes.moveTo(pt);
             }
+            fDashes.transform(fMatrix);
+            fProc(fDashes, fRC, fBlitter);
+            fDashes.rewind();
+        }
+    }
+
+private:
+    // Enough to amortize the setup in fProc, small enough to stay in cache.
+    static const int kMaxPoints = 256;
+
+    const SkMatrix&     fMatrix;
+    const SkRasterClip& fRC;
+    SkBlitter*          fBlitter;
+    HairProc            fProc;
+    SkPath              fDashes;
+};
+
+struct DashSegment {
+    SkPoint  fPts[2];
+    SkScalar fStartD;
+    SkScalar fStopD;
+};
+
+}  // namespace
+
+// Calls proc with the local rect of the butt-capped dash [startD, stopD] of a contour, or returns
+// false if the dash turns a corner. *segIndex is where to start looking; dashes come in order.
+template <typename RectProc>
+static bool dash_rect(const DashSegment segs[], int segCount, int* segIndex, SkScalar startD,
+                      SkScalar stopD, SkScalar radius, RectProc&& proc) {
+    stopD = SkTMin(stopD, segs[segCount - 1].fStopD);
+    if (!(startD < stopD)) {
+        return true;    // a butt-capped dash of no length draws nothing
+    }
+    int i = *segIndex;
+    while (i < segCount - 1 && segs[i].fStopD <= startD) {
+        ++i;
+    }
+    *segIndex = i;
+    const DashSegment& seg = segs[i];
+    if (stopD > seg.fStopD) {
+        return false;
+    }
+    // The segment runs along an axis, so distances along it are offsets along that axis.
+    SkScalar d0 = startD - seg.fStartD,
+             d1 = stopD - seg.fStartD;
+    SkRect r;
+    if (seg.fPts[0].fY == seg.fPts[1].fY) {
+        SkScalar x = seg.fPts[0].fX,
+                 y = seg.fPts[0].fY;
+        if (seg.fPts[1].fX > x) {
+            r.setLTRB(x + d0, y - radius, x + d1, y + radius);
         } else {
-            switch (paint.getStrokeCap()) {
-                case SkPaint::kButt_Cap:
-                    proc = SkScan::HairPath;
-                    break;
-                case SkPaint::kSquare_Cap:
-                    proc = SkScan::HairSquarePath;
-                    break;
-                case SkPaint::kRound_Cap:
-                    proc = SkScan::HairRoundPath;
+            r.setLTRB(x - d1, y - radius, x - d0, y + radius);
+        }
+    } else {
+        SkScalar x = seg.fPts[0].fX,
+                 y = seg.fPts[0].fY;
+        if (seg.fPts[1].fY > y) {
+            r.setLTRB(x - radius, y + d0, x + radius, y + d1);
+        } else {
+            r.setLTRB(x - radius, y - d1, x + radius, y - d0);
+        }
+    }
+    proc(r);
+    return true;
+}
+
+// Returns the first distance at or after d where a dash of the contour could reach cull, and sets
+// *stop to where that stretch ends; both are the contour's length if there is none. *segIndex is
+// where to start looking; d only grows.
+static SkScalar next_visible_distance(const DashSegment segs[], int segCount, int* segIndex,
+                                      SkScalar d, const SkRect& cull, SkScalar radius,
+                                      SkScalar* stop) {
+    for (; *segIndex < segCount; ++*segIndex) {
+        const DashSegment& seg = segs[*segIndex];
+        // Project the cull rect onto the segment: across it, a dash reaches radius either side.
+        bool horizontal = seg.fPts[0].fY == seg.fPts[1].fY;
+        SkScalar across = horizontal ? seg.fPts[0].fY : seg.fPts[0].fX;
+        SkScalar along0 = horizontal ? seg.fPts[0].fX : seg.fPts[0].fY;
+        SkScalar along1 = horizontal ? seg.fPts[1].fX : seg.fPts[1].fY;
+        SkScalar cullMin = horizontal ? cull.fTop : cull.fLeft;
+        SkScalar cullMax = horizontal ? cull.fBottom : cull.fRight;
+        if (across + radius < cullMin || across - radius > cullMax) {
+            continue;
+        }
+        SkScalar lo = horizontal ? cull.fLeft : cull.fTop;
+        SkScalar hi = horizontal ? cull.fRight : cull.fBottom;
+        SkScalar start, end;
+        if (along1 > along0) {
+            start = seg.fStartD + (lo - along0);
+            end   = seg.fStartD + (hi - along0);
+        } else {
+            start = seg.fStartD + (along0 - hi);
+            end   = seg.fStartD + (along0 - lo);
+        }
+        start = SkTMax(start, seg.fStartD);
+        end = SkTMin(end, seg.fStopD);
+        if (start <= end && end > d) {
+            *stop = end;
+            return SkTMax(start, d);
+        }
+    }
+    *stop = segs[segCount - 1].fStopD;
+    return *stop;
+}
+
+// Walks the dashes of a path made only of horizontal and vertical lines as SkDashPath does,
+// calling proc with the local rect of each butt-capped dash. Returns false, possibly having called
+// proc for some dashes, if the path is not like that, if a dash turns a corner, or if the dashes
+// would be given up on for being too many. If cull is not null, whole dash periods that cannot
+// reach it are skipped, as SkDashPath culls long lines.
+template <typename RectProc>
+static bool walk_dash_rects(const SkPath& path, const SkScalar intervals[], int32_t count,
+                            SkScalar initialDashLength, int32_t initialDashIndex,
+                            SkScalar intervalLength, SkScalar radius, const SkRect* cull,
+                            RectProc&& proc) {
+    SkPath::Iter iter(path, false);
+    SkPoint pts[4];
+    SkPath::Verb verb = iter.next(pts);
+    SkSTArray<16, DashSegment, true> segs;
+    SkScalar dashCount = 0;
+    // Dashes are placed by adding up intervals in double, which is exact; so is skipping ahead by
+    // whole periods of this.
+    double period = 0;
+    for (int i = 0; i < count; ++i) {
+        period += intervals[i];
+    }
+    bool firstContour = true;
+    while (SkPath::kDone_Verb != verb) {
+        // Gather a contour the way SkPathMeasure does.
+        segs.reset();
+        SkScalar length = 0;
+        bool isClosed = false;
+        bool sawMoveTo = false;
+        for (; SkPath::kDone_Verb != verb; verb = iter.next(pts)) {
+            if (SkPath::kMove_Verb == verb) {
+                if (sawMoveTo) {
                     break;
-                default:
-                    proc SK_INIT_TO_AVOID_WARNING;
-                    SkDEBUGFAIL("unknown paint cap type");
+                }
+                sawMoveTo = true;
+            } else if (SkPath::kLine_Verb == verb) {
+                if (pts[0].fX != pts[1].fX && pts[0].fY != pts[1].fY) {
+                    return false;
+                }
+                SkScalar prevD = length;
+                length += SkPoint::Distance(pts[0], pts[1]);
+                if (length > prevD) {
+                    segs.push_back({ { pts[0], pts[1] }, prevD, length });
+                }
+            } else if (SkPath::kClose_Verb == verb) {
+                isClosed = true;
+            } else {
+                return false;
+            }
+        }
+        // SkPathMeasure::nextContour() stops at the first empty contour after the first.
+        if (segs.empty()) {
+            if (!firstContour) {
+                break;
+            }
+            firstContour = false;
+            continue;
+        }
+        firstContour = false;
+
+        dashCount += length * (count >> 1) / intervalLength;
+        if (dashCount > SkDashPath::kMaxDashCount) {
+            return false;
+        }
+
+        int segIndex = 0;
+        int cullSegIndex = 0;
+        SkScalar visibleStop = 0;
+        bool skipFirstSegment = isClosed;
+        bool addedSegment = false;
+        int index = initialDashIndex;
+        double distance = 0;
+        double dlen = initialDashLength;
+        while (distance < length) {
+            // Past the stretch that may be seen, and once in phase, skip to the period before
+            // the next such stretch. The last period is always walked, so the contour ends
+            // exactly as it would have.
+            if (cull && distance >= visibleStop && dlen == intervals[index]) {
+                SkScalar target = SkTMin(next_visible_distance(segs.begin(), segs.count(),
+                                                               &cullSegIndex,
+                                                               SkDoubleToScalar(distance),
+                                                               *cull, radius, &visibleStop),
+                                         length - intervalLength);
+                double periods = floor((target - distance) / period);
+                if (periods > 0) {
+                    distance += periods * period;
+                    skipFirstSegment = false;
+                }
+            }
+            addedSegment = false;
+            if (!(index & 1) && !skipFirstSegment) {
+                addedSegment = true;
+                if (!dash_rect(segs.begin(), segs.count(), &segIndex,
+                               SkDoubleToScalar(distance), SkDoubleToScalar(distance + dlen),
+                               radius, proc)) {
+                    return false;
+                }
+            }
+            distance += dlen;
+            skipFirstSegment = false;
+            if (++index == count) {
+                index = 0;
+            }
+            dlen = intervals[index];
+        }
+
+        // A closed contour's first dash is drawn last. Joined to a last dash that runs up to the
+        // start point, it turns the corner there.
+        if (isClosed && !(initialDashIndex & 1)) {
+            if (addedSegment && initialDashLength > 0) {
+                return false;
+            }
+            segIndex = 0;
+            if (!dash_rect(segs.begin(), segs.count(), &segIndex, 0, initialDashLength, radius,
+                           proc)) {
+                return false;
             }
         }
     }
-    proc(devPath, *fRC, blitter);
+    return true;
+}
+
+// If paint dashes a butt-capped stroke along only horizontal and vertical lines, sets *rects to
+// the local rects of its dashes (those that may reach cull, if it is not null), to be filled in
+// place of the stroked dashed path. Filling them as one path covers overlapping and touching
+// dashes once, as the dashed path would.
+static bool dash_rects(const SkPath& path, const SkPaint& paint, const SkMatrix& matrix,
+                       const SkRect* cull, SkPath* rects) {
+    SkPathEffect::DashInfo info;
+    if (SkPathEffect::kDash_DashType != paint.getPathEffect()->asADash(&info) ||
+        path.isInverseFillType() || !matrix.isScaleTranslate() ||
+        SkPaint::kStroke_Style != paint.getStyle() || 0 == paint.getStrokeWidth() ||
+        SkPaint::kButt_Cap != paint.getStrokeCap() ||
+        SkPath::kLine_SegmentMask != path.getSegmentMasks()) {
+        return false;
+    }
+    // SkDashPath already culls a lone horizontal line and dashes it into rects.
+    SkPoint line[2];
+    if (path.isLine(line) && line[0].fY == line[1].fY) {
+        return false;
+    }
+    SkAutoSTMalloc<8, SkScalar> intervals(info.fCount);
+    info.fIntervals = intervals.get();
+    paint.getPathEffect()->asADash(&info);
+    if (!SkDashPath::ValidDashPath(info.fPhase, info.fIntervals, info.fCount)) {
+        return false;
+    }
+
+    SkScalar initialDashLength, intervalLength;
+    int32_t initialDashIndex;
+    SkDashPath::CalcDashParameters(info.fPhase, info.fIntervals, info.fCount,
+                                   &initialDashLength, &initialDashIndex, &intervalLength);
+    SkScalar radius = SkScalarHalf(paint.getStrokeWidth());
+    rects->reset();
+    return walk_dash_rects(path, info.fIntervals, info.fCount, initialDashLength,
+                           initialDashIndex, intervalLength, radius, cull,
+                           [rects](const SkRect& r) {
+        // One edit per dash, as SkDashPath adds its line dashes; addRect() makes five.
+        SkPoint quad[4];
+        r.toQuad(quad);
+        rects->addPoly(quad, 4, false);
+    });
+}
+
+bool SkDraw::drawDashPath(const SkPath& path, const SkPaint& paint, bool drawCoverage,
+                          SkBlitter* customBlitter) const {
+    SkPathEffect::DashInfo info;
+    if (SkPathEffect::kDash_DashType != paint.getPathEffect()->asADash(&info) ||
+        path.isInverseFillType() || fMatrix->hasPerspective()) {
+        return false;
+    }
+    SkAutoSTMalloc<8, SkScalar> intervals(info.fCount);
+    info.fIntervals = intervals.get();
+    paint.getPathEffect()->asADash(&info);
+
+    SkStrokeRec rec(paint, ComputeResScaleForStroking(*fMatrix));
+    if (!rec.isHairlineStyle()) {
+        return false;
+    }
+
+    SkBlitter* blitter = customBlitter;
+    SkAutoBlitterChoose blitterStorage;
+    if (nullptr == blitter) {
+        blitterStorage.choose(fDst, *fMatrix, paint, drawCoverage);
+        blitter = blitterStorage.get();
+    }
+
+    SkRect cullRect;
+    const SkRect* cullRectPtr = nullptr;
+    if (this->computeConservativeLocalClipBounds(&cullRect)) {
+        cullRectPtr = &cullRect;
+    }
+    HairDashVisitor visitor(*fMatrix, *fRC, blitter, choose_hair_proc(paint));
+    if (!SkDashPath::VisitDashes(path, rec, cullRectPtr, info, &visitor)) {
+        return false;
+    }
+    visitor.flush(true);
+    return true;
 }
 
 void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
@@ -1158,6 +1500,27 @@ void SkDraw::drawPath(const SkPath& origSrcPath, const SkPaint& origPaint,
         }
     }
 
+    // Dashed hairlines are drawn a few dashes at a time. Dashed strokes that are only rects are
+    // filled as those rects, without stroking the dashed path.
+    SkPath dashRects;
+    if (paint->getPathEffect() && !paint->getRasterizer() && !paint->getMaskFilter()) {
+        if (this->drawDashPath(*pathPtr, *paint, drawCoverage, customBlitter)) {
+            return;
+        }
+        SkRect cullRect;
+        const SkRect* cullRectPtr = nullptr;
+        if (this->computeConservativeLocalClipBounds(&cullRect)) {
+            cullRectPtr = &cullRect;
+        }
+        if (dash_rects(*pathPtr, *paint, *matrix, cullRectPtr, &dashRects)) {
+            dashRects.setIsVolatile(true);
+            pathPtr = &dashRects;
+            pathIsMutable = true;
+            paint.writable()->setPathEffect(nullptr);
+            paint.writable()->setStyle(SkPaint::kFill_Style);
+        }
+    }
+
     if (paint->getPathEffect() || paint->getStyle() != SkPaint::kFill_Style) {
         SkRect cullRect;
         const SkRect* cullRectPtr = nullptr;
@@ -1704,6 +2067,51 @@ void SkDraw::drawPosText(const char text[], size_t byteLength,
         offset, *fMatrix, pos, scalarsPerPosition, textAlignment, cache.get(), drawOneGlyph);
 }
 
+void SkDraw::prefetchGlyphImages(const char text[], size_t byteLength,
+                                 const SkScalar pos[], int scalarsPerPosition,
+                                 const SkPoint& offset, const SkPaint& paint) const {
+    // Below this, SkGlyphCache::prefetchImages() would not start any tasks anyway.
+    static const int kMinPrefetchGlyphs = 64;
+
+    if (text == nullptr || fRC->isEmpty() ||
+        paint.countText(text, byteLength) < kMinPrefetchGlyphs ||
+        ShouldDrawTextAsPaths(paint, *fMatrix)) {
+        return;
+    }
+
+    SkAutoGlyphCache cache(paint, &fDevice->surfaceProps(), this->scalerContextFlags(), fMatrix);
+
+    // Once the strike is warm there is nothing to generate, so skip placing every glyph again.
+    if (SkPaint::kGlyphID_TextEncoding == paint.getTextEncoding() &&
+        cache->hasImages((const SkGlyphID*)text, SkToInt(byteLength / sizeof(SkGlyphID)))) {
+        return;
+    }
+
+    // Only the glyphs that reach the clip are drawn, so only those are worth generating.
+    const SkRect clipBounds = SkRect::Make(fRC->getBounds());
+    SkTDArray<SkPackedGlyphID> ids;
+    auto collectOneGlyph = [&](const SkGlyph& glyph, SkPoint position, SkPoint rounding) {
+        position += rounding;
+        SkRect bounds = SkRect::MakeXYWH(SkScalarFloorToScalar(position.fX) + glyph.fLeft,
+                                         SkScalarFloorToScalar(position.fY) + glyph.fTop,
+                                         glyph.fWidth, glyph.fHeight);
+        if (SkRect::Intersects(bounds, clipBounds)) {
+            *ids.append() = glyph.getPackedID();
+        }
+    };
+
+    if (pos) {
+        SkFindAndPlaceGlyph::ProcessPosText(
+            paint.getTextEncoding(), text, byteLength, offset, *fMatrix, pos, scalarsPerPosition,
+            paint.getTextAlign(), cache.get(), collectOneGlyph);
+    } else {
+        SkFindAndPlaceGlyph::ProcessText(
+            paint.getTextEncoding(), text, byteLength, offset, *fMatrix, paint.getTextAlign(),
+            cache.get(), collectOneGlyph);
+    }
+    cache->prefetchImages(ids.begin(), ids.count());
+}
+
 #if defined _WIN32
 #pragma warning ( pop )
 #endif
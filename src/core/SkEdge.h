@@ -38,6 +38,10 @@ struct SkEdge {
     int setLine(const SkPoint& p0, const SkPoint& p1, const SkIRect* clip, int shiftUp);
     // call this version if you know you don't have a clip
     inline int setLine(const SkPoint& p0, const SkPoint& p1, int shiftUp);
+    // The rest of setLine(), once the ends are in FDot6 and ordered top to bottom, and
+    // top = SkFDot6Round(y0) < bot = SkFDot6Round(y1).
+    inline void setLine(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1, int top, int bot,
+                        int winding);
     inline int updateLine(SkFixed ax, SkFixed ay, SkFixed bx, SkFixed by);
     void chopLineWithClip(const SkIRect& clip);
 
@@ -119,6 +123,13 @@ int SkEdge::setLine(const SkPoint& p0, const SkPoint& p1, int shift) {
         return 0;
     }
 
+    this->setLine(x0, y0, x1, y1, top, bot, winding);
+    return 1;
+}
+
+void SkEdge::setLine(SkFDot6 x0, SkFDot6 y0, SkFDot6 x1, SkFDot6 y1, int top, int bot,
+                     int winding) {
+    SkASSERT(y0 <= y1 && top < bot);
     SkFixed slope = SkFDot6Div(x1 - x0, y1 - y0);
     const SkFDot6 dy  = SkEdge_Compute_DY(top, y0);
 
@@ -129,7 +140,6 @@ int SkEdge::setLine(const SkPoint& p0, const SkPoint& p1, int shift) {
     fCurveCount = 0;
     fWinding    = SkToS8(winding);
     fCurveShift = 0;
-    return 1;
 }
 
 #endif
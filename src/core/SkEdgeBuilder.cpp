@@ -11,6 +11,7 @@
 #include "SkEdgeClipper.h"
 #include "SkLineClipper.h"
 #include "SkGeometry.h"
+#include "SkNx.h"
 
 template <typename T> static T* typedAllocThrow(SkChunkAlloc& alloc) {
     return static_cast<T*>(alloc.allocThrow(sizeof(T)));
@@ -143,23 +144,7 @@ unallocate_analytic_edge:
             // TODO: unallocate edge from storage...
         }
     } else {
-        SkEdge* edge = typedAllocThrow<SkEdge>(fAlloc);
-        if (edge->setLine(pts[0], pts[1], fShiftUp)) {
-            if (vertical_line(edge) && fList.count()) {
-                Combine combine = CombineVertical(edge, (SkEdge*)*(fList.end() - 1));
-                if (kNo_Combine != combine) {
-                    if (kTotal_Combine == combine) {
-                        fList.pop();
-                    }
-                    goto unallocate_edge;
-                }
-            }
-            fList.push(edge);
-        } else {
-unallocate_edge:
-            ;
-            // TODO: unallocate edge from storage...
-        }
+        this->addLine(pts[0], pts[1]);
     }
 }
 
@@ -172,6 +157,7 @@ void SkEdgeBuilder::addQuad(const SkPoint pts[]) {
             // TODO: unallocate edge from storage...
         }
     } else {
+        this->flushLines();  // so edges stay in path order
         SkQuadraticEdge* edge = typedAllocThrow<SkQuadraticEdge>(fAlloc);
         if (edge->setQuadratic(pts, fShiftUp)) {
             fList.push(edge);
@@ -190,6 +176,7 @@ void SkEdgeBuilder::addCubic(const SkPoint pts[]) {
             // TODO: unallocate edge from storage...
         }
     } else {
+        this->flushLines();
         SkCubicEdge* edge = typedAllocThrow<SkCubicEdge>(fAlloc);
         if (edge->setCubic(pts, fShiftUp)) {
             fList.push(edge);
@@ -222,6 +209,109 @@ void SkEdgeBuilder::addClipper(SkEdgeClipper* clipper) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+void SkEdgeBuilder::addLine(const SkPoint& p0, const SkPoint& p1) {
+    SkASSERT(!fAnalyticAA);
+    LineBatch* batch = &fLines;
+    int i = batch->fCount++;
+    batch->fX0[i] = p0.fX;
+    batch->fY0[i] = p0.fY;
+    batch->fX1[i] = p1.fX;
+    batch->fY1[i] = p1.fY;
+    if (LineBatch::kMaxLines == batch->fCount) {
+        this->flushLines();
+    }
+}
+
+// Does what SkEdge::setLine() would for each line in turn, but converts the ends to FDot6,
+// orders them and rounds them to rows four lines at a time.
+void SkEdgeBuilder::flushLines() {
+    LineBatch* batch = &fLines;
+    const int count = batch->fCount;
+    batch->fCount = 0;
+
+    SkFDot6 x0[LineBatch::kMaxLines], y0[LineBatch::kMaxLines],
+            x1[LineBatch::kMaxLines], y1[LineBatch::kMaxLines];
+    int32_t top[LineBatch::kMaxLines], bot[LineBatch::kMaxLines], flip[LineBatch::kMaxLines];
+#ifdef SK_RASTERIZE_EVEN_ROUNDING
+    for (int i = 0; i < count; i++) {
+        x0[i] = SkScalarRoundToFDot6(batch->fX0[i], fShiftUp);
+        y0[i] = SkScalarRoundToFDot6(batch->fY0[i], fShiftUp);
+        x1[i] = SkScalarRoundToFDot6(batch->fX1[i], fShiftUp);
+        y1[i] = SkScalarRoundToFDot6(batch->fY1[i], fShiftUp);
+        flip[i] = y0[i] > y1[i];
+        if (flip[i]) {
+            SkTSwap(x0[i], x1[i]);
+            SkTSwap(y0[i], y1[i]);
+        }
+        top[i] = SkFDot6Round(y0[i]);
+        bot[i] = SkFDot6Round(y1[i]);
+    }
+#else
+    // The tail of the last group of four are zero-height lines, which make no edges.
+    for (int i = count; i < SkAlign4(count); i++) {
+        batch->fX0[i] = batch->fY0[i] = batch->fX1[i] = batch->fY1[i] = 0;
+    }
+    const Sk4f scale(float(1 << (fShiftUp + 6)));
+    for (int i = 0; i < count; i += 4) {
+        Sk4i ax = SkNx_cast<int>(Sk4f::Load(batch->fX0 + i) * scale),
+             ay = SkNx_cast<int>(Sk4f::Load(batch->fY0 + i) * scale),
+             bx = SkNx_cast<int>(Sk4f::Load(batch->fX1 + i) * scale),
+             by = SkNx_cast<int>(Sk4f::Load(batch->fY1 + i) * scale);
+        Sk4i flipped = ay > by;
+        Sk4i topY = flipped.thenElse(by, ay),
+             botY = flipped.thenElse(ay, by);
+        flipped.thenElse(bx, ax).store(x0 + i);
+        topY.store(y0 + i);
+        flipped.thenElse(ax, bx).store(x1 + i);
+        botY.store(y1 + i);
+        flipped.store(flip + i);
+        ((topY + 32) >> 6).store(top + i);
+        ((botY + 32) >> 6).store(bot + i);
+    }
+#endif
+
+    if (!batch->fEdgePtr) {
+        for (int i = 0; i < count; i++) {
+            // are we a zero-height line?
+            if (top[i] == bot[i]) {
+                continue;
+            }
+            SkEdge* edge = typedAllocThrow<SkEdge>(fAlloc);
+            edge->setLine(x0[i], y0[i], x1[i], y1[i], top[i], bot[i], flip[i] ? -1 : 1);
+            if (vertical_line(edge) && fList.count()) {
+                Combine combine = CombineVertical(edge, (SkEdge*)*(fList.end() - 1));
+                if (kNo_Combine != combine) {
+                    if (kTotal_Combine == combine) {
+                        fList.pop();
+                    }
+                    continue;
+                }
+            }
+            fList.push(edge);
+        }
+        return;
+    }
+
+    SkEdge* edge = batch->fEdge;
+    SkEdge** edgePtr = batch->fEdgePtr;
+    for (int i = 0; i < count; i++) {
+        // are we a zero-height line?
+        if (top[i] == bot[i]) {
+            continue;
+        }
+        edge->setLine(x0[i], y0[i], x1[i], y1[i], top[i], bot[i], flip[i] ? -1 : 1);
+        Combine combine = checkVertical(edge, edgePtr);
+        if (kNo_Combine == combine) {
+            *edgePtr++ = edge;
+            edge++;
+        } else if (kTotal_Combine == combine) {
+            --edgePtr;
+        }
+    }
+    batch->fEdge = edge;
+    batch->fEdgePtr = edgePtr;
+}
+
 static void setShiftedClip(SkRect* dst, const SkIRect& src, int shift) {
     dst->set(SkIntToScalar(src.fLeft >> shift),
              SkIntToScalar(src.fTop >> shift),
@@ -265,6 +355,9 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
     // Record the beginning of our pointers, so we can return them to the caller
     fEdgeList = (void**)edgePtr;
 
+    fLines.fEdge = (SkEdge*)edge;
+    fLines.fEdgePtr = (SkEdge**)edgePtr;
+
     if (iclip) {
         SkRect clip;
         setShiftedClip(&clip, *iclip, shiftUp);
@@ -281,13 +374,11 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
                     int lineCount = SkLineClipper::ClipLine(pts, clip, lines, canCullToTheRight);
                     SkASSERT(lineCount <= SkLineClipper::kMaxClippedLineSegments);
                     for (int i = 0; i < lineCount; i++) {
-                        bool setLineResult = fAnalyticAA ?
-                                ((SkAnalyticEdge*)edge)->setLine(lines[i], lines[i + 1]) :
-                                ((SkEdge*)edge)->setLine(lines[i], lines[i + 1], shiftUp);
-                        if (setLineResult) {
-                            Combine combine = fAnalyticAA ?
-                                    checkVertical((SkAnalyticEdge*)edge, (SkAnalyticEdge**)edgePtr) :
-                                    checkVertical((SkEdge*)edge, (SkEdge**)edgePtr);
+                        if (!fAnalyticAA) {
+                            this->addLine(lines[i], lines[i + 1]);
+                        } else if (((SkAnalyticEdge*)edge)->setLine(lines[i], lines[i + 1])) {
+                            Combine combine = checkVertical((SkAnalyticEdge*)edge,
+                                                            (SkAnalyticEdge**)edgePtr);
                             if (kNo_Combine == combine) {
                                 *edgePtr++ = edge;
                                 edge += edgeSize;
@@ -312,13 +403,11 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
                     // the corresponding line/quad/cubic verbs
                     break;
                 case SkPath::kLine_Verb: {
-                    bool setLineResult = fAnalyticAA ?
-                            ((SkAnalyticEdge*)edge)->setLine(pts[0], pts[1]) :
-                            ((SkEdge*)edge)->setLine(pts[0], pts[1], shiftUp);
-                    if (setLineResult) {
-                        Combine combine = fAnalyticAA ?
-                                checkVertical((SkAnalyticEdge*)edge, (SkAnalyticEdge**)edgePtr) :
-                                checkVertical((SkEdge*)edge, (SkEdge**)edgePtr);
+                    if (!fAnalyticAA) {
+                        this->addLine(pts[0], pts[1]);
+                    } else if (((SkAnalyticEdge*)edge)->setLine(pts[0], pts[1])) {
+                        Combine combine = checkVertical((SkAnalyticEdge*)edge,
+                                                        (SkAnalyticEdge**)edgePtr);
                         if (kNo_Combine == combine) {
                             *edgePtr++ = edge;
                             edge += edgeSize;
@@ -334,6 +423,11 @@ int SkEdgeBuilder::buildPoly(const SkPath& path, const SkIRect* iclip, int shift
             }
         }
     }
+    if (!fAnalyticAA) {
+        this->flushLines();
+        edge = (char*)fLines.fEdge;
+        edgePtr = (char**)fLines.fEdgePtr;
+    }
     SkASSERT((char*)edge <= (char*)fEdgeList);
     SkASSERT(edgePtr - (char**)fEdgeList <= maxEdgeCount);
     return SkToInt(edgePtr - (char**)fEdgeList);
@@ -353,6 +447,9 @@ int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip, int shiftUp,
     fList.reset();
     fShiftUp = shiftUp;
     fAnalyticAA = analyticAA;
+    fLines.fCount = 0;
+    fLines.fEdge = nullptr;
+    fLines.fEdgePtr = nullptr;
 
     if (SkPath::kLine_SegmentMask == path.getSegmentMasks()) {
         return this->buildPoly(path, iclip, shiftUp, canCullToTheRight);
@@ -447,6 +544,9 @@ int SkEdgeBuilder::build(const SkPath& path, const SkIRect* iclip, int shiftUp,
             }
         }
     }
+    if (!fAnalyticAA) {
+        this->flushLines();
+    }
     fEdgeList = fList.begin();
     return fList.count();
 }
@@ -42,6 +42,19 @@ private:
     bool vertical_line(const SkEdge* edge);
     bool vertical_line(const SkAnalyticEdge* edge);
 
+    // Lines for SkEdges wait here, to be set up several at a time by flushLines().
+    struct LineBatch {
+        static const int kMaxLines = 64;  // a multiple of 4
+
+        float    fX0[kMaxLines], fY0[kMaxLines], fX1[kMaxLines], fY1[kMaxLines];
+        int      fCount;
+        // buildPoly() places the edges and their pointers itself; otherwise they go in fList.
+        SkEdge*  fEdge;
+        SkEdge** fEdgePtr;
+    };
+    void addLine(const SkPoint& p0, const SkPoint& p1);
+    void flushLines();
+
     SkChunkAlloc        fAlloc;
     SkTDArray<void*>    fList;
 
@@ -55,6 +68,7 @@ private:
 
     int         fShiftUp;
     bool        fAnalyticAA;
+    LineBatch   fLines;
 
 public:
     void addLine(const SkPoint pts[]);
@@ -9,12 +9,15 @@
 #include "SkGlyphCache_Globals.h"
 #include "SkGraphics.h"
 #include "SkOnce.h"
+#include "SkMutex.h"
 #include "SkPath.h"
+#include "SkTaskGroup.h"
 #include "SkTemplates.h"
 #include "SkTraceMemoryDump.h"
 #include "SkTypeface.h"
 
 #include <cctype>
+#include <vector>
 
 //#define SPEW_PURGE_STATUS
 
@@ -206,6 +209,102 @@ const void* SkGlyphCache::findImage(const SkGlyph& glyph) {
     return glyph.fImage;
 }
 
+// Each prefetch task rasterizes this many glyphs; fewer than two tasks' worth are done in place.
+static const int kPrefetchGlyphsPerTask = 32;
+
+void SkGlyphCache::prefetchImages(const SkPackedGlyphID ids[], int count) {
+    VALIDATE();
+    for (int i = 0; i < count; i++) {
+        this->lookupByPackedGlyphID(ids[i], kFull_MetricsType);
+    }
+
+    // No glyphs are added from here on, so pointers into fGlyphMap stay valid. Allocating the
+    // images up front also means a glyph listed twice is only generated once.
+    SkTDArray<const SkGlyph*> pending;
+    for (int i = 0; i < count; i++) {
+        SkGlyph* glyph = fGlyphMap.find(ids[i]);
+        if (glyph->fWidth > 0 && glyph->fWidth < kMaxGlyphWidth && nullptr == glyph->fImage) {
+            size_t size = glyph->computeImageSize();
+            glyph->fImage = fGlyphAlloc.alloc(size, SkChunkAlloc::kReturnNil_AllocFailType);
+            if (glyph->fImage) {
+                fMemoryUsed += size;
+                *pending.append() = glyph;
+            }
+        }
+    }
+
+    if (pending.count() < 2 * kPrefetchGlyphsPerTask) {
+        for (const SkGlyph* glyph : pending) {
+            fScalerContext->getImage(*glyph);
+        }
+        return;
+    }
+
+    // Tasks take an idle scaler context, or make one if there is none. This thread is blocked
+    // until the tasks are done, so our own context starts out idle, as do those made by earlier
+    // calls; without worker threads our own is the only one ever used.
+    SkMutex mutex;
+    SkTDArray<SkScalerContext*> idle;
+    SkTDArray<int> failed;
+    *idle.append() = fScalerContext.get();
+    for (const auto& ctx : fPrefetchContexts) {
+        *idle.append() = ctx.get();
+    }
+
+    const int taskCount = (pending.count() + kPrefetchGlyphsPerTask - 1) / kPrefetchGlyphsPerTask;
+    auto generate = [&](SkScalerContext* ctx, int task) {
+        int start = task * kPrefetchGlyphsPerTask;
+        int stop = SkTMin(start + kPrefetchGlyphsPerTask, pending.count());
+        for (int i = start; i < stop; i++) {
+            ctx->getImage(*pending[i]);
+        }
+    };
+
+    SkTaskGroup tasks;
+    tasks.batch(taskCount, [&](int task) {
+        SkScalerContext* ctx = nullptr;
+        {
+            SkAutoMutexAcquire lock(mutex);
+            if (!idle.isEmpty()) {
+                idle.pop(&ctx);
+            }
+        }
+        if (!ctx) {
+            std::unique_ptr<SkScalerContext> newCtx = fScalerContext->getTypeface()->
+                    createScalerContext(fScalerContext->getEffects(), fDesc.get(), true);
+            SkAutoMutexAcquire lock(mutex);
+            if (!newCtx) {
+                // Out of font resources; leave this task for later, on our own context.
+                *failed.append() = task;
+                return;
+            }
+            ctx = newCtx.get();
+            fPrefetchContexts.push_back(std::move(newCtx));
+        }
+        generate(ctx, task);
+        SkAutoMutexAcquire lock(mutex);
+        *idle.append() = ctx;
+    });
+    tasks.wait();
+
+    for (int task : failed) {
+        generate(fScalerContext.get(), task);
+    }
+}
+
+bool SkGlyphCache::hasImages(const SkGlyphID glyphIDs[], int count) const {
+    for (int i = 0; i < count; i++) {
+        const SkGlyph* glyph = fGlyphMap.find(SkPackedGlyphID(glyphIDs[i]));
+        if (!glyph || glyph->isJustAdvance()) {
+            return false;
+        }
+        if (glyph->fWidth > 0 && glyph->fWidth < kMaxGlyphWidth && nullptr == glyph->fImage) {
+            return false;
+        }
+    }
+    return true;
+}
+
 const SkPath* SkGlyphCache::findPath(const SkGlyph& glyph) {
     if (glyph.fWidth) {
         if (glyph.fPathData == nullptr) {
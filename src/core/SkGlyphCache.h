@@ -17,6 +17,7 @@
 #include "SkTemplates.h"
 #include "SkTDArray.h"
 #include <memory>
+#include <vector>
 
 class SkTraceMemoryDump;
 
@@ -78,6 +79,19 @@ public:
     */
     const void* findImage(const SkGlyph&);
 
+    /** Generate the images of the glyphs that do not have one yet, as findImage() would, but
+        spread over SkTaskGroup threads. The strike's scaler context is not thread-safe, so each
+        thread borrows a context of its own, made from the same descriptor and kept for reuse.
+    */
+    void prefetchImages(const SkPackedGlyphID ids[], int count);
+
+    /** Return true if each of the glyphs, at a subpixel offset of zero, is cached with its image
+        (or needs none). This only probes the cache, so it is a cheap way to tell that
+        prefetchImages() would have nothing to do; for subpixel strikes it is a heuristic, as the
+        glyphs may be drawn at other offsets.
+    */
+    bool hasImages(const SkGlyphID glyphIDs[], int count) const;
+
     /** If the advance axis intersects the glyph's path, append the positions scaled and offset
         to the array (if non-null), and set the count to the updated array length.
     */
@@ -230,6 +244,8 @@ private:
     SkGlyphCache*          fPrev;
     const std::unique_ptr<SkDescriptor> fDesc;
     const std::unique_ptr<SkScalerContext> fScalerContext;
+    // Extra contexts made by prefetchImages(), kept to be borrowed again by its next call.
+    std::vector<std::unique_ptr<SkScalerContext>> fPrefetchContexts;
     SkPaint::FontMetrics   fFontMetrics;
 
     // Map from a combined GlyphID and sub-pixel position to a SkGlyph.
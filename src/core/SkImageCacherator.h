@@ -31,6 +31,8 @@ public:
 
     const SkImageInfo& info() const { return fInfo; }
     uint32_t uniqueID() const { return fUniqueIDs[kLegacy_CachedFormat]; }
+    // Where info() sits in the generator's output; non-zero for some subsets.
+    const SkIPoint& origin() const { return fOrigin; }
 
     enum CachedFormat {
         kLegacy_CachedFormat,    // The format from the generator, with any color space stripped out
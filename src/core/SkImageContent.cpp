@@ -0,0 +1,150 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkColorSpace.h"
+#include "SkData.h"
+#include "SkImageCacherator.h"
+#include "SkImageContent.h"
+#include "SkImage_Base.h"
+#include "SkOpts.h"
+#include "SkPixmap.h"
+
+// Contents up to this size are pre-hashed in full. Bigger ones are sampled in kSamples pieces,
+// spread evenly from the start to the end.
+static const size_t kFullHashBytes = 64 * 1024;
+static const int    kSamples       = 16;
+static const size_t kSampleBytes   = kFullHashBytes / kSamples;
+
+namespace {
+
+struct Contents {
+    sk_sp<SkData> fEncoded;  // Either this,
+    SkPixmap      fPixels;   // or this.
+
+    bool init(const SkImage* image) {
+        if (SkImageCacherator* cacherator = as_IB(image)->peekCacherator()) {
+            // Subsets share the encoded data of the whole image. With the same origin, the
+            // dimensions are enough to tell them apart; with another, they are not.
+            if (cacherator->origin().isZero()) {
+                fEncoded.reset(image->refEncoded());
+            }
+            return fEncoded != nullptr;
+        }
+        return image->peekPixels(&fPixels);
+    }
+
+    size_t rowBytes() const { return fPixels.info().minRowBytes(); }
+
+    // Everything but the bytes themselves.
+    void header(const SkImage* image, uint32_t header[5]) const {
+        header[0] = image->width();
+        header[1] = image->height();
+        if (fEncoded) {
+            header[2] = header[3] = ~0u;
+            header[4] = SkToU32(fEncoded->size());
+        } else {
+            header[2] = fPixels.colorType();
+            header[3] = fPixels.alphaType();
+            header[4] = fPixels.colorSpace() ? 1 : 0;
+        }
+    }
+};
+
+}  // namespace
+
+bool SkImageContent::PreHash(const SkImage* image, uint32_t* hash) {
+    Contents contents;
+    if (!contents.init(image)) {
+        return false;
+    }
+    uint32_t header[5];
+    contents.header(image, header);
+    uint32_t h = SkOpts::hash(header, sizeof(header), 0);
+
+    if (contents.fEncoded) {
+        const uint8_t* bytes = contents.fEncoded->bytes();
+        size_t size = contents.fEncoded->size();
+        if (size <= kFullHashBytes) {
+            h = SkOpts::hash(bytes, size, h);
+        } else {
+            for (int i = 0; i < kSamples; i++) {
+                size_t offset = (size - kSampleBytes) / (kSamples - 1) * i;
+                h = SkOpts::hash(bytes + offset, kSampleBytes, h);
+            }
+        }
+    } else {
+        const SkPixmap& pm = contents.fPixels;
+        size_t rowBytes = contents.rowBytes();
+        if (rowBytes * pm.height() <= kFullHashBytes) {
+            for (int y = 0; y < pm.height(); y++) {
+                h = SkOpts::hash(pm.addr(0, y), rowBytes, h);
+            }
+        } else {
+            // A sample of rows, and no more than kSampleBytes from the middle of each.
+            size_t length = SkTMin(rowBytes, kSampleBytes),
+                   offset = (rowBytes - length) / 2;
+            for (int i = 0; i < kSamples; i++) {
+                int y = (pm.height() - 1) * i / (kSamples - 1);
+                h = SkOpts::hash((const char*)pm.addr(0, y) + offset, length, h);
+            }
+        }
+    }
+    *hash = h;
+    return true;
+}
+
+bool SkImageContent::Equals(const SkImage* a, const SkImage* b) {
+    Contents ca, cb;
+    if (!ca.init(a) || !cb.init(b) || a->dimensions() != b->dimensions()) {
+        return false;
+    }
+    if (ca.fEncoded || cb.fEncoded) {
+        return ca.fEncoded && cb.fEncoded && ca.fEncoded->equals(cb.fEncoded.get());
+    }
+    const SkPixmap& pa = ca.fPixels;
+    const SkPixmap& pb = cb.fPixels;
+    if (pa.colorType() != pb.colorType() || pa.alphaType() != pb.alphaType() ||
+        !SkColorSpace::Equals(pa.colorSpace(), pb.colorSpace())) {
+        return false;
+    }
+    size_t rowBytes = ca.rowBytes();
+    for (int y = 0; y < pa.height(); y++) {
+        if (0 != memcmp(pa.addr(0, y), pb.addr(0, y), rowBytes)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SkImageContent::Fingerprint(const SkImage* image, SkMD5::Digest* digest) {
+    Contents contents;
+    if (!contents.init(image)) {
+        return false;
+    }
+    uint32_t header[5];
+    contents.header(image, header);
+
+    SkMD5 md5;
+    md5.write(header, sizeof(header));
+    if (contents.fEncoded) {
+        md5.write(contents.fEncoded->data(), contents.fEncoded->size());
+    } else {
+        const SkPixmap& pm = contents.fPixels;
+        if (pm.colorSpace()) {
+            sk_sp<SkData> colorSpace = pm.colorSpace()->serialize();
+            if (colorSpace) {
+                md5.write(colorSpace->data(), colorSpace->size());
+            }
+        }
+        size_t rowBytes = contents.rowBytes();
+        for (int y = 0; y < pm.height(); y++) {
+            md5.write(pm.addr(0, y), rowBytes);
+        }
+    }
+    md5.finish(*digest);
+    return true;
+}
@@ -0,0 +1,41 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkImageContent_DEFINED
+#define SkImageContent_DEFINED
+
+#include "SkMD5.h"
+
+class SkImage;
+
+/**
+ *  Recognizes images with the same contents under different uniqueIDs (e.g. the same file decoded
+ *  twice), so that serializers can store each distinct image once.
+ *
+ *  An image's contents are its encoded data if it has some, and otherwise its pixels if they can
+ *  be read without decoding or a GPU readback. Other images have no contents as far as these
+ *  functions are concerned: they return false, and such images only ever match themselves.
+ */
+namespace SkImageContent {
+    /**
+     *  A cheap hash of the dimensions and a sample of the contents; images with equal contents
+     *  have equal pre-hashes. Large images are sampled, so equal pre-hashes must be confirmed
+     *  with Equals().
+     */
+    bool PreHash(const SkImage*, uint32_t* hash);
+
+    /** True if both images have contents, and they are the same. */
+    bool Equals(const SkImage*, const SkImage*);
+
+    /**
+     *  An MD5 digest of the dimensions and all of the contents, for callers that cannot keep
+     *  images around to compare them.
+     */
+    bool Fingerprint(const SkImage*, SkMD5::Digest*);
+}
+
+#endif//SkImageContent_DEFINED
@@ -42,6 +42,7 @@
 #include "SkBlitRow_opts.h"
 #include "SkBlurImageFilter_opts.h"
 #include "SkChecksum_opts.h"
+#include "SkDeflate_opts.h"
 #include "SkColorCubeFilter_opts.h"
 #include "SkMorphologyImageFilter_opts.h"
 #include "SkRasterPipeline_opts.h"
@@ -90,6 +91,9 @@ namespace SkOpts {
 
     DEFINE_DEFAULT(hash_fn);
 
+    DEFINE_DEFAULT(adler32);
+    DEFINE_DEFAULT(gzip_crc32);
+
     DEFINE_DEFAULT(run_pipeline);
     DEFINE_DEFAULT(compile_pipeline);
 
@@ -75,6 +75,11 @@ namespace SkOpts {
         return hash_fn(data, bytes, seed);
     }
 
+    // The checksums of zlib (Adler-32) and gzip (CRC-32) streams, with zlib's semantics:
+    // pass 1 and 0 respectively to start a new checksum.
+    extern uint32_t (*adler32)(uint32_t adler, const uint8_t*, size_t);
+    extern uint32_t (*gzip_crc32)(uint32_t crc, const uint8_t*, size_t);
+
     extern void (*run_pipeline)(size_t, size_t, size_t, const SkRasterPipeline::Stage*, int);
     extern std::function<void(size_t, size_t, size_t)>
     (*compile_pipeline)(const SkRasterPipeline::Stage*, int);
@@ -1970,6 +1970,8 @@ bool SkPaint::getFillPath(const SkPath& src, SkPath* dst, const SkRect* cullRect
     SkPath tmpPath;
 
     if (fPathEffect && fPathEffect->filterPath(&tmpPath, src, &rec, cullRect)) {
+        // a new path every time, so there is no point in caching its stroke
+        tmpPath.setIsVolatile(true);
         srcPtr = &tmpPath;
     }
 
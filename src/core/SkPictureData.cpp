@@ -9,6 +9,7 @@
 #include "SkPictureData.h"
 #include "SkPictureRecord.h"
 #include "SkReadBuffer.h"
+#include "SkTaskGroup.h"
 #include "SkTextBlob.h"
 #include "SkTypeface.h"
 #include "SkWriteBuffer.h"
@@ -104,6 +105,9 @@ void SkPictureData::init() {
     fImageRefs = nullptr;
     fImageCount = 0;
     fFactoryPlayback = nullptr;
+    fSkipOpData = false;
+    fOpDataOffset = 0;
+    fOpDataSize = 0;
 }
 
 SkPictureData::~SkPictureData() {
@@ -219,36 +223,58 @@ void SkPictureData::WriteTypefaces(SkWStream* stream, const SkRefCntSet& rec) {
     }
 }
 
-void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
+void SkPictureData::flattenSection(BufferSection section, SkWriteBuffer& buffer,
+                                   const sk_sp<SkData>* encodedImages) const {
     int i, n;
 
-    if ((n = fPaints.count()) > 0) {
-        write_tag_size(buffer, SK_PICT_PAINT_BUFFER_TAG, n);
-        for (i = 0; i < n; i++) {
-            buffer.writePaint(fPaints[i]);
-        }
-    }
-
-    if ((n = fPaths.count()) > 0) {
-        write_tag_size(buffer, SK_PICT_PATH_BUFFER_TAG, n);
-        buffer.writeInt(n);
-        for (int i = 0; i < n; i++) {
-            buffer.writePath(fPaths[i]);
-        }
-    }
-
-    if (fTextBlobCount > 0) {
-        write_tag_size(buffer, SK_PICT_TEXTBLOB_BUFFER_TAG, fTextBlobCount);
-        for (i = 0; i  < fTextBlobCount; ++i) {
-            fTextBlobRefs[i]->flatten(buffer);
-        }
+    switch (section) {
+        case kPaint_BufferSection:
+            if ((n = fPaints.count()) > 0) {
+                write_tag_size(buffer, SK_PICT_PAINT_BUFFER_TAG, n);
+                for (i = 0; i < n; i++) {
+                    buffer.writePaint(fPaints[i]);
+                }
+            }
+            break;
+        case kPath_BufferSection:
+            if ((n = fPaths.count()) > 0) {
+                write_tag_size(buffer, SK_PICT_PATH_BUFFER_TAG, n);
+                buffer.writeInt(n);
+                for (i = 0; i < n; i++) {
+                    buffer.writePath(fPaths[i]);
+                }
+            }
+            break;
+        case kTextBlob_BufferSection:
+            if (fTextBlobCount > 0) {
+                write_tag_size(buffer, SK_PICT_TEXTBLOB_BUFFER_TAG, fTextBlobCount);
+                for (i = 0; i  < fTextBlobCount; ++i) {
+                    fTextBlobRefs[i]->flatten(buffer);
+                }
+            }
+            break;
+        case kImage_BufferSection:
+            if (fImageCount > 0) {
+                write_tag_size(buffer, SK_PICT_IMAGE_BUFFER_TAG, fImageCount);
+                for (i = 0; i  < fImageCount; ++i) {
+                    if (encodedImages) {
+                        static_cast<SkBinaryWriteBuffer&>(buffer).writeEncodedImage(
+                                fImageRefs[i], encodedImages[i].get());
+                    } else {
+                        buffer.writeImage(fImageRefs[i]);
+                    }
+                }
+            }
+            break;
+        case kBufferSectionCount:
+            SkASSERT(false);
+            break;
     }
+}
 
-    if (fImageCount > 0) {
-        write_tag_size(buffer, SK_PICT_IMAGE_BUFFER_TAG, fImageCount);
-        for (i = 0; i  < fImageCount; ++i) {
-            buffer.writeImage(fImageRefs[i]);
-        }
+void SkPictureData::flattenToBuffer(SkWriteBuffer& buffer) const {
+    for (int i = 0; i < kBufferSectionCount; i++) {
+        this->flattenSection((BufferSection)i, buffer);
     }
 }
 
@@ -264,26 +290,65 @@ void SkPictureData::serialize(SkWStream* stream,
     SkRefCntSet* typefaceSet = topLevelTypeFaceSet ? topLevelTypeFaceSet : &localTypefaceSet;
 
     // We delay serializing the bulk of our data until after we've serialized
-    // factories and typefaces by first serializing to an in-memory write buffer.
-    SkFactorySet factSet;  // buffer refs factSet, so factSet must come first.
-    SkBinaryWriteBuffer buffer(SkBinaryWriteBuffer::kCrossProcess_Flag);
-    buffer.setFactoryRecorder(&factSet);
-    buffer.setPixelSerializer(sk_ref_sp(pixelSerializer));
-    buffer.setTypefaceRecorder(typefaceSet);
-    this->flattenToBuffer(buffer);
+    // factories and typefaces by first serializing to in-memory write buffers.
+    //
+    // Each section goes to a buffer of its own. Paths need neither factories nor typefaces, so
+    // their section is written on another thread while this one writes the paints and text
+    // blobs. The buffers are then written out in section order, so the result is the same as
+    // flattenToBuffer() writing them all to one buffer. Images are encoded in parallel too, if
+    // the serializer allows.
+    SkFactorySet factSet;  // buffers ref factSet, so factSet must come first.
+    static_assert(kBufferSectionCount == 4, "one initializer per buffer section");
+    const uint32_t kFlags = SkBinaryWriteBuffer::kCrossProcess_Flag;
+    SkBinaryWriteBuffer buffers[kBufferSectionCount] = { {kFlags}, {kFlags}, {kFlags}, {kFlags} };
+    for (BufferSection section : { kPaint_BufferSection, kTextBlob_BufferSection }) {
+        buffers[section].setFactoryRecorder(&factSet);
+        buffers[section].setPixelSerializer(sk_ref_sp(pixelSerializer));
+        buffers[section].setTypefaceRecorder(typefaceSet);
+    }
+
+    SkAutoTArray<sk_sp<SkData>> encodedImages(fImageCount);
+    auto encode = [&](int i) {
+        encodedImages[i].reset(fImageRefs[i]->encode(pixelSerializer));
+    };
+    // Texture-backed images are read back through their GrContext, which is not thread safe,
+    // so they are always encoded on this thread.
+    bool encodeInParallel = !pixelSerializer || pixelSerializer->isThreadSafe();
+    auto encodeHere = [&](int i) {
+        return !encodeInParallel || fImageRefs[i]->isTextureBacked();
+    };
+
+    SkTaskGroup tg;
+    if (fPaths.count() > 0) {
+        tg.add([&] { this->flattenSection(kPath_BufferSection, buffers[kPath_BufferSection]); });
+    }
+    if (encodeInParallel) {
+        tg.batch(fImageCount, [&](int i) {
+            if (!encodeHere(i)) {
+                encode(i);
+            }
+        });
+    }
+
+    this->flattenSection(kPaint_BufferSection, buffers[kPaint_BufferSection]);
+    this->flattenSection(kTextBlob_BufferSection, buffers[kTextBlob_BufferSection]);
+    for (int i = 0; i < fImageCount; ++i) {
+        if (encodeHere(i)) {
+            encode(i);
+        }
+    }
 
-    // Dummy serialize our sub-pictures for the side effect of filling
-    // typefaceSet with typefaces from sub-pictures.
-    struct DevNull: public SkWStream {
-        DevNull() : fBytesWritten(0) {}
-        size_t fBytesWritten;
-        bool write(const void*, size_t size) override { fBytesWritten += size; return true; }
-        size_t bytesWritten() const override { return fBytesWritten; }
-    } devnull;
+    // Serialize our sub-pictures now, for the side effect of filling typefaceSet with their
+    // typefaces, and write them out after our buffer.
+    SkDynamicMemoryWStream subPictures;
     for (int i = 0; i < fPictureCount; i++) {
-        fPictureRefs[i]->serialize(&devnull, pixelSerializer, typefaceSet);
+        fPictureRefs[i]->serialize(&subPictures, pixelSerializer, typefaceSet);
     }
 
+    tg.wait();
+    this->flattenSection(kImage_BufferSection, buffers[kImage_BufferSection],
+                         encodedImages.get());
+
     // We need to write factories before we write the buffer.
     // We need to write typefaces before we write the buffer or any sub-picture.
     WriteFactories(stream, factSet);
@@ -291,16 +356,20 @@ void SkPictureData::serialize(SkWStream* stream,
         WriteTypefaces(stream, *typefaceSet);
     }
 
-    // Write the buffer.
-    write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, buffer.bytesWritten());
-    buffer.writeToStream(stream);
+    // Write the buffers.
+    size_t bufferSize = 0;
+    for (const SkBinaryWriteBuffer& buffer : buffers) {
+        bufferSize += buffer.bytesWritten();
+    }
+    write_tag_size(stream, SK_PICT_BUFFER_SIZE_TAG, bufferSize);
+    for (SkBinaryWriteBuffer& buffer : buffers) {
+        buffer.writeToStream(stream);
+    }
 
-    // Write sub-pictures by calling serialize again.
+    // Write sub-pictures.
     if (fPictureCount > 0) {
         write_tag_size(stream, SK_PICT_PICTURE_TAG, fPictureCount);
-        for (int i = 0; i < fPictureCount; i++) {
-            fPictureRefs[i]->serialize(stream, pixelSerializer, typefaceSet);
-        }
+        subPictures.writeToStream(stream);
     }
 
     stream->write32(SK_PICT_EOF_TAG);
@@ -373,6 +442,12 @@ bool SkPictureData::parseStreamTag(SkStream* stream,
     switch (tag) {
         case SK_PICT_READER_TAG:
             SkASSERT(nullptr == fOpData);
+            if (fSkipOpData) {
+                fOpDataOffset = stream->getPosition();
+                fOpDataSize = size;
+                fOpData = SkData::MakeEmpty();
+                return stream->skip(size) == size;
+            }
             fOpData = SkData::MakeFromStream(stream, size);
             if (!fOpData) {
                 return false;
@@ -595,6 +670,22 @@ SkPictureData* SkPictureData::CreateFromStream(SkStream* stream,
     return data.release();
 }
 
+SkPictureData* SkPictureData::CreateFromStreamWithoutOps(SkStream* stream,
+                                                         const SkPictInfo& info,
+                                                         SkImageDeserializer* factory,
+                                                         size_t* opOffset,
+                                                         size_t* opSize) {
+    SkASSERT(stream->hasPosition());
+    std::unique_ptr<SkPictureData> data(new SkPictureData(info));
+    data->fSkipOpData = true;
+    if (!data->parseStream(stream, factory, &data->fTFPlayback) || !data->fOpData) {
+        return nullptr;
+    }
+    *opOffset = data->fOpDataOffset;
+    *opSize = data->fOpDataSize;
+    return data.release();
+}
+
 SkPictureData* SkPictureData::CreateFromBuffer(SkReadBuffer& buffer,
                                                const SkPictInfo& info) {
     std::unique_ptr<SkPictureData> data(new SkPictureData(info));
@@ -82,6 +82,13 @@ public:
                                            SkImageDeserializer*,
                                            SkTypefacePlayback*);
     static SkPictureData* CreateFromBuffer(SkReadBuffer&, const SkPictInfo&);
+    // Like CreateFromStream(), but skips over the ops instead of reading them: opData() is empty,
+    // and *opOffset and *opSize say where in the stream they are. The stream must have a position.
+    static SkPictureData* CreateFromStreamWithoutOps(SkStream*,
+                                                     const SkPictInfo&,
+                                                     SkImageDeserializer*,
+                                                     size_t* opOffset,
+                                                     size_t* opSize);
 
     virtual ~SkPictureData();
 
@@ -171,10 +178,29 @@ private:
     bool parseBufferTag(SkReadBuffer&, uint32_t tag, uint32_t size);
     void flattenToBuffer(SkWriteBuffer&) const;
 
+    // The sections of the buffer, in the order flatten() and serialize() write them.
+    enum BufferSection {
+        kPaint_BufferSection,
+        kPath_BufferSection,
+        kTextBlob_BufferSection,
+        kImage_BufferSection,
+
+        kBufferSectionCount
+    };
+
+    // Writes one section of the buffer. If encodedImages is not null, buffer must be an
+    // SkBinaryWriteBuffer and the images are written from their data in encodedImages.
+    void flattenSection(BufferSection, SkWriteBuffer& buffer,
+                        const sk_sp<SkData>* encodedImages = nullptr) const;
+
     SkTArray<SkPaint>  fPaints;
     SkTArray<SkPath>   fPaths;
 
     sk_sp<SkData>   fOpData;    // opcodes and parameters
+    // Set by CreateFromStreamWithoutOps(): the ops stay in the stream, here.
+    bool            fSkipOpData;
+    size_t          fOpDataOffset;
+    size_t          fOpDataSize;
 
     const SkPath    fEmptyPath;
     const SkBitmap  fEmptyBitmap;
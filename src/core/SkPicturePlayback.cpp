@@ -15,6 +15,7 @@
 #include "SkTextBlob.h"
 #include "SkTDArray.h"
 #include "SkTypes.h"
+#include "SkValidatingReadBuffer.h"
 
 // matches old SkCanvas::SaveFlags
 enum LegacySaveFlags {
@@ -121,6 +122,20 @@ void SkPicturePlayback::draw(SkCanvas* canvas,
     }
 }
 
+bool SkPicturePlayback::drawOp(SkCanvas* canvas, const void* opData, size_t opSize,
+                               const SkMatrix& initialMatrix) {
+    // Clips that come out empty skip ahead to their restore, which is not in this buffer.
+    // A validating reader just stops there; the ops up to the restore draw nothing anyway.
+    SkValidatingReadBuffer reader(opData, opSize);
+    uint32_t size;
+    DrawType op = ReadOpAndSize(&reader, &size);
+    if (!reader.validate(op > UNUSED && op <= LAST_DRAWTYPE_ENUM && size <= opSize)) {
+        return false;
+    }
+    this->handleOp(&reader, op, size, canvas, initialMatrix);
+    return true;
+}
+
 void SkPicturePlayback::handleOp(SkReadBuffer* reader,
                                  DrawType op,
                                  uint32_t size,
@@ -25,6 +25,10 @@ public:
 
     void draw(SkCanvas* canvas, SkPicture::AbortCallback*, SkReadBuffer* buffer);
 
+    // Draws a single op, given its bytes from the op data. initialMatrix is the canvas's matrix
+    // when playback of the whole picture began. Returns false if the op is invalid.
+    bool drawOp(SkCanvas* canvas, const void* op, size_t size, const SkMatrix& initialMatrix);
+
     // TODO: remove the curOp calls after cleaning up GrGatherDevice
     // Return the ID of the operation currently being executed when playing
     // back. 0 indicates no call is active.
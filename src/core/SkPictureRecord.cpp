@@ -6,6 +6,7 @@
  */
 
 #include "SkPictureRecord.h"
+#include "SkImageContent.h"
 #include "SkImage_Base.h"
 #include "SkPatchUtils.h"
 #include "SkPixelRef.h"
@@ -881,7 +882,36 @@ sk_sp<SkSurface> SkPictureRecord::onNewSurface(const SkImageInfo& info, const Sk
 
 void SkPictureRecord::addImage(const SkImage* image) {
     // convention for images is 0-based index
-    this->addInt(find_or_append_uniqueID(fImageRefs, image));
+    if (int* index = fImageIndices.find(image->uniqueID())) {
+        this->addInt(*index);
+        return;
+    }
+
+    // A new ID may still be an image we already have, e.g. the same file decoded again.
+    int index = -1;
+    SkTDArray<int>* sameHash = nullptr;
+    uint32_t hash;
+    if (SkImageContent::PreHash(image, &hash)) {
+        sameHash = fImageIndicesByContent.find(hash);
+        if (!sameHash) {
+            sameHash = fImageIndicesByContent.set(hash, SkTDArray<int>());
+        }
+        for (int i : *sameHash) {
+            if (SkImageContent::Equals(fImageRefs[i], image)) {
+                index = i;
+                break;
+            }
+        }
+    }
+    if (index < 0) {
+        index = fImageRefs.count();
+        *fImageRefs.append() = SkRef(image);
+        if (sameHash) {
+            *sameHash->append() = index;
+        }
+    }
+    fImageIndices.set(image->uniqueID(), index);
+    this->addInt(index);
 }
 
 void SkPictureRecord::addMatrix(const SkMatrix& matrix) {
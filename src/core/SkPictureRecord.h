@@ -273,6 +273,11 @@ private:
     SkTDArray<SkDrawable*>       fDrawableRefs;
     SkTDArray<const SkTextBlob*> fTextBlobRefs;
 
+    // Indices into fImageRefs, by uniqueID and by SkImageContent::PreHash(). Images with the
+    // same contents share an index.
+    SkTHashMap<uint32_t, int>           fImageIndices;
+    SkTHashMap<uint32_t, SkTDArray<int>> fImageIndicesByContent;
+
     uint32_t fRecordFlags;
     int      fInitialSaveCount;
 
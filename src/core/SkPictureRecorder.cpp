@@ -6,6 +6,7 @@
  */
 
 #include "SkBigPicture.h"
+#include "SkCompactPicture.h"
 #include "SkData.h"
 #include "SkDrawable.h"
 #include "SkPictureRecorder.h"
@@ -91,6 +92,15 @@ sk_sp<SkPicture> SkPictureRecorder::finishRecordingAsPicture(uint32_t finishFlag
     for (int i = 0; pictList && i < pictList->count(); i++) {
         subPictureBytes += SkPictureUtils::ApproximateBytesUsed(pictList->begin()[i]);
     }
+    if (fFlags & kCompact_RecordFlag) {
+        // The drawables' snapshots are recorded into the compact picture as pictures.
+        std::unique_ptr<SkBigPicture::SnapshotArray> drawablePicts(pictList);
+        sk_sp<SkPicture> picture = sk_make_sp<SkCompactPicture>(fCullRect, *fRecord,
+                                                                drawablePicts.get(),
+                                                                fBBH.release(), subPictureBytes);
+        fRecord.reset();
+        return picture;
+    }
     return sk_make_sp<SkBigPicture>(fCullRect, fRecord.release(), pictList, fBBH.release(),
                                     subPictureBytes);
 }
@@ -98,6 +98,32 @@ bool SkRasterClip::setRect(const SkIRect& rect) {
     return fIsRect;
 }
 
+bool SkRasterClip::setClip(const SkRasterClip& src) {
+    AUTO_RASTERCLIP_VALIDATE(*this);
+    src.validate();
+
+    fIsBW = src.fIsBW;
+    if (fIsBW) {
+        fBW = src.fBW;
+        fAA.setEmpty();
+    } else {
+        fAA = src.fAA;
+    }
+    fIsEmpty = src.fIsEmpty;
+    fIsRect = src.fIsRect;
+    return !fIsEmpty;
+}
+
+size_t SkRasterClip::approximateBytesUsed() const {
+    size_t size = sizeof(SkRasterClip);
+    if (fIsBW) {
+        size += fBW.writeToMemory(nullptr);
+    } else {
+        size += fAA.approximateBytesUsed() - sizeof(SkAAClip);
+    }
+    return size;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////
 
 bool SkRasterClip::setConservativeRect(const SkRect& r, const SkIRect& clipR, bool isInverse) {
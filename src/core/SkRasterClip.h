@@ -59,6 +59,12 @@ public:
 
     bool setEmpty();
     bool setRect(const SkIRect&);
+    // Copies the state of the other clip, but keeps this clip's settings (force-conservative-rects
+    // and the device clip restriction).
+    bool setClip(const SkRasterClip&);
+
+    // Returns the memory used by this clip, including its (possibly shared) runs.
+    size_t approximateBytesUsed() const;
 
     bool op(const SkIRect&, SkRegion::Op);
     bool op(const SkRegion&, SkRegion::Op);
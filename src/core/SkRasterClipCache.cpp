@@ -0,0 +1,111 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkRasterClipCache.h"
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gRasterClipKeyNamespaceLabel;
+
+struct RasterClipKey : public SkResourceCache::Key {
+public:
+    RasterClipKey(const SkRasterClip& prior, const SkClipStack::Element& element,
+                  const SkIRect& devBounds)
+        : fContentHash(element.getContentHash())
+        , fPriorIsBW(prior.isBW())
+        , fPriorBounds(prior.getBounds())
+        , fDevBounds(devBounds)
+    {
+        this->init(&gRasterClipKeyNamespaceLabel, 0,
+                   sizeof(fContentHash) + sizeof(fPriorIsBW) + sizeof(fPriorBounds) +
+                   sizeof(fDevBounds));
+    }
+
+    uint32_t fContentHash;
+    int32_t  fPriorIsBW;
+    SkIRect  fPriorBounds;
+    SkIRect  fDevBounds;
+};
+
+static bool same_shape(const SkClipStack::Element& a, const SkClipStack::Element& b) {
+    if (a.getType() != b.getType() || a.getOp() != b.getOp() || a.isAA() != b.isAA()) {
+        return false;
+    }
+    switch (a.getType()) {
+        case SkClipStack::Element::kRect_Type:
+        case SkClipStack::Element::kRRect_Type:
+            return a.asRRect() == b.asRRect();
+        case SkClipStack::Element::kPath_Type:
+            return a.getPath() == b.getPath();
+        case SkClipStack::Element::kEmpty_Type:
+            return true;
+    }
+    return false;
+}
+
+struct RasterClipRec : public SkResourceCache::Rec {
+    RasterClipRec(const RasterClipKey& key, const SkRasterClip& prior,
+                  const SkClipStack::Element& element, const SkRasterClip& result)
+        : fKey(key)
+        , fPrior(prior)
+        , fElement(element)
+        , fResult(result)
+    {}
+
+    RasterClipKey         fKey;
+    SkRasterClip          fPrior;
+    SkClipStack::Element  fElement;
+    SkRasterClip          fResult;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        size_t size = sizeof(*this) + fPrior.approximateBytesUsed() +
+                      fResult.approximateBytesUsed();
+        if (SkClipStack::Element::kPath_Type == fElement.getType()) {
+            const SkPath& path = fElement.getPath();
+            size += path.countPoints() * sizeof(SkPoint) + path.countVerbs();
+        }
+        return size;
+    }
+    const char* getCategory() const override { return "raster-clip"; }
+
+    struct Context {
+        const SkRasterClip*         fPrior;
+        const SkClipStack::Element* fElement;
+        SkRasterClip*               fResult;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const RasterClipRec& rec = static_cast<const RasterClipRec&>(baseRec);
+        Context* context = (Context*)contextData;
+
+        // A collision: returning false lets the cache drop this entry for the new one.
+        if (rec.fPrior != *context->fPrior || !same_shape(rec.fElement, *context->fElement)) {
+            return false;
+        }
+        context->fResult->setClip(rec.fResult);
+        return true;
+    }
+};
+} // namespace
+
+bool SkRasterClipCache::Find(const SkRasterClip& prior, const SkClipStack::Element& element,
+                             const SkIRect& devBounds, SkRasterClip* result,
+                             SkResourceCache* localCache) {
+    RasterClipKey key(prior, element, devBounds);
+    RasterClipRec::Context context = { &prior, &element, result };
+    return CHECK_LOCAL(localCache, find, Find, key, RasterClipRec::Visitor, &context);
+}
+
+void SkRasterClipCache::Add(const SkRasterClip& prior, const SkClipStack::Element& element,
+                            const SkIRect& devBounds, const SkRasterClip& result,
+                            SkResourceCache* localCache) {
+    RasterClipKey key(prior, element, devBounds);
+    return CHECK_LOCAL(localCache, add, Add, new RasterClipRec(key, prior, element, result));
+}
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkRasterClipCache_DEFINED
+#define SkRasterClipCache_DEFINED
+
+#include "SkClipStack.h"
+#include "SkRasterClip.h"
+#include "SkResourceCache.h"
+
+/**
+ *  Remembers the result of applying a path or round-rect clip element to a raster clip, so that
+ *  a clip that is repeated (on the next frame, or on another tile) is not scan-converted again.
+ *
+ *  Entries are found by the element's content hash (which covers the elements below it in its
+ *  stack), the device bounds and the bounds of the prior clip, and are then checked against the
+ *  element's shape and the prior clip itself, so a hash collision only costs a miss.
+ */
+class SkRasterClipCache {
+public:
+    /**
+     *  On success, set result to the clip that applying element (in device space) to prior
+     *  within devBounds produces, and return true.
+     */
+    static bool Find(const SkRasterClip& prior, const SkClipStack::Element& element,
+                     const SkIRect& devBounds, SkRasterClip* result,
+                     SkResourceCache* localCache = nullptr);
+
+    static void Add(const SkRasterClip& prior, const SkClipStack::Element& element,
+                    const SkIRect& devBounds, const SkRasterClip& result,
+                    SkResourceCache* localCache = nullptr);
+};
+
+#endif
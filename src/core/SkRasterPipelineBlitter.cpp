@@ -35,6 +35,8 @@ public:
     void blitAntiH(int x, int y, const SkAlpha[], const int16_t[]) override;
     void blitMask (const SkMask&, const SkIRect& clip)             override;
 
+    bool prefersMaskRows() const override { return true; }
+
     // TODO: The default implementations of the other blits look fine,
     // but some of them like blitV could probably benefit from custom
     // blits using something like a SkRasterPipeline::runFew() method.
@@ -173,9 +173,8 @@ template <> void Draw::draw(const DrawDrawable& r) {
 // in for all the control ops we stashed away.
 class FillBounds : SkNoncopyable {
 public:
-    FillBounds(const SkRect& cullRect, const SkRecord& record, SkRect bounds[])
-        : fNumRecords(record.count())
-        , fCullRect(cullRect)
+    FillBounds(const SkRect& cullRect, SkRect bounds[])
+        : fCullRect(cullRect)
         , fBounds(bounds) {
         fCTM = SkMatrix::I();
         fCurrentClipBounds = fCullRect;
@@ -196,6 +195,18 @@ public:
 
     void setCurrentOp(int currentOp) { fCurrentOp = currentOp; }
 
+    // Where bounds are written, indexed by op; for callers that grow the array as they go.
+    void setBounds(SkRect bounds[]) { fBounds = bounds; }
+
+    // True while inside a SaveLayer with a paint. We point at that paint in the record.
+    bool hasSaveLayerPaints() const {
+        for (const SaveBounds& sb : fSaveStack) {
+            if (sb.paint) {
+                return true;
+            }
+        }
+        return false;
+    }
 
     template <typename T> void operator()(const T& op) {
         this->updateCTM(op);
@@ -600,8 +611,6 @@ private:
         return true;
     }
 
-    const int fNumRecords;
-
     // We do not guarantee anything for operations outside of the cull rect
     const SkRect fCullRect;
 
@@ -623,7 +632,7 @@ private:
 }  // namespace SkRecords
 
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkRect bounds[]) {
-    SkRecords::FillBounds visitor(cullRect, record, bounds);
+    SkRecords::FillBounds visitor(cullRect, bounds);
     for (int curOp = 0; curOp < record.count(); curOp++) {
         visitor.setCurrentOp(curOp);
         record.visit(curOp, visitor);
@@ -631,3 +640,31 @@ void SkRecordFillBounds(const SkRect& cullRect, const SkRecord& record, SkRect b
     visitor.cleanUp();
 }
 
+SkRecordBoundsBuilder::SkRecordBoundsBuilder(const SkRect& cullRect)
+    : fVisitor(new SkRecords::FillBounds(cullRect, nullptr)) {}
+
+SkRecordBoundsBuilder::~SkRecordBoundsBuilder() {}
+
+void SkRecordBoundsBuilder::append(sk_sp<SkRecord> record) {
+    int start = fBounds.count();
+    fBounds.append(record->count());
+    fVisitor->setBounds(fBounds.begin());
+    for (int i = 0; i < record->count(); i++) {
+        fVisitor->setCurrentOp(start + i);
+        record->visit(i, *fVisitor);
+    }
+
+    // The paints of open SaveLayers still adjust the bounds of ops to come, so their records
+    // have to stay around until those layers are restored.
+    if (fVisitor->hasSaveLayerPaints()) {
+        fLiveRecords.push_back(std::move(record));
+    } else {
+        fLiveRecords.reset();
+    }
+}
+
+void SkRecordBoundsBuilder::finish() {
+    fVisitor->setBounds(fBounds.begin());
+    fVisitor->cleanUp();
+    fLiveRecords.reset();
+}
@@ -13,13 +13,36 @@
 #include "SkCanvas.h"
 #include "SkMatrix.h"
 #include "SkRecord.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
 
 class SkDrawable;
 class SkLayerInfo;
+namespace SkRecords { class FillBounds; }
 
 // Calculate conservative identity space bounds for each op in the record.
 void SkRecordFillBounds(const SkRect& cullRect, const SkRecord&, SkRect bounds[]);
 
+// SkRecordFillBounds() for a record that is never in memory all at once: append() its ops in
+// order, in as many pieces as needed, then finish(). Until then, the bounds of control ops (saves,
+// restores, clips and matrix changes) may not be final.
+class SkRecordBoundsBuilder : SkNoncopyable {
+public:
+    explicit SkRecordBoundsBuilder(const SkRect& cullRect);
+    ~SkRecordBoundsBuilder();
+
+    void append(sk_sp<SkRecord>);
+    void finish();
+
+    // One per op appended so far.
+    const SkTDArray<SkRect>& bounds() const { return fBounds; }
+
+private:
+    std::unique_ptr<SkRecords::FillBounds> fVisitor;
+    SkTDArray<SkRect>                      fBounds;
+    SkTArray<sk_sp<SkRecord>>              fLiveRecords;
+};
+
 // SkRecordFillBounds(), and gathers information about saveLayers and stores it for later
 // use (e.g., layer hoisting). The gathered information is sufficient to determine
 // where each saveLayer will land and which ops in the picture it represents.
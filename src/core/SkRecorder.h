@@ -53,6 +53,10 @@ public:
     // Make SkRecorder forget entirely about its SkRecord*; all calls to SkRecorder will fail.
     void forgetRecord();
 
+    // Record what comes next into another SkRecord, leaving the canvas state (matrix, clip,
+    // saves) as it is. Lets a long recording be handed off in pieces.
+    void setRecord(SkRecord* record) { fRecord = record; }
+
     void willSave() override;
     SaveLayerStrategy getSaveLayerStrategy(const SaveLayerRec&) override;
     void willRestore() override {}
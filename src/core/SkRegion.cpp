@@ -8,7 +8,9 @@
 
 #include "SkAtomics.h"
 #include "SkRegionPriv.h"
+#include "SkTDArray.h"
 #include "SkTemplates.h"
+#include "SkTSort.h"
 #include "SkUtils.h"
 
 /* Region Layout
@@ -585,16 +587,123 @@ void SkRegion::translate(int dx, int dy, SkRegion* dst) const {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// Scratch space for the runs of a region being built, grown as needed. Small regions never leave
+// the stack.
+class RunArray : SkNoncopyable {
+public:
+    RunArray() : fCount(kInitialStorage) {}
+
+    int count() const { return fCount; }
+    SkRegion::RunType* get() { return fStorage.get(); }
+    SkRegion::RunType& operator[](int index) { return fStorage[index]; }
+
+    // Keeps the contents.
+    void resizeToAtLeast(int count) {
+        if (count > fCount) {
+            fCount = SkTMax(count, fCount + (fCount >> 1));
+            fStorage.realloc(fCount);
+        }
+    }
+
+private:
+    static const int kInitialStorage = 256;
+
+    SkAutoSTMalloc<kInitialStorage, SkRegion::RunType> fStorage;
+    int fCount;
+};
+
+}  // namespace
+
+static bool rect_top_less_than(const SkIRect* a, const SkIRect* b) {
+    return a->fTop < b->fTop;
+}
+
 bool SkRegion::setRects(const SkIRect rects[], int count) {
-    if (0 == count) {
-        this->setEmpty();
-    } else {
-        this->setRect(rects[0]);
-        for (int i = 1; i < count; i++) {
-            this->op(rects[i], kUnion_Op);
+    SkTDArray<const SkIRect*> sorted;
+    SkTDArray<RunType> edges;
+    sorted.setReserve(count);
+    edges.setReserve(2 * count);
+    for (int i = 0; i < count; i++) {
+        if (!rects[i].isEmpty()) {
+            *sorted.append() = &rects[i];
+            *edges.append() = rects[i].fTop;
+            *edges.append() = rects[i].fBottom;
         }
     }
-    return !this->isEmpty();
+    if (sorted.count() <= 1) {
+        return sorted.isEmpty() ? this->setEmpty() : this->setRect(*sorted[0]);
+    }
+    SkTQSort(sorted.begin(), sorted.end() - 1, rect_top_less_than);
+    SkTQSort(edges.begin(), edges.end() - 1);
+
+    // Sweep down through the rects' edges. Each band between two edges is a scanline whose
+    // intervals are those of the rects spanning it, merged. active holds those rects, by left.
+    SkTDArray<const SkIRect*> active;
+    RunArray runs;
+    int      runCount = 0;
+    int      prevStart = 0;     // where the previous scanline's intervals start
+    int      prevLen = 0;       // never matches a real scanline, which has a sentinel
+    int      next = 0;
+
+    runs[runCount++] = edges[0];    // top
+    for (int e = 0; e < edges.count() - 1; e++) {
+        const int top = edges[e];
+        const int bottom = edges[e + 1];
+        if (top == bottom) {
+            continue;
+        }
+        int keep = 0;
+        for (int i = 0; i < active.count(); i++) {
+            if (active[i]->fBottom > top) {
+                active[keep++] = active[i];
+            }
+        }
+        active.setCount(keep);
+        for (; next < sorted.count() && sorted[next]->fTop == top; next++) {
+            const SkIRect* rect = sorted[next];
+            int i = active.count();
+            while (i > 0 && active[i - 1]->fLeft > rect->fLeft) {
+                i--;
+            }
+            *active.insert(i) = rect;
+        }
+
+        // bottom, interval count, intervals, sentinel, and the final sentinel
+        runs.resizeToAtLeast(runCount + 2 * active.count() + 4);
+        RunType* start = runs.get() + runCount + 2;
+        RunType* stop = start;
+        for (int i = 0; i < active.count(); i++) {
+            if (stop > start && stop[-1] >= active[i]->fLeft) {
+                stop[-1] = SkTMax(stop[-1], active[i]->fRight);
+            } else {
+                *stop++ = active[i]->fLeft;
+                *stop++ = active[i]->fRight;
+            }
+        }
+        *stop++ = kRunTypeSentinel;
+        int len = SkToInt(stop - start);
+
+        RunType* prev = runs.get() + prevStart;
+        if (prevLen == len && !memcmp(prev, start, (len - 1) * sizeof(RunType))) {
+            prev[-2] = bottom;  // same intervals as the scanline above: extend it
+        } else {
+            start[-2] = bottom;
+            start[-1] = len >> 1;
+            prevStart = runCount + 2;
+            prevLen = len;
+            runCount += len + 2;
+        }
+    }
+    runs[runCount++] = kRunTypeSentinel;
+    return this->setRuns(runs.get(), runCount);
+}
+
+bool SkRegion::op(const SkIRect rects[], int count, Op op) {
+    SkRegion rgn;
+    rgn.setRects(rects, count);
+    return this->op(*this, rgn, op);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -704,6 +813,35 @@ struct spanRec {
     }
 };
 
+// The intervals of one side that end before the other side's next interval begins come out of
+// the merge as they went in: emit them with a single copy (or skip them, if the op drops them).
+// left and rite are that side's current interval, runs the rest of its intervals.
+static SkRegion::RunType* copy_intervals(int* left, int* rite, const SkRegion::RunType** runs,
+                                         int otherLeft, bool keep, bool* firstInterval,
+                                         SkRegion::RunType dst[]) {
+    const SkRegion::RunType* start = *runs;
+    const SkRegion::RunType* stop = start;
+    while (stop[0] != SkRegion::kRunTypeSentinel && stop[1] <= otherLeft) {
+        stop += 2;
+    }
+    if (keep) {
+        // only the current interval may need to join the last one written
+        if (*firstInterval || dst[-1] < *left) {
+            *dst++ = (SkRegion::RunType)(*left);
+            *dst++ = (SkRegion::RunType)(*rite);
+            *firstInterval = false;
+        } else {
+            dst[-1] = (SkRegion::RunType)(*rite);
+        }
+        memcpy(dst, start, (stop - start) * sizeof(SkRegion::RunType));
+        dst += stop - start;
+    }
+    *left = stop[0];
+    *rite = stop[1];
+    *runs = stop + 2;
+    return dst;
+}
+
 static SkRegion::RunType* operate_on_span(const SkRegion::RunType a_runs[],
                                           const SkRegion::RunType b_runs[],
                                           SkRegion::RunType dst[],
@@ -714,6 +852,17 @@ static SkRegion::RunType* operate_on_span(const SkRegion::RunType a_runs[],
     rec.init(a_runs, b_runs);
 
     while (!rec.done()) {
+        if (rec.fA_left != SkRegion::kRunTypeSentinel && rec.fA_rite <= rec.fB_left) {
+            dst = copy_intervals(&rec.fA_left, &rec.fA_rite, &rec.fA_runs, rec.fB_left,
+                                 min <= 1, &firstInterval, dst);
+            continue;
+        }
+        if (rec.fB_left != SkRegion::kRunTypeSentinel && rec.fB_rite <= rec.fA_left) {
+            dst = copy_intervals(&rec.fB_left, &rec.fB_rite, &rec.fB_runs, rec.fA_left,
+                                 (unsigned)(2 - min) <= (unsigned)(max - min), &firstInterval,
+                                 dst);
+            continue;
+        }
         rec.next();
 
         int left = rec.fLeft;
@@ -753,7 +902,7 @@ static const struct {
 
 class RgnOper {
 public:
-    RgnOper(int top, SkRegion::RunType dst[], SkRegion::Op op) {
+    RgnOper(int top, RunArray* array, SkRegion::Op op) {
         // need to ensure that the op enum lines up with our minmax array
         SkASSERT(SkRegion::kDifference_Op == 0);
         SkASSERT(SkRegion::kIntersect_Op == 1);
@@ -761,8 +910,9 @@ public:
         SkASSERT(SkRegion::kXOR_Op == 3);
         SkASSERT((unsigned)op <= 3);
 
-        fStartDst = dst;
-        fPrevDst = dst + 1;
+        fArray = array;
+        fStartDst = array->get();
+        fPrevDst = fStartDst + 1;
         fPrevLen = 0;       // will never match a length from operate_on_span
         fTop = (SkRegion::RunType)(top);    // just a first guess, we might update this
 
@@ -770,6 +920,17 @@ public:
         fMax = gOpMinMax[op].fMax;
     }
 
+    // Makes room for the next two addSpan() calls, which merge at most this many intervals.
+    void reserve(int intervals) {
+        int used = (int)(fPrevDst - fStartDst + fPrevLen);
+        // an empty span, then bottom, count, intervals and sentinel, then flush()'s sentinel
+        fArray->resizeToAtLeast(used + 3 + 3 + 2 * intervals + 1);
+        if (fArray->get() != fStartDst) {
+            fPrevDst = fArray->get() + (fPrevDst - fStartDst);
+            fStartDst = fArray->get();
+        }
+    }
+
     void addSpan(int bottom, const SkRegion::RunType a_runs[],
                  const SkRegion::RunType b_runs[]) {
         // skip X values and slots for the next Y+intervalCount
@@ -808,6 +969,7 @@ public:
     uint8_t fMin, fMax;
 
 private:
+    RunArray*           fArray;
     SkRegion::RunType*  fStartDst;
     SkRegion::RunType*  fPrevDst;
     size_t              fPrevLen;
@@ -819,7 +981,7 @@ private:
 
 static int operate(const SkRegion::RunType a_runs[],
                    const SkRegion::RunType b_runs[],
-                   SkRegion::RunType dst[],
+                   RunArray* dst,
                    SkRegion::Op op,
                    bool quickExit) {
     const SkRegion::RunType gEmptyScanline[] = {
@@ -894,6 +1056,8 @@ static int operate(const SkRegion::RunType a_runs[],
             }
         }
 
+        // each scanline's intervals are preceded by their count
+        oper.reserve(run0[-1] + run1[-1]);
         if (top > prevBot) {
             oper.addSpan(top, gSentinel, gSentinel);
         }
@@ -929,41 +1093,6 @@ static int operate(const SkRegion::RunType a_runs[],
 
 ///////////////////////////////////////////////////////////////////////////////
 
-/*  Given count RunTypes in a complex region, return the worst case number of
-    logical intervals that represents (i.e. number of rects that would be
-    returned from the iterator).
-
-    We could just return count/2, since there must be at least 2 values per
-    interval, but we can first trim off the const overhead of the initial TOP
-    value, plus the final BOTTOM + 2 sentinels.
- */
-#if 0 // UNUSED
-static int count_to_intervals(int count) {
-    SkASSERT(count >= 6);   // a single rect is 6 values
-    return (count - 4) >> 1;
-}
-#endif
-
-/*  Given a number of intervals, what is the worst case representation of that
-    many intervals?
-
-    Worst case (from a storage perspective), is a vertical stack of single
-    intervals:  TOP + N * (BOTTOM INTERVALCOUNT LEFT RIGHT SENTINEL) + SENTINEL
- */
-static int intervals_to_count(int intervals) {
-    return 1 + intervals * 5 + 1;
-}
-
-/*  Given the intervalCounts of RunTypes in two regions, return the worst-case number
-    of RunTypes need to store the result after a region-op.
- */
-static int compute_worst_case_count(int a_intervals, int b_intervals) {
-    // Our heuristic worst case is ai * (bi + 1) + bi * (ai + 1)
-    int intervals = 2 * a_intervals * b_intervals + a_intervals + b_intervals;
-    // convert back to number of RunType values
-    return intervals_to_count(intervals);
-}
-
 static bool setEmptyCheck(SkRegion* result) {
     return result ? result->setEmpty() : false;
 }
@@ -1066,16 +1195,11 @@ bool SkRegion::Oper(const SkRegion& rgnaOrig, const SkRegion& rgnbOrig, Op op,
     const RunType* a_runs = rgna->getRuns(tmpA, &a_intervals);
     const RunType* b_runs = rgnb->getRuns(tmpB, &b_intervals);
 
-    int dstCount = compute_worst_case_count(a_intervals, b_intervals);
-    SkAutoSTMalloc<256, RunType> array(dstCount);
-
-#ifdef SK_DEBUG
-//  Sometimes helpful to seed everything with a known value when debugging
-//  sk_memset32((uint32_t*)array.get(), 0x7FFFFFFF, dstCount);
-#endif
-
-    int count = operate(a_runs, b_runs, array.get(), op, nullptr == result);
-    SkASSERT(count <= dstCount);
+    // The result is built in scratch space that grows as needed: the worst case for two regions
+    // is far larger than the result usually is.
+    RunArray array;
+    int count = operate(a_runs, b_runs, &array, op, nullptr == result);
+    SkASSERT(count <= array.count());
 
     if (result) {
         SkASSERT(count >= 0);
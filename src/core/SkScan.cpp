@@ -16,6 +16,8 @@
     std::atomic<bool> gSkUseAnalyticAA{true};
 #endif
 
+std::atomic<int> gSkAntiFillPathBands{1};
+
 static inline void blitrect(SkBlitter* blitter, const SkIRect& r) {
     blitter->blitRect(r.fLeft, r.fTop, r.width(), r.height());
 }
@@ -25,6 +25,10 @@ typedef SkIRect SkXRect;
 
 extern std::atomic<bool> gSkUseAnalyticAA;
 
+// Supersampled fills of big, complex paths are split into this many bands of rows, which are
+// rasterized concurrently. 1 (the default) fills them row by row on the calling thread.
+extern std::atomic<int> gSkAntiFillPathBands;
+
 class AdditiveBlitter;
 
 class SkScan {
@@ -51,6 +55,10 @@ public:
     static void FillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
     static void AAAFillPath(const SkPath&, const SkRasterClip&, SkBlitter*);
+    // AntiFillPath() by supersampling, whatever gSkUseAnalyticAA says, with big complex paths
+    // split into bandCount bands of rows rather than gSkAntiFillPathBands.
+    static void SupersampleFillPath(const SkPath&, const SkRasterClip&, SkBlitter*,
+                                    int bandCount);
     static void FrameRect(const SkRect&, const SkPoint& strokeSize,
                           const SkRasterClip&, SkBlitter*);
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -79,6 +87,8 @@ private:
     static void FillPath(const SkPath&, const SkRegion& clip, SkBlitter*);
     static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*,
                              bool forceRLE = false);
+    static void AntiFillPath(const SkPath&, const SkRegion& clip, SkBlitter*, bool forceRLE,
+                             int bandCount);
     static void FillTriangle(const SkPoint pts[], const SkRegion*, SkBlitter*);
 
     static void AntiFrameRect(const SkRect&, const SkPoint& strokeSize,
@@ -34,6 +34,13 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect,
                   SkBlitter* blitter, int start_y, int stop_y, int shiftEdgesUp,
                   bool pathContainedInClip);
 
+// sk_fill_path() for a path that is neither inverse nor convex, with rows [start_y, stop_y) split
+// into bandCount bands of whole rows. The bands are walked concurrently, band i into blitters[i],
+// and each band's blitter sees exactly the calls it would have in sk_fill_path().
+void sk_fill_path_bands(const SkPath& path, const SkIRect& clipRect, SkBlitter* const blitters[],
+                        int bandCount, int start_y, int stop_y, int shiftEdgesUp,
+                        bool pathContainedInClip);
+
 void aaa_fill_path(const SkPath& path, const SkIRect& clipRect, AdditiveBlitter*,
                    int start_y, int stop_y, bool pathContainedInClip, bool isUsingMask,
                    bool forceRLE);
@@ -12,6 +12,9 @@
 #include "SkBlitter.h"
 #include "SkRegion.h"
 #include "SkAntiRun.h"
+#include "SkTArray.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
 
 #define SHIFT   2
 #define SCALE   (1 << SHIFT)
@@ -390,6 +393,87 @@ void SuperBlitter::blitRect(int x, int y, int width, int height) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// Holds the rows a SuperBlitter blits, so that one band of a path can be supersampled on its own
+/// thread, and its rows blitted later, in order with the other bands.
+class RowRecorder : public SkBlitter {
+public:
+    RowRecorder() : fMaxWidth(0) {}
+
+    void blitH(int x, int y, int width) override {
+        SkDEBUGFAIL("How did I get here?");
+    }
+
+    /// Keeps just the runs, as (length, alpha) pairs.
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        Row* row = fRows.append();
+        row->fX = x;
+        row->fY = y;
+        row->fStart = fRuns.count();
+        int width = 0;
+        for (int n = runs[0]; n > 0; n = runs[0]) {
+            *fRuns.append() = n;
+            *fAlpha.append() = antialias[0];
+            width += n;
+            runs += n;
+            antialias += n;
+        }
+        row->fCount = fRuns.count() - row->fStart;
+        fMaxWidth = SkTMax(fMaxWidth, width);
+    }
+
+    /// Blits the rows, in the order they came, through blitter.
+    void replay(SkBlitter* blitter) const {
+        SkAutoSTMalloc<512, int16_t> runs(fMaxWidth + 1);
+        SkAutoSTMalloc<512, SkAlpha> alpha(fMaxWidth + 1);
+        for (const Row& row : fRows) {
+            int x = 0;
+            for (int i = row.fStart; i < row.fStart + row.fCount; i++) {
+                runs[x] = fRuns[i];
+                alpha[x] = fAlpha[i];
+                x += fRuns[i];
+            }
+            runs[x] = 0;
+            blitter->blitAntiH(row.fX, row.fY, alpha.get(), runs.get());
+        }
+    }
+
+private:
+    struct Row {
+        int fX, fY;
+        int fStart, fCount;  // into fRuns and fAlpha
+    };
+    SkTDArray<Row>     fRows;
+    SkTDArray<int16_t> fRuns;
+    SkTDArray<SkAlpha> fAlpha;
+    int                fMaxWidth;
+};
+
+// Bands smaller than this are not worth their threads.
+static const int kMinRowsPerBand = 64;
+
+/// Supersamples each band of rows into its own RowRecorder, all at once, then blits the bands in
+/// order. blitter sees the same calls as from a single SuperBlitter.
+static void anti_fill_path_in_bands(const SkPath& path, const SkRegion& clipRgn,
+                                    SkBlitter* blitter, const SkIRect& ir,
+                                    bool pathContainedInClip, int bandCount) {
+    std::unique_ptr<RowRecorder[]> recorders(new RowRecorder[bandCount]);
+    SkTArray<std::unique_ptr<SuperBlitter>> superBlits(bandCount);
+    SkAutoSTMalloc<8, SkBlitter*> blitters(bandCount);
+    for (int i = 0; i < bandCount; i++) {
+        superBlits.emplace_back(new SuperBlitter(&recorders[i], ir, clipRgn, false));
+        blitters[i] = superBlits.back().get();
+    }
+    sk_fill_path_bands(path, clipRgn.getBounds(), blitters.get(), bandCount, ir.fTop, ir.fBottom,
+                       SHIFT, pathContainedInClip);
+    superBlits.reset();  // Flushes the last row of each band.
+
+    for (int i = 0; i < bandCount; i++) {
+        recorders[i].replay(blitter);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 /// Masked supersampling antialiased blitter.
 class MaskSuperBlitter : public BaseSuperBlitter {
 public:
@@ -623,6 +707,11 @@ static bool safeRoundOut(const SkRect& src, SkIRect* dst, int32_t maxInt) {
 
 void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
                           SkBlitter* blitter, bool forceRLE) {
+    AntiFillPath(path, origClip, blitter, forceRLE, gSkAntiFillPathBands.load());
+}
+
+void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
+                          SkBlitter* blitter, bool forceRLE, int bandCount) {
     if (origClip.isEmpty()) {
         return;
     }
@@ -713,6 +802,8 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
 
     SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
 
+    bandCount = SkTMin(bandCount, clippedIR.height() / kMinRowsPerBand);
+
     // MaskSuperBlitter can't handle drawing outside of ir, so we can't use it
     // if we're an inverse filltype
     if (!isInverse && MaskSuperBlitter::CanHandleRect(ir) && !forceRLE) {
@@ -720,6 +811,8 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRegion& origClip,
         SkASSERT(SkIntToScalar(ir.fTop) <= path.getBounds().fTop);
         sk_fill_path(path, clipRgn->getBounds(), &superBlit, ir.fTop, ir.fBottom, SHIFT,
                 superClipRect == nullptr);
+    } else if (!isInverse && !path.isConvex() && bandCount > 1) {
+        anti_fill_path_in_bands(path, *clipRgn, blitter, ir, superClipRect == nullptr, bandCount);
     } else {
         SuperBlitter    superBlit(blitter, ir, *clipRgn, isInverse);
         sk_fill_path(path, clipRgn->getBounds(), &superBlit, ir.fTop, ir.fBottom, SHIFT,
@@ -760,18 +853,23 @@ void SkScan::AntiFillPath(const SkPath& path, const SkRasterClip& clip,
         return;
     }
 
+    SkScan::SupersampleFillPath(path, clip, blitter, gSkAntiFillPathBands.load());
+}
+
+void SkScan::SupersampleFillPath(const SkPath& path, const SkRasterClip& clip,
+                                 SkBlitter* blitter, int bandCount) {
     if (clip.isEmpty()) {
         return;
     }
 
     if (clip.isBW()) {
-        AntiFillPath(path, clip.bwRgn(), blitter);
+        AntiFillPath(path, clip.bwRgn(), blitter, false, bandCount);
     } else {
         SkRegion        tmp;
         SkAAClipBlitter aaBlitter;
 
         tmp.setRect(clip.getBounds());
         aaBlitter.init(blitter, &clip.aaRgn());
-        SkScan::AntiFillPath(path, tmp, &aaBlitter, true);
+        SkScan::AntiFillPath(path, tmp, &aaBlitter, true, bandCount);
     }
 }
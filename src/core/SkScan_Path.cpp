@@ -7,6 +7,7 @@
 
 #include "SkScanPriv.h"
 #include "SkBlitter.h"
+#include "SkChunkAlloc.h"
 #include "SkEdge.h"
 #include "SkEdgeBuilder.h"
 #include "SkGeometry.h"
@@ -16,6 +17,7 @@
 #include "SkRegion.h"
 #include "SkTemplates.h"
 #include "SkTSort.h"
+#include "SkTaskGroup.h"
 
 #define kEDGE_HEAD_Y    SK_MinS32
 #define kEDGE_TAIL_Y    SK_MaxS32
@@ -128,11 +130,11 @@ typedef void (*PrePostProc)(SkBlitter* blitter, int y, bool isStartOfScanline);
 #define PREPOST_START   true
 #define PREPOST_END     false
 
+// Walks rows [start_y, stop_y). The edges are left as they would be at the start of stop_y, so that
+// another call can carry on from there.
 static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
                        SkBlitter* blitter, int start_y, int stop_y,
                        PrePostProc proc, int rightClip) {
-    validate_sort(prevHead->fNext);
-
     int curr_y = start_y;
     // returns 1 for evenodd, -1 for winding, regardless of inverse-ness
     int windingMask = (fillType & 1) ? 1 : -1;
@@ -213,11 +215,11 @@ static void walk_edges(SkEdge* prevHead, SkPath::FillType fillType,
         }
 
         curr_y += 1;
+        // now currE points to the first edge with a Yint larger than curr_y
+        insert_new_edges(currE, curr_y);
         if (curr_y >= stop_y) {
             break;
         }
-        // now currE points to the first edge with a Yint larger than curr_y
-        insert_new_edges(currE, curr_y);
     }
 }
 
@@ -408,8 +410,55 @@ static bool operator<(const SkEdge& a, const SkEdge& b) {
     return valuea < valueb;
 }
 
+static bool edge_x_less_than(const SkEdge* a, const SkEdge* b) {
+    return a->fX < b->fX;
+}
+
+// Sorts edges as operator< does: by fFirstY with a counting sort, then by fX within each row.
+// Returns false, having done nothing, if the rows are too spread out to be worth counting.
+static bool counting_sort_edges(SkEdge* list[], int count) {
+    int minY = list[0]->fFirstY,
+        maxY = list[0]->fFirstY;
+    for (int i = 1; i < count; i++) {
+        minY = SkTMin(minY, list[i]->fFirstY);
+        maxY = SkTMax(maxY, list[i]->fFirstY);
+    }
+    if ((int64_t)maxY - minY >= 4 * (int64_t)count) {
+        return false;
+    }
+    const int rows = maxY - minY + 1;
+
+    // starts[y - minY] is where the edges starting on row y go.
+    SkAutoSTMalloc<256, int> starts(rows + 1);
+    sk_bzero(starts.get(), (rows + 1) * sizeof(int));
+    for (int i = 0; i < count; i++) {
+        starts[list[i]->fFirstY - minY + 1]++;
+    }
+    for (int row = 0; row < rows; row++) {
+        starts[row + 1] += starts[row];
+    }
+    SkAutoSTMalloc<256, SkEdge*> sorted(count);
+    for (int i = 0; i < count; i++) {
+        sorted[starts[list[i]->fFirstY - minY]++] = list[i];
+    }
+    memcpy(list, sorted.get(), count * sizeof(SkEdge*));
+
+    // Placing the edges has moved starts[row] to the end of that row.
+    int rowStart = 0;
+    for (int row = 0; row < rows; row++) {
+        if (starts[row] - rowStart > 1) {
+            SkTQSort(list + rowStart, list + starts[row] - 1, edge_x_less_than);
+        }
+        rowStart = starts[row];
+    }
+    return true;
+}
+
 static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
-    SkTQSort(list, list + count - 1);
+    // Counting pays off once there are enough edges to amortize the row counts.
+    if (count < 32 || !counting_sort_edges(list, count)) {
+        SkTQSort(list, list + count - 1);
+    }
 
     // now make the edges linked in sorted order
     for (int i = 1; i < count; i++) {
@@ -421,28 +470,71 @@ static SkEdge* sort_edges(SkEdge* list[], int count, SkEdge** last) {
     return list[0];
 }
 
+// Builds path's edges and links them, sorted, between headEdge and tailEdge. Sets *shiftedClip to
+// clipRect shifted up, and, if there are edges, shifts [*start_y, *stop_y) up and within it.
+// Returns the number of edges.
+static int build_edge_list(const SkPath& path, const SkIRect& clipRect, int shiftEdgesUp,
+                           bool pathContainedInClip, bool canCullToTheRight,
+                           SkEdgeBuilder* builder, SkEdge* headEdge, SkEdge* tailEdge,
+                           SkIRect* shiftedClip, int* start_y, int* stop_y) {
+    *shiftedClip = clipRect;
+    shiftedClip->fLeft <<= shiftEdgesUp;
+    shiftedClip->fRight <<= shiftEdgesUp;
+    shiftedClip->fTop <<= shiftEdgesUp;
+    shiftedClip->fBottom <<= shiftEdgesUp;
+
+    SkIRect* builderClip = pathContainedInClip ? nullptr : shiftedClip;
+    int count = builder->build(path, builderClip, shiftEdgesUp, canCullToTheRight);
+    SkASSERT(count >= 0);
+    if (0 == count) {
+        return 0;
+    }
+
+    SkEdge* last;
+    // this returns the first and last edge after they're sorted into a dlink list
+    SkEdge* edge = sort_edges(builder->edgeList(), count, &last);
+
+    headEdge->fPrev = nullptr;
+    headEdge->fNext = edge;
+    headEdge->fFirstY = kEDGE_HEAD_Y;
+    headEdge->fX = SK_MinS32;
+    edge->fPrev = headEdge;
+
+    tailEdge->fPrev = last;
+    tailEdge->fNext = nullptr;
+    tailEdge->fFirstY = kEDGE_TAIL_Y;
+    last->fNext = tailEdge;
+
+    // now edge is the head of the sorted linklist
+    validate_sort(edge);
+
+    *start_y = SkLeftShift(*start_y, shiftEdgesUp);
+    *stop_y = SkLeftShift(*stop_y, shiftEdgesUp);
+    if (!pathContainedInClip && *start_y < shiftedClip->fTop) {
+        *start_y = shiftedClip->fTop;
+    }
+    if (!pathContainedInClip && *stop_y > shiftedClip->fBottom) {
+        *stop_y = shiftedClip->fBottom;
+    }
+    return count;
+}
+
 // clipRect has not been shifted up
 void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitter,
                   int start_y, int stop_y, int shiftEdgesUp, bool pathContainedInClip) {
     SkASSERT(blitter);
 
-    SkIRect shiftedClip = clipRect;
-    shiftedClip.fLeft <<= shiftEdgesUp;
-    shiftedClip.fRight <<= shiftEdgesUp;
-    shiftedClip.fTop <<= shiftEdgesUp;
-    shiftedClip.fBottom <<= shiftEdgesUp;
-
     SkEdgeBuilder   builder;
+    SkEdge          headEdge, tailEdge;
+    SkIRect         shiftedClip;
 
     // If we're convex, then we need both edges, even the right edge is past the clip
     const bool canCullToTheRight = !path.isConvex();
 
-    SkIRect* builderClip = pathContainedInClip ? nullptr : &shiftedClip;
-    int count = builder.build(path, builderClip, shiftEdgesUp, canCullToTheRight);
-    SkASSERT(count >= 0);
-
-    SkEdge**    list = builder.edgeList();
-
+    const int origStartY = start_y, origStopY = stop_y;
+    int count = build_edge_list(path, clipRect, shiftEdgesUp, pathContainedInClip,
+                                canCullToTheRight, &builder, &headEdge, &tailEdge, &shiftedClip,
+                                &start_y, &stop_y);
     if (0 == count) {
         if (path.isInverseFillType()) {
             /*
@@ -452,11 +544,11 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
              *  and those two limits.
              */
             SkIRect rect = clipRect;
-            if (rect.fTop < start_y) {
-                rect.fTop = start_y;
+            if (rect.fTop < origStartY) {
+                rect.fTop = origStartY;
             }
-            if (rect.fBottom > stop_y) {
-                rect.fBottom = stop_y;
+            if (rect.fBottom > origStopY) {
+                rect.fBottom = origStopY;
             }
             if (!rect.isEmpty()) {
                 blitter->blitRect(rect.fLeft << shiftEdgesUp,
@@ -468,32 +560,6 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
         return;
     }
 
-    SkEdge headEdge, tailEdge, *last;
-    // this returns the first and last edge after they're sorted into a dlink list
-    SkEdge* edge = sort_edges(list, count, &last);
-
-    headEdge.fPrev = nullptr;
-    headEdge.fNext = edge;
-    headEdge.fFirstY = kEDGE_HEAD_Y;
-    headEdge.fX = SK_MinS32;
-    edge->fPrev = &headEdge;
-
-    tailEdge.fPrev = last;
-    tailEdge.fNext = nullptr;
-    tailEdge.fFirstY = kEDGE_TAIL_Y;
-    last->fNext = &tailEdge;
-
-    // now edge is the head of the sorted linklist
-
-    start_y = SkLeftShift(start_y, shiftEdgesUp);
-    stop_y = SkLeftShift(stop_y, shiftEdgesUp);
-    if (!pathContainedInClip && start_y < shiftedClip.fTop) {
-        start_y = shiftedClip.fTop;
-    }
-    if (!pathContainedInClip && stop_y > shiftedClip.fBottom) {
-        stop_y = shiftedClip.fBottom;
-    }
-
     InverseBlitter  ib;
     PrePostProc     proc = nullptr;
 
@@ -512,6 +578,83 @@ void sk_fill_path(const SkPath& path, const SkIRect& clipRect, SkBlitter* blitte
     }
 }
 
+// Copies the edge list from prevHead to its tail edge, so that the copy can be walked on its own
+// from the row the original has reached.
+static SkEdge* copy_edge_list(const SkEdge* prevHead, SkChunkAlloc* alloc) {
+    SkEdge* head = new (alloc->allocThrow(sizeof(SkEdge))) SkEdge(*prevHead);
+    SkEdge* prev = head;
+    const SkEdge* edge = prevHead->fNext;
+    for (;;) {
+        SkEdge* copy;
+        if (edge->fFirstY == kEDGE_TAIL_Y) {
+            copy = new (alloc->allocThrow(sizeof(SkEdge))) SkEdge(*edge);
+        } else if (edge->fCurveCount < 0) {
+            copy = new (alloc->allocThrow(sizeof(SkCubicEdge)))
+                    SkCubicEdge(*(const SkCubicEdge*)edge);
+        } else if (edge->fCurveCount > 0) {
+            copy = new (alloc->allocThrow(sizeof(SkQuadraticEdge)))
+                    SkQuadraticEdge(*(const SkQuadraticEdge*)edge);
+        } else {
+            copy = new (alloc->allocThrow(sizeof(SkEdge))) SkEdge(*edge);
+        }
+        prev->fNext = copy;
+        copy->fPrev = prev;
+        if (edge->fFirstY == kEDGE_TAIL_Y) {
+            return head;
+        }
+        prev = copy;
+        edge = edge->fNext;
+    }
+}
+
+void sk_fill_path_bands(const SkPath& path, const SkIRect& clipRect, SkBlitter* const blitters[],
+                        int bandCount, int start_y, int stop_y, int shiftEdgesUp,
+                        bool pathContainedInClip) {
+    SkASSERT(!path.isInverseFillType() && !path.isConvex());
+    SkASSERT(bandCount > 0);
+
+    SkEdgeBuilder   builder;
+    SkEdge          headEdge, tailEdge;
+    SkIRect         shiftedClip;
+    if (0 == build_edge_list(path, clipRect, shiftEdgesUp, pathContainedInClip, true, &builder,
+                             &headEdge, &tailEdge, &shiftedClip, &start_y, &stop_y)) {
+        return;
+    }
+    if (start_y >= stop_y) {
+        return;
+    }
+
+    // Bands start on whole rows, so each row is blitted by just one of the blitters. Every band
+    // but the last walks a copy of the edges as they are at its first row, which the null walk
+    // below brings them to; the last band walks the edges themselves.
+    const int rows = (stop_y - start_y) >> shiftEdgesUp;
+    const SkPath::FillType fillType = path.getFillType();
+    const int rightClip = shiftedClip.right();
+    SkChunkAlloc    alloc(4096);
+    SkNullBlitter   nullBlitter;
+    SkTaskGroup     tg;
+    int top = start_y;
+    for (int band = 0; band < bandCount; band++) {
+        int bottom = band + 1 == bandCount
+                ? stop_y : start_y + SkLeftShift(rows * (band + 1) / bandCount, shiftEdgesUp);
+        if (top >= bottom) {
+            continue;
+        }
+        if (band + 1 == bandCount) {
+            walk_edges(&headEdge, fillType, blitters[band], top, bottom, nullptr, rightClip);
+        } else {
+            SkEdge* bandHead = copy_edge_list(&headEdge, &alloc);
+            SkBlitter* blitter = blitters[band];
+            tg.add([=] {
+                walk_edges(bandHead, fillType, blitter, top, bottom, nullptr, rightClip);
+            });
+            walk_edges(&headEdge, fillType, &nullBlitter, top, bottom, nullptr, rightClip);
+        }
+        top = bottom;
+    }
+    tg.wait();
+}
+
 void sk_blit_above(SkBlitter* blitter, const SkIRect& ir, const SkRegion& clip) {
     const SkIRect& cr = clip.getBounds();
     SkIRect tmp;
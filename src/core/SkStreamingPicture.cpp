@@ -0,0 +1,314 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkImageDeserializer.h"
+#include "SkPicturePlayback.h"
+#include "SkPictureRecord.h"
+#include "SkRecordDraw.h"
+#include "SkRecorder.h"
+#include "SkStream.h"
+#include "SkStreamingPicture.h"
+
+static const uint32_t kIndexMagic   = SkSetFourByteTag('s', 'k', 'p', 'x');
+static const uint32_t kIndexVersion = 1;
+
+// Ops are handed to SkRecordBoundsBuilder this many at a time while indexing.
+static const int kRecordOpsPerPiece = 4096;
+
+// Reads the size of the op at the start of these bytes (which includes the op and size
+// themselves). Returns false if there are too few bytes to tell, or the size makes no sense.
+static bool read_op_size(const uint8_t* bytes, size_t available, size_t* size) {
+    uint32_t packed;
+    if (available < sizeof(packed)) {
+        return false;
+    }
+    memcpy(&packed, bytes, sizeof(packed));
+    uint32_t op, opSize;
+    UNPACK_8_24(packed, op, opSize);
+    if (MASK_24 == opSize) {
+        if (available < 2 * sizeof(packed)) {
+            return false;
+        }
+        memcpy(&opSize, bytes + sizeof(packed), sizeof(opSize));
+    }
+    // Very old SKPs don't record op sizes, and we can't find our way through those.
+    *size = opSize;
+    return op != UNUSED && opSize >= sizeof(packed) && SkIsAlign4(opSize);
+}
+
+static bool is_save(uint32_t op) {
+    return SAVE == op || SAVE_LAYER_SAVEFLAGS_DEPRECATED == op ||
+           SAVE_LAYER_SAVELAYERFLAGS_DEPRECATED_JAN_2016 == op || SAVE_LAYER_SAVELAYERREC == op;
+}
+
+static bool read_u32(SkStream* stream, uint32_t* value) {
+    return stream->read(value, sizeof(*value)) == sizeof(*value);
+}
+
+std::unique_ptr<SkStreamingPicture> SkStreamingPicture::Make(std::unique_ptr<SkStreamAsset> stream,
+                                                             SkImageDeserializer* factory) {
+    SkPictInfo info;
+    if (!stream || !SkPicture::InternalOnly_StreamIsSKP(stream.get(), &info) ||
+        !stream->readBool()) {
+        return nullptr;
+    }
+    SkImageDeserializer defaultFactory;
+    if (!factory) {
+        factory = &defaultFactory;
+    }
+    size_t opOffset, opSize;
+    std::unique_ptr<SkPictureData> data(SkPictureData::CreateFromStreamWithoutOps(
+            stream.get(), info, factory, &opOffset, &opSize));
+    if (!data) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkStreamingPicture>(
+            new SkStreamingPicture(std::move(stream), info, std::move(data), opOffset, opSize));
+}
+
+SkStreamingPicture::SkStreamingPicture(std::unique_ptr<SkStreamAsset> stream,
+                                       const SkPictInfo& info,
+                                       std::unique_ptr<SkPictureData> data,
+                                       size_t opOffset, size_t opSize)
+    : fStream(std::move(stream))
+    , fInfo(info)
+    , fData(std::move(data))
+    , fOpOffset(opOffset)
+    , fOpSize(opSize)
+    , fMemoryLimit(kDefaultMemoryLimit)
+    , fWindowCapacity(0) {
+    memset(&fStats, 0, sizeof(fStats));
+}
+
+SkStreamingPicture::~SkStreamingPicture() {}
+
+void SkStreamingPicture::setMemoryLimit(size_t bytes) {
+    // Enough for any op's size to be read.
+    fMemoryLimit = SkTMax(bytes, (size_t)64);
+    if (fWindowCapacity > fMemoryLimit) {
+        fWindow.reset(0);
+        fWindowCapacity = 0;
+    }
+}
+
+bool SkStreamingPicture::readWindow(size_t offset, size_t size) {
+    SkASSERT(offset + size <= fOpSize);
+    if (size > fWindowCapacity) {
+        fWindow.reset(size);
+        fWindowCapacity = size;
+        fStats.fPeakBytes = SkTMax(fStats.fPeakBytes, size);
+    }
+    if (!fStream->seek(fOpOffset + offset) || fStream->read(fWindow.get(), size) != size) {
+        return false;
+    }
+    fStats.fBytesRead += size;
+    return true;
+}
+
+template <typename Fn>
+bool SkStreamingPicture::forEachOp(Fn&& fn) {
+    size_t offset = 0;
+    while (offset < fOpSize) {
+        size_t size = SkTMin(fMemoryLimit, fOpSize - offset);
+        if (!this->readWindow(offset, size)) {
+            return false;
+        }
+        size_t used = 0, opSize;
+        while (read_op_size(fWindow.get() + used, size - used, &opSize) &&
+               opSize <= size - used) {
+            if (!fn(offset + used, fWindow.get() + used, opSize)) {
+                return false;
+            }
+            used += opSize;
+        }
+        if (0 == used) {
+            // This op is bigger than the window, so it gets one of its own.
+            if (!read_op_size(fWindow.get(), size, &opSize) || opSize > fOpSize - offset ||
+                !this->readWindow(offset, opSize) || !fn(offset, fWindow.get(), opSize)) {
+                return false;
+            }
+            used = opSize;
+        }
+        offset += used;
+    }
+    return true;
+}
+
+bool SkStreamingPicture::buildIndex() {
+    SkTDArray<uint32_t> offsets;
+    SkTDArray<int> firstRecordOps;  // the SkRecord ops each op recorded start here
+    SkTDArray<uint8_t> ops;
+
+    SkRecordBoundsBuilder builder(this->cullRect());
+    sk_sp<SkRecord> record = sk_make_sp<SkRecord>();
+    SkRecorder recorder(record.get(), this->cullRect());
+    SkPicturePlayback playback(fData.get());
+    int recordOps = 0;  // in the pieces already handed to the builder
+
+    bool ok = this->forEachOp([&](size_t offset, const void* op, size_t size) {
+        *offsets.append() = SkToU32(offset);
+        *firstRecordOps.append() = recordOps + record->count();
+        *ops.append() = SkToU8(*(const uint32_t*)op >> 24);
+        if (!playback.drawOp(&recorder, op, size, SkMatrix::I())) {
+            return false;
+        }
+        if (record->count() >= kRecordOpsPerPiece) {
+            recordOps += record->count();
+            builder.append(std::move(record));
+            record = sk_make_sp<SkRecord>();
+            recorder.setRecord(record.get());
+        }
+        return true;
+    });
+    if (!ok) {
+        return false;
+    }
+    recordOps += record->count();
+    builder.append(std::move(record));
+    builder.finish();
+    *offsets.append() = SkToU32(fOpSize);
+    *firstRecordOps.append() = recordOps;
+
+    // An op's bounds are those of all it recorded. Ops that recorded nothing do nothing.
+    const SkTDArray<SkRect>& recordBounds = builder.bounds();
+    int count = offsets.count() - 1;
+    fBounds.setCount(count);
+    for (int i = 0; i < count; i++) {
+        SkRect bounds = SkRect::MakeEmpty();
+        for (int j = firstRecordOps[i]; j < firstRecordOps[i + 1]; j++) {
+            bounds.join(recordBounds[j]);
+        }
+        fBounds[i] = bounds;
+    }
+
+    // SkCanvas defers saves until something needs them, so a save records nothing of its own,
+    // and a restore of a save never needed records nothing either. Either way a save and its
+    // restore must be drawn together, so both get the bounds of everything between them.
+    auto join = [this](int start, int stop) {
+        SkRect bounds = SkRect::MakeEmpty();
+        for (int i = start; i <= stop; i++) {
+            bounds.join(fBounds[i]);
+        }
+        return bounds;
+    };
+    SkTDArray<int> saves;
+    for (int i = 0; i < count; i++) {
+        if (is_save(ops[i])) {
+            saves.push(i);
+        } else if (RESTORE == ops[i] && !saves.isEmpty()) {
+            int save = saves.top();
+            fBounds[save] = fBounds[i] = join(save, i);
+            saves.pop();
+        }
+    }
+    while (!saves.isEmpty()) {
+        int save = saves.top();
+        fBounds[save] = join(save, count - 1);
+        saves.pop();
+    }
+    fOffsets.swap(offsets);
+    return true;
+}
+
+bool SkStreamingPicture::writeIndex(SkWStream* stream) const {
+    if (!this->hasIndex()) {
+        return false;
+    }
+    return stream->write32(kIndexMagic) &&
+           stream->write32(kIndexVersion) &&
+           stream->write32(SkToU32(fOpSize)) &&
+           stream->write(&fInfo.fCullRect, sizeof(SkRect)) &&
+           stream->write32(fBounds.count()) &&
+           stream->write(fOffsets.begin(), fOffsets.count() * sizeof(uint32_t)) &&
+           stream->write(fBounds.begin(), fBounds.count() * sizeof(SkRect));
+}
+
+bool SkStreamingPicture::readIndex(SkStream* stream) {
+    uint32_t magic, version, opSize, count;
+    SkRect cullRect;
+    if (!read_u32(stream, &magic)   || kIndexMagic != magic ||
+        !read_u32(stream, &version) || kIndexVersion != version ||
+        !read_u32(stream, &opSize)  || fOpSize != opSize ||
+        stream->read(&cullRect, sizeof(cullRect)) != sizeof(cullRect) ||
+        cullRect != fInfo.fCullRect ||
+        !read_u32(stream, &count)   || 0 == count || count > fOpSize / 4) {
+        return false;
+    }
+
+    SkTDArray<uint32_t> offsets;
+    SkTDArray<SkRect> bounds;
+    offsets.setCount(count + 1);
+    bounds.setCount(count);
+    if (stream->read(offsets.begin(), offsets.count() * sizeof(uint32_t)) !=
+            offsets.count() * sizeof(uint32_t) ||
+        stream->read(bounds.begin(), bounds.count() * sizeof(SkRect)) !=
+            bounds.count() * sizeof(SkRect)) {
+        return false;
+    }
+    if (0 != offsets[0] || fOpSize != offsets[count]) {
+        return false;
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (offsets[i] >= offsets[i + 1] || !SkIsAlign4(offsets[i])) {
+            return false;
+        }
+    }
+    fOffsets.swap(offsets);
+    fBounds.swap(bounds);
+    return true;
+}
+
+void SkStreamingPicture::playback(SkCanvas* canvas) {
+    SkAutoCanvasRestore acr(canvas, false);
+    SkMatrix initialMatrix = canvas->getTotalMatrix();
+    SkPicturePlayback playback(fData.get());
+
+    if (!this->hasIndex()) {
+        this->forEachOp([&](size_t, const void* op, size_t size) {
+            fStats.fOpsDrawn++;
+            return playback.drawOp(canvas, op, size, initialMatrix);
+        });
+        return;
+    }
+
+    SkRect query;
+    if (!canvas->getClipBounds(&query)) {
+        return;
+    }
+    const int count = fBounds.count();
+    int i = 0;
+    while (i < count) {
+        if (!SkRect::Intersects(fBounds[i], query)) {
+            i++;
+            continue;
+        }
+        // Read this op, and whichever of the next ones we'll draw that fit in the same window.
+        const size_t start = fOffsets[i];
+        size_t end = fOffsets[i + 1];
+        int last = i;
+        for (int j = i + 1; j < count && fOffsets[j + 1] - start <= fMemoryLimit; j++) {
+            if (SkRect::Intersects(fBounds[j], query)) {
+                end = fOffsets[j + 1];
+                last = j;
+            }
+        }
+        if (!this->readWindow(start, end - start)) {
+            return;
+        }
+        for (int j = i; j <= last; j++) {
+            if (j == i || SkRect::Intersects(fBounds[j], query)) {
+                fStats.fOpsDrawn++;
+                const uint8_t* op = fWindow.get() + (fOffsets[j] - start);
+                if (!playback.drawOp(canvas, op, fOffsets[j + 1] - fOffsets[j], initialMatrix)) {
+                    return;
+                }
+            }
+        }
+        i = last + 1;
+    }
+}
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStreamingPicture_DEFINED
+#define SkStreamingPicture_DEFINED
+
+#include "SkPictureData.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+#include "SkTemplates.h"
+#include <memory>
+
+class SkCanvas;
+class SkImageDeserializer;
+class SkStream;
+class SkStreamAsset;
+class SkWStream;
+
+/**
+ *  Draws an SKP straight from its stream, for pictures whose ops are too many to hold in memory,
+ *  let alone expand into an SkRecord. Everything else in the SKP (paints, paths, images, ...) is
+ *  read up front as usual; the ops are read as they are drawn, at most setMemoryLimit() bytes of
+ *  them at a time.
+ *
+ *  Without an index, every op is read and drawn. buildIndex() reads through the ops once and
+ *  notes where each one is and what it can touch; from then on, playback() reads only the ops
+ *  that can touch the canvas's clip, so drawing a tile reads a fraction of the stream. The index
+ *  can be saved alongside the SKP with writeIndex() and loaded again with readIndex().
+ *
+ *  Not thread safe.
+ */
+class SkStreamingPicture : SkNoncopyable {
+public:
+    /**
+     *  Returns null if the stream does not hold an SKP. The stream must stay seekable: ops are
+     *  read from it as they are drawn.
+     */
+    static std::unique_ptr<SkStreamingPicture> Make(std::unique_ptr<SkStreamAsset>,
+                                                    SkImageDeserializer* = nullptr);
+
+    ~SkStreamingPicture();
+
+    const SkRect& cullRect() const { return fInfo.fCullRect; }
+
+    static const size_t kDefaultMemoryLimit = 4 * 1024 * 1024;
+
+    /**
+     *  How many bytes of ops to hold in memory at a time. A single op larger than this is still
+     *  read, on its own.
+     */
+    void setMemoryLimit(size_t bytes);
+
+    bool hasIndex() const { return !fBounds.isEmpty(); }
+
+    /** The number of ops. Only known once there is an index. */
+    int opCount() const { return fBounds.count(); }
+
+    /**
+     *  Reads through the ops, noting the offset and conservative bounds of each. Returns false
+     *  (and leaves no index) if the ops cannot be read.
+     */
+    bool buildIndex();
+
+    /** Writes the index in a form readIndex() accepts. Returns false if there is no index. */
+    bool writeIndex(SkWStream*) const;
+
+    /**
+     *  Reads an index written by writeIndex(). Returns false (and leaves any index there was)
+     *  if it is malformed or was not built for this SKP.
+     */
+    bool readIndex(SkStream*);
+
+    /**
+     *  Draws the picture. With an index, only the ops that can touch the canvas's clip are read
+     *  and drawn.
+     */
+    void playback(SkCanvas*);
+
+    struct Stats {
+        size_t fBytesRead;     // Of ops, from the stream.
+        size_t fPeakBytes;     // The most bytes of ops held at once.
+        int    fOpsDrawn;
+    };
+
+    /** Totals since the picture was made. */
+    const Stats& stats() const { return fStats; }
+
+private:
+    SkStreamingPicture(std::unique_ptr<SkStreamAsset>, const SkPictInfo&,
+                       std::unique_ptr<SkPictureData>, size_t opOffset, size_t opSize);
+
+    // Reads [offset, offset + size) of the ops into fWindow.
+    bool readWindow(size_t offset, size_t size);
+
+    // Calls fn(offset, op, size) for each op in turn, reading them a window at a time.
+    template <typename Fn>
+    bool forEachOp(Fn&& fn);
+
+    std::unique_ptr<SkStreamAsset> fStream;
+    const SkPictInfo               fInfo;
+    std::unique_ptr<SkPictureData> fData;
+    const size_t                   fOpOffset;  // where the ops start in fStream
+    const size_t                   fOpSize;
+    size_t                         fMemoryLimit;
+
+    SkAutoTMalloc<uint8_t>         fWindow;
+    size_t                         fWindowCapacity;
+
+    // The index: fOffsets has one more entry than fBounds, the end of the ops.
+    SkTDArray<uint32_t>            fOffsets;
+    SkTDArray<SkRect>              fBounds;
+
+    Stats                          fStats;
+};
+
+#endif
@@ -7,7 +7,9 @@
 
 #include "SkStrokerPriv.h"
 #include "SkGeometry.h"
+#include "SkNx.h"
 #include "SkPathPriv.h"
+#include "SkTArray.h"
 
 enum {
     kTangent_RecursiveLimit,
@@ -129,6 +131,7 @@ public:
 
     void moveTo(const SkPoint&);
     void lineTo(const SkPoint&, const SkPath::Iter* iter = nullptr);
+    void lineRun(const SkPoint pts[], int count);
     void quadTo(const SkPoint&, const SkPoint&);
     void conicTo(const SkPoint&, const SkPoint&, SkScalar weight);
     void cubicTo(const SkPoint&, const SkPoint&, const SkPoint&);
@@ -142,6 +145,8 @@ public:
 
     SkScalar getResScale() const { return fResScale; }
 
+    bool joinCompleted() const { return fJoinCompleted; }
+
     bool isZeroLength() const {
         return fInner.isZeroLength() && fOuter.isZeroLength();
     }
@@ -237,6 +242,7 @@ private:
     void    finishContour(bool close, bool isLine);
     bool    preJoinTo(const SkPoint&, SkVector* normal, SkVector* unitNormal,
                       bool isLine);
+    void    joinTo(const SkVector& normal, const SkVector& unitNormal, bool isLine);
     void    postJoinTo(const SkPoint&, const SkVector& normal,
                        const SkVector& unitNormal);
 
@@ -249,9 +255,6 @@ bool SkPathStroker::preJoinTo(const SkPoint& currPt, SkVector* normal,
                               SkVector* unitNormal, bool currIsLine) {
     SkASSERT(fSegmentCount >= 0);
 
-    SkScalar    prevX = fPrevPt.fX;
-    SkScalar    prevY = fPrevPt.fY;
-
     if (!set_normal_unitnormal(fPrevPt, currPt, fResScale, fRadius, normal, unitNormal)) {
         if (SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper) {
             return false;
@@ -263,19 +266,27 @@ bool SkPathStroker::preJoinTo(const SkPoint& currPt, SkVector* normal,
         unitNormal->set(1, 0);
     }
 
+    this->joinTo(*normal, *unitNormal, currIsLine);
+    return true;
+}
+
+void SkPathStroker::joinTo(const SkVector& normal, const SkVector& unitNormal,
+                           bool currIsLine) {
+    SkScalar    prevX = fPrevPt.fX;
+    SkScalar    prevY = fPrevPt.fY;
+
     if (fSegmentCount == 0) {
-        fFirstNormal = *normal;
-        fFirstUnitNormal = *unitNormal;
-        fFirstOuterPt.set(prevX + normal->fX, prevY + normal->fY);
+        fFirstNormal = normal;
+        fFirstUnitNormal = unitNormal;
+        fFirstOuterPt.set(prevX + normal.fX, prevY + normal.fY);
 
         fOuter.moveTo(fFirstOuterPt.fX, fFirstOuterPt.fY);
-        fInner.moveTo(prevX - normal->fX, prevY - normal->fY);
+        fInner.moveTo(prevX - normal.fX, prevY - normal.fY);
     } else {    // we have a previous segment
-        fJoiner(&fOuter, &fInner, fPrevUnitNormal, fPrevPt, *unitNormal,
+        fJoiner(&fOuter, &fInner, fPrevUnitNormal, fPrevPt, unitNormal,
                 fRadius, fInvMiterLimit, fPrevIsLine, currIsLine);
     }
     fPrevIsLine = currIsLine;
-    return true;
 }
 
 void SkPathStroker::postJoinTo(const SkPoint& currPt, const SkVector& normal,
@@ -434,6 +445,58 @@ void SkPathStroker::lineTo(const SkPoint& currPt, const SkPath::Iter* iter) {
     this->postJoinTo(currPt, normal, unitNormal);
 }
 
+// Strokes the lines from the previous point through pts[0] ... pts[count - 1], as count calls to
+// lineTo() would. Only used once the contour has a join, so that a teeny line never has to look
+// ahead for a tangent. The unit normals of all of the lines are found up front, two at a time;
+// lines that would not get the same answer that way (degenerate ones, those that follow a skipped
+// line, and those too long to square in a float) go through preJoinTo() instead.
+void SkPathStroker::lineRun(const SkPoint pts[], int count) {
+    SkASSERT(fJoinCompleted);
+    SkAutoSTMalloc<32, SkVector> unitNormals(count + 1);
+    SkAutoSTMalloc<32, bool> fast(count + 1);
+    const Sk4f scale(fResScale);
+    const Sk4f nearlyZero2(SK_ScalarNearlyZero * SK_ScalarNearlyZero);
+    for (int i = 0; i < count; i += 2) {
+        const SkPoint& prev = i > 0 ? pts[i - 1] : fPrevPt;
+        // the second lane is a throwaway past the end of an odd count
+        const SkPoint& curr = i + 1 < count ? pts[i + 1] : pts[i];
+        Sk4f from(prev.fX, prev.fY, pts[i].fX, pts[i].fY),
+             to(pts[i].fX, pts[i].fY, curr.fX, curr.fY);
+        Sk4f d = (to - from) * scale;
+        Sk4f d2 = d * d;
+        // x*x + y*y in both lanes of each line, as SkPoint::setLength() computes it
+        Sk4f mag2 = d2 + SkNx_shuffle<1, 0, 3, 2>(d2);
+        Sk4f unit = d * (Sk4f(1) / mag2.sqrt());
+        float m[4], u[4];
+        mag2.store(m);
+        unit.store(u);
+        for (int j = 0; j < 2; ++j) {
+            // rotated CCW, as set_normal_unitnormal() does
+            unitNormals[i + j].set(u[2 * j + 1], -u[2 * j]);
+            fast[i + j] = m[2 * j] > SK_ScalarNearlyZero * SK_ScalarNearlyZero &&
+                          SkScalarIsFinite(m[2 * j]);
+        }
+    }
+
+    const SkScalar tolerance = SK_ScalarNearlyZero * fInvResScale;
+    for (int i = 0; i < count; ++i) {
+        const SkPoint& currPt = pts[i];
+        if (fPrevPt.equalsWithinTolerance(currPt, tolerance)) {
+            continue;
+        }
+        SkVector normal, unitNormal;
+        if (fast[i] && fPrevPt == (i > 0 ? pts[i - 1] : fPrevPt)) {
+            unitNormal = unitNormals[i];
+            unitNormal.scale(fRadius, &normal);
+            this->joinTo(normal, unitNormal, true);
+        } else if (!this->preJoinTo(currPt, &normal, &unitNormal, true)) {
+            continue;
+        }
+        this->line_to(currPt, normal);
+        this->postJoinTo(currPt, normal, unitNormal);
+    }
+}
+
 void SkPathStroker::setQuadEndNormal(const SkPoint quad[3], const SkVector& normalAB,
         const SkVector& unitNormalAB, SkVector* normalBC, SkVector* unitNormalBC) {
     if (!set_normal_unitnormal(quad[1], quad[2], fResScale, fRadius, normalBC, unitNormalBC)) {
@@ -1396,14 +1459,27 @@ void SkStroke::strokePath(const SkPath& src, SkPath* dst) const {
     SkPath::Iter    iter(src, false);
     SkPath::Verb    lastSegment = SkPath::kMove_Verb;
 
+    // Polylines are stroked a run of lines at a time, once each contour is under way.
+    const bool lineOnly = src.getSegmentMasks() == SkPath::kLine_SegmentMask;
+    SkSTArray<32, SkPoint, true> lineRun;
+
     for (;;) {
         SkPoint  pts[4];
-        switch (iter.next(pts, false)) {
+        SkPath::Verb verb = iter.next(pts, false);
+        if (SkPath::kLine_Verb != verb && !lineRun.empty()) {
+            stroker.lineRun(lineRun.begin(), lineRun.count());
+            lineRun.reset();
+        }
+        switch (verb) {
             case SkPath::kMove_Verb:
                 stroker.moveTo(pts[0]);
                 break;
             case SkPath::kLine_Verb:
-                stroker.lineTo(pts[1], &iter);
+                if (lineOnly && stroker.joinCompleted()) {
+                    lineRun.push_back(pts[1]);
+                } else {
+                    stroker.lineTo(pts[1], &iter);
+                }
                 lastSegment = SkPath::kLine_Verb;
                 break;
             case SkPath::kQuad_Verb:
@@ -0,0 +1,91 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkChecksum.h"
+#include "SkStrokeCache.h"
+#include <atomic>
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+// Polylines shorter than this stroke about as fast as they are looked up.
+static const int kMinLinePointsToCache = 16;
+
+// The generation IDs of recently stroked paths, one per slot. Races only cost a cache entry.
+static const int kSeenSlots = 1024;
+static std::atomic<uint32_t> gSeenGenIDs[kSeenSlots];
+
+bool SkStrokeCache::CanCache(const SkPath& src, SkScalar resScale) {
+    if (src.isVolatile() || !(resScale > 0) || !SkScalarIsFinite(resScale)) {
+        return false;
+    }
+    return SkPath::kLine_SegmentMask != src.getSegmentMasks() ||
+           src.countPoints() >= kMinLinePointsToCache;
+}
+
+bool SkStrokeCache::SeenBefore(const SkPath& src) {
+    const uint32_t genID = src.getGenerationID();
+    std::atomic<uint32_t>& slot = gSeenGenIDs[SkChecksum::Mix(genID) & (kSeenSlots - 1)];
+    return slot.exchange(genID, std::memory_order_relaxed) == genID;
+}
+
+namespace {
+static unsigned gStrokeKeyNamespaceLabel;
+
+struct StrokeKey : public SkResourceCache::Key {
+public:
+    StrokeKey(const SkPath& src, const SkStrokeRec& rec, SkScalar resScale)
+        : fGenID(src.getGenerationID())
+        , fFlags(src.getFillType() | (rec.getCap() << 2) | (rec.getJoin() << 4) |
+                 ((SkStrokeRec::kStrokeAndFill_Style == rec.getStyle()) << 6))
+        , fWidth(rec.getWidth())
+        , fMiter(rec.getMiter())
+        , fResScale(resScale)
+    {
+        this->init(&gStrokeKeyNamespaceLabel, 0,
+                   sizeof(fGenID) + sizeof(fFlags) + sizeof(fWidth) + sizeof(fMiter) +
+                   sizeof(fResScale));
+    }
+
+    uint32_t fGenID;
+    uint32_t fFlags;
+    SkScalar fWidth;
+    SkScalar fMiter;
+    SkScalar fResScale;
+};
+
+struct StrokeRec : public SkResourceCache::Rec {
+    StrokeRec(const StrokeKey& key, const SkPath& path) : fKey(key), fPath(path) {}
+
+    StrokeKey fKey;
+    SkPath    fPath;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fPath.countPoints() * sizeof(SkPoint) + fPath.countVerbs();
+    }
+    const char* getCategory() const override { return "stroke"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextPath) {
+        const StrokeRec& rec = static_cast<const StrokeRec&>(baseRec);
+        *static_cast<SkPath*>(contextPath) = rec.fPath;
+        return true;
+    }
+};
+} // namespace
+
+bool SkStrokeCache::Find(const SkPath& src, const SkStrokeRec& rec, SkScalar resScale,
+                         SkPath* dst, SkResourceCache* localCache) {
+    StrokeKey key(src, rec, resScale);
+    return CHECK_LOCAL(localCache, find, Find, key, StrokeRec::Visitor, dst);
+}
+
+void SkStrokeCache::Add(const SkPath& src, const SkStrokeRec& rec, SkScalar resScale,
+                        const SkPath& dst, SkResourceCache* localCache) {
+    StrokeKey key(src, rec, resScale);
+    return CHECK_LOCAL(localCache, add, Add, new StrokeRec(key, dst));
+}
@@ -0,0 +1,48 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "SkPath.h"
+#include "SkResourceCache.h"
+#include "SkStrokeRec.h"
+
+/**
+ *  Remembers the outlines that SkStrokeRec::applyToPath() builds, so that stroking the same path
+ *  again (e.g. a chart redrawn every frame) skips the stroker.
+ *
+ *  Entries are found by the source path's generation ID and fill type, the stroke parameters and
+ *  the exact resolution scale, so a cached outline is always the one the stroker would build.
+ *
+ *  Most paths are stroked just once: the temporary ones that drawOval() and friends build get a
+ *  new generation ID on every draw. To keep those from pushing useful entries out of the
+ *  SkResourceCache, an outline is only added once its path is stroked a second time.
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  Returns true if strokes of src are worth caching: src is not volatile, and has curves or
+     *  enough lines that stroking it costs more than a lookup.
+     */
+    static bool CanCache(const SkPath& src, SkScalar resScale);
+
+    /**
+     *  Returns true if src was recently passed here before. Notes src for next time if not.
+     *  (Best effort: a few of the most recent generation IDs are kept, and may be forgotten.)
+     */
+    static bool SeenBefore(const SkPath& src);
+
+    /** On success, set dst to the outline of src stroked with rec at resScale, and return true. */
+    static bool Find(const SkPath& src, const SkStrokeRec& rec, SkScalar resScale, SkPath* dst,
+                     SkResourceCache* localCache = nullptr);
+
+    static void Add(const SkPath& src, const SkStrokeRec& rec, SkScalar resScale,
+                    const SkPath& dst, SkResourceCache* localCache = nullptr);
+};
+
+#endif
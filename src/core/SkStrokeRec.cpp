@@ -95,6 +95,7 @@ void SkStrokeRec::setStrokeStyle(SkScalar width, bool strokeAndFill) {
 }
 
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 
 #ifdef SK_DEBUG
     // enables tweaking these values at runtime from SampleApp
@@ -107,18 +108,34 @@ bool SkStrokeRec::applyToPath(SkPath* dst, const SkPath& src) const {
         return false;
     }
 
+    SkScalar resScale = fResScale;
+#ifdef SK_DEBUG
+    if (gDebugStrokerErrorSet) {
+        resScale = gDebugStrokerError;
+    }
+#endif
+    // Paths that are stroked over and over (e.g. on every frame) are found in the cache instead.
+    // Those stroked only once are never looked up or added.
+    const bool cache = dst != &src && SkStrokeCache::CanCache(src, resScale) &&
+                       SkStrokeCache::SeenBefore(src);
+    if (cache) {
+        if (SkStrokeCache::Find(src, *this, resScale, dst)) {
+            return true;
+        }
+    }
+
     SkStroke stroker;
     stroker.setCap((SkPaint::Cap)fCap);
     stroker.setJoin((SkPaint::Join)fJoin);
     stroker.setMiterLimit(fMiterLimit);
     stroker.setWidth(fWidth);
     stroker.setDoFill(fStrokeAndFill);
-#ifdef SK_DEBUG
-    stroker.setResScale(gDebugStrokerErrorSet ? gDebugStrokerError : fResScale);
-#else
-    stroker.setResScale(fResScale);
-#endif
+    stroker.setResScale(resScale);
     stroker.strokePath(src, dst);
+
+    if (cache) {
+        SkStrokeCache::Add(src, *this, resScale, *dst);
+    }
     return true;
 }
 
@@ -175,12 +175,17 @@ void SkBinaryWriteBuffer::writeImage(const SkImage* image) {
         return;
     }
 
+    sk_sp<SkData> encoded(image->encode(this->getPixelSerializer()));
+    this->writeEncodedImage(image, encoded.get());
+}
+
+void SkBinaryWriteBuffer::writeEncodedImage(const SkImage* image, SkData* encoded) {
+    SkASSERT(!fDeduper);
     this->writeInt(image->width());
     this->writeInt(image->height());
 
-    sk_sp<SkData> encoded(image->encode(this->getPixelSerializer()));
     if (encoded && encoded->size() > 0) {
-        write_encoded_bitmap(this, encoded.get(), SkIPoint::Make(0, 0));
+        write_encoded_bitmap(this, encoded, SkIPoint::Make(0, 0));
         return;
     }
 
@@ -97,6 +97,31 @@ private:
 
 } // anonymous namespace
 
+static unsigned gIntervalListKeyNamespaceLabel;
+
+struct SkGradientShaderBase::GradientShaderBase4fContext::IntervalListRec
+        : public SkResourceCache::Rec {
+    IntervalListRec(SkGradientCacheKey* key, sk_sp<const IntervalList> intervals)
+        : fKey(key)
+        , fIntervals(std::move(intervals)) {}
+
+    const Key& getKey() const override { return *fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fKey->size() + sizeof(IntervalList)
+             + fIntervals->count() * sizeof(Interval);
+    }
+    const char* getCategory() const override { return "gradient"; }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* context) {
+        const IntervalListRec& rec = static_cast<const IntervalListRec&>(baseRec);
+        *static_cast<sk_sp<const IntervalList>*>(context) = rec.fIntervals;
+        return true;
+    }
+
+    std::unique_ptr<SkGradientCacheKey> fKey;
+    sk_sp<const IntervalList>           fIntervals;
+};
+
 SkGradientShaderBase::GradientShaderBase4fContext::
 Interval::Interval(const Sk4f& c0, SkScalar p0,
                    const Sk4f& c1, SkScalar p1)
@@ -191,9 +216,33 @@ GradientShaderBase4fContext::buildIntervals(const SkGradientShaderBase& shader,
     //
     // TODO: investigate collapsing intervals << 1px.
 
+    // The list only depends on the stops, the tiling, the paint alpha, the interpolation space and
+    // the direction, so contexts share it when those match.
+
     SkASSERT(shader.fColorCount > 0);
     SkASSERT(shader.fOrigColors);
 
+    SkSTArray<32, uint32_t, true> keyData;
+    keyData.push_back(shader.fTileMode);
+    keyData.push_back(reverse);
+    keyData.push_back(fColorsArePremul);
+    keyData.push_back(rec.fPaint->getAlpha());
+    keyData.push_back(shader.fColorCount);
+    keyData.push_back_n(shader.fColorCount, shader.fOrigColors);
+    keyData.push_back(SkToBool(shader.fOrigPos));
+    if (shader.fOrigPos) {
+        keyData.push_back_n(shader.fColorCount,
+                            reinterpret_cast<const uint32_t*>(shader.fOrigPos));
+    }
+    std::unique_ptr<SkGradientCacheKey> key(
+            SkGradientCacheKey::Create(&gIntervalListKeyNamespaceLabel,
+                                       keyData.begin(), keyData.count()));
+    if (SkResourceCache::Find(*key, IntervalListRec::Finder, &fIntervals)) {
+        return;
+    }
+
+    sk_sp<IntervalList> intervals(new IntervalList);
+
     const float paintAlpha = rec.fPaint->getAlpha() * (1.0f / 255);
     const Sk4f componentScale = fColorsArePremul
         ? Sk4f(paintAlpha)
@@ -208,21 +257,22 @@ GradientShaderBase4fContext::buildIntervals(const SkGradientShaderBase& shader,
         const Sk4f clamp_color = pack_color(shader.fOrigColors[first_index],
                                             fColorsArePremul, componentScale);
         const SkScalar clamp_pos = reverse ? SK_ScalarInfinity : SK_ScalarNegativeInfinity;
-        fIntervals.emplace_back(clamp_color, clamp_pos,
+        intervals->emplace_back(clamp_color, clamp_pos,
                                 clamp_color, first_pos);
     } else if (shader.fTileMode == SkShader::kMirror_TileMode && reverse) {
         // synthetic mirror intervals injected before main intervals: (2 .. 1]
-        addMirrorIntervals(shader, componentScale, false);
+        this->addMirrorIntervals(shader, intervals.get(), componentScale, false);
     }
 
     const IntervalIterator iter(shader.fOrigColors,
                                 shader.fOrigPos,
                                 shader.fColorCount,
                                 reverse);
-    iter.iterate([this, &componentScale] (SkColor c0, SkColor c1, SkScalar p0, SkScalar p1) {
-        SkASSERT(fIntervals.empty() || fIntervals.back().fP1 == p0);
+    iter.iterate([this, &intervals, &componentScale] (SkColor c0, SkColor c1,
+                                                      SkScalar p0, SkScalar p1) {
+        SkASSERT(intervals->empty() || intervals->back().fP1 == p0);
 
-        fIntervals.emplace_back(pack_color(c0, fColorsArePremul, componentScale),
+        intervals->emplace_back(pack_color(c0, fColorsArePremul, componentScale),
                                 p0,
                                 pack_color(c1, fColorsArePremul, componentScale),
                                 p1);
@@ -233,30 +283,35 @@ GradientShaderBase4fContext::buildIntervals(const SkGradientShaderBase& shader,
         const Sk4f clamp_color = pack_color(shader.fOrigColors[last_index],
                                             fColorsArePremul, componentScale);
         const SkScalar clamp_pos = reverse ? SK_ScalarNegativeInfinity : SK_ScalarInfinity;
-        fIntervals.emplace_back(clamp_color, last_pos,
+        intervals->emplace_back(clamp_color, last_pos,
                                 clamp_color, clamp_pos);
     } else if (shader.fTileMode == SkShader::kMirror_TileMode && !reverse) {
         // synthetic mirror intervals injected after main intervals: [1 .. 2)
-        addMirrorIntervals(shader, componentScale, true);
+        this->addMirrorIntervals(shader, intervals.get(), componentScale, true);
     }
+
+    fIntervals = intervals;
+    SkResourceCache::Add(new IntervalListRec(key.release(), std::move(intervals)));
 }
 
 void SkGradientShaderBase::
 GradientShaderBase4fContext::addMirrorIntervals(const SkGradientShaderBase& shader,
-                                            const Sk4f& componentScale, bool reverse) {
+                                                IntervalList* intervals,
+                                                const Sk4f& componentScale, bool reverse) const {
     const IntervalIterator iter(shader.fOrigColors,
                                 shader.fOrigPos,
                                 shader.fColorCount,
                                 reverse);
-    iter.iterate([this, &componentScale] (SkColor c0, SkColor c1, SkScalar p0, SkScalar p1) {
-        SkASSERT(fIntervals.empty() || fIntervals.back().fP1 == 2 - p0);
+    iter.iterate([this, intervals, &componentScale] (SkColor c0, SkColor c1,
+                                                     SkScalar p0, SkScalar p1) {
+        SkASSERT(intervals->empty() || intervals->back().fP1 == 2 - p0);
 
         const auto mirror_p0 = 2 - p0;
         const auto mirror_p1 = 2 - p1;
         // mirror_p1 & mirror_p1 may collapse for very small values - recheck to avoid
         // triggering Interval asserts.
         if (mirror_p0 != mirror_p1) {
-            fIntervals.emplace_back(pack_color(c0, fColorsArePremul, componentScale),
+            intervals->emplace_back(pack_color(c0, fColorsArePremul, componentScale),
                                     mirror_p0,
                                     pack_color(c1, fColorsArePremul, componentScale),
                                     mirror_p1);
@@ -335,8 +390,8 @@ template<DstType dstType, ApplyPremul premul, SkShader::TileMode tileMode>
 class SkGradientShaderBase::GradientShaderBase4fContext::TSampler {
 public:
     TSampler(const GradientShaderBase4fContext& ctx)
-        : fFirstInterval(ctx.fIntervals.begin())
-        , fLastInterval(ctx.fIntervals.end() - 1)
+        : fFirstInterval(ctx.fIntervals->begin())
+        , fLastInterval(ctx.fIntervals->end() - 1)
         , fInterval(nullptr) {
         SkASSERT(fLastInterval >= fFirstInterval);
         switch (tileMode) {
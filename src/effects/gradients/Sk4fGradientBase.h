@@ -14,6 +14,7 @@
 #include "SkMatrix.h"
 #include "SkNx.h"
 #include "SkPM4f.h"
+#include "SkRefCnt.h"
 #include "SkShader.h"
 #include "SkTArray.h"
 
@@ -42,11 +43,15 @@ protected:
         bool     fZeroRamp;
     };
 
+    // Immutable once built. Equivalent contexts (same stops, tiling, paint alpha and direction)
+    // share one through the SkResourceCache, even across shaders.
+    class IntervalList : public SkNVRefCnt<IntervalList>, public SkSTArray<8, Interval, true> {};
+
     virtual void mapTs(int x, int y, SkScalar ts[], int count) const = 0;
 
     void buildIntervals(const SkGradientShaderBase&, const ContextRec&, bool reverse);
 
-    SkSTArray<8, Interval, true> fIntervals;
+    sk_sp<const IntervalList>    fIntervals;
     SkMatrix                     fDstToPos;
     SkMatrix::MapXYProc          fDstToPosProc;
     uint8_t                      fDstToPosClass;
@@ -57,8 +62,10 @@ protected:
 private:
     using INHERITED = SkShader::Context;
 
-    void addMirrorIntervals(const SkGradientShaderBase&,
-                            const Sk4f& componentScale, bool reverse);
+    struct IntervalListRec;
+
+    void addMirrorIntervals(const SkGradientShaderBase&, IntervalList*,
+                            const Sk4f& componentScale, bool reverse) const;
 
     template<DstType, ApplyPremul, SkShader::TileMode tileMode>
     class TSampler;
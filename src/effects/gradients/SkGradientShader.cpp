@@ -7,9 +7,13 @@
 
 #include "Sk4fLinearGradient.h"
 #include "SkColorSpace_XYZ.h"
+#include "SkFixedAlloc.h"
+#include "SkGradientShaderContext.h"
 #include "SkGradientShaderPriv.h"
 #include "SkHalf.h"
 #include "SkLinearGradient.h"
+#include "SkPM4fPriv.h"
+#include "SkRasterPipeline.h"
 #include "SkRadialGradient.h"
 #include "SkTwoPointConicalGradient.h"
 #include "SkSweepGradient.h"
@@ -372,6 +376,140 @@ bool SkGradientShaderBase::onAsLuminanceColor(SkColor* lum) const {
     return true;
 }
 
+// With more intervals than this, the gradient stage looks them up in a table instead of
+// comparing t against every boundary.
+static const int kMaxIntervalsToSearch = 8;
+static const int kMaxIntervalLUTSize = 1024;
+
+bool SkGradientShaderBase::onAppendStages(SkRasterPipeline* p,
+                                          SkColorSpace* dst,
+                                          SkFallbackAlloc* scratch,
+                                          const SkMatrix& ctm,
+                                          const SkPaint& paint) const {
+    // Legacy destinations keep the legacy gradient, with its dithering and unlinearized colors.
+    if (!dst) {
+        return false;
+    }
+    SkMatrix matrix;
+    if (!SkMatrix::Concat(ctm, this->getLocalMatrix()).invert(&matrix)) {
+        return false;
+    }
+    matrix.postConcat(fPtsToUnit);
+
+    auto ctx = scratch->make<SkGradientShaderContext>();
+    if (matrix.asAffine(ctx->matrix)) {
+        p->append(SkRasterPipeline::matrix_2x3, ctx->matrix);
+    } else {
+        matrix.get9(ctx->matrix);
+        p->append(SkRasterPipeline::matrix_perspective, ctx->matrix);
+    }
+    SkRasterPipeline postPipeline;
+    if (!this->appendGradientStages(ctx, p, &postPipeline)) {
+        return false;
+    }
+
+    // Zero-width intervals (hard stops) are never sampled, so they're left out.
+    const bool premulColors =
+            SkToBool(fGradFlags & SkGradientShader::kInterpolateColorsInPremul_Flag);
+    auto color = [&](int i) {
+        Sk4f c = Sk4f::Load(fOrigColors4f[i].vec());
+        return premulColors ? c * Sk4f(c[3], c[3], c[3], 1) : c;
+    };
+    SkSTArray<8, float, true> ts;
+    SkSTArray<8, SkColor4f, true> fs, bs;
+    auto appendInterval = [&](float t0, const Sk4f& f, const Sk4f& b) {
+        ts.push_back(t0);
+        f.store(fs.push_back().vec());
+        b.store(bs.push_back().vec());
+    };
+
+    // When clamping, t before the first stop is the first color and t after the last stop is the
+    // last color, each an interval of its own. Clamping t into [0,1] instead would give the
+    // color on the far side of a hard stop at 0 or 1.
+    appendInterval(-SK_FloatInfinity, 0.0f, color(0));  // Dropped below unless needed.
+    bool hardStopAtEnd = false;
+    float minWidth = 1;
+    float prev = 0;
+    for (int i = 0; i < fColorCount - 1; ++i) {
+        float t0 = prev,
+              t1 = fOrigPos ? SkTMax(fOrigPos[i + 1], t0) : (i + 1) / (fColorCount - 1.0f);
+        prev = t1;
+        if (t1 <= t0) {
+            hardStopAtEnd = hardStopAtEnd || 1 == ts.count() || i == fColorCount - 2;
+            continue;
+        }
+        Sk4f f = (color(i + 1) - color(i)) * (1 / (t1 - t0));
+        appendInterval(t0, f, color(i) - f * t0);
+        minWidth = SkTMin(minWidth, t1 - t0);
+    }
+    const int stopIntervals = ts.count() - 1;
+    if (0 == stopIntervals) {
+        return false;
+    }
+
+    // A lone interval with no hard stop at either end gives the same colors with t clamped, and
+    // can then use gradient_2stops.
+    const bool clampIntervals =
+            kClamp_TileMode == fTileMode && (stopIntervals > 1 || hardStopAtEnd);
+    if (clampIntervals) {
+        appendInterval(prev, 0.0f, color(fColorCount - 1));
+    }
+    ts.push_back(SK_FloatInfinity);
+    const int first = clampIntervals ? 0 : 1;
+
+    switch (fTileMode) {
+        case kClamp_TileMode:
+            if (!clampIntervals) {
+                p->append(SkRasterPipeline::clamp_x_1);
+            }
+            break;
+        case kMirror_TileMode: p->append(SkRasterPipeline::mirror_x_1); break;
+        case kRepeat_TileMode: p->append(SkRasterPipeline::repeat_x_1); break;
+    }
+
+    const int n = ts.count() - 1 - first;
+    ctx->intervalCount = n;
+    ctx->storage.reset(new float[9 * n + 1]);
+    ctx->ts = ctx->storage.get();
+    memcpy(ctx->ts, ts.begin() + first, (n + 1) * sizeof(float));
+    for (int c = 0; c < 4; ++c) {
+        ctx->fs[c] = ctx->ts + n + 1 + c * n;
+        ctx->bs[c] = ctx->ts + n + 1 + (4 + c) * n;
+        for (int i = 0; i < n; ++i) {
+            ctx->fs[c][i] = fs[first + i].vec()[c];
+            ctx->bs[c][i] = bs[first + i].vec()[c];
+        }
+    }
+
+    // Any bucket of the table, widened by half a bucket to the left to absorb rounding, must
+    // hold at most one boundary.
+    const float lutSize = SkScalarCeilToScalar(2 / minWidth);
+    if (n == 1) {
+        p->append(SkRasterPipeline::gradient_2stops, ctx);
+    } else if (n > kMaxIntervalsToSearch && lutSize <= kMaxIntervalLUTSize) {
+        ctx->lutSize = (int)lutSize;
+        ctx->lutStorage.reset(new int32_t[ctx->lutSize]);
+        ctx->lut = ctx->lutStorage.get();
+        int i = 0;
+        for (int k = 0; k < ctx->lutSize; ++k) {
+            float x = (k - 0.5f) / ctx->lutSize;
+            while (i + 1 < n && ctx->ts[i + 1] <= x) {
+                i++;
+            }
+            ctx->lut[k] = i;
+        }
+        p->append(SkRasterPipeline::gradient_lut, ctx);
+    } else {
+        p->append(SkRasterPipeline::gradient, ctx);
+    }
+
+    if (!premulColors) {
+        p->append(SkRasterPipeline::premul);
+    }
+    p->extend(postPipeline);
+    return append_gamut_transform(p, scratch, fColorSpace.get(), dst);
+}
+
 SkGradientShaderBase::GradientShaderBaseContext::GradientShaderBaseContext(
         const SkGradientShaderBase& shader, const ContextRec& rec)
     : INHERITED(shader, rec)
@@ -402,6 +540,63 @@ bool SkGradientShaderBase::GradientShaderBaseContext::isValid() const {
     return fDstToIndex.isFinite();
 }
 
+SkGradientCacheKey::SkGradientCacheKey(void* nameSpace, const uint32_t data[], int count) {
+    uint32_t* content = SkTAfter<uint32_t>(this);
+    // No holes.
+    SkASSERT(SkTAddOffset<uint32_t>(this, sizeof(SkResourceCache::Key)) == content);
+
+    memcpy(content, data, count * sizeof(uint32_t));
+    this->init(nameSpace, 0, count * sizeof(uint32_t));
+}
+
+SkGradientCacheKey* SkGradientCacheKey::Create(void* nameSpace, const uint32_t data[], int count) {
+    char* storage = new char[sizeof(SkGradientCacheKey) + count * sizeof(uint32_t)];
+    return new (storage) SkGradientCacheKey(nameSpace, data, count);
+}
+
+static unsigned gRamp32KeyNamespaceLabel;
+static unsigned gTableKeyNamespaceLabel;
+
+namespace {
+
+// A 32bit ramp, or a table bitmap. Its pixels are immutable, so finding it just shares them.
+struct GradientBitmapRec : public SkResourceCache::Rec {
+    GradientBitmapRec(SkGradientCacheKey* key, const SkBitmap& bitmap)
+        : fKey(key)
+        , fBitmap(bitmap) {}
+
+    const Key& getKey() const override { return *fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fKey->size() + fBitmap.getSize();
+    }
+    const char* getCategory() const override { return "gradient"; }
+
+    static bool Finder(const SkResourceCache::Rec& baseRec, void* context) {
+        const GradientBitmapRec& rec = static_cast<const GradientBitmapRec&>(baseRec);
+        *static_cast<SkBitmap*>(context) = rec.fBitmap;
+        return true;
+    }
+
+    std::unique_ptr<SkGradientCacheKey> fKey;
+    SkBitmap                            fBitmap;
+};
+
+} // anonymous namespace
+
+// The stops as the 32bit ramp sees them: the colors, and their fixed point positions when there
+// are more than two.
+static void append_stops(const SkGradientShaderBase& shader,
+                         SkSTArray<32, uint32_t, true>* keyData) {
+    keyData->push_back(shader.fColorCount);
+    keyData->push_back_n(shader.fColorCount, shader.fOrigColors);
+    if (shader.fColorCount > 2) {
+        const auto* recs = shader.getRecs();
+        for (int i = 1; i < shader.fColorCount; i++) {
+            keyData->push_back(recs[i].fPos);
+        }
+    }
+}
+
 SkGradientShaderBase::GradientShaderCache::GradientShaderCache(
         U8CPU alpha, bool dither, const SkGradientShaderBase& shader)
     : fCacheAlpha(alpha)
@@ -410,12 +605,9 @@ SkGradientShaderBase::GradientShaderCache::GradientShaderCache(
 {
     // Only initialize the cache in getCache32.
     fCache32 = nullptr;
-    fCache32PixelRef = nullptr;
 }
 
-SkGradientShaderBase::GradientShaderCache::~GradientShaderCache() {
-    SkSafeUnref(fCache32PixelRef);
-}
+SkGradientShaderBase::GradientShaderCache::~GradientShaderCache() {}
 
 /*
  *  r,g,b used to be SkFixed, but on gcc (4.2.1 mac and 4.6.3 goobuntu) in
@@ -580,30 +772,51 @@ const SkPMColor* SkGradientShaderBase::GradientShaderCache::getCache32() {
 }
 
 void SkGradientShaderBase::GradientShaderCache::initCache32(GradientShaderCache* cache) {
-    const int kNumberOfDitherRows = 4;
-    const SkImageInfo info = SkImageInfo::MakeN32Premul(kCache32Count, kNumberOfDitherRows);
-
-    SkASSERT(nullptr == cache->fCache32PixelRef);
-    cache->fCache32PixelRef = SkMallocPixelRef::NewAllocate(info, 0, nullptr);
-    cache->fCache32 = (SkPMColor*)cache->fCache32PixelRef->getAddr();
-    if (cache->fShader.fColorCount == 2) {
-        Build32bitCache(cache->fCache32, cache->fShader.fOrigColors[0],
-                        cache->fShader.fOrigColors[1], kCache32Count, cache->fCacheAlpha,
-                        cache->fShader.fGradFlags, cache->fCacheDither);
-    } else {
-        Rec* rec = cache->fShader.fRecs;
-        int prevIndex = 0;
-        for (int i = 1; i < cache->fShader.fColorCount; i++) {
-            int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache32Shift;
-            SkASSERT(nextIndex < kCache32Count);
-
-            if (nextIndex > prevIndex)
-                Build32bitCache(cache->fCache32 + prevIndex, cache->fShader.fOrigColors[i-1],
-                                cache->fShader.fOrigColors[i], nextIndex - prevIndex + 1,
-                                cache->fCacheAlpha, cache->fShader.fGradFlags, cache->fCacheDither);
-            prevIndex = nextIndex;
+    const SkGradientShaderBase& shader = cache->fShader;
+
+    SkSTArray<32, uint32_t, true> keyData;
+    keyData.push_back(cache->fCacheAlpha);
+    keyData.push_back(cache->fCacheDither);
+    keyData.push_back(shader.fGradFlags);
+    append_stops(shader, &keyData);
+    std::unique_ptr<SkGradientCacheKey> key(SkGradientCacheKey::Create(&gRamp32KeyNamespaceLabel,
+                                                                       keyData.begin(),
+                                                                       keyData.count()));
+
+    SkBitmap ramp;
+    if (!SkResourceCache::Find(*key, GradientBitmapRec::Finder, &ramp)) {
+        const int kNumberOfDitherRows = 4;
+        const SkImageInfo info = SkImageInfo::MakeN32Premul(kCache32Count, kNumberOfDitherRows);
+
+        sk_sp<SkMallocPixelRef> pixelRef(SkMallocPixelRef::NewAllocate(info, 0, nullptr));
+        SkPMColor* cache32 = (SkPMColor*)pixelRef->getAddr();
+        if (shader.fColorCount == 2) {
+            Build32bitCache(cache32, shader.fOrigColors[0], shader.fOrigColors[1], kCache32Count,
+                            cache->fCacheAlpha, shader.fGradFlags, cache->fCacheDither);
+        } else {
+            Rec* rec = shader.fRecs;
+            int prevIndex = 0;
+            for (int i = 1; i < shader.fColorCount; i++) {
+                int nextIndex = SkFixedToFFFF(rec[i].fPos) >> kCache32Shift;
+                SkASSERT(nextIndex < kCache32Count);
+
+                if (nextIndex > prevIndex)
+                    Build32bitCache(cache32 + prevIndex, shader.fOrigColors[i-1],
+                                    shader.fOrigColors[i], nextIndex - prevIndex + 1,
+                                    cache->fCacheAlpha, shader.fGradFlags, cache->fCacheDither);
+                prevIndex = nextIndex;
+            }
         }
+        pixelRef->setImmutable();
+
+        ramp.setInfo(info);
+        ramp.setPixelRef(std::move(pixelRef), 0, 0);
+        SkResourceCache::Add(new GradientBitmapRec(key.release(), ramp));
     }
+
+    // Every ramp in the SkResourceCache was allocated above.
+    cache->fCache32PixelRef = sk_ref_sp(static_cast<SkMallocPixelRef*>(ramp.pixelRef()));
+    cache->fCache32 = (const SkPMColor*)cache->fCache32PixelRef->getAddr();
 }
 
 void SkGradientShaderBase::initLinearBitmap(SkBitmap* bitmap) const {
@@ -678,84 +891,65 @@ sk_sp<SkGradientShaderBase::GradientShaderCache> SkGradientShaderBase::refCache(
     return fCache;
 }
 
-SK_DECLARE_STATIC_MUTEX(gGradientCacheMutex);
 /*
  *  Because our caller might rebuild the same (logically the same) gradient
  *  over and over, we'd like to return exactly the same "bitmap" if possible,
  *  allowing the client to utilize a cache of our bitmap (e.g. with a GPU).
- *  To do that, we maintain a private cache of built-bitmaps, based on our
- *  colors and positions. Note: we don't try to flatten the fMapper, so if one
- *  is present, we skip the cache for now.
+ *  So the bitmaps live in the SkResourceCache, keyed by what they are built
+ *  from: the legacy one is a row of the (shared) 32bit ramp, and the others
+ *  are built from our float colors and positions.
  */
 void SkGradientShaderBase::getGradientTableBitmap(SkBitmap* bitmap,
                                                   GradientBitmapType bitmapType) const {
-    // our caller assumes no external alpha, so we ensure that our cache is built with 0xFF
-    sk_sp<GradientShaderCache> cache(this->refCache(0xFF, true));
-
-    // build our key: [numColors + colors[] + {positions[]} + flags + colorType ]
-    int count = 1 + fColorCount + 1 + 1;
-    if (fColorCount > 2) {
-        count += fColorCount - 1;    // fRecs[].fPos
-    }
-
-    SkAutoSTMalloc<16, int32_t> storage(count);
-    int32_t* buffer = storage.get();
-
-    *buffer++ = fColorCount;
-    memcpy(buffer, fOrigColors, fColorCount * sizeof(SkColor));
-    buffer += fColorCount;
+    if (GradientBitmapType::kLegacy == bitmapType) {
+        // our caller assumes no external alpha, so we ensure that our cache is built with 0xFF
+        sk_sp<GradientShaderCache> cache(this->refCache(0xFF, true));
+
+        // force our cache32pixelref to be built
+        (void)cache->getCache32();
+        bitmap->setInfo(SkImageInfo::MakeN32Premul(kCache32Count, 1));
+        bitmap->setPixelRef(sk_ref_sp(cache->getCache32PixelRef()), 0, 0);
+        return;
+    }
+
+    // build our key: [bitmapType + flags + numColors + colors4f[] + {positions[]}]
+    SkSTArray<32, uint32_t, true> keyData;
+    keyData.push_back(static_cast<uint32_t>(bitmapType));
+    keyData.push_back(fGradFlags);
+    keyData.push_back(fColorCount);
+    keyData.push_back_n(4 * fColorCount, reinterpret_cast<const uint32_t*>(fOrigColors4f));
     if (fColorCount > 2) {
         for (int i = 1; i < fColorCount; i++) {
-            *buffer++ = fRecs[i].fPos;
+            keyData.push_back(fRecs[i].fPos);
         }
     }
-    *buffer++ = fGradFlags;
-    *buffer++ = static_cast<int32_t>(bitmapType);
-    SkASSERT(buffer - storage.get() == count);
-
-    ///////////////////////////////////
-
-    static SkGradientBitmapCache* gCache;
-    // each cache cost 1K or 2K of RAM, since each bitmap will be 1x256 at either 32bpp or 64bpp
-    static const int MAX_NUM_CACHED_GRADIENT_BITMAPS = 32;
-    SkAutoMutexAcquire ama(gGradientCacheMutex);
-
-    if (nullptr == gCache) {
-        gCache = new SkGradientBitmapCache(MAX_NUM_CACHED_GRADIENT_BITMAPS);
+    std::unique_ptr<SkGradientCacheKey> key(SkGradientCacheKey::Create(&gTableKeyNamespaceLabel,
+                                                                       keyData.begin(),
+                                                                       keyData.count()));
+    if (SkResourceCache::Find(*key, GradientBitmapRec::Finder, bitmap)) {
+        return;
     }
-    size_t size = count * sizeof(int32_t);
 
-    if (!gCache->find(storage.get(), size, bitmap)) {
-        if (GradientBitmapType::kLegacy == bitmapType) {
-            // force our cache32pixelref to be built
-            (void)cache->getCache32();
-            bitmap->setInfo(SkImageInfo::MakeN32Premul(kCache32Count, 1));
-            bitmap->setPixelRef(sk_ref_sp(cache->getCache32PixelRef()), 0, 0);
-        } else {
-            // For these cases we use the bitmap cache, but not the GradientShaderCache. So just
-            // allocate and populate the bitmap's data directly.
-
-            SkImageInfo info;
-            switch (bitmapType) {
-                case GradientBitmapType::kSRGB:
-                    info = SkImageInfo::Make(kCache32Count, 1, kRGBA_8888_SkColorType,
-                                             kPremul_SkAlphaType,
-                                             SkColorSpace::MakeNamed(SkColorSpace::kSRGB_Named));
-                    break;
-                case GradientBitmapType::kHalfFloat:
-                    info = SkImageInfo::Make(
-                        kCache32Count, 1, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
-                        SkColorSpace::MakeNamed(SkColorSpace::kSRGBLinear_Named));
-                    break;
-                default:
-                    SkFAIL("Unexpected bitmap type");
-                    return;
-            }
-            bitmap->allocPixels(info);
-            this->initLinearBitmap(bitmap);
-        }
-        gCache->add(storage.get(), size, *bitmap);
-    }
+    SkImageInfo info;
+    switch (bitmapType) {
+        case GradientBitmapType::kSRGB:
+            info = SkImageInfo::Make(kCache32Count, 1, kRGBA_8888_SkColorType,
+                                     kPremul_SkAlphaType,
+                                     SkColorSpace::MakeNamed(SkColorSpace::kSRGB_Named));
+            break;
+        case GradientBitmapType::kHalfFloat:
+            info = SkImageInfo::Make(
+                kCache32Count, 1, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                SkColorSpace::MakeNamed(SkColorSpace::kSRGBLinear_Named));
+            break;
+        default:
+            SkFAIL("Unexpected bitmap type");
+            return;
+    }
+    bitmap->allocPixels(info);
+    this->initLinearBitmap(bitmap);
+    bitmap->setImmutable();
+    SkResourceCache::Add(new GradientBitmapRec(key.release(), *bitmap));
 }
 
 void SkGradientShaderBase::commonAsAGradient(GradientInfo* info, bool flipGrad) const {
@@ -0,0 +1,42 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradientShaderContext_DEFINED
+#define SkGradientShaderContext_DEFINED
+
+#include "SkTypes.h"
+#include <memory>
+
+// Definition used by SkGradientShader.cpp, the gradient subclasses and SkRasterPipeline_opts.h.
+
+struct SkGradientShaderContext {
+    float matrix[9];
+
+    // The gradient is a list of intervals. Between ts[i] and ts[i+1], each channel c is
+    // fs[c][i]*t + bs[c][i]. ts[0] is 0, or -infinity when clamping to the first color, and
+    // ts[intervalCount] is +infinity.
+    int    intervalCount;
+    float* ts;
+    float* fs[4];
+    float* bs[4];
+
+    // With many stops, lut[k] is the interval just before bucket k of lutSize equal buckets of
+    // [0,1], and no bucket is more than one interval boundary away from it.
+    int      lutSize;
+    int32_t* lut;
+
+    // Two-point conical: see TwoPtRadial.
+    float centerX, centerY, dCenterX, dCenterY;
+    float radius, dRadius, radius2, rdr, a;
+    bool  flipped;
+    float mask[8];  // Set by xy_to_2pt_conical for the pixels it cannot draw.
+
+    std::unique_ptr<float[]>   storage;
+    std::unique_ptr<int32_t[]> lutStorage;
+};
+
+#endif//SkGradientShaderContext_DEFINED
@@ -8,12 +8,12 @@
 #ifndef SkGradientShaderPriv_DEFINED
 #define SkGradientShaderPriv_DEFINED
 
-#include "SkGradientBitmapCache.h"
 #include "SkGradientShader.h"
 #include "SkClampRange.h"
 #include "SkColorPriv.h"
 #include "SkColorSpace.h"
 #include "SkReadBuffer.h"
+#include "SkResourceCache.h"
 #include "SkWriteBuffer.h"
 #include "SkMallocPixelRef.h"
 #include "SkUtils.h"
@@ -75,6 +75,27 @@ static const TileProc gTileProcs[] = {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/**
+ *  Key for gradient data (color ramps, interval lists) kept in the global SkResourceCache, so
+ *  that equivalent shaders share it, even across threads. The namespace tells the kinds of data
+ *  apart; the rest is any number of 32-bit words.
+ */
+class SkGradientCacheKey : public SkResourceCache::Key {
+public:
+    static SkGradientCacheKey* Create(void* nameSpace, const uint32_t data[], int count);
+
+    void operator delete(void* storage) {
+        delete[] reinterpret_cast<char*>(storage);
+    }
+
+private:
+    SkGradientCacheKey(void* nameSpace, const uint32_t data[], int count);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+struct SkGradientShaderContext;
+
 class SkGradientShaderBase : public SkShader {
 public:
     struct Descriptor {
@@ -118,7 +139,8 @@ public:
     SkGradientShaderBase(const Descriptor& desc, const SkMatrix& ptsToUnit);
     virtual ~SkGradientShaderBase();
 
-    // The cache is initialized on-demand when getCache32 is called.
+    // The cache is initialized on-demand when getCache32 is called. The ramp itself is shared
+    // with every equivalent shader, through the SkResourceCache.
     class GradientShaderCache : public SkRefCnt {
     public:
         GradientShaderCache(U8CPU alpha, bool dither, const SkGradientShaderBase& shader);
@@ -126,16 +148,16 @@ public:
 
         const SkPMColor*    getCache32();
 
-        SkMallocPixelRef* getCache32PixelRef() const { return fCache32PixelRef; }
+        SkMallocPixelRef* getCache32PixelRef() const { return fCache32PixelRef.get(); }
 
         unsigned getAlpha() const { return fCacheAlpha; }
         bool getDither() const { return fCacheDither; }
 
     private:
         // Working pointer. If it's nullptr, we need to recompute the cache values.
-        SkPMColor*  fCache32;
+        const SkPMColor*  fCache32;
 
-        SkMallocPixelRef* fCache32PixelRef;
+        sk_sp<SkMallocPixelRef> fCache32PixelRef;
         const unsigned    fCacheAlpha;        // The alpha value we used when we computed the cache.
                                               // Larger than 8bits so we can store uninitialized
                                               // value.
@@ -220,6 +242,15 @@ protected:
 
     bool onAsLuminanceColor(SkColor*) const override;
 
+    bool onAppendStages(SkRasterPipeline*, SkColorSpace*, SkFallbackAlloc*,
+                        const SkMatrix&, const SkPaint&) const override;
+
+    // Appends to tPipeline the stages mapping the point in unit space (r,g) to the gradient's t,
+    // in r, and to postPipeline any stages to run after the color is found. Returns false if
+    // the gradient can't be drawn this way.
+    virtual bool appendGradientStages(SkGradientShaderContext*, SkRasterPipeline* tPipeline,
+                                      SkRasterPipeline* postPipeline) const = 0;
+
 
     void initLinearBitmap(SkBitmap* bitmap) const;
 
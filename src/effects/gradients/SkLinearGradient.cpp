@@ -6,7 +6,9 @@
  */
 
 #include "Sk4fLinearGradient.h"
+#include "SkGradientShaderContext.h"
 #include "SkLinearGradient.h"
+#include "SkRasterPipeline.h"
 #include "SkRefCnt.h"
 
 // define to test the 4f gradient path
@@ -86,6 +88,12 @@ SkShader::Context* SkLinearGradient::onCreateContext(const ContextRec& rec, void
         : CheckedCreateContext<  LinearGradientContext>(storage, *this, rec);
 }
 
+bool SkLinearGradient::appendGradientStages(SkGradientShaderContext*, SkRasterPipeline*,
+                                            SkRasterPipeline*) const {
+    // fPtsToUnit already maps the start point to x = 0 and the end point to x = 1.
+    return true;
+}
+
 // This swizzles SkColor into the same component order as SkPMColor, but does not actually
 // "pre" multiply the color components.
 //
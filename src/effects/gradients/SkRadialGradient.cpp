@@ -6,7 +6,9 @@
  */
 
 #include "SkRadialGradient.h"
+#include "SkGradientShaderContext.h"
 #include "SkNx.h"
+#include "SkRasterPipeline.h"
 
 namespace {
 
@@ -47,6 +49,12 @@ SkShader::Context* SkRadialGradient::onCreateContext(const ContextRec& rec, void
     return CheckedCreateContext<RadialGradientContext>(storage, *this, rec);
 }
 
+bool SkRadialGradient::appendGradientStages(SkGradientShaderContext*, SkRasterPipeline* p,
+                                            SkRasterPipeline*) const {
+    p->append(SkRasterPipeline::xy_to_radius);
+    return true;
+}
+
 SkRadialGradient::RadialGradientContext::RadialGradientContext(
         const SkRadialGradient& shader, const ContextRec& rec)
     : INHERITED(shader, rec) {}
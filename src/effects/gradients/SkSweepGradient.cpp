@@ -6,6 +6,8 @@
  */
 
 #include "SkSweepGradient.h"
+#include "SkGradientShaderContext.h"
+#include "SkRasterPipeline.h"
 
 static SkMatrix translate(SkScalar dx, SkScalar dy) {
     SkMatrix matrix;
@@ -53,6 +55,12 @@ SkShader::Context* SkSweepGradient::onCreateContext(const ContextRec& rec, void*
     return CheckedCreateContext<SweepGradientContext>(storage, *this, rec);
 }
 
+bool SkSweepGradient::appendGradientStages(SkGradientShaderContext*, SkRasterPipeline* p,
+                                           SkRasterPipeline*) const {
+    p->append(SkRasterPipeline::xy_to_angle);
+    return true;
+}
+
 SkSweepGradient::SweepGradientContext::SweepGradientContext(
         const SkSweepGradient& shader, const ContextRec& rec)
     : INHERITED(shader, rec) {}
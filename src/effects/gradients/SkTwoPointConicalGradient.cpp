@@ -6,6 +6,8 @@
  */
 
 #include "SkTwoPointConicalGradient.h"
+#include "SkGradientShaderContext.h"
+#include "SkRasterPipeline.h"
 
 struct TwoPtRadialContext {
     const TwoPtRadial&  fRec;
@@ -219,6 +221,24 @@ SkShader::Context* SkTwoPointConicalGradient::onCreateContext(const ContextRec&
     return CheckedCreateContext<TwoPointConicalGradientContext>(storage, *this, rec);
 }
 
+bool SkTwoPointConicalGradient::appendGradientStages(SkGradientShaderContext* ctx,
+                                                     SkRasterPipeline* p,
+                                                     SkRasterPipeline* postPipeline) const {
+    ctx->centerX  = fRec.fCenterX;
+    ctx->centerY  = fRec.fCenterY;
+    ctx->dCenterX = fRec.fDCenterX;
+    ctx->dCenterY = fRec.fDCenterY;
+    ctx->radius   = fRec.fRadius;
+    ctx->dRadius  = fRec.fDRadius;
+    ctx->radius2  = fRec.fRadius2;
+    ctx->rdr      = fRec.fRDR;
+    ctx->a        = fRec.fA;
+    ctx->flipped  = fRec.fFlipped;
+    p->append(SkRasterPipeline::xy_to_2pt_conical, ctx);
+    postPipeline->append(SkRasterPipeline::mask_2pt_conical_degenerates, ctx);
+    return true;
+}
+
 SkTwoPointConicalGradient::TwoPointConicalGradientContext::TwoPointConicalGradientContext(
         const SkTwoPointConicalGradient& shader, const ContextRec& rec)
     : INHERITED(shader, rec)
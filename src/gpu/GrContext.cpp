@@ -20,6 +20,7 @@
 
 #include "SkConfig8888.h"
 #include "SkGrPriv.h"
+#include "SkSLCompileCache.h"
 
 #include "effects/GrConfigConversionEffect.h"
 #include "effects/GrGammaEffect.h"
@@ -93,6 +94,10 @@ void GrContext::initCommon(const GrContextOptions& options) {
 
     fDidTestPMConversions = false;
 
+    if (options.fShaderCacheDirectory) {
+        SkSL::CompileCache::Global()->setDirectory(options.fShaderCacheDirectory);
+    }
+
     GrRenderTargetOpList::Options rtOpListOptions;
     rtOpListOptions.fClipDrawOpsToBounds = options.fClipDrawOpsToBounds;
     rtOpListOptions.fMaxOpCombineLookback = options.fMaxOpCombineLookback;
@@ -7,6 +7,9 @@
 
 #include "GrMemoryPool.h"
 
+#include "SkChecksum.h"
+#include "SkThreadID.h"
+
 #ifdef SK_DEBUG
     #define VALIDATE this->validate()
 #else
@@ -15,8 +18,7 @@
 
 constexpr size_t GrMemoryPool::kSmallestMinAllocSize;
 
-GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize) {
-    SkDEBUGCODE(fAllocationCnt = 0);
+GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize, ReleaseMode releaseMode) {
     SkDEBUGCODE(fAllocBlockCnt = 0);
 
     minAllocSize = SkTMax<size_t>(GrSizeAlignUp(minAllocSize, kAlignment), kSmallestMinAllocSize);
@@ -24,8 +26,13 @@ GrMemoryPool::GrMemoryPool(size_t preallocSize, size_t minAllocSize) {
 
     fMinAllocSize = minAllocSize;
     fSize = 0;
+    fPerAllocPad = ReleaseMode::kIndividual == releaseMode ? kPerAllocPad : 0;
+    fAllocationCnt = 0;
+    fFreeCnt = 0;
+    sk_bzero(fFreeLists, sizeof(fFreeLists));
+    fReleaseMode = releaseMode;
 
-    fHead = CreateBlock(preallocSize);
+    fHead = this->createBlock(preallocSize);
     fTail = fHead;
     fHead->fNext = nullptr;
     fHead->fPrev = nullptr;
@@ -40,14 +47,37 @@ GrMemoryPool::~GrMemoryPool() {
     DeleteBlock(fHead);
 };
 
+// Every allocation has room for a FreeAlloc, so that it can be put on a freelist.
+static size_t alloc_size(size_t size, size_t alignment, size_t freeAllocSize) {
+    return GrSizeAlignUp(SkTMax(size, freeAllocSize), alignment);
+}
+
 void* GrMemoryPool::allocate(size_t size) {
     VALIDATE;
-    size += kPerAllocPad;
-    size = GrSizeAlignUp(size, kAlignment);
+    size = alloc_size(size, kAlignment, sizeof(FreeAlloc));
+    size_t sizeClass = size / kAlignment - 1;
+    if (sizeClass < kSizeClassCount && fFreeLists[sizeClass]) {
+        FreeAlloc* alloc = fFreeLists[sizeClass];
+        fFreeLists[sizeClass] = alloc->fNext;
+        --fFreeCnt;
+        ++fAllocationCnt;
+#ifdef SK_DEBUG
+        if (ReleaseMode::kIndividual == fReleaseMode) {
+            AllocHeader* allocData = reinterpret_cast<AllocHeader*>(
+                    reinterpret_cast<intptr_t>(alloc) - kPerAllocPad);
+            SkASSERT(kFreedMarker == allocData->fSentinal);
+            allocData->fSentinal = kAssignedMarker;
+        }
+#endif
+        VALIDATE;
+        return alloc;
+    }
+
+    size += fPerAllocPad;
     if (fTail->fFreeSize < size) {
         size_t blockSize = size + kHeaderSize;
         blockSize = SkTMax<size_t>(blockSize, fMinAllocSize);
-        BlockHeader* block = CreateBlock(blockSize);
+        BlockHeader* block = this->createBlock(blockSize);
 
         block->fPrev = fTail;
         block->fNext = nullptr;
@@ -60,24 +90,67 @@ void* GrMemoryPool::allocate(size_t size) {
     SkASSERT(kAssignedMarker == fTail->fBlockSentinal);
     SkASSERT(fTail->fFreeSize >= size);
     intptr_t ptr = fTail->fCurrPtr;
-    // We stash a pointer to the block header, just before the allocated space,
-    // so that we can decrement the live count on delete in constant time.
-    AllocHeader* allocData = reinterpret_cast<AllocHeader*>(ptr);
-    SkDEBUGCODE(allocData->fSentinal = kAssignedMarker);
-    allocData->fHeader = fTail;
-    ptr += kPerAllocPad;
+    if (ReleaseMode::kIndividual == fReleaseMode) {
+        // We stash a pointer to the block header, just before the allocated space,
+        // so that we can decrement the live count on delete in constant time.
+        AllocHeader* allocData = reinterpret_cast<AllocHeader*>(ptr);
+        SkDEBUGCODE(allocData->fSentinal = kAssignedMarker);
+        allocData->fHeader = fTail;
+        ptr += kPerAllocPad;
+        fTail->fLiveCount += 1;
+    }
     fTail->fPrevPtr = fTail->fCurrPtr;
     fTail->fCurrPtr += size;
     fTail->fFreeSize -= size;
-    fTail->fLiveCount += 1;
 
-    SkDEBUGCODE(++fAllocationCnt);
+    ++fAllocationCnt;
     VALIDATE;
     return reinterpret_cast<void*>(ptr);
 }
 
 void GrMemoryPool::release(void* p) {
+    this->releaseAlloc(p, kSizeClassCount);
+}
+
+void GrMemoryPool::release(void* p, size_t size) {
+    size = alloc_size(size, kAlignment, sizeof(FreeAlloc));
+    this->releaseAlloc(p, SkTMin<size_t>(size / kAlignment - 1, kSizeClassCount));
+}
+
+GrMemoryPool* GrMemoryPool::Owner(void* p) {
+    AllocHeader* allocData =
+            reinterpret_cast<AllocHeader*>(reinterpret_cast<intptr_t>(p) - kPerAllocPad);
+    SkASSERT(kAssignedMarker == allocData->fSentinal);
+    SkASSERT(ReleaseMode::kIndividual == allocData->fHeader->fPool->fReleaseMode);
+    return allocData->fHeader->fPool;
+}
+
+void GrMemoryPool::pushFree(void* p, size_t sizeClass) {
+    FreeAlloc* alloc = static_cast<FreeAlloc*>(p);
+    alloc->fNext = fFreeLists[sizeClass];
+    fFreeLists[sizeClass] = alloc;
+    ++fFreeCnt;
+}
+
+void GrMemoryPool::releaseAlloc(void* p, size_t sizeClass) {
     VALIDATE;
+    SkASSERT(fAllocationCnt > 0);
+    --fAllocationCnt;
+    if (ReleaseMode::kBulk == fReleaseMode) {
+        intptr_t ptr = reinterpret_cast<intptr_t>(p);
+        if (0 == fAllocationCnt) {
+            this->reset();
+        } else if (fTail->fPrevPtr == ptr) {
+            // Trivial reclaim: if we're releasing the most recent allocation, reuse it
+            fTail->fFreeSize += (fTail->fCurrPtr - ptr);
+            fTail->fCurrPtr = ptr;
+        } else if (sizeClass < kSizeClassCount) {
+            this->pushFree(p, sizeClass);
+        }
+        VALIDATE;
+        return;
+    }
+
     intptr_t ptr = reinterpret_cast<intptr_t>(p) - kPerAllocPad;
     AllocHeader* allocData = reinterpret_cast<AllocHeader*>(ptr);
     SkASSERT(kAssignedMarker == allocData->fSentinal);
@@ -105,25 +178,51 @@ void GrMemoryPool::release(void* p) {
             DeleteBlock(block);
             SkDEBUGCODE(fAllocBlockCnt--);
         }
-    } else {
+    } else if (block->fPrevPtr == ptr) {
         --block->fLiveCount;
         // Trivial reclaim: if we're releasing the most recent allocation, reuse it
-        if (block->fPrevPtr == ptr) {
-            block->fFreeSize += (block->fCurrPtr - block->fPrevPtr);
-            block->fCurrPtr = block->fPrevPtr;
-        }
+        block->fFreeSize += (block->fCurrPtr - block->fPrevPtr);
+        block->fCurrPtr = block->fPrevPtr;
+    } else if (sizeClass < kSizeClassCount) {
+        // The allocation stays live in its block until it is reused, or the pool empties.
+        this->pushFree(p, sizeClass);
+    } else {
+        --block->fLiveCount;
+    }
+    if (0 == fAllocationCnt && fFreeCnt) {
+        this->reset();
     }
-    SkDEBUGCODE(--fAllocationCnt);
     VALIDATE;
 }
 
-GrMemoryPool::BlockHeader* GrMemoryPool::CreateBlock(size_t blockSize) {
+void GrMemoryPool::reset() {
+    SkASSERT(0 == fAllocationCnt);
+    BlockHeader* block = fHead->fNext;
+    while (block) {
+        BlockHeader* next = block->fNext;
+        fSize -= block->fSize;
+        DeleteBlock(block);
+        SkDEBUGCODE(fAllocBlockCnt--);
+        block = next;
+    }
+    fHead->fNext = nullptr;
+    fTail = fHead;
+    fHead->fCurrPtr = reinterpret_cast<intptr_t>(fHead) + kHeaderSize;
+    fHead->fPrevPtr = 0;
+    fHead->fLiveCount = 0;
+    fHead->fFreeSize = fHead->fSize - kHeaderSize;
+    sk_bzero(fFreeLists, sizeof(fFreeLists));
+    fFreeCnt = 0;
+}
+
+GrMemoryPool::BlockHeader* GrMemoryPool::createBlock(size_t blockSize) {
     blockSize = SkTMax<size_t>(blockSize, kHeaderSize);
     BlockHeader* block =
         reinterpret_cast<BlockHeader*>(sk_malloc_throw(blockSize));
     // we assume malloc gives us aligned memory
     SkASSERT(!(reinterpret_cast<intptr_t>(block) % kAlignment));
     SkDEBUGCODE(block->fBlockSentinal = kAssignedMarker);
+    block->fPool = this;
     block->fLiveCount = 0;
     block->fFreeSize = blockSize - kHeaderSize;
     block->fCurrPtr = reinterpret_cast<intptr_t>(block) + kHeaderSize;
@@ -160,13 +259,16 @@ void GrMemoryPool::validate() {
         SkASSERT(!(b % kAlignment));
         SkASSERT(!(totalSize % kAlignment));
         SkASSERT(!(block->fCurrPtr % kAlignment));
+        SkASSERT(this == block->fPool);
         if (fHead != block) {
-            SkASSERT(block->fLiveCount);
+            SkASSERT(block->fLiveCount || ReleaseMode::kBulk == fReleaseMode);
             SkASSERT(totalSize >= fMinAllocSize);
         } else {
             SkASSERT(totalSize == block->fSize);
         }
-        if (!block->fLiveCount) {
+        if (ReleaseMode::kBulk == fReleaseMode) {
+            // allocations have no headers to check
+        } else if (!block->fLiveCount) {
             SkASSERT(ptrOffset ==  kHeaderSize);
             SkASSERT(userStart == block->fCurrPtr);
         } else {
@@ -178,8 +280,60 @@ void GrMemoryPool::validate() {
 
         prev = block;
     } while ((block = block->fNext));
-    SkASSERT(allocCount == fAllocationCnt);
+    SkASSERT(ReleaseMode::kBulk == fReleaseMode || allocCount == fAllocationCnt + fFreeCnt);
+    SkASSERT(fAllocationCnt > 0 || 0 == fFreeCnt);
     SkASSERT(prev == fTail);
     SkASSERT(fAllocBlockCnt != 0 || fSize == 0);
 #endif
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+class AutoPoolLock {
+public:
+// We know in the Android framework there is only one GrContext.
+#if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
+    AutoPoolLock(SkSpinlock*) {}
+#else
+    AutoPoolLock(SkSpinlock* lock) : fLock(lock) { fLock->acquire(); }
+    ~AutoPoolLock() { fLock->release(); }
+
+private:
+    SkSpinlock* fLock;
+#endif
+};
+}
+
+GrThreadMemoryPools::~GrThreadMemoryPools() {
+    for (Pool& pool : fPools) {
+        if (pool.fCreated) {
+            pool.get()->~GrMemoryPool();
+        }
+    }
+}
+
+void* GrThreadMemoryPools::allocate(size_t size) {
+    uint64_t id = SkGetThreadID();
+    Pool& pool = fPools[SkChecksum::Mix((uint32_t)(id ^ (id >> 32))) % kPoolCount];
+    pool.fOnce([this, &pool] {
+        new (pool.get()) GrMemoryPool(fPreallocSize, fMinAllocSize);
+        pool.fCreated = true;
+    });
+    AutoPoolLock lock(&pool.fLock);
+    return pool.get()->allocate(size);
+}
+
+void GrThreadMemoryPools::release(void* p, size_t size) {
+    // The allocation's header is not touched by its pool while it is live, so it can be read
+    // without the lock.
+    GrMemoryPool* owner = GrMemoryPool::Owner(p);
+    for (Pool& pool : fPools) {
+        if (pool.get() == owner) {
+            AutoPoolLock lock(&pool.fLock);
+            owner->release(p, size);
+            return;
+        }
+    }
+    SkDEBUGFAIL("Released memory that was not allocated by these pools.");
+}
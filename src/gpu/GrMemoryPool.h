@@ -9,6 +9,9 @@
 #define GrMemoryPool_DEFINED
 
 #include "GrTypes.h"
+#include "SkOnce.h"
+#include "SkSpinlock.h"
+#include "SkTemplates.h"
 
 /**
  * Allocates memory in blocks and parcels out space in the blocks for allocation
@@ -16,9 +19,28 @@
  * efficiency. The interface is designed to be used to implement operator new
  * and delete overrides. All allocations are expected to be released before the
  * pool's destructor is called. Allocations will be 8-byte aligned.
+ *
+ * Small allocations released with their size (see release(void*, size_t)) are kept on
+ * per-size freelists and handed out again by allocate(). Their space is only given back to the
+ * blocks once every allocation in the pool has been released.
  */
 class GrMemoryPool {
 public:
+    enum class ReleaseMode : bool {
+        /**
+         * Each allocation is preceded by a small header pointing back at its block, and a block
+         * is freed as soon as all of its allocations are released.
+         */
+        kIndividual,
+        /**
+         * Allocations have no header. Releasing one only reclaims it if it was the most recent
+         * allocation, or if its size is given (for the freelists); everything else is reclaimed
+         * at once when the last allocation is released. Meant for objects that are all freed
+         * together, e.g. at the end of a flush.
+         */
+        kBulk
+    };
+
     /**
      * Prealloc size is the amount of space to allocate at pool creation
      * time and keep around until pool destruction. The min alloc size is
@@ -31,7 +53,8 @@ public:
      * Both sizes is what the pool will end up allocating from the system, and
      * portions of the allocated memory is used for internal bookkeeping.
      */
-    GrMemoryPool(size_t preallocSize, size_t minAllocSize);
+    GrMemoryPool(size_t preallocSize, size_t minAllocSize,
+                 ReleaseMode releaseMode = ReleaseMode::kIndividual);
 
     ~GrMemoryPool();
 
@@ -45,10 +68,21 @@ public:
      */
     void release(void* p);
 
+    /**
+     * Same as release(p), but size must be the size that p was allocated with. Small allocations
+     * released this way are reused by later allocate() calls of the same size.
+     */
+    void release(void* p, size_t size);
+
+    /**
+     * Returns the pool that allocated p. Only valid for pools in ReleaseMode::kIndividual.
+     */
+    static GrMemoryPool* Owner(void* p);
+
     /**
      * Returns true if there are no unreleased allocations.
      */
-    bool isEmpty() const { return fTail == fHead && !fHead->fLiveCount; }
+    bool isEmpty() const { return 0 == fAllocationCnt; }
 
     /**
      * Returns the total allocated size of the GrMemoryPool minus any preallocated amount
@@ -68,20 +102,35 @@ public:
 private:
     struct BlockHeader;
 
-    static BlockHeader* CreateBlock(size_t size);
+    BlockHeader* createBlock(size_t size);
 
     static void DeleteBlock(BlockHeader* block);
 
+    /**
+     * sizeClass is the index of p's freelist, or kSizeClassCount if p does not go on one.
+     */
+    void releaseAlloc(void* p, size_t sizeClass);
+
+    void pushFree(void* p, size_t sizeClass);
+
+    /**
+     * Frees every block but the head and empties the freelists. Called once all allocations have
+     * been released, for the allocations whose space was not reclaimed individually.
+     */
+    void reset();
+
     void validate();
 
     struct BlockHeader {
 #ifdef SK_DEBUG
         uint32_t     fBlockSentinal;  ///< known value to check for bad back pointers to blocks
 #endif
+        GrMemoryPool* fPool;     ///< the pool that owns the block
         BlockHeader* fNext;      ///< doubly-linked list of blocks.
         BlockHeader* fPrev;
         int          fLiveCount; ///< number of outstanding allocations in the
-                                 ///< block.
+                                 ///< block, including those on a freelist. Not
+                                 ///< maintained for ReleaseMode::kBulk.
         intptr_t     fCurrPtr;   ///< ptr to the start of blocks free space.
         intptr_t     fPrevPtr;   ///< ptr to the last allocation made
         size_t       fFreeSize;  ///< amount of free space left in the block.
@@ -98,12 +147,26 @@ private:
         BlockHeader* fHeader;    ///< pointer back to the block header in which an alloc resides
     };
 
+    /** A released allocation waiting on a freelist. */
+    struct FreeAlloc {
+        FreeAlloc* fNext;
+    };
+
+    enum {
+        // Allocations of up to kSizeClassCount * kAlignment bytes have a freelist.
+        kSizeClassCount = 64,
+    };
+
     size_t                            fSize;
     size_t                            fMinAllocSize;
     BlockHeader*                      fHead;
     BlockHeader*                      fTail;
+    size_t                            fPerAllocPad;  ///< kPerAllocPad, or 0 for kBulk
+    int                               fAllocationCnt;  ///< unreleased allocations
+    int                               fFreeCnt;      ///< allocations on the freelists
+    FreeAlloc*                        fFreeLists[kSizeClassCount];
+    ReleaseMode                       fReleaseMode;
 #ifdef SK_DEBUG
-    int                               fAllocationCnt;
     int                               fAllocBlockCnt;
 #endif
 
@@ -150,9 +213,11 @@ public:
      * Preallocates memory for preallocCount objects, and sets new block size to be
      * enough to hold minAllocCount objects.
      */
-    GrObjectMemoryPool(size_t preallocCount, size_t minAllocCount)
-        : GrMemoryPool(CountToSize(preallocCount),
-                       CountToSize(SkTMax(minAllocCount, kSmallestMinAllocCount))) {
+    GrObjectMemoryPool(size_t preallocCount, size_t minAllocCount,
+                       ReleaseMode releaseMode = ReleaseMode::kIndividual)
+        : GrMemoryPool(CountToSize(preallocCount, releaseMode),
+                       CountToSize(SkTMax(minAllocCount, kSmallestMinAllocCount), releaseMode),
+                       releaseMode) {
     }
 
     /**
@@ -161,12 +226,20 @@ public:
      */
     T* allocate() { return static_cast<T*>(GrMemoryPool::allocate(sizeof(T))); }
 
+    /**
+     * Releases memory returned by allocate(). The memory is reused by later allocate() calls.
+     */
+    void release(T* p) { GrMemoryPool::release(p, sizeof(T)); }
+    using GrMemoryPool::release;
+
 private:
     constexpr static size_t kTotalObjectSize =
         kPerAllocPad + GR_CT_ALIGN_UP(sizeof(T), kAlignment);
 
-    constexpr static size_t CountToSize(size_t count) {
-        return kHeaderSize + count * kTotalObjectSize;
+    constexpr static size_t CountToSize(size_t count, ReleaseMode releaseMode) {
+        return kHeaderSize + count * (ReleaseMode::kBulk == releaseMode
+                                              ? GR_CT_ALIGN_UP(sizeof(T), kAlignment)
+                                              : kTotalObjectSize);
     }
 
 public:
@@ -181,4 +254,47 @@ public:
 template <class T>
 constexpr size_t GrObjectMemoryPool<T>::kSmallestMinAllocCount;
 
+/**
+ * A fixed set of GrMemoryPools, each guarded by a spinlock, for objects that are created on any
+ * thread (e.g. ops and processors). A thread allocates from the pool its thread ID hashes to, so
+ * threads recording at the same time seldom contend for a pool. An allocation is released to the
+ * pool it came from, whichever thread releases it. The pools are created on first use.
+ */
+class GrThreadMemoryPools : SkNoncopyable {
+public:
+    GrThreadMemoryPools(size_t preallocSize, size_t minAllocSize)
+        : fPreallocSize(preallocSize)
+        , fMinAllocSize(minAllocSize) {}
+
+    ~GrThreadMemoryPools();
+
+    void* allocate(size_t size);
+
+    /**
+     * p must have been returned by allocate(size).
+     */
+    void release(void* p, size_t size);
+
+private:
+#if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
+    // We know in the Android framework there is only one GrContext.
+    static constexpr int kPoolCount = 1;
+#else
+    static constexpr int kPoolCount = 8;
+#endif
+
+    struct Pool {
+        SkOnce                                 fOnce;
+        SkSpinlock                             fLock;
+        bool                                   fCreated = false;
+        SkAlignedSTStorage<1, GrMemoryPool>    fStorage;
+
+        GrMemoryPool* get() { return reinterpret_cast<GrMemoryPool*>(fStorage.get()); }
+    };
+
+    const size_t fPreallocSize;
+    const size_t fMinAllocSize;
+    Pool         fPools[kPoolCount];
+};
+
 #endif
@@ -13,7 +13,7 @@
 #include "GrSamplerParams.h"
 #include "GrTexturePriv.h"
 #include "GrXferProcessor.h"
-#include "SkSpinlock.h"
+#include "SkOnce.h"
 
 #if SK_ALLOW_STATIC_GLOBAL_INITIALIZERS
 
@@ -81,29 +81,17 @@ void GrXPFactoryTestFactory::VerifyFactoryCount() {
 #endif
 
 
-// We use a global pool protected by a mutex(spinlock). Chrome may use the same GrContext on
-// different threads. The GrContext is not used concurrently on different threads and there is a
-// memory barrier between accesses of a context on different threads. Also, there may be multiple
-// GrContexts and those contexts may be in use concurrently on different threads.
-namespace {
-static SkSpinlock gProcessorSpinlock;
-class MemoryPoolAccessor {
-public:
-
-// We know in the Android framework there is only one GrContext.
-#if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
-    MemoryPoolAccessor() {}
-    ~MemoryPoolAccessor() {}
-#else
-    MemoryPoolAccessor() { gProcessorSpinlock.acquire(); }
-    ~MemoryPoolAccessor() { gProcessorSpinlock.release(); }
-#endif
-
-    GrMemoryPool* pool() const {
-        static GrMemoryPool gPool(4096, 4096);
-        return &gPool;
-    }
-};
+// We use global pools, one per group of threads, each protected by a spinlock. Chrome may use the
+// same GrContext on different threads. The GrContext is not used concurrently on different threads
+// and there is a memory barrier between accesses of a context on different threads. Also, there may
+// be multiple GrContexts and those contexts may be in use concurrently on different threads.
+// The pools are created under SkOnce rather than as a function-local static, since Skia builds
+// with -fno-threadsafe-statics and the first processors may be created on several threads at once.
+static GrThreadMemoryPools* pools() {
+    static SkOnce once;
+    static GrThreadMemoryPools* gPools;
+    once([] { gPools = new GrThreadMemoryPools(4096, 4096); });
+    return gPools;
 }
 
 int32_t GrProcessor::gCurrProcessorClassID = GrProcessor::kIllegalProcessorClassID;
@@ -161,11 +149,11 @@ void GrProcessor::pendingIOComplete() const {
 }
 
 void* GrProcessor::operator new(size_t size) {
-    return MemoryPoolAccessor().pool()->allocate(size);
+    return pools()->allocate(size);
 }
 
-void GrProcessor::operator delete(void* target) {
-    return MemoryPoolAccessor().pool()->release(target);
+void GrProcessor::operator delete(void* target, size_t size) {
+    return pools()->release(target, size);
 }
 
 bool GrProcessor::hasSameSamplersAndAccesses(const GrProcessor &that) const {
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrRectanizer.h"
+#include "SkPoint.h"
+#include "SkTemplates.h"
+#include "SkTSort.h"
+
+int GrRectanizer::addRects(const SkISize sizes[], int count, SkIPoint16 locs[]) {
+    SkAutoSTMalloc<64, int> order(count);
+    for (int i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    SkTQSort(order.get(), order.get() + count - 1, [sizes](int a, int b) {
+        if (sizes[a].fHeight != sizes[b].fHeight) {
+            return sizes[a].fHeight > sizes[b].fHeight;
+        }
+        if (sizes[a].fWidth != sizes[b].fWidth) {
+            return sizes[a].fWidth > sizes[b].fWidth;
+        }
+        return a < b;
+    });
+
+    int added = 0;
+    for (int i = 0; i < count; ++i) {
+        int index = order[i];
+        if (this->addRect(sizes[index].fWidth, sizes[index].fHeight, &locs[index])) {
+            ++added;
+        } else {
+            locs[index].set(-1, -1);
+        }
+    }
+    return added;
+}
@@ -9,6 +9,7 @@
 #define GrRectanizer_DEFINED
 
 #include "GrTypes.h"
+#include "SkSize.h"
 
 struct SkIPoint16;
 
@@ -31,6 +32,11 @@ public:
     virtual bool addRect(int width, int height, SkIPoint16* loc) = 0;
     virtual float percentFull() const = 0;
 
+    // Add 'count' rects at once, placing the tallest (then widest) first, which packs better
+    // than taking them in an arbitrary order. Returns the number of rects that fit; 'locs' gets
+    // the position of each rect, in the order given, or (-1, -1) for those that did not fit.
+    int addRects(const SkISize sizes[], int count, SkIPoint16 locs[]);
+
     /**
      *  Our factory, which returns the subclass du jour
      */
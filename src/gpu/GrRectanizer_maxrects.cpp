@@ -0,0 +1,105 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "GrRectanizer_maxrects.h"
+#include "SkPoint.h"
+
+bool GrRectanizerMaxRects::addRect(int width, int height, SkIPoint16* loc) {
+    if ((unsigned)width > (unsigned)this->width() ||
+        (unsigned)height > (unsigned)this->height()) {
+        return false;
+    }
+
+    // find the free rect that leaves the least space along the shorter side, then the longer
+    int bestShortSide = SK_MaxS32;
+    int bestLongSide = SK_MaxS32;
+    int bestIndex = -1;
+    for (int i = 0; i < fFreeRects.count(); ++i) {
+        const SkIRect& free = fFreeRects[i];
+        int leftoverX = free.width() - width;
+        int leftoverY = free.height() - height;
+        if (leftoverX < 0 || leftoverY < 0) {
+            continue;
+        }
+        int shortSide = SkMin32(leftoverX, leftoverY);
+        int longSide = SkMax32(leftoverX, leftoverY);
+        if (shortSide < bestShortSide || (shortSide == bestShortSide && longSide < bestLongSide)) {
+            bestIndex = i;
+            bestShortSide = shortSide;
+            bestLongSide = longSide;
+        }
+    }
+
+    if (-1 != bestIndex) {
+        SkIRect used = SkIRect::MakeXYWH(fFreeRects[bestIndex].fLeft, fFreeRects[bestIndex].fTop,
+                                         width, height);
+        this->splitFreeRects(used);
+        loc->fX = used.fLeft;
+        loc->fY = used.fTop;
+
+        fAreaSoFar += width*height;
+        return true;
+    }
+
+    loc->fX = 0;
+    loc->fY = 0;
+    return false;
+}
+
+void GrRectanizerMaxRects::splitFreeRects(const SkIRect& used) {
+    if (used.isEmpty()) {
+        return;
+    }
+
+    // Replace each free rect that overlaps 'used' with the (up to four) maximal rects around it.
+    const int oldCount = fFreeRects.count();
+    SkTDArray<SkIRect> split;
+    for (int i = 0; i < oldCount; ++i) {
+        const SkIRect& free = fFreeRects[i];
+        if (!SkIRect::IntersectsNoEmptyCheck(free, used)) {
+            continue;
+        }
+        if (used.fLeft > free.fLeft) {
+            *split.append() = SkIRect::MakeLTRB(free.fLeft, free.fTop, used.fLeft, free.fBottom);
+        }
+        if (used.fRight < free.fRight) {
+            *split.append() = SkIRect::MakeLTRB(used.fRight, free.fTop, free.fRight, free.fBottom);
+        }
+        if (used.fTop > free.fTop) {
+            *split.append() = SkIRect::MakeLTRB(free.fLeft, free.fTop, free.fRight, used.fTop);
+        }
+        if (used.fBottom < free.fBottom) {
+            *split.append() = SkIRect::MakeLTRB(free.fLeft, used.fBottom, free.fRight,
+                                                free.fBottom);
+        }
+        fFreeRects[i].setEmpty();
+    }
+
+    // The untouched free rects still contain no other, and cannot be contained in a piece of one
+    // they did not contain before, so only the new pieces need checking. Of two equal pieces,
+    // the first is kept.
+    for (int i = 0; i < split.count(); ++i) {
+        const SkIRect& piece = split[i];
+        bool contained = false;
+        for (int j = 0; j < oldCount && !contained; ++j) {
+            contained = fFreeRects[j].contains(piece);
+        }
+        for (int j = 0; j < split.count() && !contained; ++j) {
+            contained = j != i && split[j].contains(piece) && (j < i || split[j] != piece);
+        }
+        if (!contained) {
+            *fFreeRects.append() = piece;
+        }
+    }
+
+    for (int i = 0; i < fFreeRects.count(); ++i) {
+        if (fFreeRects[i].isEmpty()) {
+            fFreeRects.removeShuffle(i);
+            --i;
+        }
+    }
+}
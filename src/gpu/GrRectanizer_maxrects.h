@@ -0,0 +1,52 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrRectanizer_maxrects_DEFINED
+#define GrRectanizer_maxrects_DEFINED
+
+#include "GrRectanizer.h"
+#include "SkRect.h"
+#include "SkTDArray.h"
+
+// Tracks every maximal free rectangle left in the atlas, and places each new rect in the free
+// rectangle that it fits most snugly along its shorter leftover side ("best short side fit").
+// Based, in part, on Jukka Jylanki's work at http://clb.demon.fi
+// Packs mixed sizes tighter than the skyline, which can only place rects on top of its
+// silhouette, but each placement costs time in the number of free rectangles.
+class GrRectanizerMaxRects : public GrRectanizer {
+public:
+    GrRectanizerMaxRects(int w, int h) : INHERITED(w, h) {
+        this->reset();
+    }
+
+    ~GrRectanizerMaxRects() override { }
+
+    void reset() override {
+        fAreaSoFar = 0;
+        fFreeRects.reset();
+        *fFreeRects.append() = SkIRect::MakeWH(this->width(), this->height());
+    }
+
+    bool addRect(int w, int h, SkIPoint16* loc) override;
+
+    float percentFull() const override {
+        return fAreaSoFar / ((float)this->width() * this->height());
+    }
+
+private:
+    // Remove the space taken by 'used' from the free rectangles.
+    void splitFreeRects(const SkIRect& used);
+
+    // No free rectangle is contained in another one.
+    SkTDArray<SkIRect> fFreeRects;
+
+    int32_t fAreaSoFar;
+
+    typedef GrRectanizer INHERITED;
+};
+
+#endif
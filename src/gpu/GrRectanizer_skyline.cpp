@@ -20,15 +20,34 @@ bool GrRectanizerSkyline::addRect(int width, int height, SkIPoint16* loc) {
     int bestY = this->height() + 1;
     int bestIndex = -1;
     for (int i = 0; i < fSkyline.count(); ++i) {
-        int y;
-        if (this->rectangleFits(i, width, height, &y)) {
-            // minimize y position first, then width of skyline
-            if (y < bestY || (y == bestY && fSkyline[i].fWidth < bestWidth)) {
-                bestIndex = i;
-                bestWidth = fSkyline[i].fWidth;
-                bestX = fSkyline[i].fX;
-                bestY = y;
-            }
+        const SkylineSegment& segment = fSkyline[i];
+        int right = segment.fX + width;
+        if (right > this->width()) {
+            // fX only grows, so no later segment fits either
+            break;
+        }
+        // the rect rests at least as high as this segment, so skip the ones that cannot win
+        if (segment.fY > bestY || (segment.fY == bestY && segment.fWidth >= bestWidth)) {
+            continue;
+        }
+        // rest the rect on the highest segment under it, giving up once that is worse than the
+        // best so far
+        int y = segment.fY;
+        int covered = segment.fX + segment.fWidth;
+        for (int j = i + 1; covered < right && y <= bestY; ++j) {
+            SkASSERT(j < fSkyline.count());
+            y = SkMax32(y, fSkyline[j].fY);
+            covered += fSkyline[j].fWidth;
+        }
+        if (y + height > this->height()) {
+            continue;
+        }
+        // minimize y position first, then width of skyline
+        if (y < bestY || (y == bestY && segment.fWidth < bestWidth)) {
+            bestIndex = i;
+            bestWidth = segment.fWidth;
+            bestX = segment.fX;
+            bestY = y;
         }
     }
 
@@ -47,29 +66,6 @@ bool GrRectanizerSkyline::addRect(int width, int height, SkIPoint16* loc) {
     return false;
 }
 
-bool GrRectanizerSkyline::rectangleFits(int skylineIndex, int width, int height, int* ypos) const {
-    int x = fSkyline[skylineIndex].fX;
-    if (x + width > this->width()) {
-        return false;
-    }
-
-    int widthLeft = width;
-    int i = skylineIndex;
-    int y = fSkyline[skylineIndex].fY;
-    while (widthLeft > 0) {
-        y = SkMax32(y, fSkyline[i].fY);
-        if (y + height > this->height()) {
-            return false;
-        }
-        widthLeft -= fSkyline[i].fWidth;
-        ++i;
-        SkASSERT(i < fSkyline.count() || widthLeft <= 0);
-    }
-
-    *ypos = y;
-    return true;
-}
-
 void GrRectanizerSkyline::addSkylineLevel(int skylineIndex, int x, int y, int width, int height) {
     SkylineSegment newSegment;
     newSegment.fX = x;
@@ -104,13 +100,16 @@ void GrRectanizerSkyline::addSkylineLevel(int skylineIndex, int x, int y, int wi
         }
     }
 
-    // merge fSkylines
-    for (int i = 0; i < fSkyline.count()-1; ++i) {
-        if (fSkyline[i].fY == fSkyline[i+1].fY) {
-            fSkyline[i].fWidth += fSkyline[i+1].fWidth;
-            fSkyline.remove(i+1);
-            --i;
-        }
+    // merge fSkylines; the rest of the skyline was already merged, so only the new segment can
+    // have the same height as its neighbors
+    if (skylineIndex + 1 < fSkyline.count() &&
+        fSkyline[skylineIndex].fY == fSkyline[skylineIndex + 1].fY) {
+        fSkyline[skylineIndex].fWidth += fSkyline[skylineIndex + 1].fWidth;
+        fSkyline.remove(skylineIndex + 1);
+    }
+    if (skylineIndex > 0 && fSkyline[skylineIndex - 1].fY == fSkyline[skylineIndex].fY) {
+        fSkyline[skylineIndex - 1].fWidth += fSkyline[skylineIndex].fWidth;
+        fSkyline.remove(skylineIndex);
     }
 }
 
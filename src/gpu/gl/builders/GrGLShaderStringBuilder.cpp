@@ -9,6 +9,7 @@
 #include "gl/GrGLGpu.h"
 #include "gl/GrGLSLPrettyPrint.h"
 #include "SkTraceEvent.h"
+#include "SkSLCompileCache.h"
 #include "SkSLCompiler.h"
 #include "SkSLGLSLCodeGenerator.h"
 #include "ir/SkSLProgram.h"
@@ -67,20 +68,19 @@ GrGLuint GrGLCompileAndAttachShader(const GrGLContext& glCtx,
     SkString glsl;
     if (type == GR_GL_VERTEX_SHADER || type == GR_GL_FRAGMENT_SHADER) {
         SkSL::Compiler& compiler = *glCtx.compiler();
-        std::unique_ptr<SkSL::Program> program;
-        program = compiler.convertProgram(
-                                        type == GR_GL_VERTEX_SHADER ? SkSL::Program::kVertex_Kind
-                                                                    : SkSL::Program::kFragment_Kind,
-                                        sksl,
-                                        settings);
-        if (!program || !compiler.toGLSL(*program, &glsl)) {
+        // Identical shaders are common across programs and contexts, so the output is memoized.
+        if (!SkSL::CompileCache::Global()->compile(&compiler,
+                                                   SkSL::CompileCache::kGLSL_Target,
+                                                   type == GR_GL_VERTEX_SHADER
+                                                           ? SkSL::Program::kVertex_Kind
+                                                           : SkSL::Program::kFragment_Kind,
+                                                   sksl, settings, &glsl, outInputs)) {
             SkDebugf("SKSL compilation error\n----------------------\n");
             SkDebugf("SKSL:\n");
             dump_string(sksl);
             SkDebugf("\nErrors:\n%s\n", compiler.errorText().c_str());
             SkDEBUGFAIL("SKSL compilation failed!\n");
         }
-        *outInputs = program->fInputs;
     } else {
         // TODO: geometry shader support in sksl.
         SkASSERT(type == GR_GL_GEOMETRY_SHADER);
@@ -18,7 +18,8 @@ namespace gr_instanced {
 InstancedRendering::InstancedRendering(GrGpu* gpu)
     : fGpu(SkRef(gpu)),
       fState(State::kRecordingDraws),
-      fDrawPool(1024, 1024) {
+      // Draws are freed along with their ops, at the end of a flush.
+      fDrawPool(1024, 1024, GrMemoryPool::ReleaseMode::kBulk) {
 }
 
 std::unique_ptr<GrDrawOp> InstancedRendering::recordRect(const SkRect& rect,
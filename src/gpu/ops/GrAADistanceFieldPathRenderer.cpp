@@ -22,6 +22,8 @@
 
 #include "SkPathOps.h"
 #include "SkDistanceFieldGen.h"
+#include "SkTaskGroup.h"
+#include "SkTHash.h"
 #include "GrDistanceFieldGenFromVector.h"
 
 #define ATLAS_TEXTURE_WIDTH 2048
@@ -42,6 +44,10 @@ static const int kSmallMIP = 32;
 static const int kMediumMIP = 73;
 static const int kLargeMIP = 162;
 
+// The most distance fields an op generates ahead of adding them to the atlas. At the largest mip
+// level this holds about a megabyte of fields.
+static const int kFieldsPerBatch = 32;
+
 // Callback to clear out internal path cache when eviction occurs
 void GrAADistanceFieldPathRenderer::HandleEviction(GrDrawOpAtlas::AtlasID id, void* pr) {
     GrAADistanceFieldPathRenderer* dfpr = (GrAADistanceFieldPathRenderer*)pr;
@@ -121,6 +127,128 @@ bool GrAADistanceFieldPathRenderer::onCanDrawPath(const CanDrawPathArgs& args) c
 // padding around path bounds to allow for antialiased pixels
 static const SkScalar kAntiAliasPad = 1.0f;
 
+// Picks the size of the distance field to generate for a shape.
+static SkScalar desired_dimension(const GrShape& shape, SkScalar maxScale) {
+    const SkRect& bounds = shape.bounds();
+    SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
+    SkScalar size = maxScale * maxDim;
+    // For minimizing (or the common case of identity) transforms, we try to
+    // create the DF at the appropriately sized native src-space path resolution.
+    // In the majority of cases this will yield a crisper rendering.
+    if (size <= maxDim && maxDim < kSmallMIP) {
+        return maxDim;
+    } else if (size <= kSmallMIP) {
+        return kSmallMIP;
+    } else if (size <= maxDim) {
+        return maxDim;
+    } else if (size <= kMediumMIP) {
+        return kMediumMIP;
+    } else {
+        return kLargeMIP;
+    }
+}
+
+// A shape's distance field, before it is added to the atlas.
+struct ShapeDistanceField {
+    SkAutoTMalloc<unsigned char> fImage;
+    int fWidth;
+    int fHeight;
+    // integer portion of the scaled bounds' origin (the fractional offset is burnt in)
+    SkScalar fDX;
+    SkScalar fDY;
+};
+
+// Generates the distance field for a shape, scaled to its mip level. Only touches its arguments,
+// so may run on any thread.
+static bool generate_distance_field(const GrShape& shape, SkScalar scale,
+                                    ShapeDistanceField* field) {
+    const SkRect& bounds = shape.bounds();
+
+    // generate bounding rect for bitmap draw
+    SkRect scaledBounds = bounds;
+    // scale to mip level size
+    scaledBounds.fLeft *= scale;
+    scaledBounds.fTop *= scale;
+    scaledBounds.fRight *= scale;
+    scaledBounds.fBottom *= scale;
+    // subtract out integer portion of origin
+    // (SDF created will be placed with fractional offset burnt in)
+    SkScalar dx = SkScalarFloorToScalar(scaledBounds.fLeft);
+    SkScalar dy = SkScalarFloorToScalar(scaledBounds.fTop);
+    scaledBounds.offset(-dx, -dy);
+    // get integer boundary
+    SkIRect devPathBounds;
+    scaledBounds.roundOut(&devPathBounds);
+    // pad to allow room for antialiasing
+    const int intPad = SkScalarCeilToInt(kAntiAliasPad);
+    // place devBounds at origin
+    int width = devPathBounds.width() + 2*intPad;
+    int height = devPathBounds.height() + 2*intPad;
+    devPathBounds = SkIRect::MakeWH(width, height);
+
+    // draw path to bitmap
+    SkMatrix drawMatrix;
+    drawMatrix.setScale(scale, scale);
+    drawMatrix.postTranslate(intPad - dx, intPad - dy);
+
+    SkASSERT(devPathBounds.fLeft == 0);
+    SkASSERT(devPathBounds.fTop == 0);
+
+    // setup signed distance field storage
+    SkIRect dfBounds = devPathBounds.makeOutset(SK_DistanceFieldPad, SK_DistanceFieldPad);
+    width = dfBounds.width();
+    height = dfBounds.height();
+    // TODO We should really generate this directly into the plot somehow
+    field->fImage.reset(width * height * sizeof(unsigned char));
+    field->fWidth = width;
+    field->fHeight = height;
+    field->fDX = dx;
+    field->fDY = dy;
+
+    SkPath path;
+    shape.asPath(&path);
+#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
+    // Generate signed distance field directly from SkPath
+    bool succeed = GrGenerateDistanceFieldFromPath(field->fImage.get(),
+                                    path, drawMatrix,
+                                    width, height, width * sizeof(unsigned char));
+    if (!succeed) {
+#endif
+        // setup bitmap backing
+        SkAutoPixmapStorage dst;
+        if (!dst.tryAlloc(SkImageInfo::MakeA8(devPathBounds.width(),
+                                              devPathBounds.height()))) {
+            field->fImage.reset(0);
+            return false;
+        }
+        sk_bzero(dst.writable_addr(), dst.getSafeSize());
+
+        // rasterize path
+        SkPaint paint;
+        paint.setStyle(SkPaint::kFill_Style);
+        paint.setAntiAlias(true);
+
+        SkDraw draw;
+        sk_bzero(&draw, sizeof(draw));
+
+        SkRasterClip rasterClip;
+        rasterClip.setRect(devPathBounds);
+        draw.fRC = &rasterClip;
+        draw.fMatrix = &drawMatrix;
+        draw.fDst = dst;
+
+        draw.drawPathCoverage(path, paint);
+
+        // Generate signed distance field
+        SkGenerateDistanceFieldFromA8Image(field->fImage.get(),
+                                           (const unsigned char*)dst.addr(),
+                                           dst.width(), dst.height(), dst.rowBytes());
+#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
+    }
+#endif
+    return true;
+}
+
 class AADistanceFieldPathOp final : public GrMeshDrawOp {
 public:
     DEFINE_OP_CLASS_ID
@@ -232,161 +360,120 @@ private:
         flushInfo.fInstancesToFlush = 0;
         // Pointer to the next set of vertices to write.
         intptr_t offset = reinterpret_cast<intptr_t>(vertices);
-        for (int i = 0; i < instanceCount; i++) {
-            const Entry& args = fShapes[i];
-
-            // get mip level
-            SkScalar maxScale = this->viewMatrix().getMaxScale();
-            const SkRect& bounds = args.fShape.bounds();
-            SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
-            SkScalar size = maxScale * maxDim;
-            SkScalar desiredDimension;
-            // For minimizing (or the common case of identity) transforms, we try to
-            // create the DF at the appropriately sized native src-space path resolution.
-            // In the majority of cases this will yield a crisper rendering.
-            if (size <= maxDim && maxDim < kSmallMIP) {
-                desiredDimension = maxDim;
-            } else if (size <= kSmallMIP) {
-                desiredDimension = kSmallMIP;
-            } else if (size <= maxDim) {
-                desiredDimension = maxDim;
-            } else if (size <= kMediumMIP) {
-                desiredDimension = kMediumMIP;
-            } else {
-                desiredDimension = kLargeMIP;
-            }
 
-            // check to see if path is cached
-            ShapeData::Key key(args.fShape, SkScalarCeilToInt(desiredDimension));
-            ShapeData* shapeData = fShapeCache->find(key);
-            if (nullptr == shapeData || !atlas->hasID(shapeData->fID)) {
-                // Remove the stale cache entry
-                if (shapeData) {
-                    fShapeCache->remove(shapeData->fKey);
-                    fShapeList->remove(shapeData);
-                    delete shapeData;
-                }
-                SkScalar scale = desiredDimension/maxDim;
-
-                shapeData = new ShapeData;
-                if (!this->addPathToAtlas(target,
-                                          &flushInfo,
-                                          atlas,
-                                          shapeData,
-                                          args.fShape,
-                                          SkScalarCeilToInt(desiredDimension),
-                                          scale)) {
-                    delete shapeData;
-                    SkDebugf("Can't rasterize path\n");
-                    continue;
+        // The distance fields for the shapes that are not in the atlas are generated ahead of
+        // time, in parallel, a batch of instances at a time; adding them to the atlas has to be
+        // done one at a time. Batches bound the memory the generated fields hold.
+        SkScalar maxScale = this->viewMatrix().getMaxScale();
+        ShapeDistanceField fields[kFieldsPerBatch];
+        for (int batchStart = 0; batchStart < instanceCount; batchStart += kFieldsPerBatch) {
+            int batchCount = SkTMin(kFieldsPerBatch, instanceCount - batchStart);
+            this->generateFields(atlas, maxScale, batchStart, batchCount, fields);
+
+            for (int i = batchStart; i < batchStart + batchCount; i++) {
+                const Entry& args = fShapes[i];
+
+                // get mip level
+                const SkRect& bounds = args.fShape.bounds();
+                SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
+                SkScalar desiredDimension = desired_dimension(args.fShape, maxScale);
+
+                // check to see if path is cached
+                ShapeData::Key key(args.fShape, SkScalarCeilToInt(desiredDimension));
+                ShapeData* shapeData = fShapeCache->find(key);
+                if (nullptr == shapeData || !atlas->hasID(shapeData->fID)) {
+                    // Remove the stale cache entry
+                    if (shapeData) {
+                        fShapeCache->remove(shapeData->fKey);
+                        fShapeList->remove(shapeData);
+                        delete shapeData;
+                    }
+                    SkScalar scale = desiredDimension/maxDim;
+
+                    shapeData = new ShapeData;
+                    if (!this->addPathToAtlas(target,
+                                              &flushInfo,
+                                              atlas,
+                                              shapeData,
+                                              args.fShape,
+                                              SkScalarCeilToInt(desiredDimension),
+                                              scale,
+                                              &fields[i - batchStart])) {
+                        delete shapeData;
+                        SkDebugf("Can't rasterize path\n");
+                        continue;
+                    }
                 }
-            }
 
-            atlas->setLastUseToken(shapeData->fID, target->nextDrawToken());
-
-            this->writePathVertices(target,
-                                    atlas,
-                                    offset,
-                                    args.fColor,
-                                    vertexStride,
-                                    maxScale,
-                                    shapeData);
-            offset += kVerticesPerQuad * vertexStride;
-            flushInfo.fInstancesToFlush++;
+                atlas->setLastUseToken(shapeData->fID, target->nextDrawToken());
+
+                this->writePathVertices(target,
+                                        atlas,
+                                        offset,
+                                        args.fColor,
+                                        vertexStride,
+                                        maxScale,
+                                        shapeData);
+                offset += kVerticesPerQuad * vertexStride;
+                flushInfo.fInstancesToFlush++;
+            }
         }
 
         this->flush(target, &flushInfo);
     }
 
+    // Clears fields[0, count) and, if more than one of the count shapes starting at first is not
+    // in the atlas, generates their distance fields in parallel into the matching fields.
+    void generateFields(GrDrawOpAtlas* atlas, SkScalar maxScale, int first, int count,
+                        ShapeDistanceField fields[]) const {
+        SkSTArray<kFieldsPerBatch, int, true> uncached;
+        // Repeated shapes are only generated once. A hash collision just means that a shape is
+        // generated as it is added to the atlas instead.
+        SkTHashSet<uint32_t> uncachedHashes;
+        for (int i = 0; i < count; i++) {
+            fields[i].fImage.reset(0);
+            const GrShape& shape = fShapes[first + i].fShape;
+            ShapeData::Key key(shape, SkScalarCeilToInt(desired_dimension(shape, maxScale)));
+            ShapeData* shapeData = fShapeCache->find(key);
+            uint32_t hash = ShapeData::Hash(key);
+            if ((nullptr == shapeData || !atlas->hasID(shapeData->fID)) &&
+                !uncachedHashes.contains(hash)) {
+                uncachedHashes.add(hash);
+                uncached.push_back(i);
+            }
+        }
+        if (uncached.count() > 1) {
+            SkTaskGroup().batch(uncached.count(), [&](int i) {
+                const GrShape& shape = fShapes[first + uncached[i]].fShape;
+                const SkRect& bounds = shape.bounds();
+                SkScalar maxDim = SkMaxScalar(bounds.width(), bounds.height());
+                SkScalar scale = desired_dimension(shape, maxScale)/maxDim;
+                generate_distance_field(shape, scale, &fields[uncached[i]]);
+            });
+        }
+    }
+
     bool addPathToAtlas(GrMeshDrawOp::Target* target, FlushInfo* flushInfo, GrDrawOpAtlas* atlas,
                         ShapeData* shapeData, const GrShape& shape, uint32_t dimension,
-                        SkScalar scale) const {
+                        SkScalar scale, ShapeDistanceField* field) const {
         const SkRect& bounds = shape.bounds();
 
-        // generate bounding rect for bitmap draw
-        SkRect scaledBounds = bounds;
-        // scale to mip level size
-        scaledBounds.fLeft *= scale;
-        scaledBounds.fTop *= scale;
-        scaledBounds.fRight *= scale;
-        scaledBounds.fBottom *= scale;
-        // subtract out integer portion of origin
-        // (SDF created will be placed with fractional offset burnt in)
-        SkScalar dx = SkScalarFloorToScalar(scaledBounds.fLeft);
-        SkScalar dy = SkScalarFloorToScalar(scaledBounds.fTop);
-        scaledBounds.offset(-dx, -dy);
-        // get integer boundary
-        SkIRect devPathBounds;
-        scaledBounds.roundOut(&devPathBounds);
-        // pad to allow room for antialiasing
-        const int intPad = SkScalarCeilToInt(kAntiAliasPad);
-        // place devBounds at origin
-        int width = devPathBounds.width() + 2*intPad;
-        int height = devPathBounds.height() + 2*intPad;
-        devPathBounds = SkIRect::MakeWH(width, height);
-
-        // draw path to bitmap
-        SkMatrix drawMatrix;
-        drawMatrix.setScale(scale, scale);
-        drawMatrix.postTranslate(intPad - dx, intPad - dy);
-
-        SkASSERT(devPathBounds.fLeft == 0);
-        SkASSERT(devPathBounds.fTop == 0);
-
-        // setup signed distance field storage
-        SkIRect dfBounds = devPathBounds.makeOutset(SK_DistanceFieldPad, SK_DistanceFieldPad);
-        width = dfBounds.width();
-        height = dfBounds.height();
-        // TODO We should really generate this directly into the plot somehow
-        SkAutoSMalloc<1024> dfStorage(width * height * sizeof(unsigned char));
-
-        SkPath path;
-        shape.asPath(&path);
-#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
-        // Generate signed distance field directly from SkPath
-        bool succeed = GrGenerateDistanceFieldFromPath((unsigned char*)dfStorage.get(),
-                                        path, drawMatrix,
-                                        width, height, width * sizeof(unsigned char));
-        if (!succeed) {
-#endif
-            // setup bitmap backing
-            SkAutoPixmapStorage dst;
-            if (!dst.tryAlloc(SkImageInfo::MakeA8(devPathBounds.width(),
-                                                  devPathBounds.height()))) {
-                return false;
-            }
-            sk_bzero(dst.writable_addr(), dst.getSafeSize());
-
-            // rasterize path
-            SkPaint paint;
-            paint.setStyle(SkPaint::kFill_Style);
-            paint.setAntiAlias(true);
-
-            SkDraw draw;
-            sk_bzero(&draw, sizeof(draw));
-
-            SkRasterClip rasterClip;
-            rasterClip.setRect(devPathBounds);
-            draw.fRC = &rasterClip;
-            draw.fMatrix = &drawMatrix;
-            draw.fDst = dst;
-
-            draw.drawPathCoverage(path, paint);
-
-            // Generate signed distance field
-            SkGenerateDistanceFieldFromA8Image((unsigned char*)dfStorage.get(),
-                                               (const unsigned char*)dst.addr(),
-                                               dst.width(), dst.height(), dst.rowBytes());
-#ifndef SK_USE_LEGACY_DISTANCE_FIELDS
+        // the field may have been generated ahead of time
+        if (!field->fImage.get() && !generate_distance_field(shape, scale, field)) {
+            return false;
         }
-#endif
+        int width = field->fWidth;
+        int height = field->fHeight;
+        SkScalar dx = field->fDX;
+        SkScalar dy = field->fDY;
 
         // add to atlas
         SkIPoint16 atlasLocation;
         GrDrawOpAtlas::AtlasID id;
-        if (!atlas->addToAtlas(&id, target, width, height, dfStorage.get(), &atlasLocation)) {
+        if (!atlas->addToAtlas(&id, target, width, height, field->fImage.get(), &atlasLocation)) {
             this->flush(target, flushInfo);
-            if (!atlas->addToAtlas(&id, target, width, height, dfStorage.get(), &atlasLocation)) {
+            if (!atlas->addToAtlas(&id, target, width, height, field->fImage.get(),
+                                   &atlasLocation)) {
                 return false;
             }
         }
@@ -8,36 +8,24 @@
 #include "GrOp.h"
 
 #include "GrMemoryPool.h"
-#include "SkSpinlock.h"
+#include "SkOnce.h"
 
 // TODO I noticed a small benefit to using a larger exclusive pool for ops. Its very small, but
 // seems to be mostly consistent.  There is a lot in flux right now, but we should really revisit
 // this.
 
 
-// We use a global pool protected by a mutex(spinlock). Chrome may use the same GrContext on
-// different threads. The GrContext is not used concurrently on different threads and there is a
-// memory barrier between accesses of a context on different threads. Also, there may be multiple
-// GrContexts and those contexts may be in use concurrently on different threads.
-namespace {
-static SkSpinlock gOpPoolSpinLock;
-class MemoryPoolAccessor {
-public:
-
-// We know in the Android framework there is only one GrContext.
-#if defined(SK_BUILD_FOR_ANDROID_FRAMEWORK)
-    MemoryPoolAccessor() {}
-    ~MemoryPoolAccessor() {}
-#else
-    MemoryPoolAccessor() { gOpPoolSpinLock.acquire(); }
-    ~MemoryPoolAccessor() { gOpPoolSpinLock.release(); }
-#endif
-
-    GrMemoryPool* pool() const {
-        static GrMemoryPool gPool(16384, 16384);
-        return &gPool;
-    }
-};
+// We use global pools, one per group of threads, each protected by a spinlock. Chrome may use the
+// same GrContext on different threads. The GrContext is not used concurrently on different threads
+// and there is a memory barrier between accesses of a context on different threads. Also, there may
+// be multiple GrContexts and those contexts may be in use concurrently on different threads.
+// The pools are created under SkOnce rather than as a function-local static, since Skia builds
+// with -fno-threadsafe-statics and the first ops may be created on several threads at once.
+static GrThreadMemoryPools* pools() {
+    static SkOnce once;
+    static GrThreadMemoryPools* gPools;
+    once([] { gPools = new GrThreadMemoryPools(16384, 16384); });
+    return gPools;
 }
 
 int32_t GrOp::gCurrOpClassID = GrOp::kIllegalOpID;
@@ -45,11 +33,11 @@ int32_t GrOp::gCurrOpClassID = GrOp::kIllegalOpID;
 int32_t GrOp::gCurrOpUniqueID = GrOp::kIllegalOpID;
 
 void* GrOp::operator new(size_t size) {
-    return MemoryPoolAccessor().pool()->allocate(size);
+    return pools()->allocate(size);
 }
 
-void GrOp::operator delete(void* target) {
-    return MemoryPoolAccessor().pool()->release(target);
+void GrOp::operator delete(void* target, size_t size) {
+    return pools()->release(target, size);
 }
 
 GrOp::GrOp(uint32_t classID)
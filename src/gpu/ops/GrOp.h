@@ -87,7 +87,7 @@ public:
     }
 
     void* operator new(size_t size);
-    void operator delete(void* target);
+    void operator delete(void* target, size_t size);
 
     void* operator new(size_t size, void* placement) {
         return ::operator new(size, placement);
@@ -8,6 +8,7 @@
 #include "GrVkUtil.h"
 
 #include "vk/GrVkGpu.h"
+#include "SkSLCompileCache.h"
 #include "SkSLCompiler.h"
 
 bool GrPixelConfigToVkFormat(GrPixelConfig config, VkFormat* format) {
@@ -283,18 +284,14 @@ bool GrCompileVkShaderModule(const GrVkGpu* gpu,
                              VkPipelineShaderStageCreateInfo* stageInfo,
                              const SkSL::Program::Settings& settings,
                              SkSL::Program::Inputs* outInputs) {
-    std::unique_ptr<SkSL::Program> program = gpu->shaderCompiler()->convertProgram(
-                                                              vk_shader_stage_to_skiasl_kind(stage),
-                                                              SkString(shaderString),
-                                                              settings);
-    if (!program) {
+    SkString code;
+    if (!SkSL::CompileCache::Global()->compile(gpu->shaderCompiler(),
+                                               SkSL::CompileCache::kSPIRV_Target,
+                                               vk_shader_stage_to_skiasl_kind(stage),
+                                               SkString(shaderString), settings, &code,
+                                               outInputs)) {
         SkDebugf("SkSL error:\n%s\n", gpu->shaderCompiler()->errorText().c_str());
         SkASSERT(false);
-    }
-    *outInputs = program->fInputs;
-    SkString code;
-    if (!gpu->shaderCompiler()->toSPIRV(*program, &code)) {
-        SkDebugf("%s\n", gpu->shaderCompiler()->errorText().c_str());
         return false;
     }
 
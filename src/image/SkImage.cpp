@@ -104,6 +104,12 @@ SkData* SkImage::encode(SkEncodedImageFormat type, int quality) const {
 }
 
 SkData* SkImage::encode(SkPixelSerializer* serializer) const {
+    if (serializer) {
+        if (SkData* known = serializer->encodeKnownImage(this)) {
+            return known;
+        }
+    }
+
     sk_sp<SkData> encoded(this->refEncoded());
     if (encoded &&
         (!serializer || serializer->useEncodedData(encoded->data(), encoded->size()))) {
@@ -277,8 +277,19 @@ bool SkImageShader::onAppendStages(SkRasterPipeline* p, SkColorSpace* dst, SkFal
     ctx->stride  = pm.rowBytesAsPixels();
     ctx->width   = (float)pm.width();
     ctx->height  = (float)pm.height();
+    ctx->tileX    = fTileModeX;
+    ctx->tileY    = fTileModeY;
+    ctx->fromSRGB = info.gammaCloseToSRGB() && dst != nullptr;
+    ctx->clampA   = ctx->fromSRGB && info.alphaType() == kPremul_SkAlphaType;
+
     if (matrix.asAffine(ctx->matrix)) {
-        p->append(SkRasterPipeline::matrix_2x3, ctx->matrix);
+        if (matrix.getType() <= SkMatrix::kTranslate_Mask) {
+            p->append(SkRasterPipeline::matrix_translate, ctx->matrix);
+        } else if (matrix.getType() <= (SkMatrix::kScale_Mask | SkMatrix::kTranslate_Mask)) {
+            p->append(SkRasterPipeline::matrix_scale_translate, ctx->matrix);
+        } else {
+            p->append(SkRasterPipeline::matrix_2x3, ctx->matrix);
+        }
     } else {
         matrix.get9(ctx->matrix);
         p->append(SkRasterPipeline::matrix_perspective, ctx->matrix);
@@ -319,8 +330,14 @@ bool SkImageShader::onAppendStages(SkRasterPipeline* p, SkColorSpace* dst, SkFal
         p->append(SkRasterPipeline::accumulate, ctx);
     };
 
+    // 8888 images, by far the most common, filter in a single stage.
+    bool is8888 = info.colorType() == kRGBA_8888_SkColorType ||
+                  info.colorType() == kBGRA_8888_SkColorType;
+
     if (quality == kNone_SkFilterQuality) {
         append_tiling_and_gather();
+    } else if (quality == kLow_SkFilterQuality && is8888) {
+        p->append(SkRasterPipeline::bilinear_8888, ctx);
     } else if (quality == kLow_SkFilterQuality) {
         p->append(SkRasterPipeline::save_xy, ctx);
 
@@ -330,6 +347,8 @@ bool SkImageShader::onAppendStages(SkRasterPipeline* p, SkColorSpace* dst, SkFal
         sample(SkRasterPipeline::bilinear_px, SkRasterPipeline::bilinear_py);
 
         p->append(SkRasterPipeline::move_dst_src);
+    } else if (is8888) {
+        p->append(SkRasterPipeline::bicubic_8888, ctx);
     } else {
         p->append(SkRasterPipeline::save_xy, ctx);
 
@@ -11,6 +11,7 @@
 #include "SkBitmapController.h"
 #include "SkColor.h"
 #include "SkColorTable.h"
+#include "SkShader.h"
 #include <memory>
 
 // Definition used by SkImageShader.cpp and SkRasterPipeline_opts.h.
@@ -25,6 +26,14 @@ struct SkImageShaderContext {
     int           stride;
     float         width;
     float         height;
+
+    // Used only by the bilinear_8888 and bicubic_8888 stages, which tile, gather and linearize
+    // each tap themselves.
+    SkShader::TileMode tileX;
+    SkShader::TileMode tileY;
+    bool               fromSRGB;    // as from_srgb
+    bool               clampA;      // as clamp_a, after from_srgb
+
     float         matrix[9];
     float         x[8];
     float         y[8];
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkDeflate_opts_DEFINED
+#define SkDeflate_opts_DEFINED
+
+#include "SkOnce.h"
+#include "SkTypes.h"
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    #include <tmmintrin.h>
+#endif
+#if defined(SK_CPU_ARM64) && defined(SK_ARM_HAS_CRC32)
+    #include <arm_acle.h>
+#endif
+
+// The two checksums used by zlib and gzip streams, computed exactly as zlib's adler32() and
+// crc32() do. Everything is static inline, so including this file costs nothing if unused.
+
+namespace SK_OPTS_NS {
+
+static const uint32_t kAdlerBase = 65521;
+// Largest n such that 255n(n+1)/2 + (n+1)(kAdlerBase-1) <= 2^32-1, i.e. the most bytes we can
+// sum before s2 has to be reduced.
+static const size_t   kAdlerNMax = 5552;
+
+static inline uint32_t adler32_portable(uint32_t adler, const uint8_t* data, size_t len) {
+    uint32_t s1 = adler & 0xffff,
+             s2 = adler >> 16;
+    while (len > 0) {
+        size_t n = SkTMin(len, kAdlerNMax);
+        len -= n;
+        for (; n >= 8; n -= 8, data += 8) {
+            s1 += data[0]; s2 += s1;
+            s1 += data[1]; s2 += s1;
+            s1 += data[2]; s2 += s1;
+            s1 += data[3]; s2 += s1;
+            s1 += data[4]; s2 += s1;
+            s1 += data[5]; s2 += s1;
+            s1 += data[6]; s2 += s1;
+            s1 += data[7]; s2 += s1;
+        }
+        for (; n > 0; n--) {
+            s1 += *data++; s2 += s1;
+        }
+        s1 %= kAdlerBase;
+        s2 %= kAdlerBase;
+    }
+    return (s2 << 16) | s1;
+}
+
+#if SK_CPU_SSE_LEVEL >= SK_CPU_SSE_LEVEL_SSSE3
+    // Sums 32 bytes per step: _mm_sad_epu8() accumulates s1, and _mm_maddubs_epi16() weights
+    // each byte by its distance from the end of the block for s2.
+    static inline uint32_t adler32(uint32_t adler, const uint8_t* data, size_t len) {
+        const size_t kBlock = 32;
+        uint32_t s1 = adler & 0xffff,
+                 s2 = adler >> 16;
+
+        size_t blocks = len / kBlock;
+        len -= blocks * kBlock;
+
+        const __m128i tap1 = _mm_setr_epi8(32,31,30,29,28,27,26,25,24,23,22,21,20,19,18,17),
+                      tap2 = _mm_setr_epi8(16,15,14,13,12,11,10, 9, 8, 7, 6, 5, 4, 3, 2, 1),
+                      zero = _mm_setzero_si128(),
+                      ones = _mm_set1_epi16(1);
+        while (blocks > 0) {
+            size_t n = SkTMin(blocks, kAdlerNMax / kBlock);
+            blocks -= n;
+
+            // v_ps accumulates s1 as of the start of each block; each contributes 32x to s2.
+            __m128i v_ps = _mm_set_epi32(0, 0, 0, s1 * (uint32_t)n),
+                    v_s2 = _mm_set_epi32(0, 0, 0, s2),
+                    v_s1 = zero;
+            do {
+                __m128i lo = _mm_loadu_si128((const __m128i*)(data +  0)),
+                        hi = _mm_loadu_si128((const __m128i*)(data + 16));
+
+                v_ps = _mm_add_epi32(v_ps, v_s1);
+                v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(lo, zero));
+                v_s1 = _mm_add_epi32(v_s1, _mm_sad_epu8(hi, zero));
+                v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(lo, tap1), ones));
+                v_s2 = _mm_add_epi32(v_s2, _mm_madd_epi16(_mm_maddubs_epi16(hi, tap2), ones));
+                data += kBlock;
+            } while (--n);
+
+            v_s2 = _mm_add_epi32(v_s2, _mm_slli_epi32(v_ps, 5));
+
+            // Sum the lanes.
+            v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(1,0,3,2)));
+            v_s1 = _mm_add_epi32(v_s1, _mm_shuffle_epi32(v_s1, _MM_SHUFFLE(2,3,0,1)));
+            s1 += _mm_cvtsi128_si32(v_s1);
+
+            v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(1,0,3,2)));
+            v_s2 = _mm_add_epi32(v_s2, _mm_shuffle_epi32(v_s2, _MM_SHUFFLE(2,3,0,1)));
+            s2 = _mm_cvtsi128_si32(v_s2);
+
+            s1 %= kAdlerBase;
+            s2 %= kAdlerBase;
+        }
+        return adler32_portable((s2 << 16) | s1, data, len);
+    }
+#else
+    static inline uint32_t adler32(uint32_t adler, const uint8_t* data, size_t len) {
+        return adler32_portable(adler, data, len);
+    }
+#endif
+
+#if defined(SK_CPU_ARM64) && defined(SK_ARM_HAS_CRC32)
+    // ARMv8's CRC32 instructions use the same polynomial as gzip.
+    // (x86's SSE4.2 crc32 computes CRC-32C, which is no use here.)
+    static inline uint32_t gzip_crc32(uint32_t crc, const uint8_t* data, size_t len) {
+        crc = ~crc;
+        for (; len >= 8; len -= 8, data += 8) {
+            uint64_t v;
+            memcpy(&v, data, 8);
+            crc = __crc32d(crc, v);
+        }
+        for (; len > 0; len--) {
+            crc = __crc32b(crc, *data++);
+        }
+        return ~crc;
+    }
+#else
+    // Slicing-by-8: eight table lookups per 8 bytes instead of one per byte.
+    static inline uint32_t gzip_crc32(uint32_t crc, const uint8_t* data, size_t len) {
+        // Built under SkOnce: we compile with -fno-threadsafe-statics, and streams may be
+        // written on several threads at once.
+        static SkOnce once;
+        static uint32_t t[8][256];
+        once([] {
+            for (uint32_t i = 0; i < 256; i++) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+                }
+                t[0][i] = c;
+            }
+            for (uint32_t i = 0; i < 256; i++) {
+                for (int j = 1; j < 8; j++) {
+                    t[j][i] = (t[j-1][i] >> 8) ^ t[0][t[j-1][i] & 0xff];
+                }
+            }
+        });
+
+        crc = ~crc;
+        for (; len >= 8; len -= 8, data += 8) {
+            uint32_t lo = crc ^ ((uint32_t)data[0]       | (uint32_t)data[1] <<  8 |
+                                 (uint32_t)data[2] << 16 | (uint32_t)data[3] << 24),
+                     hi =        (uint32_t)data[4]       | (uint32_t)data[5] <<  8 |
+                                 (uint32_t)data[6] << 16 | (uint32_t)data[7] << 24;
+            crc = t[7][ lo        & 0xff] ^ t[6][(lo >>  8) & 0xff] ^
+                  t[5][(lo >> 16) & 0xff] ^ t[4][ lo >> 24        ] ^
+                  t[3][ hi        & 0xff] ^ t[2][(hi >>  8) & 0xff] ^
+                  t[1][(hi >> 16) & 0xff] ^ t[0][ hi >> 24        ];
+        }
+        for (; len > 0; len--) {
+            crc = t[0][(crc ^ *data++) & 0xff] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+#endif
+
+}  // namespace SK_OPTS_NS
+
+#endif//SkDeflate_opts_DEFINED
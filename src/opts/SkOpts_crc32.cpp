@@ -9,9 +9,11 @@
 
 #define SK_OPTS_NS crc32
 #include "SkChecksum_opts.h"
+#include "SkDeflate_opts.h"
 
 namespace SkOpts {
     void Init_crc32() {
-        hash_fn = crc32::hash_fn;
+        hash_fn    = crc32::hash_fn;
+        gzip_crc32 = crc32::gzip_crc32;
     }
 }
@@ -9,6 +9,7 @@
 #define SK_OPTS_NS ssse3
 #include "SkBlitMask_opts.h"
 #include "SkColorCubeFilter_opts.h"
+#include "SkDeflate_opts.h"
 #include "SkSwizzler_opts.h"
 #include "SkXfermode_opts.h"
 
@@ -17,6 +18,7 @@ namespace SkOpts {
         create_xfermode = ssse3::create_xfermode;
         blit_mask_d32_a8 = ssse3::blit_mask_d32_a8;
         color_cube_filter_span = ssse3::color_cube_filter_span;
+        adler32 = ssse3::adler32;
 
         RGBA_to_BGRA          = ssse3::RGBA_to_BGRA;
         RGBA_to_rgbA          = ssse3::RGBA_to_rgbA;
@@ -12,6 +12,7 @@
 #include "SkColorLookUpTable.h"
 #include "SkColorSpaceXform_A2B.h"
 #include "SkColorSpaceXformPriv.h"
+#include "SkGradientShaderContext.h"
 #include "SkHalf.h"
 #include "SkImageShaderContext.h"
 #include "SkMSAN.h"
@@ -647,6 +648,15 @@ STAGE(luminance_to_alpha) {
     r = g = b = 0;
 }
 
+// These take the same 2x3 matrix as matrix_2x3, and skip the multiplies by its zero entries.
+STAGE_CTX(matrix_translate, const float*) {
+    r = r + ctx[4];
+    g = g + ctx[5];
+}
+STAGE_CTX(matrix_scale_translate, const float*) {
+    r = SkNf_fma(r,ctx[0], ctx[4]);
+    g = SkNf_fma(g,ctx[3], ctx[5]);
+}
 STAGE_CTX(matrix_2x3, const float*) {
     auto m = ctx;
 
@@ -796,6 +806,110 @@ STAGE_CTX( clamp_y, const float*) { g = clamp (g, *ctx); }
 STAGE_CTX(repeat_y, const float*) { g = repeat(g, *ctx); }
 STAGE_CTX(mirror_y, const float*) { g = mirror(g, *ctx); }
 
+// Gradients tile t into [0,1], the range of their stops.
+STAGE( clamp_x_1) { r = SkNf::Max(0.0f, SkNf::Min(r, 1.0f)); }
+STAGE(repeat_x_1) { r = r - r.floor(); }
+STAGE(mirror_x_1) { r = ((r - 1.0f) - ((r - 1.0f) * 0.5f).floor() * 2.0f - 1.0f).abs(); }
+
+STAGE(xy_to_radius) {
+    r = SkNf_fma(r,r, g*g).sqrt();
+}
+
+// Like the legacy sweep gradient, measures the angle clockwise from +x, in turns: [0,1).
+STAGE(xy_to_angle) {
+    SkNf ax = r.abs(),
+         ay = g.abs();
+    // q is in [0,1], and 0 at the origin.
+    SkNf q = SkNf::Min(ax, ay) / SkNf::Max(SkNf::Max(ax, ay), FLT_MIN);
+
+    // atan(q), good to 1e-5 radians (Abramowitz & Stegun 4.4.49).
+    SkNf s = q*q;
+    SkNf phi = q * SkNf_fma(s, SkNf_fma(s, SkNf_fma(s, SkNf_fma(s, 0.0208351f, -0.0851330f),
+                                                    0.1801410f),
+                                        -0.3302995f),
+                            0.9998660f);
+
+    phi = (ay > ax).thenElse(SK_ScalarPI/2 - phi, phi);
+    phi = (r < 0.0f).thenElse(SK_ScalarPI - phi, phi);
+    phi = (g < 0.0f).thenElse(2*SK_ScalarPI - phi, phi);
+    r = phi * (1 / (2*SK_ScalarPI));
+}
+
+// Solves for the t whose circle passes through (r,g), preferring the larger t (the smaller when
+// flipped) as long as its radius is not negative. Pixels with no such t are noted in ctx->mask.
+STAGE_CTX(xy_to_2pt_conical, SkGradientShaderContext*) {
+    SkNf px = r - ctx->centerX,
+         py = g - ctx->centerY;
+    // The quadratic a*t^2 + 2*hb*t + c = 0 (hb being half of TwoPtRadial's B).
+    SkNf hb = SkNf_fma(px, -ctx->dCenterX, SkNf_fma(py, -ctx->dCenterY, -ctx->rdr)),
+         c  = SkNf_fma(px,px, SkNf_fma(py,py, -ctx->radius2));
+
+    SkNf t, bad;
+    if (ctx->a == 0) {
+        t = c / (hb * -2.0f);
+        bad = (hb == 0.0f).thenElse(-1.0f, SkNf_fma(t, ctx->dRadius, ctx->radius)) < 0.0f;
+    } else {
+        SkNf disc = SkNf_fma(hb,hb, c * -ctx->a),
+             root = SkNf::Max(disc, 0.0f).sqrt(),
+             t0   = (hb + root) * (-1 / ctx->a),
+             t1   = (root - hb) * ( 1 / ctx->a),
+             lo   = SkNf::Min(t0, t1),
+             hi   = SkNf::Max(t0, t1);
+        SkNf first  = ctx->flipped ? lo : hi,
+             second = ctx->flipped ? hi : lo;
+        t = (SkNf_fma(first, ctx->dRadius, ctx->radius) >= 0.0f).thenElse(first, second);
+        bad = SkNf::Min(disc, SkNf_fma(t, ctx->dRadius, ctx->radius)) < 0.0f;
+    }
+    bad.store(ctx->mask);
+    r = bad.thenElse(0.0f, t);
+}
+
+STAGE_CTX(mask_2pt_conical_degenerates, const SkGradientShaderContext*) {
+    auto bad = SkNf::Load(ctx->mask);
+    r = bad.thenElse(0.0f, r);
+    g = bad.thenElse(0.0f, g);
+    b = bad.thenElse(0.0f, b);
+    a = bad.thenElse(0.0f, a);
+}
+
+SI void gradient_interval(size_t tail, const SkGradientShaderContext* ctx, const SkNi& idx,
+                          const SkNf& t, SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+    *r = SkNf_fma(t, gather(tail, ctx->fs[0], idx), gather(tail, ctx->bs[0], idx));
+    *g = SkNf_fma(t, gather(tail, ctx->fs[1], idx), gather(tail, ctx->bs[1], idx));
+    *b = SkNf_fma(t, gather(tail, ctx->fs[2], idx), gather(tail, ctx->bs[2], idx));
+    *a = SkNf_fma(t, gather(tail, ctx->fs[3], idx), gather(tail, ctx->bs[3], idx));
+}
+
+STAGE_CTX(gradient_2stops, const SkGradientShaderContext*) {
+    auto t = r;
+    r = SkNf_fma(t, ctx->fs[0][0], ctx->bs[0][0]);
+    g = SkNf_fma(t, ctx->fs[1][0], ctx->bs[1][0]);
+    b = SkNf_fma(t, ctx->fs[2][0], ctx->bs[2][0]);
+    a = SkNf_fma(t, ctx->fs[3][0], ctx->bs[3][0]);
+}
+
+// Counts the interval boundaries at or before t.
+STAGE_CTX(gradient, const SkGradientShaderContext*) {
+    auto t = r;
+    SkNf idx = 0.0f;
+    for (int i = 1; i < ctx->intervalCount; i++) {
+        idx = idx + (t >= ctx->ts[i]).thenElse(1.0f, 0.0f);
+    }
+    gradient_interval(tail, ctx, SkNx_cast<int>(idx), t, &r,&g,&b,&a);
+}
+
+// Looks up the interval just before t's bucket, then steps over at most one boundary.
+STAGE_CTX(gradient_lut, const SkGradientShaderContext*) {
+    auto t = r;
+    SkNf k = t * (float)ctx->lutSize;
+    k = (k < (float)(ctx->lutSize - 1)).thenElse(k, (float)(ctx->lutSize - 1));  // Also NaN.
+    k = (k > 0.0f).thenElse(k, 0.0f);
+
+    SkNi idx = gather(tail, ctx->lut, SkNx_cast<int>(k));
+    idx = idx + SkNx_cast<int>((t >= gather(tail, ctx->ts, idx + 1)).thenElse(1.0f, 0.0f));
+    gradient_interval(tail, ctx, idx, t, &r,&g,&b,&a);
+}
+
 STAGE_CTX(save_xy, SkImageShaderContext*) {
     r.store(ctx->x);
     g.store(ctx->y);
@@ -946,6 +1060,79 @@ STAGE_CTX(gather_f16, const SkImageShaderContext*) {
     from_f16(&px, &r, &g, &b, &a);
 }
 
+// bilinear_8888 and bicubic_8888 do the work of save_xy, the bilinear_ or bicubic_ stages,
+// tiling, gather_8888, from_srgb and accumulate for every tap, in one stage, with the same math
+// in the same order, so they give the same results as the stages they replace.
+SI SkNf tile(const SkNf& v, SkShader::TileMode mode, float limit) {
+    switch (mode) {
+        case SkShader::kClamp_TileMode:  return clamp (v, limit);
+        case SkShader::kRepeat_TileMode: return repeat(v, limit);
+        case SkShader::kMirror_TileMode: return mirror(v, limit);
+    }
+    return v;
+}
+
+SI void accumulate_8888(const SkImageShaderContext* ctx, size_t tail,
+                        const SkNf& x, const SkNf& y, const SkNf& scale,
+                        SkNf* r, SkNf* g, SkNf* b, SkNf* a) {
+    const uint32_t* p;
+    SkNi offset = offset_and_ptr(&p, ctx, tile(x, ctx->tileX, ctx->width),
+                                          tile(y, ctx->tileY, ctx->height));
+    SkNf sr, sg, sb, sa;
+    from_8888(gather(tail, p, offset), &sr, &sg, &sb, &sa);
+    if (ctx->fromSRGB) {
+        sr = sk_linear_from_srgb_math(sr);
+        sg = sk_linear_from_srgb_math(sg);
+        sb = sk_linear_from_srgb_math(sb);
+        if (ctx->clampA) {
+            sa = SkNf::Min(sa, 1.0f);
+            sr = SkNf::Min(sr, sa);
+            sg = SkNf::Min(sg, sa);
+            sb = SkNf::Min(sb, sa);
+        }
+    }
+    *r = SkNf_fma(scale, sr, *r);
+    *g = SkNf_fma(scale, sg, *g);
+    *b = SkNf_fma(scale, sb, *b);
+    *a = SkNf_fma(scale, sa, *a);
+}
+
+STAGE_CTX(bilinear_8888, const SkImageShaderContext*) {
+    auto fract = [](const SkNf& v) { return v - v.floor(); };
+    SkNf fx = fract(r + 0.5f),
+         fy = fract(g + 0.5f);
+    const SkNf xs[] = { r - 0.5f, r + 0.5f },
+               ys[] = { g - 0.5f, g + 0.5f },
+               wx[] = { 1.0f - fx, fx },
+               wy[] = { 1.0f - fy, fy };
+
+    r = g = b = a = 0.0f;
+    for (int j = 0; j < 2; j++) {
+        for (int i = 0; i < 2; i++) {
+            accumulate_8888(ctx, tail, xs[i], ys[j], wx[i]*wy[j], &r, &g, &b, &a);
+        }
+    }
+}
+
+STAGE_CTX(bicubic_8888, const SkImageShaderContext*) {
+    auto fract = [](const SkNf& v) { return v - v.floor(); };
+    SkNf fx = fract(r + 0.5f),
+         fy = fract(g + 0.5f);
+    const SkNf xs[] = { r - 1.5f, r - 0.5f, r + 0.5f, r + 1.5f },
+               ys[] = { g - 1.5f, g - 0.5f, g + 0.5f, g + 1.5f },
+               wx[] = { bicubic_far(1.0f - fx), bicubic_near(1.0f - fx),
+                        bicubic_near(fx),       bicubic_far(fx) },
+               wy[] = { bicubic_far(1.0f - fy), bicubic_near(1.0f - fy),
+                        bicubic_near(fy),       bicubic_far(fy) };
+
+    r = g = b = a = 0.0f;
+    for (int j = 0; j < 4; j++) {
+        for (int i = 0; i < 4; i++) {
+            accumulate_8888(ctx, tail, xs[i], ys[j], wx[i]*wy[j], &r, &g, &b, &a);
+        }
+    }
+}
+
 
 SI Fn enum_to_Fn(SkRasterPipeline::StockStage st) {
     switch (st) {
@@ -48,6 +48,9 @@ public:
     }
 
     void setID(uint32_t id) { fID = id; }
+    uint32_t id() const { return fID; }
+
+    const SkImage* image() const { return fImage.get(); }
 
     bool isValid() const { return fImage != nullptr; }
 
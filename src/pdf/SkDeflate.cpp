@@ -9,9 +9,14 @@
 #include "SkData.h"
 #include "SkDeflate.h"
 #include "SkMakeUnique.h"
+#include "SkMutex.h"
+#include "SkOpts.h"
+#include "SkTArray.h"
 
 #include "zlib.h"
 
+#include <math.h>
+
 namespace {
 
 // Different zlib implementations use different T.
@@ -29,6 +34,73 @@ void skia_free_func(void*, void* address) { sk_free(address); }
                                                   // enough to always do a
                                                   // single loop.
 
+// Compressor states are expensive to set up (zlib allocates ~270KB for one), and a document
+// deflates many small streams in a row, so finished states are reset and reused.
+// PDF's FlateDecode cannot carry a preset dictionary, so this is the reuse we can offer.
+static const int kMaxPooledStreams = 4;
+
+SK_DECLARE_STATIC_MUTEX(gZStreamPoolMutex);
+static SkTArray<std::pair<int, z_stream*>>* gZStreamPool;  // (level, state)
+
+static z_stream* acquire_zstream(int level) {
+    {
+        SkAutoMutexAcquire lock(gZStreamPoolMutex);
+        if (gZStreamPool) {
+            for (int i = 0; i < gZStreamPool->count(); ++i) {
+                if ((*gZStreamPool)[i].first == level) {
+                    z_stream* zStream = (*gZStreamPool)[i].second;
+                    gZStreamPool->removeShuffle(i);
+                    return zStream;
+                }
+            }
+        }
+    }
+    z_stream* zStream = new z_stream;
+    zStream->next_in = nullptr;
+    zStream->zalloc = &skia_alloc_func;
+    zStream->zfree = &skia_free_func;
+    zStream->opaque = nullptr;
+    // Negative window bits: a raw deflate stream. We write the zlib or gzip framing ourselves,
+    // so that the checksum can be computed by SkOpts instead of zlib.
+    SkDEBUGCODE(int r =) deflateInit2(zStream, level, Z_DEFLATED, -MAX_WBITS,
+                                      8, Z_DEFAULT_STRATEGY);
+    SkASSERT(Z_OK == r);
+    return zStream;
+}
+
+static void release_zstream(int level, z_stream* zStream) {
+    if (Z_OK == deflateReset(zStream)) {
+        SkAutoMutexAcquire lock(gZStreamPoolMutex);
+        if (!gZStreamPool) {
+            gZStreamPool = new SkTArray<std::pair<int, z_stream*>>;
+        }
+        if (gZStreamPool->count() < kMaxPooledStreams) {
+            gZStreamPool->push_back(std::make_pair(level, zStream));
+            return;
+        }
+    }
+    (void)deflateEnd(zStream);
+    delete zStream;
+}
+
+// Estimates the order-0 entropy of the buffer, in bits per byte. Already-compressed or random
+// data comes out at ~8, and deflate would only spend time making it slightly bigger.
+static bool looks_incompressible(const uint8_t* data, size_t len) {
+    uint32_t counts[256] = { 0 };
+    for (size_t i = 0; i < len; ++i) {
+        counts[data[i]]++;
+    }
+    double bits = 0;
+    for (uint32_t count : counts) {
+        if (count) {
+            double p = (double)count / len;
+            bits -= count * log2(p);
+        }
+    }
+    // Sampling 4KB of uniformly random bytes measures ~7.95 bits/byte.
+    return bits > 7.9 * len;
+}
+
 // called by both write() and finalize()
 static void do_deflate(int flush,
                        z_stream* zStream,
@@ -57,7 +129,44 @@ struct SkDeflateWStream::Impl {
     SkWStream* fOut;
     unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
     size_t fInBufferIndex;
-    z_stream fZStream;
+    z_stream* fZStream;
+    int fLevel;         // the level asked for
+    bool fStoring;      // currently at level 0 because the input looks incompressible
+    bool fSwitched;     // the level was ever changed, so the state cannot be pooled as is
+    bool fGzip;
+    uint32_t fChecksum;
+    size_t fTotalIn;    // total_in, saved once the state has been released
+
+    // Checksums and compresses the buffered input. Each full buffer is checked first, and the
+    // compressor switches to storing (level 0) while the input looks incompressible.
+    void deflateBuffer(int flush) {
+        fChecksum = fGzip ? SkOpts::gzip_crc32(fChecksum, fInBuffer, fInBufferIndex)
+                          : SkOpts::adler32(fChecksum, fInBuffer, fInBufferIndex);
+
+        bool store = fStoring;
+        if (sizeof(fInBuffer) == fInBufferIndex && 0 != fLevel) {
+            store = looks_incompressible(fInBuffer, fInBufferIndex);
+        }
+        if (store != fStoring) {
+            if (fZStream->total_in > 0) {
+                // End the current block, so that the new level applies from here on.
+                do_deflate(Z_BLOCK, fZStream, fOut, nullptr, 0);
+            }
+            unsigned char outBuffer[SKDEFLATEWSTREAM_OUTPUT_BUFFER_SIZE];
+            fZStream->next_out = outBuffer;
+            fZStream->avail_out = sizeof(outBuffer);
+            SkDEBUGCODE(int r =) deflateParams(fZStream, store ? 0 : fLevel, Z_DEFAULT_STRATEGY);
+            // deflateParams() tries to flush a block itself, and finding nothing left to flush
+            // leaves a "buffer error" behind. That is not an error.
+            SkASSERT(Z_OK == r || Z_BUF_ERROR == r);
+            fZStream->msg = nullptr;
+            fOut->write(outBuffer, sizeof(outBuffer) - fZStream->avail_out);
+            fStoring = store;
+            fSwitched = true;
+        }
+        do_deflate(flush, fZStream, fOut, fInBuffer, fInBufferIndex);
+        fInBufferIndex = 0;
+    }
 };
 
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
@@ -66,18 +175,36 @@ SkDeflateWStream::SkDeflateWStream(SkWStream* out,
     : fImpl(skstd::make_unique<SkDeflateWStream::Impl>()) {
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
+    fImpl->fZStream = nullptr;
+    fImpl->fTotalIn = 0;
     if (!fImpl->fOut) {
         return;
     }
-    fImpl->fZStream.next_in = nullptr;
-    fImpl->fZStream.zalloc = &skia_alloc_func;
-    fImpl->fZStream.zfree = &skia_free_func;
-    fImpl->fZStream.opaque = nullptr;
     SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
-    SkDEBUGCODE(int r =) deflateInit2(&fImpl->fZStream, compressionLevel,
-                                      Z_DEFLATED, gzip ? 0x1F : 0x0F,
-                                      8, Z_DEFAULT_STRATEGY);
-    SkASSERT(Z_OK == r);
+    fImpl->fLevel = compressionLevel;
+    fImpl->fStoring = false;
+    fImpl->fSwitched = false;
+    fImpl->fGzip = gzip;
+    fImpl->fZStream = acquire_zstream(compressionLevel);
+
+    // In zlib mode the output is byte-for-byte what zlib's own framing produced. In gzip mode
+    // it is not: zlib's gzip header carries its OS code and a level hint, which this one leaves
+    // out.
+    if (gzip) {
+        // RFC 1952: deflate, no flags, no mtime, no extra flags, unknown OS.
+        static const uint8_t kGzipHeader[] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+        fImpl->fOut->write(kGzipHeader, sizeof(kGzipHeader));
+        fImpl->fChecksum = 0;
+    } else {
+        // RFC 1950: deflate with a 32K window, then the same level hint zlib would write.
+        int level = (-1 == compressionLevel) ? 6 : compressionLevel;
+        int levelFlags = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+        unsigned header = (0x78 << 8) | (levelFlags << 6);
+        header += 31 - (header % 31);
+        uint8_t zlibHeader[] = { (uint8_t)(header >> 8), (uint8_t)header };
+        fImpl->fOut->write(zlibHeader, sizeof(zlibHeader));
+        fImpl->fChecksum = 1;
+    }
 }
 
 SkDeflateWStream::~SkDeflateWStream() { this->finalize(); }
@@ -86,9 +213,31 @@ void SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
         return;
     }
-    do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
-               fImpl->fInBufferIndex);
-    (void)deflateEnd(&fImpl->fZStream);
+    fImpl->deflateBuffer(Z_FINISH);
+    uint32_t checksum = fImpl->fChecksum;
+    if (fImpl->fGzip) {
+        uint32_t size = (uint32_t)fImpl->fZStream->total_in;
+        uint8_t trailer[] = {
+            (uint8_t)checksum, (uint8_t)(checksum >> 8), (uint8_t)(checksum >> 16),
+            (uint8_t)(checksum >> 24),
+            (uint8_t)size, (uint8_t)(size >> 8), (uint8_t)(size >> 16), (uint8_t)(size >> 24),
+        };
+        fImpl->fOut->write(trailer, sizeof(trailer));
+    } else {
+        uint8_t trailer[] = {
+            (uint8_t)(checksum >> 24), (uint8_t)(checksum >> 16), (uint8_t)(checksum >> 8),
+            (uint8_t)checksum,
+        };
+        fImpl->fOut->write(trailer, sizeof(trailer));
+    }
+    fImpl->fTotalIn = fImpl->fZStream->total_in;
+    if (fImpl->fSwitched) {
+        (void)deflateEnd(fImpl->fZStream);
+        delete fImpl->fZStream;
+    } else {
+        release_zstream(fImpl->fLevel, fImpl->fZStream);
+    }
+    fImpl->fZStream = nullptr;
     fImpl->fOut = nullptr;
 }
 
@@ -108,14 +257,15 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 
         // if the buffer isn't filled, don't call into zlib yet.
         if (sizeof(fImpl->fInBuffer) == fImpl->fInBufferIndex) {
-            do_deflate(Z_NO_FLUSH, &fImpl->fZStream, fImpl->fOut,
-                       fImpl->fInBuffer, fImpl->fInBufferIndex);
-            fImpl->fInBufferIndex = 0;
+            fImpl->deflateBuffer(Z_NO_FLUSH);
         }
     }
     return true;
 }
 
 size_t SkDeflateWStream::bytesWritten() const {
-    return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
+    if (!fImpl->fZStream) {
+        return fImpl->fTotalIn;
+    }
+    return fImpl->fZStream->total_in + fImpl->fInBufferIndex;
 }
@@ -6,6 +6,7 @@
  */
 
 #include "SkImage.h"
+#include "SkImageContent.h"
 #include "SkPDFBitmap.h"
 #include "SkPDFCanon.h"
 #include "SkPDFFont.h"
@@ -91,6 +92,23 @@ void SkPDFCanon::addGraphicState(const SkPDFGraphicState* state) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+uint32_t SkPDFCanon::canonicalImageID(uint32_t id, const SkImage* image) {
+    if (uint32_t* canonical = fCanonicalImageIDs.find(id)) {
+        return *canonical;
+    }
+    uint32_t canonical = id;
+    SkMD5::Digest digest;
+    if (SkImageContent::Fingerprint(image, &digest)) {
+        if (uint32_t* first = fImageIDsByContent.find(digest)) {
+            canonical = *first;
+        } else {
+            fImageIDsByContent.set(digest, id);
+        }
+    }
+    fCanonicalImageIDs.set(id, canonical);
+    return canonical;
+}
+
 sk_sp<SkPDFObject> SkPDFCanon::findPDFBitmap(SkBitmapKey key) const {
     SkPDFObject** ptr = fPDFBitmapMap.find(key);
     return ptr ? sk_ref_sp(*ptr) : sk_sp<SkPDFObject>();
@@ -7,6 +7,7 @@
 #ifndef SkPDFCanon_DEFINED
 #define SkPDFCanon_DEFINED
 
+#include "SkMD5.h"
 #include "SkPDFGraphicState.h"
 #include "SkPDFShader.h"
 #include "SkPixelSerializer.h"
@@ -53,6 +54,13 @@ public:
     const SkPDFGraphicState* findGraphicState(const SkPDFGraphicState&) const;
     void addGraphicState(const SkPDFGraphicState*);
 
+    /**
+     *  Returns the ID of the first image seen with the same contents as this one (see
+     *  SkImageContent), so that keying bitmaps by it stores each distinct image once.
+     *  The ID is the one its bitmap key would otherwise use.
+     */
+    uint32_t canonicalImageID(uint32_t id, const SkImage*);
+
     sk_sp<SkPDFObject> findPDFBitmap(SkBitmapKey key) const;
     void addPDFBitmap(SkBitmapKey key, sk_sp<SkPDFObject>);
 
@@ -99,6 +107,9 @@ private:
 
     // TODO(halcanary): make SkTHashMap<K, sk_sp<V>> work correctly.
     SkTHashMap<SkBitmapKey, SkPDFObject*> fPDFBitmapMap;
+    // Images are not kept once written, so their contents are remembered by fingerprint.
+    SkTHashMap<uint32_t, uint32_t> fCanonicalImageIDs;
+    SkTHashMap<SkMD5::Digest, uint32_t> fImageIDsByContent;
 
     sk_sp<SkPixelSerializer> fPixelSerializer;
     sk_sp<SkPDFStream> fInvertFunction;
@@ -2253,6 +2253,8 @@ void SkPDFDevice::internalDrawImage(const SkMatrix& origMatrix,
         // (maybe in the resource cache?)
     }
 
+    SkPDFCanon* canon = fDocument->canon();
+    imageSubset.setID(canon->canonicalImageID(imageSubset.id(), imageSubset.image()));
     SkBitmapKey key = imageSubset.getKey();
     sk_sp<SkPDFObject> pdfimage = fDocument->canon()->findPDFBitmap(key);
     if (!pdfimage) {
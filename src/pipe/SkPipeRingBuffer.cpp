@@ -0,0 +1,274 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkAtomics.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkPicture.h"
+#include "SkPipe.h"
+#include "SkPipeRingBuffer.h"
+#include "SkString.h"
+
+#include <thread>
+
+#if defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID) || \
+    defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_IOS)
+    #define SK_PIPE_HAS_SHARED_MEMORY
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+static const uint32_t kRingMagic = SkSetFourByteTag('s', 'k', 'r', 'b');
+
+// Written in place of a length word when the next message did not fit before the end of the ring,
+// and was started over at offset 0 instead.
+static const uint32_t kWrapMarker = 0xFFFFFFFF;
+
+size_t SkPipeRingBuffer::StorageSize(size_t capacity) {
+    return sizeof(SkPipeRingBuffer) + SkAlign4(capacity);
+}
+
+SkPipeRingBuffer* SkPipeRingBuffer::Create(void* storage, size_t storageSize) {
+    if (!storage || !SkIsAlign4((intptr_t)storage) || storageSize > 0xFFFFFFFF ||
+        storageSize < sizeof(SkPipeRingBuffer) + 64) {
+        return nullptr;
+    }
+    SkPipeRingBuffer* ring = static_cast<SkPipeRingBuffer*>(storage);
+    ring->fCapacity = SkToU32((storageSize - sizeof(SkPipeRingBuffer)) & ~3);
+    ring->fHead = 0;
+    ring->fTail = 0;
+    ring->fClosed = 0;
+    sk_atomic_store(&ring->fMagic, kRingMagic, sk_memory_order_release);
+    return ring;
+}
+
+SkPipeRingBuffer* SkPipeRingBuffer::Attach(void* storage, size_t storageSize) {
+    if (!storage || !SkIsAlign4((intptr_t)storage) || storageSize < sizeof(SkPipeRingBuffer)) {
+        return nullptr;
+    }
+    SkPipeRingBuffer* ring = static_cast<SkPipeRingBuffer*>(storage);
+    if (sk_atomic_load(&ring->fMagic, sk_memory_order_acquire) != kRingMagic ||
+        StorageSize(ring->fCapacity) > storageSize) {
+        return nullptr;
+    }
+    return ring;
+}
+
+void SkPipeRingBuffer::close() {
+    sk_atomic_store(&fClosed, 1u, sk_memory_order_release);
+}
+
+bool SkPipeRingBuffer::isClosed() const {
+    return sk_atomic_load(&fClosed, sk_memory_order_acquire) != 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+SkPipeRingWriter::SkPipeRingWriter(SkPipeRingBuffer* ring)
+    : fRing(ring)
+    , fMsgStart(sk_atomic_load(&ring->fHead, sk_memory_order_relaxed))
+    , fCursor(fMsgStart)
+    , fBytesWritten(0)
+    , fFailed(false)
+{}
+
+SkPipeRingWriter::~SkPipeRingWriter() {
+    (void)this->commit();
+}
+
+// Makes room for 'size' more bytes at fCursor, keeping the pending message contiguous. If the
+// message no longer fits before the end of the ring, it is moved to the front (leaving a wrap
+// marker behind), which is the only time the writer ever copies data.
+bool SkPipeRingWriter::reserve(size_t size) {
+    const uint32_t capacity = fRing->fCapacity;
+    const size_t needed = (fCursor - fMsgStart) + size;
+
+    // The back of the ring can grow up to the end (less a gap if the reader is parked at 0), and
+    // the front up to where this message starts. If neither can ever hold it, give up.
+    const size_t maxBack = capacity - fMsgStart - (0 == fMsgStart ? 4 : 0);
+    const size_t maxFront = fMsgStart >= 4 ? fMsgStart - 4 : 0;
+    if (needed > maxBack && needed > maxFront) {
+        return false;
+    }
+
+    for (;;) {
+        uint32_t tail = sk_atomic_load(&fRing->fTail, sk_memory_order_acquire);
+        if (tail > fMsgStart) {
+            // The reader is still finishing the previous lap; stay 4 bytes behind it so that
+            // a full ring never looks empty.
+            if (fMsgStart + needed <= tail - 4) {
+                return true;
+            }
+        } else {
+            uint32_t end = (0 == tail) ? capacity - 4 : capacity;
+            if (fMsgStart + needed <= end) {
+                return true;
+            }
+            if (tail >= 4 && needed <= tail - 4u) {
+                uint8_t* data = fRing->data();
+                uint32_t used = fCursor - fMsgStart;
+                memcpy(data, data + fMsgStart, used);
+                memcpy(data + fMsgStart, &kWrapMarker, sizeof(kWrapMarker));
+                fMsgStart = 0;
+                fCursor = used;
+                return true;
+            }
+        }
+        if (fRing->isClosed()) {
+            return false;
+        }
+        std::this_thread::yield();
+    }
+}
+
+bool SkPipeRingWriter::write(const void* buffer, size_t size) {
+    if (fFailed) {
+        return false;
+    }
+    if (fCursor == fMsgStart) {
+        // Leave room for the length word, filled in by commit().
+        if (!this->reserve(sizeof(uint32_t) + SkAlign4(size))) {
+            fFailed = true;
+            return false;
+        }
+        fCursor += sizeof(uint32_t);
+    } else if (!this->reserve(SkAlign4(fCursor + size) - fCursor)) {
+        fFailed = true;
+        return false;
+    }
+    memcpy(fRing->data() + fCursor, buffer, size);
+    fCursor += SkToU32(size);
+    fBytesWritten += size;
+    return true;
+}
+
+bool SkPipeRingWriter::commit() {
+    if (fFailed) {
+        fCursor = fMsgStart;
+        fFailed = false;
+        return false;
+    }
+    if (fCursor == fMsgStart) {
+        return true;
+    }
+
+    uint8_t* data = fRing->data();
+    uint32_t length = fCursor - fMsgStart - sizeof(uint32_t);
+    memcpy(data + fMsgStart, &length, sizeof(length));
+    // write() reserved the padding, so rounding up stays inside the ring.
+    uint32_t head = SkAlign4(fCursor);
+    if (head == fRing->fCapacity) {
+        head = 0;
+    }
+    sk_atomic_store(&fRing->fHead, head, sk_memory_order_release);
+    fMsgStart = fCursor = head;
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+const void* SkPipeRingReader::peek(size_t* size, bool wait) {
+    const uint8_t* data = fRing->data();
+    for (;;) {
+        uint32_t tail = sk_atomic_load(&fRing->fTail, sk_memory_order_relaxed);
+        uint32_t head = sk_atomic_load(&fRing->fHead, sk_memory_order_acquire);
+        if (head != tail) {
+            uint32_t length;
+            memcpy(&length, data + tail, sizeof(length));
+            if (kWrapMarker == length) {
+                sk_atomic_store(&fRing->fTail, 0u, sk_memory_order_release);
+                continue;
+            }
+            uint32_t next = tail + sizeof(uint32_t) + SkAlign4(length);
+            fNextTail = (next == fRing->fCapacity) ? 0 : next;
+            *size = length;
+            return data + tail + sizeof(uint32_t);
+        }
+        if (!wait || fRing->isClosed()) {
+            return nullptr;
+        }
+        std::this_thread::yield();
+    }
+}
+
+void SkPipeRingReader::consume() {
+    sk_atomic_store(&fRing->fTail, fNextTail, sk_memory_order_release);
+}
+
+bool SkPipeRingReader::playbackNext(SkPipeDeserializer* deserializer, SkCanvas* canvas) {
+    size_t size;
+    const void* message = this->peek(&size, true);
+    if (!message) {
+        return false;
+    }
+    bool success = deserializer->playback(message, size, canvas);
+    this->consume();
+    return success;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+#ifdef SK_PIPE_HAS_SHARED_MEMORY
+
+static int create_shared_fd() {
+    int fd;
+#if defined(SYS_memfd_create)
+    fd = (int)syscall(SYS_memfd_create, "skia-pipe", 1u /*MFD_CLOEXEC*/);
+    if (fd >= 0) {
+        return fd;
+    }
+#endif
+    // No memfd; fall back to a POSIX shm object that is unlinked as soon as it is open.
+    static SkAtomic<uint32_t> gCounter{0};
+    SkString name;
+    name.printf("/skia-pipe-%d-%u", (int)getpid(), gCounter.fetch_add(1));
+    fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd >= 0) {
+        shm_unlink(name.c_str());
+    }
+    return fd;
+}
+
+std::unique_ptr<SkPipeSharedMemory> SkPipeSharedMemory::Make(size_t size) {
+    int fd = create_shared_fd();
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (ftruncate(fd, size) != 0) {
+        ::close(fd);
+        return nullptr;
+    }
+    std::unique_ptr<SkPipeSharedMemory> shm = Attach(fd, size);
+    if (!shm) {
+        ::close(fd);
+    }
+    return shm;
+}
+
+std::unique_ptr<SkPipeSharedMemory> SkPipeSharedMemory::Attach(int fd, size_t size) {
+    void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == addr) {
+        return nullptr;
+    }
+    return std::unique_ptr<SkPipeSharedMemory>(new SkPipeSharedMemory(fd, addr, size));
+}
+
+SkPipeSharedMemory::~SkPipeSharedMemory() {
+    munmap(fMemory, fSize);
+    ::close(fFD);
+}
+
+#else
+
+std::unique_ptr<SkPipeSharedMemory> SkPipeSharedMemory::Make(size_t) { return nullptr; }
+std::unique_ptr<SkPipeSharedMemory> SkPipeSharedMemory::Attach(int, size_t) { return nullptr; }
+SkPipeSharedMemory::~SkPipeSharedMemory() {}
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkPipeRingBuffer_DEFINED
+#define SkPipeRingBuffer_DEFINED
+
+#include "SkStream.h"
+
+class SkCanvas;
+class SkPipeDeserializer;
+
+/**
+ *  A single-producer, single-consumer ring of pipe messages. The ring lives entirely inside a
+ *  block of caller-supplied memory (header included), so the writer and the reader may be in
+ *  different processes as long as both have the block mapped (see SkPipeSharedMemory).
+ *
+ *  The writer streams straight into the ring, and each message is kept contiguous, so the reader
+ *  can hand it to SkPipeDeserializer::playback() in place. Neither side copies the op stream.
+ */
+class SkPipeRingBuffer {
+public:
+    /** Returns the number of bytes of storage needed for a ring holding 'capacity' bytes. */
+    static size_t StorageSize(size_t capacity);
+
+    /**
+     *  Formats 'storage' as an empty ring and returns it. This must be done exactly once, by the
+     *  side that owns the memory, before any writer or reader attaches.
+     *  Returns nullptr if the storage is too small or misaligned.
+     */
+    static SkPipeRingBuffer* Create(void* storage, size_t storageSize);
+
+    /**
+     *  Returns the ring that was previously Create()d in 'storage' (possibly by another process),
+     *  or nullptr if the storage does not hold a valid ring.
+     */
+    static SkPipeRingBuffer* Attach(void* storage, size_t storageSize);
+
+    size_t capacity() const { return fCapacity; }
+
+    /**
+     *  The largest message that is guaranteed to fit. Messages are stored contiguously, so a
+     *  message may need to wait for the reader to free up the front of the ring.
+     */
+    size_t maxMessageSize() const { return fCapacity / 2 - 2 * sizeof(uint32_t); }
+
+    /** Marks the ring as closed. Any writer or reader blocked on the ring returns right away. */
+    void close();
+    bool isClosed() const;
+
+private:
+    SkPipeRingBuffer() = delete;
+
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this + 1); }
+    const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(this + 1); }
+
+    // Everything below lives in the (possibly shared) storage, so it must stay plain-old-data.
+    uint32_t    fMagic;
+    uint32_t    fCapacity;
+    uint32_t    fHead;      // written by the writer: offset just past the last committed message
+    uint32_t    fTail;      // written by the reader: offset of the next message to read
+    uint32_t    fClosed;
+    uint32_t    fPad[3];
+
+    friend class SkPipeRingWriter;
+    friend class SkPipeRingReader;
+};
+
+/**
+ *  Stream that writes pipe messages into a ring. Pass it to SkPipeSerializer::beginWrite(), and
+ *  call commit() (or flush()) to hand everything written so far to the reader as one message.
+ *  When the ring is full the writer waits for the reader to catch up.
+ */
+class SkPipeRingWriter : public SkWStream {
+public:
+    explicit SkPipeRingWriter(SkPipeRingBuffer*);
+    ~SkPipeRingWriter() override;
+
+    bool write(const void* buffer, size_t size) override;
+    size_t bytesWritten() const override { return fBytesWritten; }
+    void flush() override { (void)this->commit(); }
+
+    /**
+     *  Publishes the pending message. Returns false if any write since the last commit failed
+     *  (the message was larger than maxMessageSize() or the ring was closed). In that case the
+     *  message is dropped, and the serializer's caches should be reset before writing again.
+     */
+    bool commit();
+
+private:
+    bool reserve(size_t size);
+
+    SkPipeRingBuffer*   fRing;
+    uint32_t            fMsgStart;  // offset of the pending message's length word
+    uint32_t            fCursor;    // offset of the next byte to write
+    size_t              fBytesWritten;
+    bool                fFailed;
+};
+
+/**
+ *  Pulls messages out of a ring. Messages are returned in place; the memory stays valid until
+ *  consume() is called.
+ */
+class SkPipeRingReader {
+public:
+    explicit SkPipeRingReader(SkPipeRingBuffer* ring) : fRing(ring) {}
+
+    /**
+     *  Returns the next message, or nullptr if there is none. If 'wait' is true, blocks until a
+     *  message arrives or the ring is closed.
+     */
+    const void* peek(size_t* size, bool wait);
+
+    /** Releases the message returned by the last peek() back to the writer. */
+    void consume();
+
+    /**
+     *  Waits for the next message, plays it back into 'canvas' and releases it. Returns false once
+     *  the ring is closed and drained, or if playback fails.
+     */
+    bool playbackNext(SkPipeDeserializer*, SkCanvas*);
+
+private:
+    SkPipeRingBuffer*   fRing;
+    uint32_t            fNextTail = 0;
+};
+
+/**
+ *  Anonymous memory that can be mapped by more than one process (memfd or shm on POSIX). The
+ *  creating process passes fd() to its peer (e.g. over a socket or by fork()), which calls
+ *  Attach() with the same size.
+ */
+class SkPipeSharedMemory : SkNoncopyable {
+public:
+    static std::unique_ptr<SkPipeSharedMemory> Make(size_t size);
+    static std::unique_ptr<SkPipeSharedMemory> Attach(int fd, size_t size);
+
+    ~SkPipeSharedMemory();
+
+    void* memory() const { return fMemory; }
+    size_t size() const { return fSize; }
+    int fd() const { return fFD; }
+
+private:
+    SkPipeSharedMemory(int fd, void* memory, size_t size)
+        : fFD(fd), fMemory(memory), fSize(size) {}
+
+    int     fFD;
+    void*   fMemory;
+    size_t  fSize;
+};
+
+#endif
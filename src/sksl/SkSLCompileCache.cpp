@@ -0,0 +1,300 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLCompileCache.h"
+
+#include <stdio.h>
+#include "SkData.h"
+#include "SkOnce.h"
+#include "SkOSFile.h"
+#include "SkOSPath.h"
+#include "SkOpts.h"
+#include "SkSLCompiler.h"
+#include "SkStream.h"
+
+namespace SkSL {
+
+// Bump this whenever the code generators change their output, so that stale files are ignored.
+static const uint32_t kFileVersion = 1;
+static const uint32_t kFileMagic = SkSetFourByteTag('s', 'k', 's', 'l');
+static const char* kFileSuffix = ".sksl";
+
+static const char* or_empty(const char* s) {
+    return s ? s : "";
+}
+
+// Everything in the caps that the compiler looks at. dump() covers most of the flags, but not the
+// strings.
+static void append_caps(const GrShaderCaps& caps, SkString* key) {
+    key->append(caps.dump());
+    key->appendf("%d %d %d\n", caps.generation(), caps.fbFetchNeedsCustomOutput(),
+                 caps.mustDeclareFragmentShaderOutput());
+    key->appendf("%s\n%s\n", or_empty(caps.versionDeclString()),
+                 or_empty(caps.fragCoordConventionsExtensionString()));
+    if (caps.shaderDerivativeSupport()) {
+        key->appendf("%s\n", or_empty(caps.shaderDerivativeExtensionString()));
+    }
+    if (caps.imageLoadStoreSupport()) {
+        key->appendf("%s\n", or_empty(caps.imageLoadStoreExtensionString()));
+    }
+}
+
+static SkString make_key(CompileCache::Target target, Program::Kind kind, const SkString& text,
+                         const Program::Settings& settings) {
+    SkString key;
+    key.appendf("%d %d %d\n", (int) target, (int) kind, settings.fFlipY);
+    if (settings.fCaps) {
+        append_caps(*settings.fCaps, &key);
+    }
+    key.append("\n");
+    key.append(text);
+    return key;
+}
+
+CompileCache::CompileCache(size_t maxBytes, size_t maxDiskBytes)
+: fMaxBytes(maxBytes)
+, fMaxDiskBytes(maxDiskBytes)
+, fBytes(0)
+, fDiskBytes(0) {
+    memset(&fStats, 0, sizeof(fStats));
+}
+
+CompileCache::~CompileCache() {
+    this->purge();
+}
+
+CompileCache* CompileCache::Global() {
+    static SkOnce once;
+    static CompileCache* cache;
+    once([] { cache = new CompileCache(); });
+    return cache;
+}
+
+void CompileCache::setDirectory(const char* path) {
+    SkAutoMutexAcquire lock(fMutex);
+    fDirectory.reset();
+    fDiskFiles.clear();
+    fDiskBytes = 0;
+    if (!path || !path[0] || !sk_mkdir(path)) {
+        return;
+    }
+    fDirectory.set(path);
+
+    SkOSFile::Iter iter(path, kFileSuffix);
+    SkString name;
+    while (iter.next(&name)) {
+        SkString filePath = SkOSPath::Join(path, name.c_str());
+        FILE* file = sk_fopen(filePath.c_str(), kRead_SkFILE_Flag);
+        if (file) {
+            size_t size = sk_fgetsize(file);
+            sk_fclose(file);
+            fDiskFiles.push_back({ name, size });
+            fDiskBytes += size;
+        }
+    }
+}
+
+bool CompileCache::compile(Compiler* compiler, Target target, Program::Kind kind,
+                           const SkString& text, const Program::Settings& settings,
+                           SkString* output, Program::Inputs* inputs) {
+    SkString key = make_key(target, kind, text, settings);
+    if (this->find(key, output, inputs)) {
+        return true;
+    }
+    if (this->readFile(key, output, inputs)) {
+        this->insert(key, *output, *inputs);
+        return true;
+    }
+
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        fStats.fMisses++;
+    }
+    std::unique_ptr<Program> program = compiler->convertProgram(kind, text, settings);
+    if (!program) {
+        return false;
+    }
+    bool success = kGLSL_Target == target ? compiler->toGLSL(*program, output)
+                                          : compiler->toSPIRV(*program, output);
+    if (!success) {
+        return false;
+    }
+    *inputs = program->fInputs;
+    this->insert(key, *output, *inputs);
+    this->writeFile(key, *output, *inputs);
+    return true;
+}
+
+bool CompileCache::find(const SkString& key, SkString* output, Program::Inputs* inputs) {
+    SkAutoMutexAcquire lock(fMutex);
+    Entry** found = fMap.find(key);
+    if (!found) {
+        return false;
+    }
+    Entry* entry = *found;
+    if (entry != fLRU.head()) {
+        fLRU.remove(entry);
+        fLRU.addToHead(entry);
+    }
+    *output = entry->fOutput;
+    *inputs = entry->fInputs;
+    fStats.fHits++;
+    return true;
+}
+
+void CompileCache::insert(const SkString& key, const SkString& output, Program::Inputs inputs) {
+    SkAutoMutexAcquire lock(fMutex);
+    if (fMap.find(key)) {
+        // another thread compiled the same shader at the same time
+        return;
+    }
+    Entry* entry = new Entry;
+    entry->fKey = key;
+    entry->fOutput = output;
+    entry->fInputs = inputs;
+    fMap.set(entry);
+    fLRU.addToHead(entry);
+    fBytes += entry->bytes();
+    this->purgeAsNeeded();
+}
+
+void CompileCache::purgeAsNeeded() {
+    while (fBytes > fMaxBytes && fLRU.tail()) {
+        Entry* entry = fLRU.tail();
+        fBytes -= entry->bytes();
+        fMap.remove(entry->fKey);
+        fLRU.remove(entry);
+        delete entry;
+    }
+}
+
+void CompileCache::purge() {
+    SkAutoMutexAcquire lock(fMutex);
+    fMap.reset();
+    for (Entry* entry = fLRU.head(); entry; entry = fLRU.head()) {
+        fLRU.remove(entry);
+        delete entry;
+    }
+    fBytes = 0;
+}
+
+CompileCache::Stats CompileCache::stats() {
+    SkAutoMutexAcquire lock(fMutex);
+    Stats result = fStats;
+    result.fBytes = fBytes;
+    result.fDiskBytes = fDiskBytes;
+    return result;
+}
+
+// Files are named after two hashes of the key, and store the full key, which is compared on load;
+// a collision just looks like a miss.
+SkString CompileCache::FileName(const SkString& key) {
+    SkString name;
+    name.printf("%08x%08x%s", SkOpts::hash(key.c_str(), key.size(), 0),
+                SkOpts::hash(key.c_str(), key.size(), 0x9e3779b9), kFileSuffix);
+    return name;
+}
+
+bool CompileCache::readFile(const SkString& key, SkString* output, Program::Inputs* inputs) {
+    SkString name = FileName(key);
+    SkString path;
+    {
+        SkAutoMutexAcquire lock(fMutex);
+        if (fDirectory.isEmpty()) {
+            return false;
+        }
+        path = SkOSPath::Join(fDirectory.c_str(), name.c_str());
+    }
+    sk_sp<SkData> data = SkData::MakeFromFileName(path.c_str());
+    if (!data) {
+        return false;
+    }
+
+    const uint8_t* bytes = data->bytes();
+    size_t remaining = data->size();
+    auto read = [&bytes, &remaining](void* dst, size_t size) {
+        if (remaining < size) {
+            return false;
+        }
+        memcpy(dst, bytes, size);
+        bytes += size;
+        remaining -= size;
+        return true;
+    };
+    uint32_t magic, version, keyLength, outputLength;
+    uint8_t rtHeight;
+    if (!read(&magic, sizeof(magic)) || kFileMagic != magic ||
+        !read(&version, sizeof(version)) || kFileVersion != version ||
+        !read(&keyLength, sizeof(keyLength)) || keyLength != key.size() ||
+        remaining < keyLength || 0 != memcmp(bytes, key.c_str(), keyLength)) {
+        return false;
+    }
+    bytes += keyLength;
+    remaining -= keyLength;
+    if (!read(&rtHeight, sizeof(rtHeight)) || !read(&outputLength, sizeof(outputLength)) ||
+        remaining != outputLength) {
+        return false;
+    }
+    output->set((const char*) bytes, outputLength);
+    inputs->reset();
+    inputs->fRTHeight = SkToBool(rtHeight);
+
+    SkAutoMutexAcquire lock(fMutex);
+    for (size_t i = 0; i < fDiskFiles.size(); i++) {
+        if (fDiskFiles[i].fName == name) {
+            // the most recently used file goes to the back
+            DiskFile file = fDiskFiles[i];
+            fDiskFiles.erase(fDiskFiles.begin() + i);
+            fDiskFiles.push_back(file);
+            break;
+        }
+    }
+    fStats.fDiskHits++;
+    return true;
+}
+
+void CompileCache::writeFile(const SkString& key, const SkString& output,
+                             Program::Inputs inputs) {
+    SkDynamicMemoryWStream buffer;
+    buffer.write32(kFileMagic);
+    buffer.write32(kFileVersion);
+    buffer.write32(SkToU32(key.size()));
+    buffer.write(key.c_str(), key.size());
+    buffer.write8(inputs.fRTHeight ? 1 : 0);
+    buffer.write32(SkToU32(output.size()));
+    buffer.write(output.c_str(), output.size());
+    sk_sp<SkData> data(buffer.detachAsData());
+
+    SkString name = FileName(key);
+    SkAutoMutexAcquire lock(fMutex);
+    if (fDirectory.isEmpty() || data->size() > fMaxDiskBytes) {
+        return;
+    }
+    for (size_t i = 0; i < fDiskFiles.size(); i++) {
+        if (fDiskFiles[i].fName == name) {
+            // a stale file (e.g. from an older version) is about to be replaced
+            fDiskBytes -= fDiskFiles[i].fSize;
+            fDiskFiles.erase(fDiskFiles.begin() + i);
+            break;
+        }
+    }
+    while (fDiskBytes + data->size() > fMaxDiskBytes && !fDiskFiles.empty()) {
+        SkString path = SkOSPath::Join(fDirectory.c_str(), fDiskFiles.front().fName.c_str());
+        remove(path.c_str());
+        fDiskBytes -= fDiskFiles.front().fSize;
+        fDiskFiles.erase(fDiskFiles.begin());
+    }
+    SkString path = SkOSPath::Join(fDirectory.c_str(), name.c_str());
+    SkFILEWStream file(path.c_str());
+    if (!file.isValid() || !file.write(data->data(), data->size())) {
+        return;
+    }
+    fDiskFiles.push_back({ name, data->size() });
+    fDiskBytes += data->size();
+}
+
+} // namespace
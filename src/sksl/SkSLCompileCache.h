@@ -0,0 +1,137 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_COMPILECACHE
+#define SKSL_COMPILECACHE
+
+#include <vector>
+#include "SkMutex.h"
+#include "SkTHash.h"
+#include "SkTInternalLList.h"
+#include "ir/SkSLProgram.h"
+
+namespace SkSL {
+
+class Compiler;
+
+/**
+ * Memoizes compilation. Maps the program kind, settings, caps and source text of a shader to the
+ * GLSL or SPIR-V generated for it (along with the program's inputs), so that compiling an
+ * identical shader again skips the front end, the optimizer and code generation.
+ *
+ * Entries are kept in memory up to a byte limit, discarding the least recently used first. If a
+ * directory is set, entries are also written to it as files, so that they outlive the process;
+ * the directory has its own byte limit, enforced in the same way.
+ *
+ * Thread-safe. One cache may be used with any number of Compilers.
+ */
+class CompileCache : SkNoncopyable {
+public:
+    enum Target {
+        kGLSL_Target,
+        kSPIRV_Target
+    };
+
+    static const size_t kDefaultMaxBytes = 2 * 1024 * 1024;
+    static const size_t kDefaultMaxDiskBytes = 16 * 1024 * 1024;
+
+    CompileCache(size_t maxBytes = kDefaultMaxBytes, size_t maxDiskBytes = kDefaultMaxDiskBytes);
+
+    ~CompileCache();
+
+    /**
+     * The cache shared by every GrContext in the process.
+     */
+    static CompileCache* Global();
+
+    /**
+     * Stores entries in (and looks them up from) the given directory, which is created if needed.
+     * Passing null or an empty path goes back to keeping entries in memory only.
+     */
+    void setDirectory(const char* path);
+
+    /**
+     * Equivalent to compiler->convertProgram() followed by toGLSL() or toSPIRV(), but returns the
+     * cached output when there is one. On failure, returns false and the compiler's errorText()
+     * describes the errors; failures are not cached.
+     */
+    bool compile(Compiler* compiler, Target target, Program::Kind kind, const SkString& text,
+                 const Program::Settings& settings, SkString* output, Program::Inputs* inputs);
+
+    /**
+     * Empties the in-memory cache. Files in the directory are left alone.
+     */
+    void purge();
+
+    struct Stats {
+        int fHits;      // found in memory
+        int fDiskHits;  // found in the directory
+        int fMisses;    // had to compile
+        size_t fBytes;
+        size_t fDiskBytes;
+    };
+
+    Stats stats();
+
+private:
+    struct Entry {
+        SkString fKey;
+        SkString fOutput;
+        Program::Inputs fInputs;
+
+        size_t bytes() const {
+            return sizeof(Entry) + fKey.size() + fOutput.size();
+        }
+
+        SK_DECLARE_INTERNAL_LLIST_INTERFACE(Entry);
+    };
+
+    struct Traits {
+        static const SkString& GetKey(const Entry* e) {
+            return e->fKey;
+        }
+
+        static uint32_t Hash(const SkString& key) {
+            return SkGoodHash()(key);
+        }
+    };
+
+    struct DiskFile {
+        SkString fName;
+        size_t fSize;
+    };
+
+    bool find(const SkString& key, SkString* output, Program::Inputs* inputs);
+
+    void insert(const SkString& key, const SkString& output, Program::Inputs inputs);
+
+    void purgeAsNeeded();
+
+    static SkString FileName(const SkString& key);
+
+    bool readFile(const SkString& key, SkString* output, Program::Inputs* inputs);
+
+    void writeFile(const SkString& key, const SkString& output, Program::Inputs inputs);
+
+    SkMutex fMutex;
+    const size_t fMaxBytes;
+    const size_t fMaxDiskBytes;
+    size_t fBytes;
+    SkTHashTable<Entry*, SkString, Traits> fMap;
+    SkTInternalLList<Entry> fLRU;
+
+    SkString fDirectory;
+    size_t fDiskBytes;
+    // least recently used first; files found by setDirectory() come first, in directory order
+    std::vector<DiskFile> fDiskFiles;
+
+    Stats fStats;
+};
+
+} // namespace
+
+#endif
@@ -20,6 +20,7 @@
 #include "ir/SkSLUnresolvedFunction.h"
 #include "ir/SkSLVarDeclarations.h"
 #include "SkMutex.h"
+#include "SkOnce.h"
 
 #define STRINGIFY(x) #x
 
@@ -39,116 +40,157 @@ static const char* SKSL_FRAG_INCLUDE =
 
 namespace SkSL {
 
+/**
+ * The built-in types and the functions declared by sksl.include. Parsing those declarations is
+ * by far the most expensive part of setting up a Compiler, so it is done once per process. The
+ * resulting symbol tables are never modified afterwards; each Compiler layers its own tables on
+ * top of them.
+ */
+class BuiltinModule : public ErrorReporter {
+public:
+    BuiltinModule()
+    : fTypes(new SymbolTable(*this)) {
+        SymbolTable* types = fTypes.get();
+        #define ADD_TYPE(t) types->addWithoutOwnership(fContext.f ## t ## _Type->fName, \
+                                                       fContext.f ## t ## _Type.get())
+        ADD_TYPE(Void);
+        ADD_TYPE(Float);
+        ADD_TYPE(Vec2);
+        ADD_TYPE(Vec3);
+        ADD_TYPE(Vec4);
+        ADD_TYPE(Double);
+        ADD_TYPE(DVec2);
+        ADD_TYPE(DVec3);
+        ADD_TYPE(DVec4);
+        ADD_TYPE(Int);
+        ADD_TYPE(IVec2);
+        ADD_TYPE(IVec3);
+        ADD_TYPE(IVec4);
+        ADD_TYPE(UInt);
+        ADD_TYPE(UVec2);
+        ADD_TYPE(UVec3);
+        ADD_TYPE(UVec4);
+        ADD_TYPE(Bool);
+        ADD_TYPE(BVec2);
+        ADD_TYPE(BVec3);
+        ADD_TYPE(BVec4);
+        ADD_TYPE(Mat2x2);
+        types->addWithoutOwnership(SkString("mat2x2"), fContext.fMat2x2_Type.get());
+        ADD_TYPE(Mat2x3);
+        ADD_TYPE(Mat2x4);
+        ADD_TYPE(Mat3x2);
+        ADD_TYPE(Mat3x3);
+        types->addWithoutOwnership(SkString("mat3x3"), fContext.fMat3x3_Type.get());
+        ADD_TYPE(Mat3x4);
+        ADD_TYPE(Mat4x2);
+        ADD_TYPE(Mat4x3);
+        ADD_TYPE(Mat4x4);
+        types->addWithoutOwnership(SkString("mat4x4"), fContext.fMat4x4_Type.get());
+        ADD_TYPE(GenType);
+        ADD_TYPE(GenDType);
+        ADD_TYPE(GenIType);
+        ADD_TYPE(GenUType);
+        ADD_TYPE(GenBType);
+        ADD_TYPE(Mat);
+        ADD_TYPE(Vec);
+        ADD_TYPE(GVec);
+        ADD_TYPE(GVec2);
+        ADD_TYPE(GVec3);
+        ADD_TYPE(GVec4);
+        ADD_TYPE(DVec);
+        ADD_TYPE(IVec);
+        ADD_TYPE(UVec);
+        ADD_TYPE(BVec);
+
+        ADD_TYPE(Sampler1D);
+        ADD_TYPE(Sampler2D);
+        ADD_TYPE(Sampler3D);
+        ADD_TYPE(SamplerExternalOES);
+        ADD_TYPE(SamplerCube);
+        ADD_TYPE(Sampler2DRect);
+        ADD_TYPE(Sampler1DArray);
+        ADD_TYPE(Sampler2DArray);
+        ADD_TYPE(SamplerCubeArray);
+        ADD_TYPE(SamplerBuffer);
+        ADD_TYPE(Sampler2DMS);
+        ADD_TYPE(Sampler2DMSArray);
+
+        ADD_TYPE(ISampler2D);
+
+        ADD_TYPE(Image2D);
+        ADD_TYPE(IImage2D);
+
+        ADD_TYPE(SubpassInput);
+        ADD_TYPE(SubpassInputMS);
+
+        ADD_TYPE(GSampler1D);
+        ADD_TYPE(GSampler2D);
+        ADD_TYPE(GSampler3D);
+        ADD_TYPE(GSamplerCube);
+        ADD_TYPE(GSampler2DRect);
+        ADD_TYPE(GSampler1DArray);
+        ADD_TYPE(GSampler2DArray);
+        ADD_TYPE(GSamplerCubeArray);
+        ADD_TYPE(GSamplerBuffer);
+        ADD_TYPE(GSampler2DMS);
+        ADD_TYPE(GSampler2DMSArray);
+
+        ADD_TYPE(Sampler1DShadow);
+        ADD_TYPE(Sampler2DShadow);
+        ADD_TYPE(SamplerCubeShadow);
+        ADD_TYPE(Sampler2DRectShadow);
+        ADD_TYPE(Sampler1DArrayShadow);
+        ADD_TYPE(Sampler2DArrayShadow);
+        ADD_TYPE(SamplerCubeArrayShadow);
+        ADD_TYPE(GSampler2DArrayShadow);
+        ADD_TYPE(GSamplerCubeArrayShadow);
+        #undef ADD_TYPE
+
+        fSymbols = std::shared_ptr<SymbolTable>(new SymbolTable(fTypes, *this));
+        IRGenerator irGenerator(&fContext, fSymbols, *this);
+        Parser parser(SkString(SKSL_INCLUDE), *fTypes, *this);
+        for (const auto& decl : parser.file()) {
+            // sksl.include only declares functions; anything else would need per-program state
+            ASSERT(decl->fKind == ASTDeclaration::kFunction_Kind);
+            ASSERT_RESULT(!irGenerator.convertFunction((ASTFunction&) *decl));
+        }
+        fSymbols->markAllFunctionsBuiltin();
+    }
+
+    void error(Position position, SkString msg) override {
+        ABORT("error in built-in declarations: %s: %s\n", position.description().c_str(),
+              msg.c_str());
+    }
+
+    int errorCount() override {
+        return 0;
+    }
+
+    Context fContext;
+    std::shared_ptr<SymbolTable> fTypes;
+    std::shared_ptr<SymbolTable> fSymbols;
+};
+
+static BuiltinModule& builtin_module() {
+    static SkOnce once;
+    static BuiltinModule* module;
+    once([] { module = new BuiltinModule(); });
+    return *module;
+}
+
 Compiler::Compiler()
-: fErrorCount(0) {
-    auto types = std::shared_ptr<SymbolTable>(new SymbolTable(*this));
-    auto symbols = std::shared_ptr<SymbolTable>(new SymbolTable(types, *this));
+: fContext(builtin_module().fContext)
+, fErrorCount(0) {
+    // The parser adds struct and array types to fTypes, and the IRGenerator adds everything else
+    // to symbols, so neither touches the shared tables.
+    fTypes = std::shared_ptr<SymbolTable>(new SymbolTable(builtin_module().fSymbols, *this));
+    auto symbols = std::shared_ptr<SymbolTable>(new SymbolTable(fTypes, *this));
     fIRGenerator = new IRGenerator(&fContext, symbols, *this);
-    fTypes = types;
-    #define ADD_TYPE(t) types->addWithoutOwnership(fContext.f ## t ## _Type->fName, \
-                                                   fContext.f ## t ## _Type.get())
-    ADD_TYPE(Void);
-    ADD_TYPE(Float);
-    ADD_TYPE(Vec2);
-    ADD_TYPE(Vec3);
-    ADD_TYPE(Vec4);
-    ADD_TYPE(Double);
-    ADD_TYPE(DVec2);
-    ADD_TYPE(DVec3);
-    ADD_TYPE(DVec4);
-    ADD_TYPE(Int);
-    ADD_TYPE(IVec2);
-    ADD_TYPE(IVec3);
-    ADD_TYPE(IVec4);
-    ADD_TYPE(UInt);
-    ADD_TYPE(UVec2);
-    ADD_TYPE(UVec3);
-    ADD_TYPE(UVec4);
-    ADD_TYPE(Bool);
-    ADD_TYPE(BVec2);
-    ADD_TYPE(BVec3);
-    ADD_TYPE(BVec4);
-    ADD_TYPE(Mat2x2);
-    types->addWithoutOwnership(SkString("mat2x2"), fContext.fMat2x2_Type.get());
-    ADD_TYPE(Mat2x3);
-    ADD_TYPE(Mat2x4);
-    ADD_TYPE(Mat3x2);
-    ADD_TYPE(Mat3x3);
-    types->addWithoutOwnership(SkString("mat3x3"), fContext.fMat3x3_Type.get());
-    ADD_TYPE(Mat3x4);
-    ADD_TYPE(Mat4x2);
-    ADD_TYPE(Mat4x3);
-    ADD_TYPE(Mat4x4);
-    types->addWithoutOwnership(SkString("mat4x4"), fContext.fMat4x4_Type.get());
-    ADD_TYPE(GenType);
-    ADD_TYPE(GenDType);
-    ADD_TYPE(GenIType);
-    ADD_TYPE(GenUType);
-    ADD_TYPE(GenBType);
-    ADD_TYPE(Mat);
-    ADD_TYPE(Vec);
-    ADD_TYPE(GVec);
-    ADD_TYPE(GVec2);
-    ADD_TYPE(GVec3);
-    ADD_TYPE(GVec4);
-    ADD_TYPE(DVec);
-    ADD_TYPE(IVec);
-    ADD_TYPE(UVec);
-    ADD_TYPE(BVec);
-
-    ADD_TYPE(Sampler1D);
-    ADD_TYPE(Sampler2D);
-    ADD_TYPE(Sampler3D);
-    ADD_TYPE(SamplerExternalOES);
-    ADD_TYPE(SamplerCube);
-    ADD_TYPE(Sampler2DRect);
-    ADD_TYPE(Sampler1DArray);
-    ADD_TYPE(Sampler2DArray);
-    ADD_TYPE(SamplerCubeArray);
-    ADD_TYPE(SamplerBuffer);
-    ADD_TYPE(Sampler2DMS);
-    ADD_TYPE(Sampler2DMSArray);
-
-    ADD_TYPE(ISampler2D);
-
-    ADD_TYPE(Image2D);
-    ADD_TYPE(IImage2D);
-
-    ADD_TYPE(SubpassInput);
-    ADD_TYPE(SubpassInputMS);
-
-    ADD_TYPE(GSampler1D);
-    ADD_TYPE(GSampler2D);
-    ADD_TYPE(GSampler3D);
-    ADD_TYPE(GSamplerCube);
-    ADD_TYPE(GSampler2DRect);
-    ADD_TYPE(GSampler1DArray);
-    ADD_TYPE(GSampler2DArray);
-    ADD_TYPE(GSamplerCubeArray);
-    ADD_TYPE(GSamplerBuffer);
-    ADD_TYPE(GSampler2DMS);
-    ADD_TYPE(GSampler2DMSArray);
-
-    ADD_TYPE(Sampler1DShadow);
-    ADD_TYPE(Sampler2DShadow);
-    ADD_TYPE(SamplerCubeShadow);
-    ADD_TYPE(Sampler2DRectShadow);
-    ADD_TYPE(Sampler1DArrayShadow);
-    ADD_TYPE(Sampler2DArrayShadow);
-    ADD_TYPE(SamplerCubeArrayShadow);
-    ADD_TYPE(GSampler2DArrayShadow);
-    ADD_TYPE(GSamplerCubeArrayShadow);
 
     SkString skCapsName("sk_Caps");
     Variable* skCaps = new Variable(Position(), Modifiers(), skCapsName, 
                                     *fContext.fSkCaps_Type, Variable::kGlobal_Storage);
     fIRGenerator->fSymbolTable->add(skCapsName, std::unique_ptr<Symbol>(skCaps));
-
-    Modifiers::Flag ignored1;
-    std::vector<std::unique_ptr<ProgramElement>> ignored2;
-    this->internalConvertProgram(SkString(SKSL_INCLUDE), &ignored1, &ignored2);
-    fIRGenerator->fSymbolTable->markAllFunctionsBuiltin();
-    ASSERT(!fErrorCount);
 }
 
 Compiler::~Compiler() {
@@ -30,6 +30,9 @@ class IRGenerator;
  * produce a Program (a tree of IRNodes), then feeds the Program into a CodeGenerator to produce
  * compiled output.
  *
+ * The built-in types and function declarations are parsed once per process and shared, read-only,
+ * by every Compiler, so constructing a Compiler is cheap.
+ *
  * See the README for information about SkSL.
  */
 class Compiler : public ErrorReporter {
@@ -78,7 +81,8 @@ private:
     IRGenerator* fIRGenerator;
     SkString fSkiaVertText; // FIXME store parsed version instead
 
-    Context fContext;
+    // shared by every Compiler, along with the built-in symbol tables
+    Context& fContext;
     int fErrorCount;
     SkString fErrorText;
 };
@@ -475,7 +475,6 @@ std::unique_ptr<FunctionDefinition> IRGenerator::convertFunction(const ASTFuncti
                                                    "' differ only in return type");
                         return nullptr;
                     }
-                    decl = other;
                     for (size_t i = 0; i < parameters.size(); i++) {
                         if (parameters[i]->fModifiers != other->fParameters[i]->fModifiers) {
                             fErrors.error(f.fPosition, "modifiers on parameter " +
@@ -485,6 +484,12 @@ std::unique_ptr<FunctionDefinition> IRGenerator::convertFunction(const ASTFuncti
                             return nullptr;
                         }
                     }
+                    if (other->fBuiltin) {
+                        // Built-in declarations are shared by every compiler and must not be
+                        // marked as defined; this program gets a declaration of its own.
+                        break;
+                    }
+                    decl = other;
                     if (other->fDefined) {
                         fErrors.error(f.fPosition, "duplicate definition of " +
                                                    other->description());
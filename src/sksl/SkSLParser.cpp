@@ -209,7 +209,9 @@ void Parser::error(Position p, SkString msg) {
 }
 
 bool Parser::isType(SkString name) {
-    return nullptr != fTypes[name];
+    // fTypes may be layered over a table of built-in functions, so check what was found
+    const Symbol* symbol = fTypes[name];
+    return symbol && Symbol::kType_Kind == symbol->fKind;
 }
 
 /* PRECISION (LOWP | MEDIUMP | HIGHP) type SEMICOLON */
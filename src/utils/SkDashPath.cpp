@@ -214,34 +214,15 @@ private:
 };
 
 
-bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
-                                const SkRect* cullRect, const SkScalar aIntervals[],
-                                int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
-                                SkScalar intervalLength,
-                                StrokeRecApplication strokeRecApplication) {
-
-    // we do nothing if the src wants to be filled
-    SkStrokeRec::Style style = rec->getStyle();
-    if (SkStrokeRec::kFill_Style == style || SkStrokeRec::kStrokeAndFill_Style == style) {
-        return false;
-    }
-
-    const SkScalar* intervals = aIntervals;
-    SkScalar        dashCount = 0;
-    int             segCount = 0;
-
-    SkPath cullPathStorage;
-    const SkPath* srcPtr = &src;
-    if (cull_path(src, *rec, cullRect, intervalLength, &cullPathStorage)) {
-        srcPtr = &cullPathStorage;
-    }
-
-    SpecialLineRec lineRec;
-    bool specialLine = (StrokeRecApplication::kAllow == strokeRecApplication) &&
-                       lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength);
-
-    SkPathMeasure   meas(*srcPtr, false, rec->getResScale());
-
+// Walks the dashes of every contour left in meas, calling addDash(startD, stopD, startsDash) for
+// each. A dash that does not start a new piece continues the previous one: that is how a closed
+// contour joins its last dash to its (skipped) first one.
+// Returns false, having stopped early, if the path would have more than kMaxDashCount dashes.
+template <typename AddDashProc>
+static bool visit_dashes(SkPathMeasure& meas, const SkScalar intervals[], int32_t count,
+                         SkScalar initialDashLength, int32_t initialDashIndex,
+                         SkScalar intervalLength, AddDashProc&& addDash) {
+    SkScalar dashCount = 0;
     do {
         bool        skipFirstSegment = meas.isClosed();
         bool        addedSegment = false;
@@ -257,8 +238,7 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // segments seems reasonable: at 2 verbs per segment * 9 bytes per verb, this caps the
         // maximum dash memory overhead at roughly 17MB per path.
         dashCount += length * (count >> 1) / intervalLength;
-        if (dashCount > kMaxDashCount) {
-            dst->reset();
+        if (dashCount > SkDashPath::kMaxDashCount) {
             return false;
         }
 
@@ -272,17 +252,7 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
             addedSegment = false;
             if (is_even(index) && !skipFirstSegment) {
                 addedSegment = true;
-                ++segCount;
-
-                if (specialLine) {
-                    lineRec.addSegment(SkDoubleToScalar(distance),
-                                       SkDoubleToScalar(distance + dlen),
-                                       dst);
-                } else {
-                    meas.getSegment(SkDoubleToScalar(distance),
-                                    SkDoubleToScalar(distance + dlen),
-                                    dst, true);
-                }
+                addDash(SkDoubleToScalar(distance), SkDoubleToScalar(distance + dlen), true);
             }
             distance += dlen;
 
@@ -303,10 +273,52 @@ bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec
         // extend if we ended on a segment and we need to join up with the (skipped) initial segment
         if (meas.isClosed() && is_even(initialDashIndex) &&
             initialDashLength >= 0) {
-            meas.getSegment(0, initialDashLength, dst, !addedSegment);
-            ++segCount;
+            addDash(0, initialDashLength, !addedSegment);
         }
     } while (meas.nextContour());
+    return true;
+}
+
+bool SkDashPath::InternalFilter(SkPath* dst, const SkPath& src, SkStrokeRec* rec,
+                                const SkRect* cullRect, const SkScalar aIntervals[],
+                                int32_t count, SkScalar initialDashLength, int32_t initialDashIndex,
+                                SkScalar intervalLength,
+                                StrokeRecApplication strokeRecApplication) {
+
+    // we do nothing if the src wants to be filled
+    SkStrokeRec::Style style = rec->getStyle();
+    if (SkStrokeRec::kFill_Style == style || SkStrokeRec::kStrokeAndFill_Style == style) {
+        return false;
+    }
+
+    int segCount = 0;
+
+    SkPath cullPathStorage;
+    const SkPath* srcPtr = &src;
+    if (cull_path(src, *rec, cullRect, intervalLength, &cullPathStorage)) {
+        srcPtr = &cullPathStorage;
+    }
+
+    SpecialLineRec lineRec;
+    bool specialLine = (StrokeRecApplication::kAllow == strokeRecApplication) &&
+                       lineRec.init(*srcPtr, dst, rec, count >> 1, intervalLength);
+
+    SkPathMeasure   meas(*srcPtr, false, rec->getResScale());
+
+    bool ok = visit_dashes(meas, aIntervals, count, initialDashLength, initialDashIndex,
+                           intervalLength,
+                           [&](SkScalar startD, SkScalar stopD, bool startsDash) {
+        ++segCount;
+        if (specialLine && startsDash) {
+            lineRec.addSegment(startD, stopD, dst);
+        } else {
+            meas.getSegment(startD, stopD, dst, startsDash);
+        }
+    });
+    if (!ok) {
+        dst->reset();
+        return false;
+    }
 
     if (segCount > 1) {
         dst->setConvexity(SkPath::kConcave_Convexity);
@@ -329,6 +341,77 @@ bool SkDashPath::FilterDashPath(SkPath* dst, const SkPath& src, SkStrokeRec* rec
                           initialDashIndex, intervalLength);
 }
 
+// The summed length of each contour's control polygon, closing segments included. May be inf.
+static SkScalar polygon_length(const SkPath& path) {
+    SkPath::RawIter iter(path);
+    SkPoint pts[4];
+    SkPoint moveTo = { 0, 0 };
+    SkPoint lastPt = { 0, 0 };
+    SkScalar length = 0;
+    SkPath::Verb verb;
+    while ((verb = iter.next(pts)) != SkPath::kDone_Verb) {
+        switch (verb) {
+            case SkPath::kMove_Verb:
+                moveTo = lastPt = pts[0];
+                break;
+            case SkPath::kClose_Verb:
+                length += SkPoint::Distance(lastPt, moveTo);
+                lastPt = moveTo;
+                break;
+            default: {
+                int n = SkPath::kLine_Verb == verb ? 2 : SkPath::kCubic_Verb == verb ? 4 : 3;
+                for (int i = 1; i < n; ++i) {
+                    length += SkPoint::Distance(pts[i - 1], pts[i]);
+                }
+                lastPt = pts[n - 1];
+                break;
+            }
+        }
+    }
+    return length;
+}
+
+bool SkDashPath::VisitDashes(const SkPath& src, const SkStrokeRec& rec, const SkRect* cullRect,
+                             const SkPathEffect::DashInfo& info, DashVisitor* visitor) {
+    SkStrokeRec::Style style = rec.getStyle();
+    if (SkStrokeRec::kFill_Style == style || SkStrokeRec::kStrokeAndFill_Style == style ||
+        !ValidDashPath(info.fPhase, info.fIntervals, info.fCount)) {
+        return false;
+    }
+    SkScalar initialDashLength = 0;
+    int32_t initialDashIndex = 0;
+    SkScalar intervalLength = 0;
+    CalcDashParameters(info.fPhase, info.fIntervals, info.fCount,
+                       &initialDashLength, &initialDashIndex, &intervalLength);
+
+    SkPath cullPathStorage;
+    const SkPath* srcPtr = &src;
+    if (cull_path(src, rec, cullRect, intervalLength, &cullPathStorage)) {
+        srcPtr = &cullPathStorage;
+    }
+
+    // The visitor must see all of the dashes or none of them. The control polygon bounds the arc
+    // length from above, so only a path that might reach kMaxDashCount needs measuring twice.
+    if (!(polygon_length(*srcPtr) * (info.fCount >> 1) / intervalLength <= kMaxDashCount / 2)) {
+        SkPathMeasure counter(*srcPtr, false, rec.getResScale());
+        SkScalar dashCount = 0;
+        do {
+            dashCount += counter.getLength() * (info.fCount >> 1) / intervalLength;
+            if (dashCount > kMaxDashCount) {
+                return false;
+            }
+        } while (counter.nextContour());
+    }
+
+    SkPathMeasure meas(*srcPtr, false, rec.getResScale());
+    SkAssertResult(visit_dashes(meas, info.fIntervals, info.fCount, initialDashLength,
+                                initialDashIndex, intervalLength,
+                                [&](SkScalar startD, SkScalar stopD, bool startsDash) {
+        visitor->visitDash(meas, startD, stopD, startsDash);
+    }));
+    return true;
+}
+
 bool SkDashPath::ValidDashPath(SkScalar phase, const SkScalar intervals[], int32_t count) {
     if (count < 2 || !SkIsAlign2(count)) {
         return false;
@@ -10,6 +10,8 @@
 
 #include "SkPathEffect.h"
 
+class SkPathMeasure;
+
 namespace SkDashPath {
     /**
      * Calculates the initialDashLength, initialDashIndex, and intervalLength based on the
@@ -47,6 +49,27 @@ namespace SkDashPath {
                         StrokeRecApplication = StrokeRecApplication::kAllow);
 
     bool ValidDashPath(SkScalar phase, const SkScalar intervals[], int32_t count);
+
+    class DashVisitor {
+    public:
+        virtual ~DashVisitor() {}
+
+        /**
+         * Called for each dash: the piece of meas's current contour from startD to stopD. If
+         * startsDash is false the piece continues the previous one, as when a closed contour
+         * joins its last dash to its first.
+         */
+        virtual void visitDash(SkPathMeasure& meas, SkScalar startD, SkScalar stopD,
+                               bool startsDash) = 0;
+    };
+
+    /**
+     * Finds the same dashes FilterDashPath would, but hands them to the visitor one at a time
+     * instead of appending them to a path. The stroke rec is never applied. Returns false, without
+     * visiting anything, wherever FilterDashPath would fail.
+     */
+    bool VisitDashes(const SkPath& src, const SkStrokeRec&, const SkRect* cullRect,
+                     const SkPathEffect::DashInfo& info, DashVisitor* visitor);
 }
 
 #endif
@@ -7,8 +7,10 @@
 
 #include "SkDeferredCanvas.h"
 #include "SkDrawable.h"
+#include "SkImage.h"
 #include "SkPath.h"
 #include "SkRRect.h"
+#include "SkRSXform.h"
 #include "SkSurface.h"
 #include "SkTextBlob.h"
 #include "SkClipOpPriv.h"
@@ -45,12 +47,17 @@ void SkDeferredCanvas::Rec::setConcat(const SkMatrix& m) {
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-SkDeferredCanvas::SkDeferredCanvas(SkCanvas* canvas)
-    : INHERITED(1, 1) {
+SkDeferredCanvas::SkDeferredCanvas(SkCanvas* canvas, EvalType evalType)
+    : INHERITED(1, 1)
+    , fEvalType(evalType) {
     this->reset(canvas);
 }
 
-SkDeferredCanvas::~SkDeferredCanvas() {}
+SkDeferredCanvas::~SkDeferredCanvas() {
+    // Held-back draws are already expressed in the target's current state, so they can be sent
+    // on without the save/matrix/clip changes still waiting in fRecs.
+    this->flush_pending();
+}
 
 void SkDeferredCanvas::reset(SkCanvas* canvas) {
     if (fCanvas) {
@@ -58,6 +65,7 @@ void SkDeferredCanvas::reset(SkCanvas* canvas) {
         fCanvas = nullptr;
     }
     fRecs.reset();
+    fPending.reset();
     if (canvas) {
         this->resetForNextPicture(SkIRect::MakeSize(canvas->getBaseLayerSize()));
         fCanvas = canvas;
@@ -104,6 +112,7 @@ bool SkDeferredCanvas::push_concat(const SkMatrix& mat) {
 }
 
 void SkDeferredCanvas::emit(const Rec& rec) {
+    this->flush_pending();
     switch (rec.fType) {
         case kSave_Type:
             fCanvas->save();
@@ -241,13 +250,213 @@ void SkDeferredCanvas::flush_translate(SkScalar* x, SkScalar* y, const SkPaint&
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Bounds the amount of work (and memory) spent on held-back draws in kLazy mode.
+static const int kMaxPending = 256;
+// How far back a draw may look for a batch to join.
+static const int kMaxReorderDistance = 32;
+// The largest number of draws merged into one drawRegion or drawAtlas call.
+static const int kMaxMerge = 64;
+
+bool SkDeferredCanvas::Pending::canBatchWith(const Pending& other) const {
+    return fKind == other.fKind && fImage == other.fImage && fHasPaint == other.fHasPaint &&
+           (!fHasPaint || fPaint == other.fPaint);
+}
+
+SkDeferredCanvas::Pending* SkDeferredCanvas::push_pending(Pending::Kind kind,
+                                                          const SkRect& geometry,
+                                                          const SkPaint* paint) {
+    if (kLazy != fEvalType || (paint && !paint->canComputeFastBounds())) {
+        return nullptr;
+    }
+    if (fPending.count() >= kMaxPending) {
+        this->flush_pending();
+    }
+    Pending& p = fPending.push_back();
+    p.fKind = kind;
+    p.fHasPaint = paint != nullptr;
+    p.fHasSrc = false;
+    p.fConstraint = kFast_SrcRectConstraint;
+    p.fRect = geometry;
+    p.fBounds = geometry;
+    p.fBounds.sort();
+    if (paint) {
+        p.fPaint = *paint;
+        p.fBounds = paint->computeFastBounds(p.fBounds, &p.fBounds);
+    }
+    // Antialiasing and filtering can touch the pixels just outside the geometry.
+    p.fBounds.outset(1, 1);
+    return &p;
+}
+
+bool SkDeferredCanvas::defer_rect(Pending::Kind kind, const SkRect& rect, const SkPaint& paint) {
+    return this->push_pending(kind, rect, &paint) != nullptr;
+}
+
+bool SkDeferredCanvas::defer_rrect(const SkRRect& rrect, const SkPaint& paint) {
+    Pending* p = this->push_pending(Pending::kRRect_Kind, rrect.getBounds(), &paint);
+    if (p) {
+        p->fRRect = rrect;
+    }
+    return p != nullptr;
+}
+
+bool SkDeferredCanvas::defer_image(const SkImage* image, const SkRect* src, const SkRect& dst,
+                                   const SkPaint* paint, SrcRectConstraint constraint) {
+    Pending* p = this->push_pending(Pending::kImage_Kind, dst, paint);
+    if (p) {
+        p->fImage = sk_ref_sp(image);
+        p->fHasSrc = src != nullptr;
+        p->fSrc = src ? *src : SkRect::MakeIWH(image->width(), image->height());
+        p->fConstraint = constraint;
+    }
+    return p != nullptr;
+}
+
+void SkDeferredCanvas::flush_pending() {
+    if (fPending.empty()) {
+        return;
+    }
+
+    // Move each draw back to just after the last draw it can be batched with, as long as it
+    // does not jump over anything it overlaps. All pending draws share the target's state, so
+    // their bounds can be compared directly.
+    SkTDArray<int> order;
+    order.setReserve(fPending.count());
+    for (int i = 0; i < fPending.count(); ++i) {
+        const Pending& curr = fPending[i];
+        int insertAt = order.count();
+        for (int k = order.count() - 1; k >= 0 && order.count() - k <= kMaxReorderDistance; --k) {
+            const Pending& prev = fPending[order[k]];
+            if (prev.canBatchWith(curr)) {
+                insertAt = k + 1;
+                break;
+            }
+            if (SkRect::Intersects(prev.fBounds, curr.fBounds)) {
+                break;
+            }
+        }
+        *order.insert(insertAt) = i;
+    }
+
+    for (int i = 0; i < order.count();) {
+        i += this->emit_pending(order.begin() + i, order.count() - i);
+    }
+    fPending.reset();
+}
+
+// Rects can be merged into one drawRegion() if that touches exactly the same pixels: they must
+// be integral, must not overlap, and the paint must not care about the geometry's shape.
+static bool can_merge_rects(const SkTArray<SkIRect>& rects, const SkRect& rect,
+                            const SkPaint& paint, const SkMatrix& ctm) {
+    if (paint.getStyle() != SkPaint::kFill_Style || paint.getPathEffect() ||
+        paint.getMaskFilter() || paint.getLooper() || paint.getImageFilter() ||
+        paint.getRasterizer() || ctm.getType() > SkMatrix::kTranslate_Mask ||
+        !SkScalarIsInt(ctm.getTranslateX()) || !SkScalarIsInt(ctm.getTranslateY())) {
+        return false;
+    }
+    SkIRect irect = rect.round();
+    if (SkRect::Make(irect) != rect) {
+        return false;
+    }
+    for (const SkIRect& r : rects) {
+        if (SkIRect::Intersects(r, irect)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Image draws can be merged into one drawAtlas() if each is a uniform scale plus a translate,
+// and the paint does not need anything drawAtlas() would drop.
+static bool can_merge_image(const SkImage* image, const SkRect& src, const SkRect& dst,
+                            const SkPaint* paint, SkCanvas::SrcRectConstraint constraint,
+                            SkScalar* scale) {
+    if (image->isAlphaOnly() || src.isEmpty()) {
+        return false;
+    }
+    if (paint && (paint->getShader() || paint->getMaskFilter() || paint->getLooper() ||
+                  paint->getImageFilter() || paint->getColorFilter() ||
+                  (SkCanvas::kStrict_SrcRectConstraint == constraint &&
+                   paint->getFilterQuality() != kNone_SkFilterQuality))) {
+        return false;
+    }
+    *scale = dst.width() / src.width();
+    return *scale > 0 && *scale == dst.height() / src.height();
+}
+
+int SkDeferredCanvas::emit_pending(const int order[], int count) {
+    const Pending& first = fPending[order[0]];
+    const SkPaint* paint = first.fHasPaint ? &first.fPaint : nullptr;
+
+    int n = 1;
+    while (n < count && n < kMaxMerge && first.canBatchWith(fPending[order[n]])) {
+        n++;
+    }
+
+    if (Pending::kRect_Kind == first.fKind && n > 1) {
+        SkTArray<SkIRect> rects(n);
+        const SkMatrix& ctm = fCanvas->getTotalMatrix();
+        int merged = 0;
+        while (merged < n && can_merge_rects(rects, fPending[order[merged]].fRect, *paint, ctm)) {
+            rects.push_back(fPending[order[merged]].fRect.round());
+            merged++;
+        }
+        if (merged > 1) {
+            SkRegion region;
+            region.setRects(rects.begin(), rects.count());
+            fCanvas->drawRegion(region, *paint);
+            return merged;
+        }
+    }
+
+    if (Pending::kImage_Kind == first.fKind && n > 1) {
+        SkTArray<SkRSXform> xforms(n);
+        SkTArray<SkRect> texs(n);
+        SkScalar scale;
+        while (xforms.count() < n) {
+            const Pending& p = fPending[order[xforms.count()]];
+            if (!can_merge_image(p.fImage.get(), p.fSrc, p.fRect, paint, p.fConstraint,
+                                 &scale)) {
+                break;
+            }
+            xforms.push_back(SkRSXform::Make(scale, 0, p.fRect.x() - scale * p.fSrc.x(),
+                                             p.fRect.y() - scale * p.fSrc.y()));
+            texs.push_back(p.fSrc);
+        }
+        if (xforms.count() > 1) {
+            fCanvas->drawAtlas(first.fImage.get(), xforms.begin(), texs.begin(), xforms.count(),
+                               nullptr, paint);
+            return xforms.count();
+        }
+    }
+
+    switch (first.fKind) {
+        case Pending::kRect_Kind:
+            fCanvas->drawRect(first.fRect, first.fPaint);
+            break;
+        case Pending::kOval_Kind:
+            fCanvas->drawOval(first.fRect, first.fPaint);
+            break;
+        case Pending::kRRect_Kind:
+            fCanvas->drawRRect(first.fRRect, first.fPaint);
+            break;
+        case Pending::kImage_Kind:
+            fCanvas->legacy_drawImageRect(first.fImage.get(), first.fHasSrc ? &first.fSrc : nullptr,
+                                          first.fRect, paint, first.fConstraint);
+            break;
+    }
+    return 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 void SkDeferredCanvas::willSave() {
     this->push_save();
 }
 
 SkCanvas::SaveLayerStrategy SkDeferredCanvas::getSaveLayerStrategy(const SaveLayerRec& rec) {
     this->flush_all();
-    fCanvas->saveLayer(rec);
+    this->target()->saveLayer(rec);
     this->INHERITED::getSaveLayerStrategy(rec);
     // No need for a layer.
     return kNoLayer_SaveLayerStrategy;
@@ -264,7 +473,7 @@ void SkDeferredCanvas::willRestore() {
         SkASSERT(kSave_Type != fRecs[i].fType);
     }
     fRecs.setCount(0);
-    fCanvas->restore();
+    this->target()->restore();
     this->INHERITED::willRestore();
 }
 
@@ -274,14 +483,14 @@ void SkDeferredCanvas::didConcat(const SkMatrix& matrix) {
     }
     if (!this->push_concat(matrix)) {
         this->flush_all();
-        fCanvas->concat(matrix);
+        this->target()->concat(matrix);
         this->INHERITED::didConcat(matrix);
     }
 }
 
 void SkDeferredCanvas::didSetMatrix(const SkMatrix& matrix) {
     this->flush_all();
-    fCanvas->setMatrix(matrix);
+    this->target()->setMatrix(matrix);
     this->INHERITED::didSetMatrix(matrix);
 }
 
@@ -290,63 +499,67 @@ void SkDeferredCanvas::onClipRect(const SkRect& rect, SkClipOp op, ClipEdgeStyle
         this->push_cliprect(rect);
     } else {
         this->flush_all();
-        fCanvas->clipRect(rect, op, kSoft_ClipEdgeStyle == edgeStyle);
+        this->target()->clipRect(rect, op, kSoft_ClipEdgeStyle == edgeStyle);
         this->INHERITED::onClipRect(rect, op, edgeStyle);
     }
 }
 
 void SkDeferredCanvas::onClipRRect(const SkRRect& rrect, SkClipOp op, ClipEdgeStyle edgeStyle) {
     this->flush_all();
-    fCanvas->clipRRect(rrect, op, kSoft_ClipEdgeStyle == edgeStyle);
+    this->target()->clipRRect(rrect, op, kSoft_ClipEdgeStyle == edgeStyle);
     this->INHERITED::onClipRRect(rrect, op, edgeStyle);
 }
 
 void SkDeferredCanvas::onClipPath(const SkPath& path, SkClipOp op, ClipEdgeStyle edgeStyle) {
     this->flush_all();
-    fCanvas->clipPath(path, op, kSoft_ClipEdgeStyle == edgeStyle);
+    this->target()->clipPath(path, op, kSoft_ClipEdgeStyle == edgeStyle);
     this->INHERITED::onClipPath(path, op, edgeStyle);
 }
 
 void SkDeferredCanvas::onClipRegion(const SkRegion& deviceRgn, SkClipOp op) {
     this->flush_all();
-    fCanvas->clipRegion(deviceRgn, op);
+    this->target()->clipRegion(deviceRgn, op);
     this->INHERITED::onClipRegion(deviceRgn, op);
 }
 
 void SkDeferredCanvas::onDrawPaint(const SkPaint& paint) {
     // TODO: Can we turn this into drawRect?
     this->flush_all();
-    fCanvas->drawPaint(paint);
+    this->target()->drawPaint(paint);
 }
 
 void SkDeferredCanvas::onDrawPoints(PointMode mode, size_t count, const SkPoint pts[],
                                 const SkPaint& paint) {
     this->flush_all();
-    fCanvas->drawPoints(mode, count, pts, paint);
+    this->target()->drawPoints(mode, count, pts, paint);
 }
 
 void SkDeferredCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
     SkRect modRect = rect;
     this->flush_check(&modRect, &paint);
-    fCanvas->drawRect(modRect, paint);
+    if (!this->defer_rect(Pending::kRect_Kind, modRect, paint)) {
+        this->target()->drawRect(modRect, paint);
+    }
 }
 
 void SkDeferredCanvas::onDrawRegion(const SkRegion& region, const SkPaint& paint) {
     this->flush_all();  // can we do better?
-    fCanvas->drawRegion(region, paint);
+    this->target()->drawRegion(region, paint);
 }
 
 void SkDeferredCanvas::onDrawOval(const SkRect& rect, const SkPaint& paint) {
     SkRect modRect = rect;
     this->flush_check(&modRect, &paint, kNoClip_Flag);
-    fCanvas->drawOval(modRect, paint);
+    if (!this->defer_rect(Pending::kOval_Kind, modRect, paint)) {
+        this->target()->drawOval(modRect, paint);
+    }
 }
 
 void SkDeferredCanvas::onDrawArc(const SkRect& rect, SkScalar startAngle, SkScalar sweepAngle,
                                  bool useCenter, const SkPaint& paint) {
     SkRect modRect = rect;
     this->flush_check(&modRect, &paint, kNoClip_Flag);
-    fCanvas->drawArc(modRect, startAngle, sweepAngle, useCenter, paint);
+    this->target()->drawArc(modRect, startAngle, sweepAngle, useCenter, paint);
 }
 
 static SkRRect make_offset(const SkRRect& src, SkScalar dx, SkScalar dy) {
@@ -358,14 +571,17 @@ static SkRRect make_offset(const SkRRect& src, SkScalar dx, SkScalar dy) {
 void SkDeferredCanvas::onDrawRRect(const SkRRect& rrect, const SkPaint& paint) {
     SkRect modRect = rrect.getBounds();
     this->flush_check(&modRect, &paint, kNoClip_Flag);
-    fCanvas->drawRRect(make_offset(rrect,
+    SkRRect modRRect = make_offset(rrect,
                                    modRect.x() - rrect.getBounds().x(),
-                                   modRect.y() - rrect.getBounds().y()), paint);
+                                   modRect.y() - rrect.getBounds().y());
+    if (!this->defer_rrect(modRRect, paint)) {
+        this->target()->drawRRect(modRRect, paint);
+    }
 }
 
 void SkDeferredCanvas::onDrawDRRect(const SkRRect& outer, const SkRRect& inner, const SkPaint& paint) {
     this->flush_all();
-    fCanvas->drawDRRect(outer, inner, paint);
+    this->target()->drawDRRect(outer, inner, paint);
 }
 
 void SkDeferredCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
@@ -375,7 +591,7 @@ void SkDeferredCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
         SkRect modRect = path.getBounds();
         this->flush_check(&modRect, &paint, kNoClip_Flag | kNoTranslate_Flag | kNoScale_Flag);
     }
-    fCanvas->drawPath(path, paint);
+    this->target()->drawPath(path, paint);
 }
 
 void SkDeferredCanvas::onDrawBitmap(const SkBitmap& bitmap, SkScalar x, SkScalar y,
@@ -385,9 +601,9 @@ void SkDeferredCanvas::onDrawBitmap(const SkBitmap& bitmap, SkScalar x, SkScalar
     SkRect bounds = SkRect::MakeXYWH(x, y, w, h);
     this->flush_check(&bounds, paint, kNoClip_Flag);
     if (bounds.width() == w && bounds.height() == h) {
-        fCanvas->drawBitmap(bitmap, bounds.x(), bounds.y(), paint);
+        this->target()->drawBitmap(bitmap, bounds.x(), bounds.y(), paint);
     } else {
-        fCanvas->drawBitmapRect(bitmap, bounds, paint);
+        this->target()->drawBitmapRect(bitmap, bounds, paint);
     }
 }
 
@@ -395,28 +611,28 @@ void SkDeferredCanvas::onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* sr
                                     const SkPaint* paint, SrcRectConstraint constraint) {
     SkRect modRect = dst;
     this->flush_check(&modRect, paint, kNoClip_Flag);
-    fCanvas->legacy_drawBitmapRect(bitmap, src, modRect, paint, constraint);
+    this->target()->legacy_drawBitmapRect(bitmap, src, modRect, paint, constraint);
 }
 
 void SkDeferredCanvas::onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center,
                                     const SkRect& dst, const SkPaint* paint) {
     SkRect modRect = dst;
     this->flush_check(&modRect, paint, kNoClip_Flag);
-    fCanvas->drawBitmapNine(bitmap, center, modRect, paint);
+    this->target()->drawBitmapNine(bitmap, center, modRect, paint);
 }
 
 void SkDeferredCanvas::onDrawBitmapLattice(const SkBitmap& bitmap, const Lattice& lattice,
                                            const SkRect& dst, const SkPaint* paint) {
     SkRect modRect = dst;
     this->flush_check(&modRect, paint, kNoClip_Flag);
-    fCanvas->drawBitmapLattice(bitmap, lattice, modRect, paint);
+    this->target()->drawBitmapLattice(bitmap, lattice, modRect, paint);
 }
 
 void SkDeferredCanvas::onDrawImageNine(const SkImage* image, const SkIRect& center,
                                        const SkRect& dst, const SkPaint* paint) {
     SkRect modRect = dst;
     this->flush_check(&modRect, paint, kNoClip_Flag);
-    fCanvas->drawImageNine(image, center, modRect, paint);
+    this->target()->drawImageNine(image, center, modRect, paint);
 }
 
 void SkDeferredCanvas::onDrawImage(const SkImage* image, SkScalar x, SkScalar y,
@@ -425,10 +641,13 @@ void SkDeferredCanvas::onDrawImage(const SkImage* image, SkScalar x, SkScalar y,
     const SkScalar h = SkIntToScalar(image->height());
     SkRect bounds = SkRect::MakeXYWH(x, y, w, h);
     this->flush_check(&bounds, paint, kNoClip_Flag);
+    if (this->defer_image(image, nullptr, bounds, paint, kFast_SrcRectConstraint)) {
+        return;
+    }
     if (bounds.width() == w && bounds.height() == h) {
-        fCanvas->drawImage(image, bounds.x(), bounds.y(), paint);
+        this->target()->drawImage(image, bounds.x(), bounds.y(), paint);
     } else {
-        fCanvas->drawImageRect(image, bounds, paint);
+        this->target()->drawImageRect(image, bounds, paint);
     }
 }
 
@@ -436,38 +655,40 @@ void SkDeferredCanvas::onDrawImageRect(const SkImage* image, const SkRect* src,
                                    const SkPaint* paint, SrcRectConstraint constraint) {
     SkRect modRect = dst;
     this->flush_check(&modRect, paint, kNoClip_Flag);
-    fCanvas->legacy_drawImageRect(image, src, modRect, paint, constraint);
+    if (!this->defer_image(image, src, modRect, paint, constraint)) {
+        this->target()->legacy_drawImageRect(image, src, modRect, paint, constraint);
+    }
 }
 
 void SkDeferredCanvas::onDrawImageLattice(const SkImage* image, const Lattice& lattice,
                                           const SkRect& dst, const SkPaint* paint) {
     SkRect modRect = dst;
     this->flush_check(&modRect, paint, kNoClip_Flag);
-    fCanvas->drawImageLattice(image, lattice, modRect, paint);
+    this->target()->drawImageLattice(image, lattice, modRect, paint);
 }
 
 void SkDeferredCanvas::onDrawText(const void* text, size_t byteLength, SkScalar x, SkScalar y,
                                   const SkPaint& paint) {
     this->flush_translate(&x, &y, paint);
-    fCanvas->drawText(text, byteLength, x, y, paint);
+    this->target()->drawText(text, byteLength, x, y, paint);
 }
 
 void SkDeferredCanvas::onDrawPosText(const void* text, size_t byteLength, const SkPoint pos[],
                                  const SkPaint& paint) {
     this->flush_before_saves();
-    fCanvas->drawPosText(text, byteLength, pos, paint);
+    this->target()->drawPosText(text, byteLength, pos, paint);
 }
 
 void SkDeferredCanvas::onDrawPosTextH(const void* text, size_t byteLength, const SkScalar xpos[],
                                   SkScalar constY, const SkPaint& paint) {
     this->flush_before_saves();
-    fCanvas->drawPosTextH(text, byteLength, xpos, constY, paint);
+    this->target()->drawPosTextH(text, byteLength, xpos, constY, paint);
 }
 
 void SkDeferredCanvas::onDrawTextOnPath(const void* text, size_t byteLength, const SkPath& path,
                                     const SkMatrix* matrix, const SkPaint& paint) {
     this->flush_before_saves();
-    fCanvas->drawTextOnPath(text, byteLength, path, matrix, paint);
+    this->target()->drawTextOnPath(text, byteLength, path, matrix, paint);
 }
 
 void SkDeferredCanvas::onDrawTextRSXform(const void* text, size_t byteLength,
@@ -480,13 +701,13 @@ void SkDeferredCanvas::onDrawTextRSXform(const void* text, size_t byteLength,
     } else {
         this->flush_before_saves();
     }
-    fCanvas->drawTextRSXform(text, byteLength, xform, cullRect, paint);
+    this->target()->drawTextRSXform(text, byteLength, xform, cullRect, paint);
 }
 
 void SkDeferredCanvas::onDrawTextBlob(const SkTextBlob* blob, SkScalar x, SkScalar y,
                                   const SkPaint &paint) {
     this->flush_translate(&x, &y, blob->bounds(), &paint);
-    fCanvas->drawTextBlob(blob, x, y, paint);
+    this->target()->drawTextBlob(blob, x, y, paint);
 }
 
 #include "SkPicture.h"
@@ -498,7 +719,7 @@ void SkDeferredCanvas::onDrawPicture(const SkPicture* picture, const SkMatrix* m
     picture->playback(this);
 #else
     this->flush_before_saves();
-    fCanvas->drawPicture(picture, matrix, paint);
+    this->target()->drawPicture(picture, matrix, paint);
 #endif
 }
 
@@ -508,7 +729,7 @@ void SkDeferredCanvas::onDrawDrawable(SkDrawable* drawable, const SkMatrix* matr
     drawable->draw(this, matrix);
 #else
     this->flush_before_saves();
-    fCanvas->drawDrawable(drawable, matrix);
+    this->target()->drawDrawable(drawable, matrix);
 #endif
 }
 
@@ -517,7 +738,7 @@ void SkDeferredCanvas::onDrawAtlas(const SkImage* image, const SkRSXform xform[]
                                    int count, SkBlendMode bmode,
                                    const SkRect* cull, const SkPaint* paint) {
     this->flush_before_saves();
-    fCanvas->drawAtlas(image, xform, rects, colors, count, bmode, cull, paint);
+    this->target()->drawAtlas(image, xform, rects, colors, count, bmode, cull, paint);
 }
 
 void SkDeferredCanvas::onDrawVertices(VertexMode vmode, int vertexCount,
@@ -526,7 +747,7 @@ void SkDeferredCanvas::onDrawVertices(VertexMode vmode, int vertexCount,
                                   const uint16_t indices[], int indexCount,
                                   const SkPaint& paint) {
     this->flush_before_saves();
-    fCanvas->drawVertices(vmode, vertexCount, vertices, texs, colors, bmode,
+    this->target()->drawVertices(vmode, vertexCount, vertices, texs, colors, bmode,
                            indices, indexCount, paint);
 }
 
@@ -534,18 +755,18 @@ void SkDeferredCanvas::onDrawPatch(const SkPoint cubics[12], const SkColor color
                                const SkPoint texCoords[4], SkBlendMode bmode,
                                const SkPaint& paint) {
     this->flush_before_saves();
-    fCanvas->drawPatch(cubics, colors, texCoords, bmode, paint);
+    this->target()->drawPatch(cubics, colors, texCoords, bmode, paint);
 }
 
 void SkDeferredCanvas::onDrawAnnotation(const SkRect& rect, const char key[], SkData* data) {
     SkRect modRect = rect;
     this->flush_check(&modRect, nullptr, kNoClip_Flag);
-    fCanvas->drawAnnotation(modRect, key, data);
+    this->target()->drawAnnotation(modRect, key, data);
 }
 
 #ifdef SK_SUPPORT_LEGACY_DRAWFILTER
 SkDrawFilter* SkDeferredCanvas::setDrawFilter(SkDrawFilter* filter) {
-    fCanvas->setDrawFilter(filter);
+    this->target()->setDrawFilter(filter);
     return this->INHERITED::setDrawFilter(filter);
 }
 #endif
@@ -565,12 +786,14 @@ bool SkDeferredCanvas::getClipDeviceBounds(SkIRect* bounds) const {
 }
 bool SkDeferredCanvas::isClipEmpty() const { return fCanvas->isClipEmpty(); }
 bool SkDeferredCanvas::isClipRect() const { return fCanvas->isClipRect(); }
-bool SkDeferredCanvas::onPeekPixels(SkPixmap* pixmap) { return fCanvas->peekPixels(pixmap); }
+bool SkDeferredCanvas::onPeekPixels(SkPixmap* pixmap) {
+    return this->target()->peekPixels(pixmap);
+}
 bool SkDeferredCanvas::onAccessTopLayerPixels(SkPixmap* pixmap) {
     SkImageInfo info;
     size_t rowBytes;
     SkIPoint* origin = nullptr;
-    void* addr = fCanvas->accessTopLayerPixels(&info, &rowBytes, origin);
+    void* addr = this->target()->accessTopLayerPixels(&info, &rowBytes, origin);
     if (addr) {
         *pixmap = SkPixmap(info, addr, rowBytes);
         return true;
@@ -581,5 +804,5 @@ SkImageInfo SkDeferredCanvas::onImageInfo() const { return fCanvas->imageInfo();
 bool SkDeferredCanvas::onGetProps(SkSurfaceProps* props) const { return fCanvas->getProps(props); }
 void SkDeferredCanvas::onFlush() {
     this->flush_all();
-    return fCanvas->flush();
+    return this->target()->flush();
 }
@@ -9,12 +9,25 @@
 #ifndef SkDeferredCanvas_DEFINED
 #define SkDeferredCanvas_DEFINED
 
+#include "../private/SkTArray.h"
 #include "../private/SkTDArray.h"
 #include "SkNoDrawCanvas.h"
+#include "SkPaint.h"
+#include "SkRRect.h"
 
 class SK_API SkDeferredCanvas : public SkNoDrawCanvas {
 public:
-    SkDeferredCanvas(SkCanvas* = nullptr);
+    enum EvalType {
+        // Forward draws as soon as the pending save/concat/clip state allows.
+        kEager,
+        // Also hold back simple draws (rects, ovals, rrects, images) until the target's state
+        // has to change. Before they are sent on, non-overlapping draws are reordered so that
+        // draws with matching paints and images are adjacent, and adjacent rects and images
+        // are merged into single drawRegion/drawAtlas calls.
+        kLazy,
+    };
+
+    SkDeferredCanvas(SkCanvas* = nullptr, EvalType = kEager);
     ~SkDeferredCanvas() override;
 
     void reset(SkCanvas*);
@@ -107,6 +120,7 @@ protected:
 
 private:
     SkCanvas* fCanvas{nullptr};
+    EvalType  fEvalType;
 
     enum Type {
         kSave_Type,
@@ -149,6 +163,44 @@ private:
 
     void internal_flush_translate(SkScalar* x, SkScalar* y, const SkRect* boundsOrNull);
 
+    // kLazy only: draws held back until the target's save/matrix/clip state changes. They are
+    // all expressed in the target's current state.
+    struct Pending {
+        enum Kind : uint8_t {
+            kRect_Kind,
+            kOval_Kind,
+            kRRect_Kind,
+            kImage_Kind,
+        };
+        Kind                    fKind;
+        bool                    fHasPaint;
+        bool                    fHasSrc;
+        SrcRectConstraint       fConstraint;
+        SkRect                  fBounds;    // conservative area touched, used for reordering
+        SkRect                  fRect;      // rect/oval geometry, or image dst
+        SkRect                  fSrc;
+        SkRRect                 fRRect;
+        SkPaint                 fPaint;
+        sk_sp<const SkImage>    fImage;
+
+        bool canBatchWith(const Pending&) const;
+    };
+    SkTArray<Pending>   fPending;
+
+    // Returns the target canvas, after sending it any pending draws.
+    SkCanvas* target() {
+        this->flush_pending();
+        return fCanvas;
+    }
+
+    Pending* push_pending(Pending::Kind, const SkRect& geometry, const SkPaint*);
+    bool defer_rect(Pending::Kind, const SkRect&, const SkPaint&);
+    bool defer_rrect(const SkRRect&, const SkPaint&);
+    bool defer_image(const SkImage*, const SkRect* src, const SkRect& dst, const SkPaint*,
+                     SrcRectConstraint);
+    void flush_pending();
+    int emit_pending(const int order[], int count);
+
     typedef SkNoDrawCanvas INHERITED;
 };
 
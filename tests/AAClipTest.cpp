@@ -7,10 +7,14 @@
 
 #include "SkAAClip.h"
 #include "SkCanvas.h"
+#include "SkClipStack.h"
+#include "SkClipOpPriv.h"
+#include "SkColorSpace.h"
 #include "SkMask.h"
 #include "SkPath.h"
 #include "SkRandom.h"
 #include "SkRasterClip.h"
+#include "SkRasterClipCache.h"
 #include "SkRRect.h"
 #include "Test.h"
 
@@ -409,6 +413,148 @@ static void test_crbug_422693(skiatest::Reporter* reporter) {
     rc.op(path, SkMatrix::I(), rc.getBounds(), SkRegion::kIntersect_Op, true);
 }
 
+static const SkClipStack::Element* top_element(const SkClipStack& stack) {
+    SkClipStack::Iter iter(stack, SkClipStack::Iter::kTop_IterStart);
+    return iter.prev();
+}
+
+static void test_raster_clip_cache(skiatest::Reporter* reporter) {
+    SkResourceCache cache(1024 * 1024);
+
+    SkPath path;
+    path.addRoundRect(SkRect::MakeLTRB(10.5f, 10.5f, 90.5f, 90.5f), 8, 8);
+    path.addCircle(50, 50, 20);
+    path.setFillType(SkPath::kEvenOdd_FillType);
+
+    SkClipStack stack;
+    stack.clipPath(path, SkMatrix::I(), kIntersect_SkClipOp, true);
+    const SkClipStack::Element* element = top_element(stack);
+
+    const SkIRect devBounds = SkIRect::MakeWH(100, 100);
+    SkRasterClip prior(devBounds);
+    SkRasterClip expected(prior);
+    expected.op(path, SkMatrix::I(), devBounds, SkRegion::kIntersect_Op, true);
+
+    SkRasterClip result(devBounds);
+    REPORTER_ASSERT(reporter, !SkRasterClipCache::Find(prior, *element, devBounds, &result,
+                                                       &cache));
+    SkRasterClipCache::Add(prior, *element, devBounds, expected, &cache);
+    REPORTER_ASSERT(reporter, SkRasterClipCache::Find(prior, *element, devBounds, &result,
+                                                      &cache));
+    REPORTER_ASSERT(reporter, result == expected);
+
+    // The same element in another stack is found through its content hash.
+    SkClipStack otherStack;
+    otherStack.clipPath(path, SkMatrix::I(), kIntersect_SkClipOp, true);
+    const SkClipStack::Element* otherElement = top_element(otherStack);
+    REPORTER_ASSERT(reporter, otherElement->getContentHash() == element->getContentHash());
+    REPORTER_ASSERT(reporter, otherElement->getGenID() != element->getGenID());
+    REPORTER_ASSERT(reporter, SkRasterClipCache::Find(prior, *otherElement, devBounds, &result,
+                                                      &cache));
+
+    // A different prior clip, shape or set of device bounds is a miss.
+    SkRasterClip otherPrior(SkIRect::MakeWH(80, 100));
+    REPORTER_ASSERT(reporter, !SkRasterClipCache::Find(otherPrior, *element, devBounds, &result,
+                                                       &cache));
+    SkRasterClipCache::Add(prior, *element, devBounds, expected, &cache);
+    REPORTER_ASSERT(reporter, !SkRasterClipCache::Find(prior, *element, SkIRect::MakeWH(50, 50),
+                                                       &result, &cache));
+    SkPath otherPath(path);
+    otherPath.offset(1, 0);
+    otherStack.reset();
+    otherStack.clipPath(otherPath, SkMatrix::I(), kIntersect_SkClipOp, true);
+    REPORTER_ASSERT(reporter, !SkRasterClipCache::Find(prior, *top_element(otherStack), devBounds,
+                                                       &result, &cache));
+}
+
+// Drawing through a cached clip must look the same as drawing through a freshly built one.
+static void test_canvas_clip_cache(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.addRoundRect(SkRect::MakeLTRB(5.25f, 5.25f, 58.75f, 58.75f), 9, 9);
+    path.addCircle(32, 32, 11.5f);
+    path.setFillType(SkPath::kEvenOdd_FillType);
+    const SkRRect rrect = SkRRect::MakeRectXY(SkRect::MakeLTRB(2.5f, 2.5f, 61.5f, 61.5f), 7, 7);
+
+    SkBitmap bitmaps[3];
+    for (SkBitmap& bitmap : bitmaps) {
+        bitmap.allocN32Pixels(64, 64);
+        bitmap.eraseColor(SK_ColorTRANSPARENT);
+        SkCanvas canvas(bitmap);
+        canvas.clipRRect(rrect, true);
+        canvas.rotate(3);
+        canvas.clipPath(path, true);
+        canvas.drawColor(SK_ColorBLUE);
+    }
+    for (int i = 1; i < 3; ++i) {
+        REPORTER_ASSERT(reporter, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[i].getPixels(),
+                                              bitmaps[0].getSize()));
+    }
+}
+
+// An anti-aliased clip with many short runs per row is handed to the blitter as A8 rows. The
+// coverage that reaches the pixels must be the same as when it is handed over as runs.
+static void test_clipped_draws(skiatest::Reporter* reporter) {
+    const int kSize = 64;
+    SkPath clipPath;
+    for (int i = -10; i < 20; ++i) {
+        clipPath.addRect(SkRect::MakeXYWH(i * 5.0f, -32, 2.5f, 128));
+    }
+    SkMatrix rotate;
+    rotate.setRotate(20, 32, 32);
+    clipPath.transform(rotate);
+
+    SkRegion deviceRgn(SkIRect::MakeWH(kSize, kSize));
+    SkAAClip aaclip;
+    aaclip.setPath(clipPath, &deviceRgn, true);
+    SkMask clipMask;
+    aaclip.copyToMask(&clipMask);
+    SkAutoMaskFreeImage autoFree(clipMask.fImage);
+    auto clip_coverage = [&](int x, int y) -> int {
+        return clipMask.fBounds.contains(x, y) ? *clipMask.getAddr8(x, y) : 0;
+    };
+
+    SkPath circle;
+    circle.addCircle(31.5f, 33.25f, 25.3f);
+
+    sk_sp<SkColorSpace> colorSpaces[] = {
+        nullptr, SkColorSpace::MakeNamed(SkColorSpace::kSRGB_Named),
+    };
+    for (const sk_sp<SkColorSpace>& colorSpace : colorSpaces) {
+        SkImageInfo info = SkImageInfo::MakeN32Premul(kSize, kSize, colorSpace);
+        SkBitmap fill, circleCoverage, clippedCircle;
+        for (SkBitmap* bitmap : { &fill, &circleCoverage, &clippedCircle }) {
+            bitmap->allocPixels(info);
+            bitmap->eraseColor(SK_ColorTRANSPARENT);
+        }
+        SkPaint paint;
+        paint.setAntiAlias(true);
+        {
+            SkCanvas canvas(fill);
+            canvas.clipPath(clipPath, true);
+            canvas.drawPaint(paint);
+        }
+        SkCanvas(circleCoverage).drawPath(circle, paint);
+        {
+            SkCanvas canvas(clippedCircle);
+            canvas.clipPath(clipPath, true);
+            canvas.drawPath(circle, paint);
+        }
+
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                int clipA = clip_coverage(x, y);
+                int fillA = SkGetPackedA32(*fill.getAddr32(x, y));
+                REPORTER_ASSERT(reporter, SkTAbs(fillA - clipA) <= 1);
+
+                int circleA = SkGetPackedA32(*circleCoverage.getAddr32(x, y));
+                int expected = SkMulDiv255Round(circleA, clipA);
+                int clippedA = SkGetPackedA32(*clippedCircle.getAddr32(x, y));
+                REPORTER_ASSERT(reporter, SkTAbs(clippedA - expected) <= 2);
+            }
+        }
+    }
+}
+
 DEF_TEST(AAClip, reporter) {
     test_empty(reporter);
     test_path_bounds(reporter);
@@ -419,4 +565,7 @@ DEF_TEST(AAClip, reporter) {
     test_nearly_integral(reporter);
     test_really_a_rect(reporter);
     test_crbug_422693(reporter);
+    test_raster_clip_cache(reporter);
+    test_canvas_clip_cache(reporter);
+    test_clipped_draws(reporter);
 }
@@ -717,6 +717,7 @@ DEF_TEST(PaintFilterCanvas_ConsistentState, reporter) {
 
 #include "SkDeferredCanvas.h"
 #include "SkDumpCanvas.h"
+#include "SkImage.h"
 
 DEF_TEST(DeferredCanvas, r) {
     SkDebugfDumper dumper;
@@ -734,6 +735,83 @@ DEF_TEST(DeferredCanvas, r) {
     canvas.restore();
 }
 
+static void draw_deferred_content(SkCanvas* canvas, const sk_sp<SkImage>& image) {
+    SkPaint red, blue, aa;
+    red.setColor(SK_ColorRED);
+    blue.setColor(0x800000FF);
+    aa.setAntiAlias(true);
+    aa.setColor(SK_ColorGREEN);
+
+    canvas->clear(SK_ColorWHITE);
+    for (int i = 0; i < 8; ++i) {
+        SkScalar x = SkIntToScalar(i * 12);
+        canvas->drawRect(SkRect::MakeXYWH(x, 0, 10, 10), red);
+        canvas->drawRect(SkRect::MakeXYWH(x, 20, 10, 10), blue);
+        canvas->drawImage(image, x, 40);
+        canvas->drawOval(SkRect::MakeXYWH(x + 0.5f, 60, 9, 9), aa);
+    }
+    // Overlapping draws must keep their order.
+    canvas->drawRect(SkRect::MakeXYWH(2, 2, 30, 30), blue);
+    canvas->drawRect(SkRect::MakeXYWH(4, 4, 30, 30), red);
+    canvas->save();
+    canvas->translate(5, 70);
+    canvas->clipRect(SkRect::MakeWH(50, 20));
+    canvas->drawRect(SkRect::MakeWH(60, 10), red);
+    canvas->drawImageRect(image, SkRect::MakeXYWH(10, 5, 20, 20), nullptr);
+    canvas->restore();
+    canvas->drawRect(SkRect::MakeXYWH(0, 90, 100, 10), blue);
+}
+
+DEF_TEST(DeferredCanvas_lazy, r) {
+    sk_sp<SkSurface> tile = SkSurface::MakeRasterN32Premul(10, 10);
+    tile->getCanvas()->clear(SK_ColorYELLOW);
+    tile->getCanvas()->drawCircle(5, 5, 3, SkPaint());
+    sk_sp<SkImage> image = tile->makeImageSnapshot();
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(100, 100);
+    actual.allocN32Pixels(100, 100);
+
+    SkCanvas direct(expected);
+    draw_deferred_content(&direct, image);
+
+    SkCanvas target(actual);
+    SkDeferredCanvas deferred(&target, SkDeferredCanvas::kLazy);
+    draw_deferred_content(&deferred, image);
+    deferred.flush();
+
+    for (int y = 0; y < 100; ++y) {
+        for (int x = 0; x < 100; ++x) {
+            if (*expected.getAddr32(x, y) != *actual.getAddr32(x, y)) {
+                ERRORF(r, "pixel mismatch at (%d, %d): %08x vs %08x", x, y,
+                       *expected.getAddr32(x, y), *actual.getAddr32(x, y));
+                return;
+            }
+        }
+    }
+}
+
+// Draws still held back by a lazy canvas are sent on when it goes away.
+DEF_TEST(DeferredCanvas_lazyDestroyedWithoutFlush, r) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(20, 20);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas target(bitmap);
+
+    SkPaint red;
+    red.setColor(SK_ColorRED);
+    {
+        SkDeferredCanvas deferred(&target, SkDeferredCanvas::kLazy);
+        deferred.translate(5, 5);
+        deferred.drawRect(SkRect::MakeWH(10, 10), red);
+        deferred.drawOval(SkRect::MakeXYWH(-5, -5, 4, 4), red);
+    }
+    REPORTER_ASSERT(r, SK_ColorRED == bitmap.getColor(10, 10));
+    REPORTER_ASSERT(r, SK_ColorRED == bitmap.getColor(2, 2));
+    REPORTER_ASSERT(r, SK_ColorWHITE == bitmap.getColor(17, 17));
+    REPORTER_ASSERT(r, 1 == target.getSaveCount());
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
 #include "SkCanvasStack.h"
@@ -5,11 +5,13 @@
  * found in the LICENSE file.
  */
 
+#include "SkAnimationDecoder.h"
 #include "SkBitmap.h"
 #include "SkCodec.h"
 #include "SkCommonFlags.h"
 #include "SkImageEncoder.h"
 #include "SkOSPath.h"
+#include "SkResourceCache.h"
 #include "SkStream.h"
 
 #include "Resources.h"
@@ -182,3 +184,65 @@ DEF_TEST(Codec_frames, r) {
         }
     }
 }
+
+// Every frame from SkAnimationDecoder, in any order and whether prefetched or not, should match
+// what SkCodec produces when asked for that frame on its own.
+DEF_TEST(Codec_animationDecoder, r) {
+    for (const char* name : { "randPixelsAnim.gif", "test640x479.gif", "colorTables.gif" }) {
+        sk_sp<SkData> data(GetResourceAsData(name));
+        if (!data) {
+            continue;
+        }
+        std::unique_ptr<SkCodec> codec(SkCodec::NewFromData(data));
+        SkResourceCache cache(16 * 1024 * 1024);
+        std::unique_ptr<SkAnimationDecoder> decoder = SkAnimationDecoder::Make(data, &cache);
+        if (!codec || !decoder) {
+            ERRORF(r, "Could not create decoder for %s", name);
+            continue;
+        }
+
+        const SkImageInfo info = decoder->info();
+        const int frameCount = decoder->frameCount();
+        REPORTER_ASSERT(r, frameCount == SkTMax<int>(1, SkToInt(codec->getFrameInfo().size())));
+
+        auto check = [&](int index) {
+            SkBitmap expected;
+            expected.allocPixels(info);
+            SkCodec::Options opts;
+            opts.fFrameIndex = index;
+            SkCodec::Result result = codec->getPixels(info, expected.getPixels(),
+                                                      expected.rowBytes(), &opts, nullptr, nullptr);
+            REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+
+            SkBitmap actual;
+            if (!decoder->getFrame(index, &actual)) {
+                ERRORF(r, "%s: could not get frame %i", name, index);
+                return;
+            }
+            REPORTER_ASSERT(r, actual.info() == info);
+            const size_t rowLen = info.bytesPerPixel() * info.width();
+            for (int y = 0; y < info.height(); y++) {
+                if (memcmp(expected.getAddr(0, y), actual.getAddr(0, y), rowLen)) {
+                    ERRORF(r, "%s: frame %i differs from SkCodec", name, index);
+                    break;
+                }
+            }
+        };
+
+        // Seek backwards first, so that each frame has to walk its chain.
+        for (int i = frameCount - 1; i >= 0; --i) {
+            check(i);
+        }
+
+        // Then again from a decoder that prefetched everything in parallel.
+        decoder = SkAnimationDecoder::Make(data, &cache);
+        decoder->prefetch(0, frameCount);
+        for (int i = 0; i < frameCount; ++i) {
+            check(i);
+        }
+
+        SkBitmap bm;
+        REPORTER_ASSERT(r, !decoder->getFrame(-1, &bm));
+        REPORTER_ASSERT(r, !decoder->getFrame(frameCount, &bm));
+    }
+}
@@ -10,6 +10,8 @@
 #include "SkData.h"
 #include "SkImageInfo.h"
 #include "SkRWBuffer.h"
+#include "SkRandom.h"
+#include "SkStreamingCodec.h"
 #include "SkString.h"
 
 #include "FakeStreams.h"
@@ -139,6 +141,92 @@ DEF_TEST(Codec_partial, r) {
     test_partial(r, "color_wheel.gif");
 }
 
+// Feeds the file to an SkStreamingCodec in random-sized chunks, decoding after each one.
+static void test_streaming(skiatest::Reporter* r, const char* name, bool expectIncremental) {
+    sk_sp<SkData> file = make_from_resource(name);
+    if (!file) {
+        SkDebugf("missing resource %s\n", name);
+        return;
+    }
+
+    SkBitmap truth;
+    if (!create_truth(file, &truth)) {
+        ERRORF(r, "Failed to decode %s\n", name);
+        return;
+    }
+
+    SkBitmap streamed;
+    streamed.allocPixels(truth.info());
+    streamed.eraseColor(SK_ColorTRANSPARENT);
+
+    SkStreamingCodec streaming;
+    REPORTER_ASSERT(r, streaming.setDestination(streamed.info(), streamed.getPixels(),
+                                                streamed.rowBytes()));
+    SkRandom rand;
+    const char* bytes = static_cast<const char*>(file->data());
+    size_t offset = 0;
+    int lastReady = 0;
+    SkCodec::Result result = SkCodec::kIncompleteInput;
+    while (SkCodec::kIncompleteInput == result && offset < file->size()) {
+        const size_t chunk = SkTMin<size_t>(rand.nextRangeU(1, 2000), file->size() - offset);
+        streaming.append(bytes + offset, chunk);
+        offset += chunk;
+        if (offset == file->size()) {
+            streaming.setAllDataReceived();
+        }
+        result = streaming.decode();
+
+        const SkIRect ready = streaming.readyRows();
+        REPORTER_ASSERT(r, ready.height() >= lastReady);
+        lastReady = ready.height();
+    }
+
+    REPORTER_ASSERT(r, SkCodec::kSuccess == result);
+    REPORTER_ASSERT(r, streaming.readyRows() == truth.bounds());
+    REPORTER_ASSERT(r, streaming.bytesReceived() == file->size());
+    compare_bitmaps(r, truth, streamed);
+
+    if (expectIncremental) {
+        // Only the header may be read more than once, while the codec is being created.
+        REPORTER_ASSERT(r, streaming.bytesReparsed() < 1024);
+    }
+}
+
+DEF_TEST(Codec_streaming, r) {
+    test_streaming(r, "plane.png", true);
+    test_streaming(r, "plane_interlaced.png", true);
+    test_streaming(r, "yellow_rose.png", true);
+    test_streaming(r, "mandrill_256.png", true);
+    test_streaming(r, "box.gif", true);
+    test_streaming(r, "color_wheel.gif", true);
+    test_streaming(r, "randPixels.bmp", false);
+    test_streaming(r, "mandrill_512_q075.jpg", false);
+}
+
+DEF_TEST(Codec_streamingDestination, r) {
+    sk_sp<SkData> file = make_from_resource("plane.png");
+    if (!file) {
+        return;
+    }
+
+    SkBitmap bm;
+    bm.allocN32Pixels(16, 16);
+
+    SkStreamingCodec streaming;
+    REPORTER_ASSERT(r, !streaming.setDestination(bm.info(), nullptr, bm.rowBytes()));
+    REPORTER_ASSERT(r, !streaming.setDestination(bm.info(), bm.getPixels(), bm.rowBytes() - 1));
+    REPORTER_ASSERT(r, !streaming.setDestination(SkImageInfo::MakeN32Premul(0, 16),
+                                                 bm.getPixels(), bm.rowBytes()));
+    REPORTER_ASSERT(r, SkCodec::kInvalidParameters == streaming.decode());
+
+    // plane.png is not 16x16: that is only found out once the header is there.
+    REPORTER_ASSERT(r, streaming.setDestination(bm.info(), bm.getPixels(), bm.rowBytes()));
+    streaming.append(file->data(), file->size());
+    streaming.setAllDataReceived();
+    REPORTER_ASSERT(r, SkCodec::kInvalidScale == streaming.decode());
+    REPORTER_ASSERT(r, !streaming.setDestination(bm.info(), bm.getPixels(), bm.rowBytes()));
+}
+
 DEF_TEST(Codec_partialAnim, r) {
     auto path = "test640x479.gif";
     sk_sp<SkData> file = make_from_resource(path);
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkBBHFactory.h"
+#include "SkCanvas.h"
+#include "SkImage.h"
+#include "SkPictureRecorder.h"
+#include "SkRRect.h"
+#include "SkSurface.h"
+#include "SkTextBlob.h"
+#include "Test.h"
+
+static const int kSize = 256;
+
+static sk_sp<SkPicture> make_picture(uint32_t recordFlags, SkBBHFactory* factory = nullptr) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kSize, kSize, factory, recordFlags);
+
+    // Lots of rects in a few paints, some on whole pixels and some not.
+    SkPaint paints[3];
+    paints[0].setColor(SK_ColorRED);
+    paints[1].setColor(0x8000FF00);
+    paints[1].setAntiAlias(true);
+    paints[2].setColor(SK_ColorBLUE);
+    paints[2].setStyle(SkPaint::kStroke_Style);
+    for (int y = 0; y < kSize; y += 8) {
+        for (int x = 0; x < kSize; x += 8) {
+            const SkPaint& paint = paints[(x + y) / 8 % 3];
+            if (y < kSize / 2) {
+                canvas->drawRect(SkRect::MakeXYWH(x, y, 6, 6), paint);
+            } else {
+                canvas->drawRect(SkRect::MakeXYWH(x + 0.5f, y + 0.25f, 5.5f, 6), paint);
+            }
+        }
+    }
+
+    SkPath path;
+    path.moveTo(0, 0);
+    path.lineTo(20, 5);
+    path.quadTo(10, 20, 0, 15);
+    path.close();
+    sk_sp<SkImage> image;
+    {
+        auto surface = SkSurface::MakeRasterN32Premul(16, 16);
+        surface->getCanvas()->clear(SK_ColorYELLOW);
+        surface->getCanvas()->drawCircle(8, 8, 6, paints[2]);
+        image = surface->makeImageSnapshot();
+    }
+
+    canvas->save();
+        canvas->translate(30, 40);
+        canvas->clipRRect(SkRRect::MakeRectXY(SkRect::MakeWH(150, 120), 10, 10),
+                          SkClipOp::kIntersect, true);
+        for (int i = 0; i < 5; i++) {
+            canvas->drawPath(path, paints[i % 3]);
+            canvas->translate(20, 10);
+        }
+        canvas->drawOval(SkRect::MakeLTRB(0, 0, 40, 25), paints[1]);
+        canvas->drawRRect(SkRRect::MakeRectXY(SkRect::MakeLTRB(-30, -20, 0, 0), 4, 6), paints[0]);
+        canvas->drawImage(image, 10, 30);
+        canvas->drawImageRect(image, SkRect::MakeXYWH(4, 4, 8, 8),
+                              SkRect::MakeXYWH(-50, 10, 40.5f, 30), &paints[1]);
+    canvas->restore();
+
+    SkMatrix perspective;
+    perspective.setAll(1, 0.1f, 20, 0, 1, 150, 0.001f, 0, 1);
+    canvas->save();
+        canvas->concat(perspective);
+        canvas->clipRect(SkRect::MakeLTRB(0, 0, 100.5f, 60), SkClipOp::kIntersect, true);
+        canvas->drawPaint(paints[1]);
+    canvas->restore();
+
+    // These are kept as SkRecords ops.
+    SkPaint text;
+    text.setTextSize(20);
+    text.setAntiAlias(true);
+    canvas->drawText("compact", 7, 130, 220, text);
+    SkPaint glyphs(text);
+    glyphs.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+    SkTextBlobBuilder builder;
+    const SkTextBlobBuilder::RunBuffer& run = builder.allocRun(glyphs, 3, 0, 0);
+    text.textToGlyphs("abc", 3, run.glyphs);
+    sk_sp<SkTextBlob> blob = builder.make();
+    canvas->drawTextBlob(blob, 10, 240, paints[0]);
+    SkPoint points[] = { { 200, 20 }, { 240, 60 }, { 210, 90 } };
+    canvas->drawPoints(SkCanvas::kPolygon_PointMode, 3, points, paints[2]);
+    canvas->saveLayer(nullptr, &paints[1]);
+        canvas->clipPath(path, SkClipOp::kDifference, true);
+        canvas->drawCircle(10, 10, 30, paints[0]);
+    canvas->restore();
+    canvas->setMatrix(SkMatrix::MakeScale(2, 1.5f));
+    canvas->drawTextBlob(blob, 60, 150, paints[2]);
+
+    return recorder.finishRecordingAsPicture();
+}
+
+static SkBitmap draw(const SkPicture* picture, const SkRect& clip) {
+    SkBitmap bitmap;
+    bitmap.allocN32Pixels(kSize, kSize);
+    bitmap.eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(bitmap);
+    canvas.clipRect(clip);
+    picture->playback(&canvas);
+    return bitmap;
+}
+
+static bool same_pixels(const SkBitmap& a, const SkBitmap& b) {
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+DEF_TEST(CompactPicture, r) {
+    sk_sp<SkPicture> big     = make_picture(0),
+                     compact = make_picture(SkPictureRecorder::kCompact_RecordFlag);
+    REPORTER_ASSERT(r, big->asSkBigPicture());
+    REPORTER_ASSERT(r, !compact->asSkBigPicture());
+    REPORTER_ASSERT(r, compact->approximateOpCount() == big->approximateOpCount());
+    REPORTER_ASSERT(r, compact->willPlayBackBitmaps());
+    REPORTER_ASSERT(r, compact->cullRect() == big->cullRect());
+
+    // Mostly rects in a few paints: the compact ops are a fraction of the size.
+    REPORTER_ASSERT(r, compact->approximateBytesUsed() * 4 < big->approximateBytesUsed());
+
+    const SkRect all = SkRect::MakeWH(kSize, kSize);
+    REPORTER_ASSERT(r, same_pixels(draw(big.get(), all), draw(compact.get(), all)));
+
+    // Playing back through the picture's serialized form.
+    sk_sp<SkData> data = compact->serialize();
+    sk_sp<SkPicture> copy = SkPicture::MakeFromData(data.get());
+    REPORTER_ASSERT(r, copy);
+    if (copy) {
+        REPORTER_ASSERT(r, same_pixels(draw(big.get(), all), draw(copy.get(), all)));
+    }
+}
+
+DEF_TEST(CompactPicture_BBH, r) {
+    SkRTreeFactory factory;
+    sk_sp<SkPicture> big     = make_picture(0, &factory),
+                     compact = make_picture(SkPictureRecorder::kCompact_RecordFlag, &factory);
+    REPORTER_ASSERT(r, compact->cullRect() == big->cullRect());
+
+    for (int y = 0; y < kSize; y += 64) {
+        for (int x = 0; x < kSize; x += 64) {
+            const SkRect tile = SkRect::MakeXYWH(x, y, 64, 64);
+            REPORTER_ASSERT(r, same_pixels(draw(big.get(), tile), draw(compact.get(), tile)));
+        }
+    }
+}
@@ -11,6 +11,7 @@
 #include "SkWriteBuffer.h"
 #include "SkStrokeRec.h"
 #include "SkCanvas.h"
+#include "SkDraw.h"
 #include "SkSurface.h"
 
 // crbug.com/348821 was rooted in SkDashPathEffect refusing to flatten and unflatten itself when
@@ -115,3 +116,208 @@ DEF_TEST(DashPathEffectTest_asPoints_limit, r) {
     p.setPathEffect(SkDashPathEffect::Make(intervals, SK_ARRAY_COUNT(intervals), 0));
     canvas->drawLine(1, 1, 1, 5.0e10f, p);
 }
+
+static bool draws_same(skiatest::Reporter* r, const SkPath& path, const SkPaint& paint,
+                       const SkMatrix& matrix, const SkRect& clip, int tolerance) {
+    SkImageInfo info = SkImageInfo::MakeN32Premul(200, 200);
+    sk_sp<SkSurface> surface(SkSurface::MakeRaster(info));
+    surface->getCanvas()->clear(SK_ColorWHITE);
+    surface->getCanvas()->clipRect(clip, paint.isAntiAlias());
+    surface->getCanvas()->setMatrix(matrix);
+    surface->getCanvas()->drawPath(path, paint);
+
+    // Draw the dashed path itself, already in device space.
+    SkPath dashed;
+    bool fill = paint.getFillPath(path, &dashed, nullptr,
+                                  SkDraw::ComputeResScaleForStroking(matrix));
+    dashed.transform(matrix);
+    SkPaint plain(paint);
+    plain.setPathEffect(nullptr);
+    plain.setStyle(fill ? SkPaint::kFill_Style : SkPaint::kStroke_Style);
+    plain.setStrokeWidth(0);
+    sk_sp<SkSurface> expected(SkSurface::MakeRaster(info));
+    expected->getCanvas()->clear(SK_ColorWHITE);
+    expected->getCanvas()->clipRect(clip, paint.isAntiAlias());
+    expected->getCanvas()->drawPath(dashed, plain);
+
+    SkBitmap a, b;
+    a.allocPixels(info);
+    b.allocPixels(info);
+    surface->readPixels(a.info(), a.getPixels(), a.rowBytes(), 0, 0);
+    expected->readPixels(b.info(), b.getPixels(), b.rowBytes(), 0, 0);
+    for (int y = 0; y < info.height(); ++y) {
+        for (int x = 0; x < info.width(); ++x) {
+            SkPMColor c0 = *a.getAddr32(x, y),
+                      c1 = *b.getAddr32(x, y);
+            for (int shift = 0; shift < 32; shift += 8) {
+                if (SkTAbs((int)((c0 >> shift) & 0xFF) - (int)((c1 >> shift) & 0xFF)) >
+                        tolerance) {
+                    ERRORF(r, "pixel (%d, %d): %08x vs %08x", x, y, c0, c1);
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// Dashed hairlines are drawn a dash at a time, and dashed butt-capped rects as rects; both must
+// match drawing the dashed path.
+DEF_TEST(DashPathEffectTest_drawDashes, r) {
+    SkPath paths[5];
+    paths[0].addCircle(100, 100, 80);
+    paths[1].moveTo(10, 20);
+    paths[1].lineTo(190, 60);
+    paths[1].lineTo(20, 170);
+    paths[1].cubicTo(60, 10, 150, 190, 180, 180);
+    paths[2].addRect(SkRect::MakeLTRB(20, 30, 170, 180));
+    paths[3].addOval(SkRect::MakeLTRB(30, 60, 170, 140));
+    paths[3].addRect(SkRect::MakeLTRB(60, 20, 140, 180), SkPath::kCCW_Direction);
+    paths[4].moveTo(15, 15);
+    paths[4].lineTo(185, 15);
+    paths[4].lineTo(185, 185);
+    paths[4].lineTo(15, 185);
+
+    const SkScalar intervals[] = { 7, 3, 1.5f, 4.25f };
+    SkMatrix matrices[3];
+    matrices[0].reset();
+    matrices[1].setScale(0.75f, 0.5f, 100, 100);
+    matrices[2].setRotate(20, 100, 100);
+    const SkRect clips[] = { SkRect::MakeWH(200, 200), SkRect::MakeLTRB(40.5f, 0, 150, 120.5f) };
+
+    for (const SkPath& path : paths) {
+        for (const SkMatrix& matrix : matrices) {
+            for (bool aa : { false, true }) {
+                for (SkPaint::Cap cap : { SkPaint::kButt_Cap, SkPaint::kSquare_Cap,
+                                          SkPaint::kRound_Cap }) {
+                    for (SkScalar phase : { 0.0f, 5.5f }) {
+                        for (const SkRect& clip : clips) {
+                            SkPaint paint;
+                            paint.setAntiAlias(aa);
+                            paint.setStyle(SkPaint::kStroke_Style);
+                            paint.setStrokeCap(cap);
+                            paint.setColor(0x80204080);
+                            paint.setPathEffect(SkDashPathEffect::Make(intervals, 4, phase));
+                            // Blitting through an AA clip can round a little differently.
+                            int tolerance = aa && &clip != clips ? 2 : 0;
+                            if (!draws_same(r, path, paint, matrix, clip, tolerance)) {
+                                return;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // Pixel-aligned rects are covered exactly either way.
+    const SkScalar rectIntervals[] = { 6, 4 };
+    for (int i : { 2, 4 }) {
+        for (bool aa : { false, true }) {
+            SkPaint paint;
+            paint.setAntiAlias(aa);
+            paint.setStyle(SkPaint::kStroke_Style);
+            paint.setStrokeWidth(2);
+            paint.setPathEffect(SkDashPathEffect::Make(rectIntervals, 2, 0));
+            if (!draws_same(r, paths[i], paint, SkMatrix::I(), clips[0], 0)) {
+                return;
+            }
+        }
+    }
+}
+
+// Dashes that overlap or touch are filled together, so a translucent paint covers them once and
+// AA leaves no seam between them, just as when filling the stroked dashed path.
+DEF_TEST(DashPathEffectTest_overlappingDashRects, r) {
+    SkPath paths[4];
+    // Crossing horizontal and vertical contours.
+    paths[0].moveTo(20, 100.5f);
+    paths[0].lineTo(180, 100.5f);
+    paths[0].moveTo(99.75f, 20);
+    paths[0].lineTo(99.75f, 180);
+    // A line that doubles back on itself.
+    paths[1].moveTo(20.25f, 50);
+    paths[1].lineTo(170.5f, 50);
+    paths[1].lineTo(40, 50);
+    // A closed contour whose first and last dashes meet on a straight edge.
+    paths[2].moveTo(100, 30);
+    paths[2].lineTo(170, 30);
+    paths[2].lineTo(170, 170);
+    paths[2].lineTo(30, 170);
+    paths[2].lineTo(30, 30);
+    paths[2].close();
+    // A line that crosses itself.
+    paths[3].moveTo(40, 60.3f);
+    paths[3].lineTo(160, 60.3f);
+    paths[3].lineTo(160, 140);
+    paths[3].lineTo(80.6f, 140);
+    paths[3].lineTo(80.6f, 20);
+
+    const SkScalar intervals[] = { 10.3f, 5.1f };
+    // A zero off interval makes the dashes abut at fractional positions.
+    const SkScalar touching[] = { 7.7f, 0 };
+    const SkMatrix matrices[] = { SkMatrix::I(), SkMatrix::MakeScale(1.1f, 0.9f) };
+    for (const SkPath& path : paths) {
+        for (const SkMatrix& matrix : matrices) {
+            for (bool aa : { false, true }) {
+                for (SkScalar phase : { 0.0f, 3.7f }) {
+                    for (bool abut : { false, true }) {
+                        SkPaint paint;
+                        paint.setAntiAlias(aa);
+                        paint.setStyle(SkPaint::kStroke_Style);
+                        paint.setStrokeWidth(5.5f);
+                        paint.setColor(0x80204080);
+                        paint.setPathEffect(abut ? SkDashPathEffect::Make(touching, 2, phase)
+                                                 : SkDashPathEffect::Make(intervals, 2, phase));
+                        if (!draws_same(r, path, paint, matrix, SkRect::MakeWH(200, 200), 0)) {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Dashed rects far outside the clip are skipped a whole dash period at a time; the dashes that
+// are drawn must stay in phase with those of the uncut dashed path. Integer intervals keep every
+// dash edge clear of pixel and sample boundaries, so rounding along these long lines is moot.
+DEF_TEST(DashPathEffectTest_culledDashRects, r) {
+    SkPath paths[3];
+    // Long lines running off both sides of the canvas.
+    paths[0].moveTo(-2000.1f, 100.3f);
+    paths[0].lineTo(2200.1f, 100.3f);
+    paths[0].moveTo(60.5f, 3000.3f);
+    paths[0].lineTo(60.5f, -3000.3f);
+    // A line that leaves the canvas and comes back.
+    paths[1].moveTo(20.1f, 40.3f);
+    paths[1].lineTo(900.1f, 40.3f);
+    paths[1].lineTo(900.1f, 150.1f);
+    paths[1].lineTo(30.1f, 150.1f);
+    // A closed contour mostly outside the canvas.
+    paths[2].moveTo(-500.1f, 20.3f);
+    paths[2].lineTo(180.1f, 20.3f);
+    paths[2].lineTo(180.1f, 500.3f);
+    paths[2].lineTo(-500.1f, 500.3f);
+    paths[2].close();
+
+    const SkScalar intervals[] = { 10, 5, 3, 4 };
+    const SkMatrix matrices[] = { SkMatrix::I(), SkMatrix::MakeScale(2, 0.5f) };
+    for (const SkPath& path : paths) {
+        for (const SkMatrix& matrix : matrices) {
+            for (bool aa : { false, true }) {
+                for (SkScalar phase : { 0.0f, 3.0f }) {
+                    SkPaint paint;
+                    paint.setAntiAlias(aa);
+                    paint.setStyle(SkPaint::kStroke_Style);
+                    paint.setStrokeWidth(3);
+                    paint.setColor(0x80204080);
+                    paint.setPathEffect(SkDashPathEffect::Make(intervals, 4, phase));
+                    if (!draws_same(r, path, paint, matrix, SkRect::MakeWH(200, 200), 0)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkDistanceFieldGen.h"
+#include "SkPath.h"
+#include "SkRandom.h"
+#include "SkSurface.h"
+#include "SkTArray.h"
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+#include "GrContext.h"
+#endif
+
+// SkGenerateDistanceFields() must produce exactly what generating each field alone does.
+DEF_TEST(DistanceField_Batch, reporter) {
+    static const int kCount = 37;  // not a multiple of the number of fields per task
+
+    SkRandom rand;
+    SkTArray<std::unique_ptr<unsigned char[]>> images, expected, actual;
+    SkTArray<SkDistanceFieldRequest> requests;
+    for (int i = 0; i < kCount; ++i) {
+        int width = 1 + rand.nextULessThan(40);
+        int height = 1 + rand.nextULessThan(40);
+        bool isBW = rand.nextBool();
+        size_t rowBytes = isBW ? (width + 7) / 8 : width;
+        images.emplace_back(new unsigned char[rowBytes * height]);
+        for (size_t j = 0; j < rowBytes * height; ++j) {
+            images.back()[j] = rand.nextBool() ? 0 : (isBW ? rand.nextU() : 0xFF);
+        }
+
+        size_t size = SkComputeDistanceFieldSize(width, height);
+        expected.emplace_back(new unsigned char[size]);
+        actual.emplace_back(new unsigned char[size]);
+        bool ok = isBW
+                ? SkGenerateDistanceFieldFromBWImage(expected.back().get(), images.back().get(),
+                                                     width, height, rowBytes)
+                : SkGenerateDistanceFieldFromA8Image(expected.back().get(), images.back().get(),
+                                                     width, height, rowBytes);
+        REPORTER_ASSERT(reporter, ok);
+        requests.push_back({ actual.back().get(), images.back().get(), width, height, rowBytes,
+                             isBW });
+    }
+
+    REPORTER_ASSERT(reporter, SkGenerateDistanceFields(requests.begin(), kCount));
+    for (int i = 0; i < kCount; ++i) {
+        size_t size = SkComputeDistanceFieldSize(requests[i].fWidth, requests[i].fHeight);
+        REPORTER_ASSERT(reporter, 0 == memcmp(expected[i].get(), actual[i].get(), size));
+    }
+
+    // Small batches are generated without the task group.
+    REPORTER_ASSERT(reporter, SkGenerateDistanceFields(requests.begin(), 2));
+    REPORTER_ASSERT(reporter, SkGenerateDistanceFields(requests.begin(), 0));
+}
+
+#if SK_SUPPORT_GPU
+
+// Concave paths in a grid of cells, so that the distance field path renderer draws them.
+static void draw_df_paths(SkCanvas* canvas, bool flushEach) {
+    static const int kColumns = 10, kRows = 8, kCell = 30;
+
+    SkRandom rand;
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    canvas->clear(SK_ColorWHITE);
+    for (int y = 0; y < kRows; ++y) {
+        for (int x = 0; x < kColumns; ++x) {
+            SkPath path;
+            path.moveTo(rand.nextRangeF(0, 10), rand.nextRangeF(0, 10));
+            path.lineTo(rand.nextRangeF(10, 25), rand.nextRangeF(0, 5));
+            path.lineTo(rand.nextRangeF(10, 15), rand.nextRangeF(10, 15));
+            path.lineTo(rand.nextRangeF(20, 25), rand.nextRangeF(20, 25));
+            path.lineTo(rand.nextRangeF(0, 5), rand.nextRangeF(15, 25));
+            path.close();
+            path.offset(SkIntToScalar(x * kCell + 2), SkIntToScalar(y * kCell + 2));
+            paint.setColor(0xFF000000 | rand.nextU());
+            canvas->drawPath(path, paint);
+            if (flushEach) {
+                canvas->flush();
+            }
+        }
+    }
+    canvas->flush();
+}
+
+// The paths' distance fields are generated in parallel, in batches, when they are drawn by one
+// op, and one at a time when each op has one path. The results must be the same.
+DEF_GPUTEST_FOR_RENDERING_CONTEXTS(DistanceField_PathOpBatch, reporter, ctxInfo) {
+    GrContext* context = ctxInfo.grContext();
+    SkImageInfo info = SkImageInfo::MakeN32Premul(300, 240);
+    SkBitmap batched, serial;
+    batched.allocPixels(info);
+    serial.allocPixels(info);
+
+    sk_sp<SkSurface> surface(SkSurface::MakeRenderTarget(context, SkBudgeted::kNo, info));
+    if (!surface) {
+        return;
+    }
+    draw_df_paths(surface->getCanvas(), false);
+    surface->readPixels(info, batched.getPixels(), batched.rowBytes(), 0, 0);
+
+    // Drops the path renderers, and with them the cached distance fields.
+    context->freeGpuResources();
+    draw_df_paths(surface->getCanvas(), true);
+    surface->readPixels(info, serial.getPixels(), serial.rowBytes(), 0, 0);
+
+    REPORTER_ASSERT(reporter, 0 == memcmp(batched.getPixels(), serial.getPixels(),
+                                          batched.getSize()));
+}
+
+#endif
@@ -5,10 +5,17 @@
  * found in the LICENSE file.
  */
 
+#include "SkBitmap.h"
 #include "SkBlitter.h"
+#include "SkImagePriv.h"
+#include "SkPaint.h"
 #include "SkPath.h"
+#include "SkRandom.h"
+#include "SkRasterClip.h"
 #include "SkRegion.h"
 #include "SkScan.h"
+#include "SkScanPriv.h"
+#include "SkString.h"
 #include "Test.h"
 
 struct FakeBlitter : public SkBlitter {
@@ -46,3 +53,106 @@ DEF_TEST(FillPathInverse, reporter) {
 
     REPORTER_ASSERT(reporter, blitter.m_blitCount == expected_lines);
 }
+
+// Notes every span, in order.
+struct SpanLogBlitter : public SkBlitter {
+    void blitH(int x, int y, int width) override {
+        fLog.appendf("%d,%d,%d\n", x, y, width);
+    }
+
+    void blitAntiH(int x, int y, const SkAlpha antialias[], const int16_t runs[]) override {
+        SkDEBUGFAIL("blitAntiH not implemented");
+    }
+
+    SkString fLog;
+};
+
+// A big self-intersecting path, about 320x320.
+static SkPath make_band_test_path() {
+    SkRandom rand;
+    SkPath path;
+    path.moveTo(0, 0);
+    for (int i = 0; i < 40; i++) {
+        path.lineTo(rand.nextRangeF(-10, 330), rand.nextRangeF(-10, 330));
+        path.quadTo(rand.nextRangeF(0, 320), rand.nextRangeF(0, 320),
+                    rand.nextRangeF(0, 320), rand.nextRangeF(0, 320));
+        path.cubicTo(rand.nextRangeF(0, 320), rand.nextRangeF(0, 320),
+                     rand.nextRangeF(0, 320), rand.nextRangeF(0, 320),
+                     rand.nextRangeF(0, 320), rand.nextRangeF(0, 320));
+    }
+    path.close();
+    return path;
+}
+
+// Walking the edges in bands of rows must blit just what walking them row by row does.
+DEF_TEST(FillPathBands, reporter) {
+    SkPath path = make_band_test_path();
+    SkIRect bounds;
+    path.getBounds().roundOut(&bounds);
+
+    const int kShift = 2;  // as when supersampling
+    for (SkPath::FillType fillType : { SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType }) {
+        path.setFillType(fillType);
+        for (const SkIRect& clip : { SkIRect::MakeLTRB(-20, -20, 340, 340),
+                                     SkIRect::MakeLTRB(7, 30, 290, 301) }) {
+            const bool contained = clip.contains(bounds);
+            SpanLogBlitter rows;
+            sk_fill_path(path, clip, &rows, bounds.fTop, bounds.fBottom, kShift, contained);
+            REPORTER_ASSERT(reporter, !rows.fLog.isEmpty());
+
+            for (int bandCount : { 1, 2, 5 }) {
+                SpanLogBlitter bands[5];
+                SkBlitter* blitters[5];
+                for (int i = 0; i < bandCount; i++) {
+                    blitters[i] = &bands[i];
+                }
+                sk_fill_path_bands(path, clip, blitters, bandCount, bounds.fTop, bounds.fBottom,
+                                   kShift, contained);
+                SkString log;
+                for (int i = 0; i < bandCount; i++) {
+                    REPORTER_ASSERT(reporter, !bands[i].fLog.isEmpty());
+                    log.append(bands[i].fLog);
+                }
+                REPORTER_ASSERT(reporter, rows.fLog.equals(log));
+            }
+        }
+    }
+}
+
+static void anti_fill_path(const SkPath& path, const SkIRect& clip, int bandCount,
+                           SkBitmap* bitmap) {
+    bitmap->allocN32Pixels(340, 340);
+    bitmap->eraseColor(SK_ColorWHITE);
+    SkPixmap pixmap;
+    bitmap->peekPixels(&pixmap);
+    SkPaint paint;
+    paint.setColor(0xC0204080);
+    SkTBlitterAllocator allocator;
+    SkBlitter* blitter = SkBlitter::Choose(pixmap, SkMatrix::I(), paint, &allocator);
+
+    SkScan::SupersampleFillPath(path, SkRasterClip(clip), blitter, bandCount);
+}
+
+// Supersampling in bands, with their rows replayed into the real blitter, must draw just what
+// supersampling the whole path at once does.
+DEF_TEST(AntiFillPathBands, reporter) {
+    SkPath path = make_band_test_path();
+    path.offset(5, 5);
+    for (SkPath::FillType fillType : { SkPath::kWinding_FillType, SkPath::kEvenOdd_FillType }) {
+        path.setFillType(fillType);
+        for (const SkIRect& clip : { SkIRect::MakeWH(340, 340),
+                                     SkIRect::MakeLTRB(7, 30, 290, 301) }) {
+            SkBitmap whole;
+            anti_fill_path(path, clip, 1, &whole);
+            REPORTER_ASSERT(reporter, SK_ColorWHITE != whole.getColor(160, 160) ||
+                                      SK_ColorWHITE != whole.getColor(100, 200));
+
+            for (int bandCount : { 2, 3, 8 }) {
+                SkBitmap bands;
+                anti_fill_path(path, clip, bandCount, &bands);
+                REPORTER_ASSERT(reporter, 0 == memcmp(whole.getPixels(), bands.getPixels(),
+                                                      whole.getSize()));
+            }
+        }
+    }
+}
@@ -7,6 +7,7 @@
 
 #if SK_SUPPORT_GPU
 
+#include "GrRectanizer_maxrects.h"
 #include "GrRectanizer_pow2.h"
 #include "GrRectanizer_skyline.h"
 #include "SkRandom.h"
@@ -51,6 +52,51 @@ static void test_skyline(skiatest::Reporter* reporter, const SkTDArray<SkISize>&
     test_rectanizer_inserts(reporter, &skylineRectanizer, rects);
 }
 
+// Every rect that was added must lie inside the atlas, and not overlap any other.
+static void test_rectanizer_no_overlap(skiatest::Reporter* reporter,
+                                       GrRectanizer* rectanizer,
+                                       const SkTDArray<SkISize>& rects,
+                                       bool batch) {
+    SkTDArray<SkIPoint16> locs;
+    locs.setCount(rects.count());
+    if (batch) {
+        int added = rectanizer->addRects(rects.begin(), rects.count(), locs.begin());
+        int placed = 0;
+        for (const SkIPoint16& loc : locs) {
+            placed += loc.fX >= 0;
+        }
+        REPORTER_ASSERT(reporter, added > 0 && added == placed);
+    } else {
+        for (int i = 0; i < rects.count(); ++i) {
+            if (!rectanizer->addRect(rects[i].fWidth, rects[i].fHeight, &locs[i])) {
+                locs[i].set(-1, -1);
+            }
+        }
+    }
+
+    SkTDArray<SkIRect> placed;
+    for (int i = 0; i < rects.count(); ++i) {
+        if (locs[i].fX < 0) {
+            continue;
+        }
+        SkIRect r = SkIRect::MakeXYWH(locs[i].fX, locs[i].fY,
+                                      rects[i].fWidth, rects[i].fHeight);
+        REPORTER_ASSERT(reporter, SkIRect::MakeWH(kWidth, kHeight).contains(r));
+        for (const SkIRect& other : placed) {
+            REPORTER_ASSERT(reporter, !SkIRect::Intersects(r, other));
+        }
+        *placed.append() = r;
+    }
+    rectanizer->reset();
+}
+
+static void test_maxrects(skiatest::Reporter* reporter, const SkTDArray<SkISize>& rects) {
+    GrRectanizerMaxRects maxRectsRectanizer(kWidth, kHeight);
+
+    test_rectanizer_basic(reporter, &maxRectsRectanizer);
+    test_rectanizer_inserts(reporter, &maxRectsRectanizer, rects);
+}
+
 static void test_pow2(skiatest::Reporter* reporter, const SkTDArray<SkISize>& rects) {
     GrRectanizerPow2 pow2Rectanizer(kWidth, kHeight);
 
@@ -69,6 +115,23 @@ DEF_GPUTEST(GpuRectanizer, reporter, factory) {
 
     test_skyline(reporter, rects);
     test_pow2(reporter, rects);
+    test_maxrects(reporter, rects);
+
+    SkTDArray<SkISize> smallRects;
+    for (int i = 0; i < 500; i++) {
+        smallRects.push(SkISize::Make(rand.nextRangeU(1, 64), rand.nextRangeU(1, 64)));
+    }
+    GrRectanizerPow2 pow2Rectanizer(kWidth, kHeight);
+    GrRectanizerSkyline skylineRectanizer(kWidth, kHeight);
+    GrRectanizerMaxRects maxRectsRectanizer(kWidth, kHeight);
+    for (GrRectanizer* rectanizer : { (GrRectanizer*)&pow2Rectanizer,
+                                      (GrRectanizer*)&skylineRectanizer,
+                                      (GrRectanizer*)&maxRectsRectanizer }) {
+        for (bool batch : { false, true }) {
+            test_rectanizer_no_overlap(reporter, rectanizer, rects, batch);
+            test_rectanizer_no_overlap(reporter, rectanizer, smallRects, batch);
+        }
+    }
 }
 
 #endif
@@ -10,6 +10,7 @@
 #if SK_SUPPORT_GPU
 #include "GrMemoryPool.h"
 #include "SkRandom.h"
+#include "SkTaskGroup.h"
 #include "SkTArray.h"
 #include "SkTDArray.h"
 #include "SkTemplates.h"
@@ -398,4 +399,118 @@ DEF_TEST(GrObjectMemoryPoolAPI, reporter) {
     }
 }
 
+DEF_TEST(GrMemoryPoolSizeClasses, reporter) {
+    GrMemoryPool pool(0, 0);
+    void* a = pool.allocate(40);
+    void* b = pool.allocate(40);
+    void* c = pool.allocate(40);
+
+    // A sized release goes on a freelist, and is reused by an allocation of the same size.
+    pool.release(b, 40);
+    REPORTER_ASSERT(reporter, !pool.isEmpty());
+    void* d = pool.allocate(48);
+    REPORTER_ASSERT(reporter, d != b);
+    void* e = pool.allocate(37);
+    REPORTER_ASSERT(reporter, e == b);
+
+    // Large allocations have no freelist, so their blocks are freed right away.
+    void* f = pool.allocate(4000);
+    void* g = pool.allocate(4000);
+    size_t size = pool.size();
+    pool.release(f, 4000);
+    REPORTER_ASSERT(reporter, pool.size() < size);
+
+    pool.release(a, 40);
+    pool.release(c, 40);
+    pool.release(d, 48);
+    pool.release(e, 37);
+    REPORTER_ASSERT(reporter, !pool.isEmpty());
+    pool.release(g);
+
+    // Releasing the last allocation empties the freelists and frees the extra blocks.
+    REPORTER_ASSERT(reporter, pool.isEmpty());
+    REPORTER_ASSERT(reporter, pool.size() == 0);
+}
+
+DEF_TEST(GrMemoryPoolBulk, reporter) {
+    constexpr int kCount = 1000;
+    constexpr size_t kMaxSize = 600;
+    GrMemoryPool pool(0, 0, GrMemoryPool::ReleaseMode::kBulk);
+
+    SkRandom r;
+    for (int flush = 0; flush < 4; ++flush) {
+        // Record a mix of sizes, releasing some of them early with or without their sizes.
+        SkTArray<std::pair<uint8_t*, size_t>> allocs;
+        for (int i = 0; i < kCount; ++i) {
+            size_t size = r.nextRangeU(1, kMaxSize);
+            uint8_t* p = static_cast<uint8_t*>(pool.allocate(size));
+            REPORTER_ASSERT(reporter, !(reinterpret_cast<intptr_t>(p) & 7));
+            memset(p, i & 0xff, size);
+            allocs.push_back(std::make_pair(p, size));
+            if (allocs.count() > 1 && r.nextBool()) {
+                int victim = r.nextULessThan(allocs.count());
+                if (r.nextBool()) {
+                    pool.release(allocs[victim].first, allocs[victim].second);
+                } else {
+                    pool.release(allocs[victim].first);
+                }
+                allocs.removeShuffle(victim);
+            }
+        }
+        REPORTER_ASSERT(reporter, pool.size() > 0);
+
+        // Nothing that is still live was handed out twice.
+        for (const auto& alloc : allocs) {
+            uint8_t value = alloc.first[0];
+            bool same = true;
+            for (size_t j = 1; j < alloc.second; ++j) {
+                same &= (alloc.first[j] == value);
+            }
+            REPORTER_ASSERT(reporter, same);
+        }
+
+        // Everything is reclaimed when the last allocation is released.
+        while (allocs.count()) {
+            REPORTER_ASSERT(reporter, !pool.isEmpty());
+            pool.release(allocs.back().first);
+            allocs.pop_back();
+        }
+        REPORTER_ASSERT(reporter, pool.isEmpty());
+        REPORTER_ASSERT(reporter, pool.size() == 0);
+    }
+}
+
+DEF_TEST(GrThreadMemoryPools, reporter) {
+    constexpr int kTasks = 16;
+    constexpr int kCount = 500;
+    GrThreadMemoryPools pools(0, 0);
+    std::unique_ptr<int*[]> allocs(new int*[kTasks * kCount]);
+
+    // Allocate on many threads at once, release half of it there, and the rest on this thread.
+    SkTaskGroup().batch(kTasks, [&](int task) {
+        for (int i = 0; i < kCount; ++i) {
+            int size = 1 + i % 50;
+            int* p = static_cast<int*>(pools.allocate(size * sizeof(int)));
+            for (int j = 0; j < size; ++j) {
+                p[j] = task * kCount + i;
+            }
+            allocs[task * kCount + i] = p;
+        }
+        for (int i = 0; i < kCount; i += 2) {
+            pools.release(allocs[task * kCount + i], (1 + i % 50) * sizeof(int));
+        }
+    });
+    for (int task = 0; task < kTasks; ++task) {
+        for (int i = 1; i < kCount; i += 2) {
+            int* p = allocs[task * kCount + i];
+            bool intact = true;
+            for (int j = 0; j < 1 + i % 50; ++j) {
+                intact &= (p[j] == task * kCount + i);
+            }
+            REPORTER_ASSERT(reporter, intact);
+            pools.release(p, (1 + i % 50) * sizeof(int));
+        }
+    }
+}
+
 #endif
@@ -9,11 +9,17 @@
 #include "SkColorPriv.h"
 #include "SkColorShader.h"
 #include "SkGradientShader.h"
+#include "SkGradientShaderPriv.h"
+#include "SkHalf.h"
+#include "SkLinearGradient.h"
+#include "SkResourceCache.h"
 #include "SkShader.h"
 #include "SkSurface.h"
 #include "SkTemplates.h"
 #include "Test.h"
 
+#include <functional>
+
 // https://code.google.com/p/chromium/issues/detail?id=448299
 // Giant (inverse) matrix causes overflow when converting/computing using 32.32
 // Before the fix, we would assert (and then crash).
@@ -365,6 +371,255 @@ static void text_degenerate_linear(skiatest::Reporter*) {
     // Passes if we don't trigger asserts.
 }
 
+// Equivalent shaders share their color ramps and interval lists through the SkResourceCache.
+// Drawing with shared ones must look the same as drawing with freshly built ones.
+static void test_shared_ramps(skiatest::Reporter* reporter) {
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+    const SkScalar pos[] = { 0, 0.25f, 1 };
+    const SkPoint pts[] = {{ 0, 0 }, { 64, 0 }};
+    auto make = [&](uint32_t flags) {
+        return SkGradientShader::MakeLinear(pts, colors, pos, SK_ARRAY_COUNT(colors),
+                                            SkShader::kMirror_TileMode, flags, nullptr);
+    };
+
+    SkBitmap tables[2];
+    for (SkBitmap& table : tables) {
+        sk_sp<SkShader> shader = make(0);
+        static_cast<SkGradientShaderBase*>(shader.get())->getGradientTableBitmap(
+                &table, SkGradientShaderBase::GradientBitmapType::kLegacy);
+    }
+    REPORTER_ASSERT(reporter, tables[0].pixelRef() == tables[1].pixelRef());
+
+    for (uint32_t flags : { 0u, (uint32_t)SkLinearGradient::kForce4fContext_PrivateFlag }) {
+        for (U8CPU alpha : { 0xFF, 0x80 }) {
+            // The first draw builds everything, the second finds it in the cache.
+            SkResourceCache::PurgeAll();
+            SkBitmap bitmaps[2];
+            for (SkBitmap& bitmap : bitmaps) {
+                bitmap.allocN32Pixels(128, 1);
+                bitmap.eraseColor(SK_ColorTRANSPARENT);
+                SkPaint paint;
+                paint.setShader(make(flags));
+                paint.setAlpha(alpha);
+                SkCanvas(bitmap).drawPaint(paint);
+            }
+            REPORTER_ASSERT(reporter, 0 == memcmp(bitmaps[0].getPixels(), bitmaps[1].getPixels(),
+                                                  bitmaps[0].getSize()));
+        }
+    }
+}
+
+// The color of a gradient at t, interpolating in linear floats, as the raster pipeline does.
+// Clamping extends the first and last colors, even past a hard stop at 0 or 1.
+static SkColor4f eval_stops(const SkColor4f colors[], const SkScalar pos[], int count,
+                            SkShader::TileMode mode, double t) {
+    switch (mode) {
+        case SkShader::kClamp_TileMode:
+            if (t < 0) {
+                return colors[0];
+            }
+            if (t > 1) {
+                return colors[count - 1];
+            }
+            break;
+        case SkShader::kRepeat_TileMode:
+            t -= floor(t);
+            break;
+        case SkShader::kMirror_TileMode:
+            t -= 2 * floor(t / 2);
+            if (t > 1) {
+                t = 2 - t;
+            }
+            break;
+    }
+    for (int i = 0; i < count - 1; ++i) {
+        if (t < pos[i + 1] || i == count - 2) {
+            double w = pos[i + 1] > pos[i] ? (t - pos[i]) / (pos[i + 1] - pos[i]) : 0;
+            const float* c0 = colors[i].vec();
+            const float* c1 = colors[i + 1].vec();
+            SkColor4f c;
+            for (int j = 0; j < 4; ++j) {
+                c.vec()[j] = (float)(c0[j] + (c1[j] - c0[j]) * w);
+            }
+            return c;
+        }
+    }
+    return colors[count - 1];
+}
+
+// Draws gradients into a linear half-float surface, which goes through SkRasterPipeline, and
+// checks each pixel against the color at t computed in doubles. Pixels right on a hard stop may
+// land on either side of it.
+static void test_raster_pipeline_gradients(skiatest::Reporter* reporter) {
+    const int kSize = 64;
+    SkImageInfo info = SkImageInfo::Make(kSize, kSize, kRGBA_F16_SkColorType, kPremul_SkAlphaType,
+                                         SkColorSpace::MakeNamed(SkColorSpace::kSRGBLinear_Named));
+    auto surface = SkSurface::MakeRaster(info);
+
+    const SkColor4f smooth[] = {
+        { 1, 0, 0, 1 }, { 0, 1, 0, 0.5f }, { 0, 0, 1, 1 },
+    };
+    const SkScalar smoothPos[] = { 0, 0.3f, 1 };
+
+    // Hard stops right at either end, whose outer colors only show when clamping.
+    const SkColor4f rgb[] = {
+        { 1, 0, 0, 1 }, { 0, 1, 0, 1 }, { 0, 0, 1, 1 },
+    };
+    const SkScalar hardStartPos[] = { 0, 0, 1 };
+    const SkScalar hardEndPos[]   = { 0, 1, 1 };
+
+    // Enough bands that the intervals are found through a lookup table.
+    const int kBands = 12;
+    SkColor4f bands[2 * kBands];
+    SkScalar bandPos[2 * kBands];
+    for (int i = 0; i < kBands; ++i) {
+        SkColor4f c = { (i % 3) * 0.5f, (i % 4) / 3.0f, (float)(i & 1), 1 };
+        bands[2 * i] = bands[2 * i + 1] = c;
+        bandPos[2 * i] = (float)i / kBands;
+        bandPos[2 * i + 1] = (float)(i + 1) / kBands;
+    }
+
+    struct Stops {
+        const SkColor4f* colors;
+        const SkScalar*  pos;
+        int              count;
+    } stops[] = {
+        { smooth, smoothPos, SK_ARRAY_COUNT(smooth) },
+        { bands, bandPos, SK_ARRAY_COUNT(bands) },
+        { rgb, hardStartPos, SK_ARRAY_COUNT(rgb) },
+        { rgb, hardEndPos, SK_ARRAY_COUNT(rgb) },
+    };
+
+    const SkPoint c = { 30, 34 };
+    const SkPoint c1 = { 38, 30 };
+    struct Geometry {
+        std::function<sk_sp<SkShader>(const Stops&, SkShader::TileMode)> make;
+        std::function<bool(double x, double y, double* t)> t;  // false: transparent
+        bool clampOnly;
+    } geometries[] = {
+        {
+            [&](const Stops& s, SkShader::TileMode mode) {
+                const SkPoint pts[] = { { 24, 0 }, { 40, 0 } };
+                return SkGradientShader::MakeLinear(pts, s.colors, nullptr, s.pos, s.count, mode);
+            },
+            [](double x, double, double* t) { *t = (x - 24) / 16; return true; },
+            false,
+        },
+        {
+            [&](const Stops& s, SkShader::TileMode mode) {
+                return SkGradientShader::MakeRadial(c, 20, s.colors, nullptr, s.pos, s.count,
+                                                    mode);
+            },
+            [&](double x, double y, double* t) {
+                *t = sqrt((x - c.fX) * (x - c.fX) + (y - c.fY) * (y - c.fY)) / 20;
+                return true;
+            },
+            false,
+        },
+        {
+            [&](const Stops& s, SkShader::TileMode) {
+                return SkGradientShader::MakeSweep(c.fX, c.fY, s.colors, nullptr, s.pos, s.count);
+            },
+            [&](double x, double y, double* t) {
+                *t = atan2(y - c.fY, x - c.fX) / (2 * SK_ScalarPI);
+                if (*t < 0) {
+                    *t += 1;
+                }
+                return true;
+            },
+            true,  // Sweeps only clamp, and t stays in [0,1) anyway.
+        },
+    };
+    // Two-point conical, both ways round.
+    struct Conical { SkPoint c0; float r0; SkPoint c1; float r1; } conicals[] = {
+        { c, 4, c1, 24 },
+        { c1, 24, c, 4 },
+    };
+    auto conical_t = [](const Conical& g, double x, double y, double* t) {
+        double dcx = g.c1.fX - g.c0.fX, dcy = g.c1.fY - g.c0.fY, dr = g.r1 - g.r0,
+               px = x - g.c0.fX, py = y - g.c0.fY;
+        double a = dcx * dcx + dcy * dcy - dr * dr,
+               b = -2 * (px * dcx + py * dcy + g.r0 * dr),
+               cc = px * px + py * py - g.r0 * g.r0,
+               disc = b * b - 4 * a * cc;
+        if (disc < 0) {
+            return false;
+        }
+        double roots[] = { (-b + sqrt(disc)) / (2 * a), (-b - sqrt(disc)) / (2 * a) };
+        if (roots[0] < roots[1]) {
+            SkTSwap(roots[0], roots[1]);
+        }
+        for (double root : roots) {
+            if (g.r0 + root * dr >= 0) {
+                *t = root;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    auto check = [&](const sk_sp<SkShader>& shader, const Stops& s, SkShader::TileMode mode,
+                     const std::function<bool(double, double, double*)>& tAt) {
+        surface->getCanvas()->clear(SK_ColorTRANSPARENT);
+        SkPaint paint;
+        paint.setShader(shader);
+        surface->getCanvas()->drawPaint(paint);
+        SkPixmap pm;
+        REPORTER_ASSERT(reporter, surface->peekPixels(&pm));
+
+        int mismatches = 0;
+        for (int y = 0; y < kSize; ++y) {
+            for (int x = 0; x < kSize; ++x) {
+                const uint64_t px = *pm.addr64(x, y);
+                float got[4];
+                for (int j = 0; j < 4; ++j) {
+                    got[j] = SkHalfToFloat((SkHalf)(px >> (16 * j)));
+                }
+                auto close = [&](const SkColor4f& want) {
+                    const float premul[] = { want.fR * want.fA, want.fG * want.fA,
+                                             want.fB * want.fA, want.fA };
+                    for (int j = 0; j < 4; ++j) {
+                        if (fabs(got[j] - premul[j]) > 0.01f) {
+                            return false;
+                        }
+                    }
+                    return true;
+                };
+                double t;
+                bool ok;
+                if (!tAt(x + 0.5, y + 0.5, &t)) {
+                    ok = close({ 0, 0, 0, 0 });
+                } else {
+                    ok = close(eval_stops(s.colors, s.pos, s.count, mode, t)) ||
+                         close(eval_stops(s.colors, s.pos, s.count, mode, t - 1e-3)) ||
+                         close(eval_stops(s.colors, s.pos, s.count, mode, t + 1e-3));
+                }
+                mismatches += !ok;
+            }
+        }
+        REPORTER_ASSERT(reporter, 0 == mismatches);
+    };
+
+    for (SkShader::TileMode mode : { SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode,
+                                     SkShader::kMirror_TileMode }) {
+        for (const Stops& s : stops) {
+            for (const Geometry& g : geometries) {
+                if (g.clampOnly && SkShader::kClamp_TileMode != mode) {
+                    continue;
+                }
+                check(g.make(s, mode), s, mode, g.t);
+            }
+            for (const Conical& g : conicals) {
+                check(SkGradientShader::MakeTwoPointConical(g.c0, g.r0, g.c1, g.r1, s.colors,
+                                                            nullptr, s.pos, s.count, mode),
+                      s, mode, [&](double x, double y, double* t) {
+                          return conical_t(g, x, y, t);
+                      });
+            }
+        }
+    }
+}
+
 DEF_TEST(Gradient, reporter) {
     TestGradientShaders(reporter);
     TestGradientOptimization(reporter);
@@ -376,4 +631,6 @@ DEF_TEST(Gradient, reporter) {
     test_two_point_conical_zero_radius(reporter);
     test_clamping_overflow(reporter);
     text_degenerate_linear(reporter);
+    test_shared_ramps(reporter);
+    test_raster_pipeline_gradients(reporter);
 }
@@ -10,6 +10,7 @@
 #ifdef SK_SUPPORT_PDF
 
 #include "SkDeflate.h"
+#include "SkOpts.h"
 #include "SkRandom.h"
 
 namespace {
@@ -28,7 +29,7 @@ void skia_free_func(void*, void* address) { sk_free(address); }
  *  Use the un-deflate compression algorithm to decompress the data in src,
  *  returning the result.  Returns nullptr if an error occurs.
  */
-SkStreamAsset* stream_inflate(skiatest::Reporter* reporter, SkStream* src) {
+SkStreamAsset* stream_inflate(skiatest::Reporter* reporter, SkStream* src, bool gzip = false) {
     SkDynamicMemoryWStream decompressedDynamicMemoryWStream;
     SkWStream* dst = &decompressedDynamicMemoryWStream;
 
@@ -44,7 +45,7 @@ SkStreamAsset* stream_inflate(skiatest::Reporter* reporter, SkStream* src) {
     flateData.next_out = outputBuffer;
     flateData.avail_out = kBufferSize;
     int rc;
-    rc = inflateInit(&flateData);
+    rc = gzip ? inflateInit2(&flateData, 0x1F) : inflateInit(&flateData);
     if (rc != Z_OK) {
         ERRORF(reporter, "Zlib: inflateInit failed");
         return nullptr;
@@ -166,4 +167,76 @@ DEF_TEST(SkPDF_DeflateWStream, r) {
     REPORTER_ASSERT(r, !emptyDeflateWStream.writeText("FOO"));
 }
 
+// SkDeflateWStream computes the zlib and gzip checksums itself (SkOpts::adler32/gzip_crc32),
+// and stores runs of incompressible input instead of deflating them.
+DEF_TEST(SkPDF_DeflateWStream_checksums, r) {
+    SkRandom random(654321);
+    SkAutoTMalloc<uint8_t> buffer(20000);
+    for (int i = 0; i < 20000; ++i) {
+        buffer[i] = random.nextU() & 0xff;
+    }
+    for (size_t offset : { 0, 1, 3, 15 }) {
+        for (size_t size : { 0, 1, 31, 32, 33, 5552, 5553, 19000 }) {
+            const uint8_t* data = buffer.get() + offset;
+            REPORTER_ASSERT(r, SkOpts::adler32(1, data, size) ==
+                               adler32(1, data, SkToUInt(size)));
+            REPORTER_ASSERT(r, SkOpts::gzip_crc32(0, data, size) ==
+                               crc32(0, data, SkToUInt(size)));
+        }
+    }
+    // All 0xFF is the worst case for overflowing the Adler-32 sums.
+    memset(buffer.get(), 0xFF, 20000);
+    REPORTER_ASSERT(r, SkOpts::adler32(1, buffer.get(), 20000) == adler32(1, buffer.get(), 20000));
+}
+
+DEF_TEST(SkPDF_DeflateWStream_mixed, r) {
+    // 16K of text, 16K of random bytes, then text again.
+    SkRandom random(13);
+    SkDynamicMemoryWStream input;
+    for (int i = 0; i < 1000; ++i) {
+        input.writeText("0 0 m 10 10 l S\n");
+    }
+    for (int i = 0; i < 4096; ++i) {
+        input.write32(random.nextU());
+    }
+    for (int i = 0; i < 1000; ++i) {
+        input.writeText("1 0 0 RG 5 5 10 10 re f\n");
+    }
+    sk_sp<SkData> data(input.detachAsData());
+
+    for (bool gzip : { false, true }) {
+        SkDynamicMemoryWStream compressedStream;
+        {
+            SkDeflateWStream deflateWStream(&compressedStream, -1, gzip);
+            deflateWStream.write(data->data(), data->size());
+            REPORTER_ASSERT(r, deflateWStream.bytesWritten() == data->size());
+        }
+        // The random part is stored, but the text around it still compresses well.
+        REPORTER_ASSERT(r, compressedStream.bytesWritten() < 16384 + 4096);
+
+        std::unique_ptr<SkStreamAsset> compressed(compressedStream.detachAsStream());
+        std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, compressed.get(), gzip));
+        if (!decompressed) {
+            ERRORF(r, "Decompression failed.");
+            continue;
+        }
+        sk_sp<SkData> result(SkData::MakeFromStream(decompressed.get(),
+                                                    decompressed->getLength()));
+        REPORTER_ASSERT(r, result && result->equals(data.get()));
+    }
+
+    // Streams are reused across instances; make sure a reused one starts from scratch.
+    for (int i = 0; i < 3; ++i) {
+        SkDynamicMemoryWStream compressedStream;
+        {
+            SkDeflateWStream deflateWStream(&compressedStream);
+            deflateWStream.writeText("BT /F1 12 Tf (reuse) Tj ET");
+        }
+        std::unique_ptr<SkStreamAsset> compressed(compressedStream.detachAsStream());
+        std::unique_ptr<SkStreamAsset> decompressed(stream_inflate(r, compressed.get()));
+        REPORTER_ASSERT(r, decompressed &&
+                           decompressed->getLength() == strlen("BT /F1 12 Tf (reuse) Tj ET"));
+    }
+}
+
 #endif
@@ -9,6 +9,7 @@
 #include "Resources.h"
 #include "SkCanvas.h"
 #include "SkDocument.h"
+#include "SkImage.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkStream.h"
@@ -164,6 +165,35 @@ DEF_TEST(SkPDF_document_skbug_4734, r) {
     canvas->drawText(text, strlen(text), 0, 0, SkPaint());
 }
 
+static size_t count_bytes(sk_sp<SkImage> a, sk_sp<SkImage> b) {
+    SkDynamicMemoryWStream stream;
+    sk_sp<SkDocument> doc(SkDocument::MakePDF(&stream));
+    SkCanvas* canvas = doc->beginPage(64, 64);
+    canvas->drawImage(a, 0, 0);
+    canvas->drawImage(b, 32, 0);
+    doc->endPage();
+    doc->close();
+    return stream.bytesWritten();
+}
+
+// Images with the same pixels but different IDs are only written once.
+DEF_TEST(SkPDF_document_dedup_images, r) {
+    REQUIRE_PDF_DOCUMENT(SkPDF_document_dedup_images, r);
+    SkBitmap bm;
+    bm.allocN32Pixels(32, 32);
+    bm.eraseColor(SK_ColorRED);
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, bm.peekPixels(&pixmap));
+    sk_sp<SkImage> image = SkImage::MakeRasterCopy(pixmap),
+                   copy  = SkImage::MakeRasterCopy(pixmap);
+    bm.eraseArea(SkIRect::MakeWH(1, 1), SK_ColorBLUE);
+    sk_sp<SkImage> other = SkImage::MakeRasterCopy(pixmap);
+
+    size_t once = count_bytes(image, image);
+    REPORTER_ASSERT(r, once == count_bytes(image, copy));
+    REPORTER_ASSERT(r, once < count_bytes(image, other));
+}
+
 static bool contains(const uint8_t* result, size_t size, const char expectation[]) {
     size_t len = strlen(expectation);
     size_t N = 1 + size - len;
@@ -13,6 +13,8 @@
 #include "SkColorPriv.h"
 #include "SkDashPathEffect.h"
 #include "SkData.h"
+#include "SkImageContent.h"
+#include "SkImageDeserializer.h"
 #include "SkImageGenerator.h"
 #include "SkImageEncoder.h"
 #include "SkImageGenerator.h"
@@ -30,6 +32,7 @@
 #include "SkRecord.h"
 #include "SkShader.h"
 #include "SkStream.h"
+#include "SkTHash.h"
 #include "sk_tool_utils.h"
 
 #include "Test.h"
@@ -1097,6 +1100,191 @@ DEF_TEST(Picture_preserveCullRect, r) {
     REPORTER_ASSERT(r, deserializedPicture->cullRect().bottom() == 4);
 }
 
+namespace {
+
+// Encodes to PNG, like the default, and writes a reference instead for images in fKnown.
+class KnownImageSerializer : public SkPixelSerializer {
+public:
+    explicit KnownImageSerializer(bool threadSafe) : fThreadSafe(threadSafe) {}
+
+    SkTDArray<uint32_t> fKnown;
+
+protected:
+    bool onUseEncodedData(const void*, size_t) override { return true; }
+
+    SkData* onEncode(const SkPixmap& pixmap) override {
+        SkDynamicMemoryWStream buf;
+        return SkEncodeImage(&buf, pixmap, SkEncodedImageFormat::kPNG, 100)
+               ? buf.detachAsData().release() : nullptr;
+    }
+
+    SkData* onEncodeKnownImage(const SkImage* image) override {
+        if (fKnown.find(image->uniqueID()) < 0) {
+            return nullptr;
+        }
+        SkString ref;
+        ref.printf("known %u", image->uniqueID());
+        return SkData::MakeWithCopy(ref.c_str(), ref.size()).release();
+    }
+
+    bool onIsThreadSafe() const override { return fThreadSafe; }
+
+private:
+    bool fThreadSafe;
+};
+
+// Resolves the references written by KnownImageSerializer.
+class KnownImageDeserializer : public SkImageDeserializer {
+public:
+    SkTHashMap<uint32_t, sk_sp<SkImage>> fImages;
+
+    sk_sp<SkImage> makeFromData(SkData* data, const SkIRect* subset) override {
+        SkString str((const char*)data->data(), data->size());
+        uint32_t id;
+        if (str.startsWith("known ") && 1 == sscanf(str.c_str(), "known %u", &id)) {
+            sk_sp<SkImage>* image = fImages.find(id);
+            return image ? *image : nullptr;
+        }
+        return this->SkImageDeserializer::makeFromData(data, subset);
+    }
+};
+
+}  // namespace
+
+static sk_sp<SkPicture> make_picture_with_images(SkTDArray<SkImage*>* images) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(64, 64);
+    SkPaint paint;
+    for (int i = 0; i < 4; i++) {
+        SkBitmap bm;
+        make_bm(&bm, 8 + i, 8, SkColorSetRGB(60 * i, 255 - 60 * i, 128), true);
+        sk_sp<SkImage> image = SkImage::MakeFromBitmap(bm);
+        canvas->drawImage(image, 16.0f * i, 0, &paint);
+        *images->append() = image.get();
+    }
+    SkPath path;
+    path.addCircle(32, 40, 20);
+    paint.setColor(SK_ColorBLUE);
+    canvas->drawPath(path, paint);
+
+    SkPictureRecorder subRecorder;
+    SkCanvas* subCanvas = subRecorder.beginRecording(64, 64);
+    SkBitmap bm;
+    make_bm(&bm, 8, 8, SK_ColorMAGENTA, true);
+    sk_sp<SkImage> image = SkImage::MakeFromBitmap(bm);
+    subCanvas->drawImage(image, 0, 48);
+    *images->append() = image.get();
+    canvas->drawPicture(subRecorder.finishRecordingAsPicture());
+
+    return recorder.finishRecordingAsPicture();
+}
+
+static void draw_picture(const SkPicture* picture, SkBitmap* bm) {
+    bm->allocN32Pixels(64, 64);
+    bm->eraseColor(SK_ColorTRANSPARENT);
+    SkCanvas canvas(*bm);
+    canvas.drawPicture(picture);
+}
+
+DEF_TEST(Picture_serializeImages, r) {
+    SkTDArray<SkImage*> images;
+    sk_sp<SkPicture> picture = make_picture_with_images(&images);
+
+    // Images are encoded in parallel only for thread-safe serializers; either way, the output
+    // matches the default serializer's.
+    sk_sp<SkData> expected = picture->serialize();
+    KnownImageSerializer serial(false), parallel(true);
+    REPORTER_ASSERT(r, expected->equals(picture->serialize(&serial).get()));
+    REPORTER_ASSERT(r, expected->equals(picture->serialize(&parallel).get()));
+
+    // Images the receiver already has are written as references, and resolved when read.
+    KnownImageDeserializer deserializer;
+    for (SkImage* image : images) {
+        *parallel.fKnown.append() = image->uniqueID();
+        deserializer.fImages.set(image->uniqueID(), sk_ref_sp(image));
+    }
+    sk_sp<SkData> withRefs = picture->serialize(&parallel);
+    REPORTER_ASSERT(r, withRefs->size() < expected->size());
+
+    sk_sp<SkPicture> copy = SkPicture::MakeFromData(withRefs.get(), &deserializer);
+    REPORTER_ASSERT(r, copy);
+    if (copy) {
+        SkBitmap want, got;
+        draw_picture(picture.get(), &want);
+        draw_picture(copy.get(), &got);
+        REPORTER_ASSERT(r, 0 == memcmp(want.getPixels(), got.getPixels(), want.getSize()));
+    }
+}
+
+static sk_sp<SkPicture> make_picture_with_two_images(sk_sp<SkImage> a, sk_sp<SkImage> b) {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(64, 64);
+    canvas->drawImage(a, 0, 0);
+    canvas->drawImage(b, 32, 0);
+    return recorder.finishRecordingAsPicture();
+}
+
+static sk_sp<SkData> serialize_two_images(sk_sp<SkImage> a, sk_sp<SkImage> b) {
+    return make_picture_with_two_images(std::move(a), std::move(b))->serialize();
+}
+
+DEF_TEST(Picture_dedupImages, r) {
+    SkBitmap bm;
+    bm.allocN32Pixels(32, 32);
+    for (int y = 0; y < 32; y++) {
+        for (int x = 0; x < 32; x++) {
+            *bm.getAddr32(x, y) = SkPackARGB32(0xFF, 8 * x, 8 * y, 128);
+        }
+    }
+    SkPixmap pixmap;
+    REPORTER_ASSERT(r, bm.peekPixels(&pixmap));
+
+    // Copies of the same pixels have new IDs, but are stored once.
+    sk_sp<SkImage> image = SkImage::MakeRasterCopy(pixmap),
+                   copy  = SkImage::MakeRasterCopy(pixmap);
+    REPORTER_ASSERT(r, image->uniqueID() != copy->uniqueID());
+    sk_sp<SkData> once = serialize_two_images(image, image);
+    REPORTER_ASSERT(r, once->equals(serialize_two_images(image, copy).get()));
+
+    // Different pixels are stored separately, even where the pre-hash doesn't look.
+    *bm.getAddr32(31, 30) = SK_ColorBLACK;
+    sk_sp<SkImage> other = SkImage::MakeFromBitmap(bm);
+    REPORTER_ASSERT(r, !SkImageContent::Equals(image.get(), other.get()));
+    REPORTER_ASSERT(r, serialize_two_images(image, other)->size() > once->size());
+
+    SkBitmap big;
+    big.allocN32Pixels(512, 512);
+    big.eraseColor(SK_ColorGREEN);
+    sk_sp<SkImage> bigImage = SkImage::MakeFromBitmap(big);
+    *big.getAddr32(0, 1) = SK_ColorBLUE;  // not a sampled row
+    big.notifyPixelsChanged();
+    sk_sp<SkImage> bigOther = SkImage::MakeFromBitmap(big);
+    uint32_t hash, otherHash;
+    REPORTER_ASSERT(r, SkImageContent::PreHash(bigImage.get(), &hash) &&
+                       SkImageContent::PreHash(bigOther.get(), &otherHash) && hash == otherHash);
+    REPORTER_ASSERT(r, !SkImageContent::Equals(bigImage.get(), bigOther.get()));
+    sk_sp<SkPicture> both = make_picture_with_two_images(bigImage, bigOther);
+    SkBitmap drawn;
+    draw_picture(SkPicture::MakeFromData(both->serialize().get()).get(), &drawn);
+    REPORTER_ASSERT(r, SK_ColorGREEN == *drawn.getAddr32(0, 1) &&
+                       SK_ColorBLUE  == *drawn.getAddr32(32, 1));
+
+    // The same encoded image decoded twice is stored once too...
+    sk_sp<SkData> encoded(image->encode());
+    sk_sp<SkImage> lazy  = SkImage::MakeFromEncoded(encoded),
+                   lazy2 = SkImage::MakeFromEncoded(encoded);
+    REPORTER_ASSERT(r, SkImageContent::Equals(lazy.get(), lazy2.get()));
+    REPORTER_ASSERT(r, serialize_two_images(lazy, lazy)->equals(
+                       serialize_two_images(lazy, lazy2).get()));
+
+    // ... but subsets of it, which share its data, are told apart.
+    sk_sp<SkImage> left  = lazy->makeSubset(SkIRect::MakeXYWH( 0, 0, 16, 32)),
+                   right = lazy->makeSubset(SkIRect::MakeXYWH(16, 0, 16, 32));
+    REPORTER_ASSERT(r, !SkImageContent::Equals(left.get(), right.get()));
+    REPORTER_ASSERT(r, SkImageContent::Equals(
+                       left.get(), lazy2->makeSubset(SkIRect::MakeXYWH(0, 0, 16, 32)).get()));
+}
+
 #if SK_SUPPORT_GPU
 
 DEF_TEST(PictureGpuAnalyzer, r) {
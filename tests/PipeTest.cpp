@@ -8,6 +8,7 @@
 #include "Resources.h"
 #include "SkCanvas.h"
 #include "SkPipe.h"
+#include "SkPipeRingBuffer.h"
 #include "SkPaint.h"
 #include "SkStream.h"
 #include "SkSurface.h"
@@ -185,3 +186,80 @@ DEF_TEST(Pipe_picture_draw_second, reporter) {
     size_t offset2 = stream.bytesWritten();
     REPORTER_ASSERT(reporter, offset2 <= 16);
 }
+
+DEF_TEST(Pipe_ring_wrap, reporter) {
+    SkAutoTMalloc<uint32_t> storage(SkPipeRingBuffer::StorageSize(256) / 4);
+    SkPipeRingBuffer* ring = SkPipeRingBuffer::Create(storage.get(),
+                                                      SkPipeRingBuffer::StorageSize(256));
+    REPORTER_ASSERT(reporter, ring);
+    REPORTER_ASSERT(reporter, SkPipeRingBuffer::Attach(storage.get(),
+                                                       SkPipeRingBuffer::StorageSize(256)));
+
+    SkPipeRingWriter writer(ring);
+    SkPipeRingReader reader(ring);
+
+    // Odd-sized messages force the writer to wrap at every possible offset.
+    for (uint32_t i = 0; i < 200; ++i) {
+        uint32_t count = 1 + i % 23;
+        for (uint32_t j = 0; j < count; ++j) {
+            REPORTER_ASSERT(reporter, writer.write32(i + j));
+        }
+        REPORTER_ASSERT(reporter, writer.commit());
+
+        size_t size;
+        const uint32_t* msg = static_cast<const uint32_t*>(reader.peek(&size, false));
+        REPORTER_ASSERT(reporter, msg && size == count * 4);
+        for (uint32_t j = 0; msg && j < count; ++j) {
+            REPORTER_ASSERT(reporter, msg[j] == i + j);
+        }
+        reader.consume();
+        REPORTER_ASSERT(reporter, !reader.peek(&size, false));
+    }
+
+    // Messages that can never fit are dropped.
+    for (size_t j = 0; j <= ring->maxMessageSize() + 64; j += 4) {
+        writer.write32(0);
+    }
+    REPORTER_ASSERT(reporter, !writer.commit());
+    size_t size;
+    REPORTER_ASSERT(reporter, !reader.peek(&size, false));
+}
+
+DEF_TEST(Pipe_ring_playback, reporter) {
+    auto shm = SkPipeSharedMemory::Make(SkPipeRingBuffer::StorageSize(64 * 1024));
+    SkAutoTMalloc<uint32_t> fallback;
+    void* memory;
+    size_t memorySize = SkPipeRingBuffer::StorageSize(64 * 1024);
+    if (shm) {
+        memory = shm->memory();
+    } else {
+        memory = fallback.reset(memorySize / 4);
+    }
+    SkPipeRingBuffer* ring = SkPipeRingBuffer::Create(memory, memorySize);
+    REPORTER_ASSERT(reporter, ring);
+
+    SkPipeSerializer serializer;
+    SkPipeDeserializer deserializer;
+    SkPipeRingWriter writer(ring);
+    SkPipeRingReader reader(ring);
+
+    sk_sp<SkSurface> surface = SkSurface::MakeRasterN32Premul(10, 10);
+    const SkColor colors[] = { SK_ColorRED, SK_ColorGREEN, SK_ColorBLUE };
+    for (SkColor color : colors) {
+        SkCanvas* wc = serializer.beginWrite(SkRect::MakeWH(10, 10), &writer);
+        SkPaint paint;
+        paint.setColor(color);
+        wc->drawRect(SkRect::MakeWH(10, 10), paint);
+        serializer.endWrite();
+        REPORTER_ASSERT(reporter, writer.commit());
+
+        REPORTER_ASSERT(reporter, reader.playbackNext(&deserializer, surface->getCanvas()));
+        SkPMColor pixel;
+        SkImageInfo info = SkImageInfo::MakeN32Premul(1, 1);
+        REPORTER_ASSERT(reporter, surface->readPixels(info, &pixel, 4, 5, 5));
+        REPORTER_ASSERT(reporter, pixel == SkPreMultiplyColor(color));
+    }
+
+    ring->close();
+    REPORTER_ASSERT(reporter, !reader.playbackNext(&deserializer, surface->getCanvas()));
+}
@@ -8,6 +8,7 @@
 #include "SkPath.h"
 #include "SkRandom.h"
 #include "SkRegion.h"
+#include "SkTDArray.h"
 #include "Test.h"
 
 static void Union(SkRegion* rgn, const SkIRect& rect) {
@@ -290,3 +291,66 @@ DEF_TEST(Region_writeToMemory, r) {
     REPORTER_ASSERT(r, region.isComplex());
     test_write(region, r);
 }
+
+DEF_TEST(Region_opRects, r) {
+    SkRandom rand;
+    for (int i = 0; i < 200; i++) {
+        SkRegion base;
+        randRgn(rand, &base, 4);
+
+        const int N = 1 + rand.nextU() % 64;
+        SkIRect rects[64];
+        for (int j = 0; j < N; j++) {
+            rand_rect(&rects[j], rand);     // some are empty
+        }
+        REPORTER_ASSERT(r, test_rects(rects, N));
+
+        SkRegion rectsRgn;
+        for (int j = 0; j < N; j++) {
+            rectsRgn.op(rects[j], SkRegion::kUnion_Op);
+        }
+        for (int op = 0; op < SkRegion::kOpCnt; op++) {
+            SkRegion expected, actual(base);
+            expected.op(base, rectsRgn, (SkRegion::Op)op);
+            actual.op(rects, N, (SkRegion::Op)op);
+            REPORTER_ASSERT(r, expected == actual);
+        }
+    }
+}
+
+// Regions with many intervals per scanline make results much larger than their inputs.
+DEF_TEST(Region_wideOps, r) {
+    SkTDArray<SkIRect> columns, rows;
+    for (int i = 0; i < 100; i++) {
+        *columns.append() = SkIRect::MakeXYWH(3 * i, 0, 2, 300);
+        *rows.append() = SkIRect::MakeXYWH(0, 3 * i + 1, 300, 1);
+        *rows.append() = SkIRect::MakeXYWH(3 * i, 3 * i, 1, 1);
+    }
+    SkRegion a, b;
+    a.setRects(columns.begin(), columns.count());
+    b.setRects(rows.begin(), rows.count());
+
+    for (int op = 0; op < SkRegion::kOpCnt; op++) {
+        SkRegion result;
+        result.op(a, b, (SkRegion::Op)op);
+        for (int y = -1; y <= 301; y++) {
+            for (int x = -1; x <= 301; x++) {
+                bool inA = a.contains(x, y),
+                     inB = b.contains(x, y),
+                     expected;
+                switch (op) {
+                    case SkRegion::kDifference_Op:        expected = inA && !inB; break;
+                    case SkRegion::kIntersect_Op:         expected = inA && inB;  break;
+                    case SkRegion::kUnion_Op:             expected = inA || inB;  break;
+                    case SkRegion::kXOR_Op:               expected = inA != inB;  break;
+                    case SkRegion::kReverseDifference_Op: expected = inB && !inA; break;
+                    default:                              expected = inB;         break;
+                }
+                if (result.contains(x, y) != expected) {
+                    ERRORF(r, "op %d wrong at (%d, %d)", op, x, y);
+                    return;
+                }
+            }
+        }
+    }
+}
@@ -59,3 +59,100 @@ DEF_TEST(SkRasterPipeline_nonsense, r) {
     p.append(SkRasterPipeline::srcover);
     p.run(0,0, 20);
 }
+
+#include "SkColorPriv.h"
+#include "SkImageShaderContext.h"
+#include "SkPM4f.h"
+#include "SkRandom.h"
+
+// Samples an 8888 image, either with the fused bilinear_8888 or bicubic_8888 stage or with the
+// stages it stands in for.
+static void sample_8888(SkImageShaderContext* ctx, bool bicubic, bool fused, SkPM4f* dst, int n) {
+    // Skewed and offset, so the taps land on both sides of every edge.
+    static const float kMatrix[] = { 0.37f, 0.11f, -0.23f, 0.41f, -1.7f, -1.3f };
+
+    SkRasterPipeline p;
+    p.append(SkRasterPipeline::matrix_2x3, kMatrix);
+    if (fused) {
+        p.append(bicubic ? SkRasterPipeline::bicubic_8888 : SkRasterPipeline::bilinear_8888, ctx);
+    } else {
+        const SkRasterPipeline::StockStage kBilinearX[] = {
+            SkRasterPipeline::bilinear_nx, SkRasterPipeline::bilinear_px,
+        };
+        const SkRasterPipeline::StockStage kBilinearY[] = {
+            SkRasterPipeline::bilinear_ny, SkRasterPipeline::bilinear_py,
+        };
+        const SkRasterPipeline::StockStage kBicubicX[] = {
+            SkRasterPipeline::bicubic_n3x, SkRasterPipeline::bicubic_n1x,
+            SkRasterPipeline::bicubic_p1x, SkRasterPipeline::bicubic_p3x,
+        };
+        const SkRasterPipeline::StockStage kBicubicY[] = {
+            SkRasterPipeline::bicubic_n3y, SkRasterPipeline::bicubic_n1y,
+            SkRasterPipeline::bicubic_p1y, SkRasterPipeline::bicubic_p3y,
+        };
+        const SkRasterPipeline::StockStage kTileX[] = {
+            SkRasterPipeline::clamp_x, SkRasterPipeline::repeat_x, SkRasterPipeline::mirror_x,
+        };
+        const SkRasterPipeline::StockStage kTileY[] = {
+            SkRasterPipeline::clamp_y, SkRasterPipeline::repeat_y, SkRasterPipeline::mirror_y,
+        };
+
+        p.append(SkRasterPipeline::save_xy, ctx);
+        int taps = bicubic ? 4 : 2;
+        for (int j = 0; j < taps; j++) {
+            for (int i = 0; i < taps; i++) {
+                p.append(bicubic ? kBicubicX[i] : kBilinearX[i], ctx);
+                p.append(bicubic ? kBicubicY[j] : kBilinearY[j], ctx);
+                p.append(kTileX[ctx->tileX], &ctx->width);
+                p.append(kTileY[ctx->tileY], &ctx->height);
+                p.append(SkRasterPipeline::gather_8888, ctx);
+                if (ctx->fromSRGB) {
+                    p.append_from_srgb(ctx->clampA ? kPremul_SkAlphaType : kUnpremul_SkAlphaType);
+                }
+                p.append(SkRasterPipeline::accumulate, ctx);
+            }
+        }
+        p.append(SkRasterPipeline::move_dst_src);
+    }
+    p.append(SkRasterPipeline::store_f32, &dst);
+    p.run(0,2, n);
+}
+
+DEF_TEST(SkRasterPipeline_fusedSampling, r) {
+    const int kW = 5, kH = 4;
+    uint32_t pixels[kW * kH];
+    SkRandom rand;
+    for (uint32_t& px : pixels) {
+        unsigned a = rand.nextU() & 0xff;
+        px = SkPackARGB32NoCheck(a, rand.nextU() % (a + 1), rand.nextU() % (a + 1),
+                                 rand.nextU() % (a + 1));
+    }
+
+    SkImageShaderContext ctx;
+    ctx.pixels = pixels;
+    ctx.ctable = nullptr;
+    ctx.stride = kW;
+    ctx.width  = (float)kW;
+    ctx.height = (float)kH;
+
+    const SkShader::TileMode kModes[] = {
+        SkShader::kClamp_TileMode, SkShader::kRepeat_TileMode, SkShader::kMirror_TileMode,
+    };
+    const int kN = 19;  // Not a multiple of the vector size, to exercise the tail.
+    SkPM4f fused[kN], unfused[kN];
+    for (bool bicubic : { false, true }) {
+        for (SkShader::TileMode tx : kModes) {
+            for (SkShader::TileMode ty : kModes) {
+                for (bool srgb : { false, true }) {
+                    ctx.tileX    = tx;
+                    ctx.tileY    = ty;
+                    ctx.fromSRGB = srgb;
+                    ctx.clampA   = srgb;
+                    sample_8888(&ctx, bicubic, true, fused, kN);
+                    sample_8888(&ctx, bicubic, false, unfused, kN);
+                    REPORTER_ASSERT(r, 0 == memcmp(fused, unfused, sizeof(fused)));
+                }
+            }
+        }
+    }
+}
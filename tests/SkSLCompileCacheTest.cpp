@@ -0,0 +1,119 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkSLCompileCache.h"
+#include "SkSLCompiler.h"
+
+#include "SkOSPath.h"
+#include "Test.h"
+
+#if SK_SUPPORT_GPU
+
+static const char* kShader = "void main() { sk_FragColor = vec4(0.75); }";
+static const char* kOtherShader = "void main() { sk_FragColor = vec4(0.5); }";
+
+static bool compile(SkSL::CompileCache* cache, SkSL::Compiler* compiler, const char* src,
+                    const SkSL::Program::Settings& settings, SkString* glsl) {
+    SkSL::Program::Inputs inputs;
+    return cache->compile(compiler, SkSL::CompileCache::kGLSL_Target,
+                          SkSL::Program::kFragment_Kind, SkString(src), settings, glsl, &inputs);
+}
+
+DEF_TEST(SkSLCompileCache, r) {
+    SkSL::Compiler compiler;
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    SkSL::Program::Settings settings;
+    settings.fCaps = caps.get();
+
+    SkString expected;
+    std::unique_ptr<SkSL::Program> program = compiler.convertProgram(
+            SkSL::Program::kFragment_Kind, SkString(kShader), settings);
+    REPORTER_ASSERT(r, program && compiler.toGLSL(*program, &expected));
+
+    SkSL::CompileCache cache;
+    SkString glsl;
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &glsl));
+    REPORTER_ASSERT(r, glsl == expected);
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &glsl));
+    REPORTER_ASSERT(r, glsl == expected);
+    REPORTER_ASSERT(r, 1 == cache.stats().fMisses && 1 == cache.stats().fHits);
+
+    // Different caps are a different entry.
+    sk_sp<GrShaderCaps> otherCaps = SkSL::ShaderCapsFactory::Version110();
+    settings.fCaps = otherCaps.get();
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &glsl));
+    REPORTER_ASSERT(r, glsl != expected);
+    REPORTER_ASSERT(r, 2 == cache.stats().fMisses);
+    settings.fCaps = caps.get();
+
+    // Errors are reported, and not cached.
+    REPORTER_ASSERT(r, !compile(&cache, &compiler, "void main() { x = 1; }", settings, &glsl));
+    REPORTER_ASSERT(r, compiler.errorText().size() > 0);
+    REPORTER_ASSERT(r, !compile(&cache, &compiler, "void main() { x = 1; }", settings, &glsl));
+    REPORTER_ASSERT(r, 4 == cache.stats().fMisses);
+}
+
+DEF_TEST(SkSLCompileCache_LRU, r) {
+    SkSL::Compiler compiler;
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    SkSL::Program::Settings settings;
+    settings.fCaps = caps.get();
+
+    // Measure one entry, then make room for just one.
+    SkString glsl;
+    size_t entryBytes;
+    {
+        SkSL::CompileCache cache;
+        REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &glsl));
+        entryBytes = cache.stats().fBytes;
+    }
+    SkSL::CompileCache cache(entryBytes + entryBytes / 2);
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &glsl));
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kOtherShader, settings, &glsl));
+    REPORTER_ASSERT(r, cache.stats().fBytes <= entryBytes + entryBytes / 2);
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kOtherShader, settings, &glsl));
+    REPORTER_ASSERT(r, 1 == cache.stats().fHits);
+    // kShader was evicted to make room.
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &glsl));
+    REPORTER_ASSERT(r, 3 == cache.stats().fMisses);
+}
+
+DEF_TEST(SkSLCompileCache_Directory, r) {
+    SkString tmpDir = skiatest::GetTmpDir();
+    if (tmpDir.isEmpty()) {
+        return;
+    }
+    SkString dir = SkOSPath::Join(tmpDir.c_str(), "sksl_cache");
+
+    SkSL::Compiler compiler;
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    SkSL::Program::Settings settings;
+    settings.fCaps = caps.get();
+
+    SkString expected;
+    {
+        SkSL::CompileCache cache;
+        cache.setDirectory(dir.c_str());
+        REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &expected));
+        REPORTER_ASSERT(r, cache.stats().fDiskBytes > 0);
+    }
+
+    // A new cache, e.g. in a later process, finds the entry on disk.
+    SkSL::CompileCache cache;
+    cache.setDirectory(dir.c_str());
+    SkString glsl;
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &glsl));
+    REPORTER_ASSERT(r, glsl == expected);
+    REPORTER_ASSERT(r, 1 == cache.stats().fDiskHits && 0 == cache.stats().fMisses);
+
+    // Purging memory falls back to disk.
+    cache.purge();
+    REPORTER_ASSERT(r, compile(&cache, &compiler, kShader, settings, &glsl));
+    REPORTER_ASSERT(r, 2 == cache.stats().fDiskHits && 0 == cache.stats().fMisses);
+}
+
+#endif
@@ -677,4 +677,32 @@ DEF_TEST(SkSLFragCoord, r) {
     REPORTER_ASSERT(r, !inputs.fRTHeight);
 }
 
+DEF_TEST(SkSLSharedBuiltins, r) {
+    // Built-in declarations are shared between compilers; defining a function with a built-in's
+    // signature must only affect the program that defines it.
+    static const char* kDefinesSqrt =
+        "float sqrt(float x) { return x; }"
+        "void main() { sk_FragColor = vec4(sqrt(4)); }";
+    SkSL::Program::Settings settings;
+    sk_sp<GrShaderCaps> caps = SkSL::ShaderCapsFactory::Default();
+    settings.fCaps = caps.get();
+    SkSL::Compiler compiler;
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<SkSL::Program> program = compiler.convertProgram(
+                SkSL::Program::kFragment_Kind, SkString(kDefinesSqrt), settings);
+        if (!program) {
+            ERRORF(r, "Unexpected error compiling %s\n%s", kDefinesSqrt,
+                   compiler.errorText().c_str());
+        }
+    }
+    test(r,
+         "void main() { sk_FragColor = vec4(sqrt(4)); }",
+         *caps,
+         "#version 400\n"
+         "out vec4 sk_FragColor;\n"
+         "void main() {\n"
+         "    sk_FragColor = vec4(sqrt(4.0));\n"
+         "}\n");
+}
+
 #endif
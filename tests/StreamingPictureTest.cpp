@@ -0,0 +1,140 @@
+/*
+ * Copyright 2017 Google Inc.
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "SkCanvas.h"
+#include "SkPictureRecorder.h"
+#include "SkStream.h"
+#include "SkStreamingPicture.h"
+#include "SkSurface.h"
+#include "Test.h"
+
+static const int kSize = 256;
+
+static sk_sp<SkPicture> make_picture() {
+    SkPictureRecorder recorder;
+    SkCanvas* canvas = recorder.beginRecording(kSize, kSize);
+    SkPaint paint;
+    for (int y = 0; y < kSize; y += 8) {
+        for (int x = 0; x < kSize; x += 8) {
+            paint.setColor(SkColorSetRGB(x, y, 255 - x));
+            canvas->drawRect(SkRect::MakeXYWH(x, y, 6, 6), paint);
+        }
+    }
+
+    // Matrices, clips and layers, which ops outside the tile being drawn still depend on.
+    canvas->save();
+        canvas->translate(100, 100);
+        canvas->clipRect(SkRect::MakeWH(100, 50));
+        paint.setColor(SK_ColorBLUE);
+        canvas->drawCircle(50, 50, 60, paint);
+    canvas->restore();
+    canvas->translate(0, 10);
+    paint.setAlpha(0x80);
+    canvas->saveLayer(nullptr, &paint);
+        paint.setColor(SK_ColorGREEN);
+        canvas->drawOval(SkRect::MakeLTRB(10, 150, 120, 230), paint);
+    canvas->restore();
+
+    // An op bigger than the memory limit used below.
+    SkPoint points[1000];
+    for (int i = 0; i < 1000; i++) {
+        points[i] = SkPoint::Make(200 + (i % 50), 200 + (i / 50));
+    }
+    paint.setColor(SK_ColorRED);
+    canvas->drawPoints(SkCanvas::kPoints_PointMode, 1000, points, paint);
+    return recorder.finishRecordingAsPicture();
+}
+
+static std::unique_ptr<SkStreamingPicture> make_streaming(sk_sp<SkData> skp) {
+    std::unique_ptr<SkStreamAsset> stream(new SkMemoryStream(std::move(skp)));
+    std::unique_ptr<SkStreamingPicture> picture = SkStreamingPicture::Make(std::move(stream));
+    if (picture) {
+        picture->setMemoryLimit(1024);
+    }
+    return picture;
+}
+
+// Draws the tile at (x,y) of the picture, either as an SkPicture or as an SkStreamingPicture.
+static void draw_tile(const SkPicture* picture, SkStreamingPicture* streaming,
+                      int x, int y, int size, SkBitmap* bm) {
+    bm->allocN32Pixels(size, size);
+    bm->eraseColor(SK_ColorWHITE);
+    SkCanvas canvas(*bm);
+    canvas.translate(-x, -y);
+    if (picture) {
+        canvas.drawPicture(picture);
+    } else {
+        streaming->playback(&canvas);
+    }
+}
+
+static bool equal(const SkBitmap& a, const SkBitmap& b) {
+    return 0 == memcmp(a.getPixels(), b.getPixels(), a.getSize());
+}
+
+DEF_TEST(StreamingPicture, r) {
+    sk_sp<SkPicture> picture = make_picture();
+    sk_sp<SkData> skp = picture->serialize();
+    std::unique_ptr<SkStreamingPicture> streaming = make_streaming(skp);
+    REPORTER_ASSERT(r, streaming);
+    if (!streaming) {
+        return;
+    }
+    REPORTER_ASSERT(r, streaming->cullRect() == picture->cullRect());
+
+    // Without an index, every op is read and drawn.
+    SkBitmap expected, actual;
+    draw_tile(picture.get(), nullptr, 0, 0, kSize, &expected);
+    draw_tile(nullptr, streaming.get(), 0, 0, kSize, &actual);
+    REPORTER_ASSERT(r, equal(expected, actual));
+    const int opCount = streaming->stats().fOpsDrawn;
+    REPORTER_ASSERT(r, opCount > 1000);
+    // Only the op bigger than the limit needed more memory.
+    REPORTER_ASSERT(r, streaming->stats().fPeakBytes < skp->size() / 4);
+
+    // With one, a tile reads only what touches it, and draws the same.
+    REPORTER_ASSERT(r, streaming->buildIndex());
+    REPORTER_ASSERT(r, opCount == streaming->opCount());
+    for (int y = 0; y < kSize; y += 64) {
+        for (int x = 0; x < kSize; x += 64) {
+            int opsBefore = streaming->stats().fOpsDrawn;
+            draw_tile(picture.get(), nullptr, x, y, 64, &expected);
+            draw_tile(nullptr, streaming.get(), x, y, 64, &actual);
+            REPORTER_ASSERT(r, equal(expected, actual));
+            REPORTER_ASSERT(r, streaming->stats().fOpsDrawn - opsBefore < opCount / 4);
+        }
+    }
+
+    // The index survives a round trip, and only fits the SKP it was built for.
+    SkDynamicMemoryWStream indexStream;
+    REPORTER_ASSERT(r, streaming->writeIndex(&indexStream));
+    sk_sp<SkData> index = indexStream.detachAsData();
+
+    std::unique_ptr<SkStreamingPicture> reloaded = make_streaming(skp);
+    SkMemoryStream indexReader(index);
+    REPORTER_ASSERT(r, reloaded->readIndex(&indexReader));
+    REPORTER_ASSERT(r, opCount == reloaded->opCount());
+    draw_tile(picture.get(), nullptr, 64, 128, 64, &expected);
+    draw_tile(nullptr, reloaded.get(), 64, 128, 64, &actual);
+    REPORTER_ASSERT(r, equal(expected, actual));
+
+    SkPictureRecorder recorder;
+    recorder.beginRecording(kSize, kSize)->drawColor(SK_ColorBLACK);
+    sk_sp<SkData> otherSkp = recorder.finishRecordingAsPicture()->serialize();
+    std::unique_ptr<SkStreamingPicture> other = make_streaming(otherSkp);
+    indexReader.rewind();
+    REPORTER_ASSERT(r, !other->readIndex(&indexReader));
+    REPORTER_ASSERT(r, !other->hasIndex());
+}
+
+DEF_TEST(StreamingPicture_notSKP, r) {
+    // Long enough to hold an SKP header.
+    char notSKP[256];
+    memset(notSKP, 'x', sizeof(notSKP));
+    std::unique_ptr<SkStreamAsset> stream(new SkMemoryStream(notSKP, sizeof(notSKP)));
+    REPORTER_ASSERT(r, !SkStreamingPicture::Make(std::move(stream)));
+}
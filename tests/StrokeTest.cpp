@@ -8,7 +8,9 @@
 #include "SkPaint.h"
 #include "SkPath.h"
 #include "SkRect.h"
+#include "SkResourceCache.h"
 #include "SkStroke.h"
+#include "SkStrokeCache.h"
 #include "SkStrokeRec.h"
 #include "Test.h"
 
@@ -160,8 +162,79 @@ static void test_strokerec_equality(skiatest::Reporter* reporter) {
     }
 }
 
+static void test_stroke_cache(skiatest::Reporter* reporter) {
+    SkPath path;
+    path.moveTo(10, 10);
+    path.cubicTo(40, 0, 60, 100, 90, 10);
+
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setStrokeWidth(4);
+    SkStrokeRec rec(paint);
+
+    // Strokes come out the same from the cache as from the stroker, at any resolution scale.
+    REPORTER_ASSERT(reporter, SkStrokeCache::CanCache(path, 1));
+    SkPath expected;
+    SkStroke stroker(paint);
+    stroker.strokePath(path, &expected);
+    SkPath first, second, third;
+    REPORTER_ASSERT(reporter, rec.applyToPath(&first, path));
+    REPORTER_ASSERT(reporter, rec.applyToPath(&second, path));
+    REPORTER_ASSERT(reporter, rec.applyToPath(&third, path));
+    REPORTER_ASSERT(reporter, expected == first);
+    REPORTER_ASSERT(reporter, expected == second);
+    REPORTER_ASSERT(reporter, expected == third);
+    for (SkScalar resScale : { 0.3f, 1.1f, 7.9f }) {
+        SkStrokeRec scaled(paint, resScale);
+        SkPath scaledExpected;
+        SkStroke scaledStroker(paint);
+        scaledStroker.setResScale(resScale);
+        scaledStroker.strokePath(path, &scaledExpected);
+        for (int i = 0; i < 3; i++) {
+            SkPath scaledPath;
+            REPORTER_ASSERT(reporter, scaled.applyToPath(&scaledPath, path));
+            REPORTER_ASSERT(reporter, scaledExpected == scaledPath);
+        }
+    }
+
+    SkResourceCache cache(1024 * 1024);
+    SkPath found;
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, 1, &found, &cache));
+    SkStrokeCache::Add(path, rec, 1, expected, &cache);
+    REPORTER_ASSERT(reporter, SkStrokeCache::Find(path, rec, 1, &found, &cache));
+    REPORTER_ASSERT(reporter, expected == found);
+
+    // Anything that changes the outline misses.
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, rec, 2, &found, &cache));
+    SkStrokeRec wider(rec);
+    wider.setStrokeStyle(5);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, wider, 1, &found, &cache));
+    SkStrokeRec round(rec);
+    round.setStrokeParams(SkPaint::kRound_Cap, SkPaint::kRound_Join, 4);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(path, round, 1, &found, &cache));
+    SkPath edited(path);
+    edited.lineTo(0, 0);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::Find(edited, rec, 1, &found, &cache));
+
+    // Only paths stroked before are added, so one-off paths never reach the cache.
+    SkPath once(path);
+    once.lineTo(5, 5);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::SeenBefore(once));
+    REPORTER_ASSERT(reporter, SkStrokeCache::SeenBefore(once));
+
+    // Volatile paths and short polylines are not worth caching.
+    SkPath volatilePath(path);
+    volatilePath.setIsVolatile(true);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::CanCache(volatilePath, 1));
+    SkPath line;
+    line.moveTo(0, 0);
+    line.lineTo(10, 10);
+    REPORTER_ASSERT(reporter, !SkStrokeCache::CanCache(line, 1));
+}
+
 DEF_TEST(Stroke, reporter) {
     test_strokecubic(reporter);
     test_strokerect(reporter);
     test_strokerec_equality(reporter);
+    test_stroke_cache(reporter);
 }
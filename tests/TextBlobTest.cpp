@@ -5,12 +5,15 @@
  * found in the LICENSE file.
  */
 
+#include "SkCanvas.h"
+#include "SkGraphics.h"
 #include "SkPaint.h"
 #include "SkPoint.h"
 #include "SkTextBlobRunIterator.h"
 #include "SkTypeface.h"
 
 #include "Test.h"
+#include "sk_tool_utils.h"
 
 class TextBlobTester {
 public:
@@ -386,3 +389,64 @@ DEF_TEST(TextBlob_extended, reporter) {
         REPORTER_ASSERT(reporter, 0 == strncmp(text2, it.text(), it.textSize()));
     }
 }
+
+// Large blobs have their glyph images generated up front, in parallel; the result must match
+// drawing the same glyphs one run at a time with a cold cache.
+DEF_TEST(TextBlob_prefetch, reporter) {
+    const int kPosCount = 160;
+    const int kDefaultCount = 80;
+    const SkScalar kSize = 16;
+
+    sk_sp<SkTypeface> typeface = sk_tool_utils::create_portable_typeface("serif", SkFontStyle());
+    const int distinctGlyphs = SkTMax(typeface->countGlyphs() - 1, 1);
+
+    SkPaint paint;
+    paint.setAntiAlias(true);
+    paint.setTextSize(kSize);
+    paint.setTypeface(typeface);
+    paint.setTextEncoding(SkPaint::kGlyphID_TextEncoding);
+
+    SkTextBlobBuilder builder;
+    const SkTextBlobBuilder::RunBuffer& posRun = builder.allocRunPos(paint, kPosCount);
+    for (int i = 0; i < kPosCount; ++i) {
+        posRun.glyphs[i] = SkToU16(1 + i % distinctGlyphs);
+        posRun.pos[2 * i + 0] = (i % 16) * kSize;
+        posRun.pos[2 * i + 1] = (i / 16 + 1) * kSize;
+    }
+    const SkTextBlobBuilder::RunBuffer& defaultRun = builder.allocRun(paint, kDefaultCount,
+                                                                      0, 12 * kSize);
+    for (int i = 0; i < kDefaultCount; ++i) {
+        defaultRun.glyphs[i] = SkToU16(1 + (kPosCount + i) % distinctGlyphs);
+    }
+    sk_sp<SkTextBlob> blob = builder.make();
+
+    SkBitmap expected, actual;
+    expected.allocN32Pixels(256, 256);
+    expected.eraseColor(SK_ColorWHITE);
+    actual.allocN32Pixels(256, 256);
+    actual.eraseColor(SK_ColorWHITE);
+
+    SkGraphics::PurgeFontCache();
+    {
+        SkCanvas canvas(expected);
+        SkTextBlobRunIterator it(blob.get());
+        canvas.drawPosText(it.glyphs(), it.glyphCount() * sizeof(uint16_t),
+                           reinterpret_cast<const SkPoint*>(it.pos()), paint);
+        it.next();
+        canvas.drawText(it.glyphs(), it.glyphCount() * sizeof(uint16_t),
+                        it.offset().x(), it.offset().y(), paint);
+    }
+
+    SkGraphics::PurgeFontCache();
+    SkCanvas(actual).drawTextBlob(blob, 0, 0, SkPaint());
+
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSize()));
+
+    // Drawn again, the strike is warm and the prefetch is skipped.
+    actual.eraseColor(SK_ColorWHITE);
+    SkCanvas(actual).drawTextBlob(blob, 0, 0, SkPaint());
+
+    REPORTER_ASSERT(reporter, 0 == memcmp(expected.getPixels(), actual.getPixels(),
+                                          expected.getSize()));
+}
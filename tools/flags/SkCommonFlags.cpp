@@ -67,6 +67,8 @@ DEFINE_string(properties, "",
 DEFINE_bool2(pre_log, p, false, "Log before running each test. May be incomprehensible when threading");
 
 DEFINE_bool(analyticAA, true, "If false, disable analytic anti-aliasing");
+DEFINE_int32(aaBands, 1, "Supersample big antialiased path fills in this many bands of rows "
+                         "at once (with --noanalyticAA).");
 
 bool CollectImages(SkCommandLineFlags::StringArray images, SkTArray<SkString>* output) {
     SkASSERT(output);
@@ -33,6 +33,7 @@ DECLARE_bool(veryVerbose);
 DECLARE_string(writePath);
 DECLARE_bool(pre_log);
 DECLARE_bool(analyticAA);
+DECLARE_int32(aaBands);
 
 DECLARE_string(key);
 DECLARE_string(properties);
@@ -8,12 +8,14 @@
 #include "GpuTimer.h"
 #include "GrContextFactory.h"
 #include "SkCanvas.h"
+#include "SkDrawable.h"
 #include "SkOSFile.h"
 #include "SkOSPath.h"
 #include "SkPerlinNoiseShader.h"
 #include "SkPicture.h"
 #include "SkPictureRecorder.h"
 #include "SkStream.h"
+#include "SkStreamingPicture.h"
 #include "SkSurface.h"
 #include "SkSurfaceProps.h"
 #include "picture_utils.h"
@@ -44,6 +46,9 @@ DEFINE_bool(gpuClock, false, "time on the gpu clock (gpu work only)");
 DEFINE_bool(fps, false, "use fps instead of ms");
 DEFINE_string(skp, "", "path to a single .skp file, or 'warmup' for a builtin warmup run");
 DEFINE_string(png, "", "if set, save a .png proof to disk at this file location");
+DEFINE_string(index, "", "if set, draw the skp straight from its file instead of loading it, "
+                         "using this index (from skpinfo --index)");
+DEFINE_int32(streamKB, 4096, "with --index, how many KB of the skp's ops to hold at a time");
 DEFINE_int32(verbosity, 4, "level of verbosity (0=none to 5=debug)");
 DEFINE_bool(suppressHeader, false, "don't print a header row before the results");
 
@@ -89,14 +94,40 @@ enum class ExitErr {
     kSoftware     = 70
 };
 
-static void draw_skp_and_flush(SkCanvas*, const SkPicture*);
+/**
+ * Draws an skp that is either loaded into memory or, with --index, read from its file as it draws.
+ */
+class SkpDrawable : public SkDrawable {
+public:
+    explicit SkpDrawable(sk_sp<SkPicture> picture) : fPicture(std::move(picture)) {}
+    explicit SkpDrawable(std::unique_ptr<SkStreamingPicture> streaming)
+        : fStreaming(std::move(streaming)) {}
+
+protected:
+    SkRect onGetBounds() override {
+        return fPicture ? fPicture->cullRect() : fStreaming->cullRect();
+    }
+    void onDraw(SkCanvas* canvas) override {
+        if (fPicture) {
+            canvas->drawPicture(fPicture);
+        } else {
+            fStreaming->playback(canvas);
+        }
+    }
+
+private:
+    sk_sp<SkPicture>                    fPicture;
+    std::unique_ptr<SkStreamingPicture> fStreaming;
+};
+
+static void draw_skp_and_flush(SkCanvas*, SkDrawable*);
 static sk_sp<SkPicture> create_warmup_skp();
 static bool mkdir_p(const SkString& name);
 static SkString join(const SkCommandLineFlags::StringArray&);
 static void exitf(ExitErr, const char* format, ...);
 
 static void run_benchmark(const sk_gpu_test::FenceSync* fenceSync, SkCanvas* canvas,
-                          const SkPicture* skp, std::vector<Sample>* samples) {
+                          SkDrawable* skp, std::vector<Sample>* samples) {
     using clock = std::chrono::high_resolution_clock;
     const Sample::duration sampleDuration = std::chrono::milliseconds(FLAGS_sampleMs);
     const clock::duration benchDuration = std::chrono::milliseconds(FLAGS_duration);
@@ -128,7 +159,7 @@ static void run_benchmark(const sk_gpu_test::FenceSync* fenceSync, SkCanvas* can
 
 static void run_gpu_time_benchmark(sk_gpu_test::GpuTimer* gpuTimer,
                                    const sk_gpu_test::FenceSync* fenceSync, SkCanvas* canvas,
-                                   const SkPicture* skp, std::vector<Sample>* samples) {
+                                   SkDrawable* skp, std::vector<Sample>* samples) {
     using sk_gpu_test::PlatformTimerQuery;
     using clock = std::chrono::steady_clock;
     const clock::duration sampleDuration = std::chrono::milliseconds(FLAGS_sampleMs);
@@ -244,30 +275,53 @@ int main(int argc, char** argv) {
         exitf(ExitErr::kUsage, "invalid skp '%s': must specify a single skp file, or 'warmup'",
                                join(FLAGS_skp).c_str());
     }
-    sk_sp<SkPicture> skp;
+    sk_sp<SkpDrawable> skp;
     SkString skpname;
     if (0 == strcmp(FLAGS_skp[0], "warmup")) {
-        skp = create_warmup_skp();
+        skp = sk_make_sp<SkpDrawable>(create_warmup_skp());
         skpname = "warmup";
+    } else if (!FLAGS_index.isEmpty()) {
+        const char* skpfile = FLAGS_skp[0];
+        std::unique_ptr<SkStreamAsset> skpstream(SkStream::MakeFromFile(skpfile));
+        if (!skpstream) {
+            exitf(ExitErr::kIO, "failed to open skp file %s", skpfile);
+        }
+        std::unique_ptr<SkStreamingPicture> streaming =
+                SkStreamingPicture::Make(std::move(skpstream));
+        if (!streaming) {
+            exitf(ExitErr::kData, "failed to parse skp file %s", skpfile);
+        }
+        std::unique_ptr<SkStream> indexstream(SkStream::MakeFromFile(FLAGS_index[0]));
+        if (!indexstream) {
+            exitf(ExitErr::kIO, "failed to open index file %s", FLAGS_index[0]);
+        }
+        if (!streaming->readIndex(indexstream.get())) {
+            exitf(ExitErr::kData, "index file %s does not fit skp file %s",
+                                  FLAGS_index[0], skpfile);
+        }
+        streaming->setMemoryLimit(SkTMax(FLAGS_streamKB, 1) * 1024);
+        skp = sk_make_sp<SkpDrawable>(std::move(streaming));
+        skpname = SkOSPath::Basename(skpfile);
     } else {
         const char* skpfile = FLAGS_skp[0];
         std::unique_ptr<SkStream> skpstream(SkStream::MakeFromFile(skpfile));
         if (!skpstream) {
             exitf(ExitErr::kIO, "failed to open skp file %s", skpfile);
         }
-        skp = SkPicture::MakeFromStream(skpstream.get());
-        if (!skp) {
+        sk_sp<SkPicture> picture = SkPicture::MakeFromStream(skpstream.get());
+        if (!picture) {
             exitf(ExitErr::kData, "failed to parse skp file %s", skpfile);
         }
+        skp = sk_make_sp<SkpDrawable>(std::move(picture));
         skpname = SkOSPath::Basename(skpfile);
     }
-    int width = SkTMin(SkScalarCeilToInt(skp->cullRect().width()), 2048),
-        height = SkTMin(SkScalarCeilToInt(skp->cullRect().height()), 2048);
-    if (FLAGS_verbosity >= 3 &&
-        (width != skp->cullRect().width() || height != skp->cullRect().height())) {
+    const SkRect bounds = skp->getBounds();
+    int width = SkTMin(SkScalarCeilToInt(bounds.width()), 2048),
+        height = SkTMin(SkScalarCeilToInt(bounds.height()), 2048);
+    if (FLAGS_verbosity >= 3 && (width != bounds.width() || height != bounds.height())) {
         fprintf(stderr, "%s is too large (%ix%i), cropping to %ix%i.\n",
-                        skpname.c_str(), SkScalarCeilToInt(skp->cullRect().width()),
-                        SkScalarCeilToInt(skp->cullRect().height()), width, height);
+                        skpname.c_str(), SkScalarCeilToInt(bounds.width()),
+                        SkScalarCeilToInt(bounds.height()), width, height);
     }
 
     // Create a context.
@@ -316,7 +370,7 @@ int main(int argc, char** argv) {
         samples.reserve(2 * FLAGS_duration);
     }
     SkCanvas* canvas = surface->getCanvas();
-    canvas->translate(-skp->cullRect().x(), -skp->cullRect().y());
+    canvas->translate(-bounds.x(), -bounds.y());
     if (!FLAGS_gpuClock) {
         run_benchmark(testCtx->fenceSync(), canvas, skp.get(), &samples);
     } else {
@@ -348,8 +402,8 @@ int main(int argc, char** argv) {
     exit(0);
 }
 
-static void draw_skp_and_flush(SkCanvas* canvas, const SkPicture* skp) {
-    canvas->drawPicture(skp);
+static void draw_skp_and_flush(SkCanvas* canvas, SkDrawable* skp) {
+    canvas->drawDrawable(skp);
     canvas->flush();
 }
 
@@ -9,6 +9,7 @@
 #include "SkPicture.h"
 #include "SkPictureData.h"
 #include "SkStream.h"
+#include "SkStreamingPicture.h"
 #include "SkFontDescriptor.h"
 
 DEFINE_string2(input, i, "", "skp on which to report");
@@ -17,6 +18,7 @@ DEFINE_bool2(cullRect, c, true, "cullRect");
 DEFINE_bool2(flags, f, true, "flags");
 DEFINE_bool2(tags, t, true, "tags");
 DEFINE_bool2(quiet, q, false, "quiet");
+DEFINE_string(index, "", "if set, write an index for drawing the skp from its file (see skpbench)");
 
 // This tool can print simple information about an SKP but its main use
 // is just to check if an SKP has been truncated during the recording
@@ -49,6 +51,30 @@ int tool_main(int argc, char** argv) {
         return kIOError;
     }
 
+    if (!FLAGS_index.isEmpty()) {
+        std::unique_ptr<SkStreamingPicture> picture =
+                SkStreamingPicture::Make(SkStream::MakeFromFile(FLAGS_input[0]));
+        if (!picture) {
+            return kNotAnSKP;
+        }
+        if (!picture->buildIndex()) {
+            if (!FLAGS_quiet) {
+                SkDebugf("Couldn't read ops\n");
+            }
+            return kTruncatedFile;
+        }
+        SkFILEWStream index(FLAGS_index[0]);
+        if (!index.isValid() || !picture->writeIndex(&index)) {
+            if (!FLAGS_quiet) {
+                SkDebugf("Couldn't write index\n");
+            }
+            return kIOError;
+        }
+        if (!FLAGS_quiet) {
+            SkDebugf("Index: %d ops\n", picture->opCount());
+        }
+    }
+
     size_t totStreamSize = stream.getLength();
 
     SkPictInfo info;